@@ -0,0 +1,80 @@
+// Cull.h - frustum and occlusion culling of bounding boxes (c) 2019-2022 Jules Bloomenthal
+
+#ifndef CULL_HDR
+#define CULL_HDR
+
+#include <vector>
+#include "CameraArcball.h"
+#include "Mesh.h"
+#include "VecMat.h"
+
+using std::vector;
+
+// Frustum
+
+struct Frustum {
+	vec4 planes[6];					// left, right, bottom, top, near, far; unit normals point inward
+	Frustum() { }
+	Frustum(mat4 fullview);
+		// planes (Gribb and Hartmann) in the space mapped to clip space by fullview, eg:
+		// world space if fullview = camera.persp*camera.modelview
+		// object space of a mesh if fullview = camera.persp*camera.modelview*mesh.transform
+	bool Outside(vec3 min, vec3 max);
+		// true if box is entirely outside a plane (a box may straddle two planes and be culled late)
+};
+
+// Boxes
+
+struct Boxes {
+	// axis-aligned boxes, stored as separate coordinate arrays for SIMD tests
+	vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+	int Size() { return (int) minX.size(); }
+	void Clear();
+	void Add(vec3 min, vec3 max, mat4 *transform = NULL);
+		// if non-null, add the bounds of the box transformed by transform
+	void Get(int i, vec3 &min, vec3 &max);
+};
+
+void SetMeshBoxes(vector<Mesh *> &meshes, Boxes &boxes);
+	// world space box per mesh: MinMax of points, transformed by mesh->transform
+	// recompute if a mesh's transform changes; O(total # points)
+
+void SetGroupBoxes(Mesh &mesh, Boxes &boxes);
+	// object space box per mesh.triangleGroups; recompute if points change
+
+// Hierarchical depth buffer
+
+class HiZBuffer {
+	// software rasterized depth of occluders at low resolution, with a max-depth pyramid;
+	// depth is normalized device z, 1 (far) where no occluder
+public:
+	int width = 0, height = 0;
+	vector<vector<float>> levels;	// levels[0] is width*height, each next level half size (rounded up)
+	HiZBuffer(int width = 256, int height = 128) { Resize(width, height); }
+	void Resize(int width, int height);
+	void Clear();
+	void Rasterize(vector<vec3> &points, vector<int3> &triangles, mat4 fullview);
+		// scan convert occluder triangles, keeping nearest depth per pixel; fullview maps to clip space
+		// triangles crossing the near plane are skipped (fewer occluders is conservative)
+	void Rasterize(Mesh &mesh, mat4 fullview);
+		// rasterize mesh.triangles (or coarsest LOD, if any) with fullview*mesh.transform
+	void BuildPyramid();
+		// call after rasterizing occluders, before Visible
+	bool Visible(vec3 min, vec3 max, mat4 fullview);
+		// false if the box, projected by fullview, lies entirely behind occluders
+};
+
+// Culling
+
+int CullBoxes(Frustum &frustum, Boxes &boxes, vector<int> &visible, HiZBuffer *hiz = NULL, mat4 *fullview = NULL);
+	// set visible to indices of boxes not outside frustum and, if hiz (with fullview as used to
+	// form frustum), not occluded; return # visible; boxes tested four at a time with SSE
+
+int CullMeshes(CameraAB &camera, Boxes &meshBoxes, vector<int> &visible, HiZBuffer *hiz = NULL);
+	// meshBoxes from SetMeshBoxes; set visible to indices of meshes in view
+
+int CullGroups(CameraAB &camera, Mesh &mesh, Boxes &groupBoxes, vector<int> &visible, HiZBuffer *hiz = NULL);
+	// groupBoxes from SetGroupBoxes; set visible to indices of mesh.triangleGroups in view
+	// for Mesh::Display to draw only these, set mesh.visibleGroups = &visible
+
+#endif
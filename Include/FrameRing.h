@@ -0,0 +1,35 @@
+// FrameRing.h - shared ring buffer for per-frame dynamic geometry (c) 2019-2022 Jules Bloomenthal
+
+#ifndef FRAME_RING_HDR
+#define FRAME_RING_HDR
+
+#include <glad.h>
+#include <stddef.h>
+
+// Allocation
+
+GLintptr FrameRingWrite(const void *data, size_t bytes);
+	// copy data into the ring, bind FrameRingBuffer() to GL_ARRAY_BUFFER, return offset of the copy
+	// offsets are 16-byte aligned; the ring is three regions, each fenced when left and waited on
+	// (only if the GPU still reads it) when re-entered; the ring grows if bytes exceeds a region
+GLuint FrameRingBuffer();
+	// buffer name (0 until first write)
+void FrameRingEndFrame();
+	// optional: fence the current region and start the next, so consecutive frames use separate regions
+
+// Configuration
+
+void FrameRingSize(size_t regionBytes);
+	// set region size (default 1 MB); the buffer is recreated at the next write
+bool FrameRingPersistent();
+	// after the first write, true if the buffer is mapped once, persistently and coherently
+	// (ARB_buffer_storage); else each write maps an unsynchronized range with glMapBufferRange
+
+struct FrameRingStats {
+	int writes = 0, regionChanges = 0, wraps = 0, fenceWaits = 0, grows = 0;
+};
+
+FrameRingStats GetFrameRingStats();
+	// counts since startup; fenceWaits counts fences the GPU had not yet passed when a region was re-entered
+
+#endif
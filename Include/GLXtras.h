@@ -1,73 +1,176 @@
-// GLXtras.h - GLSL convenience routines (c) 2019-2022 Jules Bloomenthal
-
-#ifndef GL_XTRAS_HDR
-#define GL_XTRAS_HDR
-
-#include "glad.h"
-#include "VecMat.h"
-
-// Print Info
-int PrintGLErrors(const char *title = NULL);
-void PrintVersionInfo();
-void PrintExtensions();
-void PrintProgramLog(int programID);
-void PrintProgramAttributes(int programID);
-void PrintProgramUniforms(int programID);
-
-// Shader Compilation
-GLuint CompileShaderViaFile(const char *filename, GLint type);
-GLuint CompileShaderViaCode(const char **code, GLint type);
-
-// Program Linking
-GLuint LinkProgramViaCode(const char **vertexCode, const char **pixelCode);
-GLuint LinkProgramViaCode(const char **vertexCode,
-						  const char **tessellationControlCode,
-						  const char **tessellationEvalCode,
-						  const char **geometryCode,
-						  const char **pixelCode);
-GLuint LinkProgramViaCode(const char **computeCode);
-GLuint LinkProgram(GLuint vshader, GLuint pshader);
-GLuint LinkProgram(GLuint vshader, GLuint tcshader, GLuint teshader, GLuint gshader, GLuint pshader);
-GLuint LinkProgramViaFile(const char *vertexShaderFile, const char *pixelShaderFile);
-GLuint LinkProgramViaFile(const char *computeShaderFile);
-
-// Miscellany
-int CurrentProgram();
-void DeleteProgram(int program);
-
-// Binary Read/Write
-void WriteProgramBinary(GLuint program, const char *filename);
-bool ReadProgramBinary(GLuint program, const char *filename);
-GLuint ReadProgramBinary(const char *filename);
-
-// Uniform Access
-void SetReport(bool report);
-	// if report, print any unknown uniforms or attributes
-bool SetUniform(int program, const char *name, bool val);
-bool SetUniform(int program, const char *name, int val);
-bool SetUniform(int program, const char *name, GLuint val);
-	// some compilers confused by int/GLuint distinction
-bool SetUniformv(int program, const char *name, int count, int *v);
-bool SetUniform(int program, const char *name, float val);
-bool SetUniformv(int program, const char *name, int count, float *v);
-bool SetUniform(int program, const char *name, vec2 v);
-bool SetUniform(int program, const char *name, vec3 v);
-bool SetUniform(int program, const char *name, vec4 v);
-bool SetUniform(int program, const char *name, vec3 *v);
-bool SetUniform(int program, const char *name, vec4 *v);
-bool SetUniform3(int program, const char *name, float *v);
-bool SetUniform3v(int program, const char *name, int count, float *v);
-bool SetUniform4v(int program, const char *name, int count, float *v);
-bool SetUniform(int program, const char *name, mat4 m);
-	// if no such named uniform and squawk, print error message
-
-// Attribute Access
-int EnableVertexAttribute(int program, const char *name);
-	// find named attribute and enable
-void DisableVertexAttribute(int program, const char *name);
-	// find named attribute and disable
-void VertexAttribPointer(int program, const char *name, GLint ncomponents, GLsizei stride, const GLvoid *offset);
-	// find and set named attribute, with given number of components, stride between entries, offset into array
-	// this calls glAttribPointer with type = GL_FLOAT and normalize = GL_FALSE
-
-#endif // GL_XTRAS_HDR
+// GLXtras.h - GLSL convenience routines (c) 2019-2022 Jules Bloomenthal
+
+#ifndef GL_XTRAS_HDR
+#define GL_XTRAS_HDR
+
+#include <string>
+#include "glad.h"
+#include "VecMat.h"
+
+// Print Info
+int PrintGLErrors(const char *title = NULL);
+void PrintVersionInfo();
+void PrintExtensions();
+void PrintProgramLog(int programID);
+void PrintProgramAttributes(int programID);
+void PrintProgramUniforms(int programID);
+
+// Shader Compilation
+GLuint CompileShaderViaFile(const char *filename, GLint type);
+GLuint CompileShaderViaCode(const char **code, GLint type);
+
+// Program Linking
+GLuint LinkProgramViaCode(const char **vertexCode, const char **pixelCode);
+GLuint LinkProgramViaCode(const char **vertexCode,
+						  const char **tessellationControlCode,
+						  const char **tessellationEvalCode,
+						  const char **geometryCode,
+						  const char **pixelCode);
+GLuint LinkProgramViaCode(const char **computeCode);
+GLuint LinkProgram(GLuint vshader, GLuint pshader);
+GLuint LinkProgram(GLuint vshader, GLuint tcshader, GLuint teshader, GLuint gshader, GLuint pshader);
+GLuint LinkProgramViaFile(const char *vertexShaderFile, const char *pixelShaderFile);
+GLuint LinkProgramViaFile(const char *computeShaderFile);
+
+// Asynchronous Program Linking
+struct ProgramFuture {
+	// a program submitted for compilation and linking, possibly on driver threads
+	GLuint program = 0, shaders[5] = { 0, 0, 0, 0, 0 };
+	int nShaders = 0;
+	bool done = false;
+	std::string cacheFile;
+	bool Ready();
+		// true if compilation and linking have finished; does not block if ParallelShaderCompile()
+	GLuint Get();
+		// wait for completion, return linked program (or 0, with logs printed, if failure)
+};
+
+ProgramFuture LinkProgramAsync(const char **vertexCode, const char **pixelCode);
+ProgramFuture LinkProgramAsync(const char **vertexCode,
+							   const char **tessellationControlCode,
+							   const char **tessellationEvalCode,
+							   const char **geometryCode,
+							   const char **pixelCode);
+	// compile and link without querying status, so that several programs compile concurrently, eg:
+	//     ProgramFuture a = LinkProgramAsync(...), b = LinkProgramAsync(...);
+	//     ... other initialization, or poll a.Ready() ...
+	//     GLuint aProgram = a.Get(), bProgram = b.Get();
+	// a program found in the program cache (see SetShaderCache) is done on return
+
+bool ParallelShaderCompile();
+	// true if the driver has GL_KHR (or ARB) _parallel_shader_compile; if so, compiler threads are
+	// set to maximum; if not, the driver may compile during submission or at Get
+
+// Library Programs
+struct LazyProgram {
+	// a program of Draw, Mesh, Sprite, Text or Letters: submitted by PrepareLibraryPrograms, else on first Get
+	const char *name, **codes[5];
+	ProgramFuture future;
+	bool prepare = true, submitted = false, got = false;
+	LazyProgram(const char *name, const char **vertexCode, const char **tessellationControlCode,
+				const char **tessellationEvalCode, const char **geometryCode, const char **pixelCode, bool prepare = true);
+		// if !prepare, PrepareLibraryPrograms skips the program (eg, one needing GL 4.x features)
+	void Submit();
+		// LinkProgramAsync, once
+	GLuint Get();
+		// submit if need be, wait for completion, return linked program (or 0 if failure)
+};
+
+void PrepareLibraryPrograms();
+	// submit every library program (of the modules linked into the app) to compile concurrently;
+	// call once the GL context is current, then do other initialization
+void SetStartupLog(bool log);
+	// if log, print when each library program is submitted and linked, and how long its first use waited
+
+// Miscellany
+int CurrentProgram();
+	// the library records the current program by wrapping glad's glUseProgram (and glDeleteProgram)
+	// on first use, rather than query GL; so glad should be loaded once, before any uniform is set
+void DeleteProgram(int program);
+
+// Binary Read/Write
+bool WriteProgramBinary(GLuint program, const char *filename);
+bool ReadProgramBinary(GLuint program, const char *filename);
+	// false if no file or the binary format is not supported by the driver
+	// if true, check GL_LINK_STATUS: a driver may still reject the binary
+GLuint ReadProgramBinary(const char *filename);
+
+// Program Cache
+void SetShaderCache(const char *directory);
+	// LinkProgramViaCode stores program binaries in directory, keyed by a hash of the shader sources
+	// and the GL vendor, renderer and version strings; a binary the driver rejects is deleted and
+	// the program compiled anew; default directory is GLXtras/ShaderCache in LOCALAPPDATA on Windows,
+	// else in XDG_CACHE_HOME or HOME/.cache (no cache if none is set); the directory is created
+	// private to the user, and the cache is disabled if it isn't (eg, owned by another user);
+	// NULL or "" disables the cache
+
+// Uniform Access
+void SetReport(bool report);
+	// if report, print any unknown uniforms or attributes
+bool SetUniform(int program, const char *name, bool val);
+bool SetUniform(int program, const char *name, int val);
+bool SetUniform(int program, const char *name, GLuint val);
+	// some compilers confused by int/GLuint distinction
+bool SetUniformv(int program, const char *name, int count, int *v);
+bool SetUniform(int program, const char *name, float val);
+bool SetUniformv(int program, const char *name, int count, float *v);
+bool SetUniform(int program, const char *name, vec2 v);
+bool SetUniform(int program, const char *name, vec3 v);
+bool SetUniform(int program, const char *name, vec4 v);
+bool SetUniform(int program, const char *name, vec3 *v);
+bool SetUniform(int program, const char *name, vec4 *v);
+bool SetUniform3(int program, const char *name, float *v);
+bool SetUniform3v(int program, const char *name, int count, float *v);
+bool SetUniform4v(int program, const char *name, int count, float *v);
+bool SetUniform(int program, const char *name, mat3 m);
+bool SetUniform(int program, const char *name, mat4 m);
+	// if no such named uniform and squawk, print error message
+	// locations are looked up in a per-program table (built at link) rather than with glGetUniformLocation
+	// an upload is skipped if the value equals the last value set via this API for the current program;
+	// as with glUniform, program should be current (else the value is neither skipped nor recorded)
+	// setting an array element (eg, "lights[2]") invalidates the array's value, and vice versa
+
+int UniformLocation(int program, const char *name);
+	// cached glGetUniformLocation; -1 if no such active uniform
+void InvalidateUniforms(int program);
+	// forget cached locations and values (eg after direct glUniform or glLinkProgram calls), forcing
+	// the next SetUniforms to upload; a program deleted with glDeleteProgram is forgotten then
+
+// Uniform Handles
+struct UniformHandle {
+	// name resolved once; re-resolved if the program is relinked via LinkProgram
+	int program = 0, slot = -1, generation = -1;
+	std::string name;
+	UniformHandle() { }
+	UniformHandle(int program, const char *name);
+	GLint Location();
+};
+
+bool SetUniform(UniformHandle &u, bool val);
+bool SetUniform(UniformHandle &u, int val);
+bool SetUniform(UniformHandle &u, float val);
+bool SetUniform(UniformHandle &u, vec2 v);
+bool SetUniform(UniformHandle &u, vec3 v);
+bool SetUniform(UniformHandle &u, vec4 v);
+bool SetUniform(UniformHandle &u, mat3 m);
+bool SetUniform(UniformHandle &u, mat4 m);
+	// upload only if changed; program must be current
+
+template<class T> struct Uniform : UniformHandle {
+	// typed handle, eg: Uniform<mat4> modelview(program, "modelview"); ... modelview = camera.modelview;
+	Uniform() { }
+	Uniform(int program, const char *name) : UniformHandle(program, name) { }
+	bool Set(T v) { return SetUniform(*this, v); }
+	Uniform &operator=(T v) { Set(v); return *this; }
+};
+
+// Attribute Access
+int EnableVertexAttribute(int program, const char *name);
+	// find named attribute and enable
+void DisableVertexAttribute(int program, const char *name);
+	// find named attribute and disable
+void VertexAttribPointer(int program, const char *name, GLint ncomponents, GLsizei stride, const GLvoid *offset);
+	// find and set named attribute, with given number of components, stride between entries, offset into array
+	// this calls glAttribPointer with type = GL_FLOAT and normalize = GL_FALSE
+
+#endif // GL_XTRAS_HDR
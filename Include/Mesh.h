@@ -1,194 +1,614 @@
-// Mesh.h - 3D mesh of triangles (c) 2019-2022 Jules Bloomenthal
-
-#ifndef MESH_HDR
-#define MESH_HDR
-
-#include <glad.h>
-#include <stdio.h>
-#include <vector>
-#include "CameraArcball.h"
-#include "Quaternion.h"
-#include "VecMat.h"
-
-using std::string;
-using std::vector;
-
-// Mesh Class and Operations
-
-GLuint GetMeshShader(bool lines = false);
-GLuint UseMeshShader(bool lines = false);
-	// lines true uses geometry shader to draw lines along triangle edges
-	// lines false is slightly more efficient
-
-class Frame {
-public:
-	Frame() { };
-	Frame(Quaternion q, vec3 p, float s) : orientation(q), position(p), scale(s) { };
-	Quaternion orientation;
-	vec3 position;
-	float scale = 1;
-};
-
-struct Group {
-	string name;
-	int startTriangle = 0, nTriangles = 0;
-	vec3 color = vec3(1, 1, 1);
-	Group(int start = 0, string n = "", vec3 c = vec3(1, 1, 1)) : startTriangle(start), name(n), color(c) { }
-};
-
-struct Mtl {
-	string name;
-	vec3 ka, kd, ks;
-	int startTriangle = 0, nTriangles = 0;
-	Mtl() {startTriangle = -1, nTriangles = 0; }
-	Mtl(int start, string n, vec3 a, vec3 d, vec3 s) : startTriangle(start), name(n), ka(a), kd(d), ks(s) { }
-};
-
-class Mesh {
-public:
-	Mesh() { };
-	Mesh(const char *filename) { Read(string(filename)); }
-	~Mesh() { glDeleteBuffers(1, &vBufferId); };
-	string objFilename, texFilename;
-	// vertices and facets
-	vector<vec3>	points;
-	vector<vec3>	normals;
-	vector<vec2>	uvs;
-	vector<int3>	triangles;
-	vector<int4>	quads;
-	// ancillary data
-	vector<Group>	triangleGroups;
-	vector<Mtl>		triangleMtls;
-	// position/orientation
-	mat4			transform;				// object to world space, set during drag
-	Frame			frameDown;				// reference frame on mouse down
-	// hierarchy
-	vector<Mesh *>	children;
-	// GPU vertex buffer and texture
-	GLuint			vao = 0;				// vertex array object
-	GLuint			vBufferId = 0;			// vertex buffer
-	GLuint			eBufferId = 0;			// element (triangle) buffer
-	GLuint			textureName = 0;
-	// operations
-	void Buffer();
-	void Buffer(vector<vec3> &pts, vector<vec3> *nrms = NULL, vector<vec2> *uvs = NULL);
-		// if non-null, nrms and uvs assumed same size as pts
-	void Set(vector<vec3> &pts, vector<vec3> *nrms = NULL, vector<vec2> *tex = NULL,
-			 vector<int> *tris = NULL, vector<int> *quas = NULL);
-			 // **** maybe we don't want this routine
-	void Display(CameraAB camera, int textureUnit = 0, bool lines = false, bool useGroupColor = false);
-		// texture is enabled if textureUnit >= 0 and textureName previously set
-		// before this call, app must optionally change uniforms from their default, including:
-		//     nLights, lights, color, opacity, ambient
-		//     useLight, useTint, fwdFacingOnly, facetedShading
-		//     outlineColor, outlineWidth, transition
-//	void Display(CameraAB camera, bool lines = false, int textureUnit = -1, bool useGroupColor = false);
-	bool Read(string objFile, mat4 *m = NULL, bool normalize = true, bool buffer = true);
-		// read in object file (with normals, uvs), initialize matrix, build vertex buffer
-	bool Read(string objFile, string texFile, mat4 *m = NULL, bool normalize = true, bool buffer = true);
-		// read in object file (with normals, uvs) and texture file, initialize matrix, build vertex buffer
-		// textureUnit must be > 0
-};
-
-class MeshFramer { // rename Articulater? derive from Widgets::Framer?
-public:
-	Mesh *mesh = NULL;
-	Arcball arcball;
-	MeshFramer() { }
-	void Set(Mesh *m, float radius, mat4 fullview);
-	void SetFramedown(Mesh *m);
-		// set m.qstart from m.transform and recurse on m.children
-	void RotateTransform(Mesh *m, Quaternion qrot, vec3 *center = NULL);
-		// apply qrot to qstart, optionally rotate base around center
-		// set m.transform, recurse on m.children
-	void TranslateTransform(Mesh *m, vec3 pDif);
-	bool Hit(int x, int y);
-	void Down(int x, int y, mat4 modelview, mat4 persp, bool control = false);
-	void Drag(int x, int y, mat4 modelview, mat4 persp);
-		// recursively apply to mesh.children
-	void Up();
-	void Wheel(double spin, bool shift);
-	void Draw(mat4 fullview);
-private:
-	bool moverPicked = false;
-	Mover mover;
-};
-
-// Read STL Format
-
-struct VertexSTL {
-	vec3 point, normal;
-	VertexSTL() { }
-	VertexSTL(float *p, float *n) : point(vec3(p[0], p[1], p[2])), normal(vec3(n[0], n[1], n[2])) { }
-};
-
-int ReadSTL(const char *filename, vector<VertexSTL> &vertices);
-	// read vertices from file, three per triangle; return # triangles
-
-// Read OBJ Format
-
-bool ReadAsciiObj(const char    *filename,                  // must be ASCII file
-				  vector<vec3>  &points,                    // unique set of points determined by vertex/normal/uv triplets in file
-				  vector<int3>  &triangles,                 // array of triangle vertex ids
-				  vector<vec3>  *normals  = NULL,           // if non-null, read normals from file, correspond with points
-				  vector<vec2>  *textures = NULL,           // if non-null, read uvs from file, correspond with points
-				  vector<Group> *triangleGroups = NULL,     // correspond with triangle groups
-				  vector<Mtl>   *triangleMtls = NULL,		// correspond with triangle groups
-				  vector<int4>  *quads = NULL,              // optional quadrilaterals
-				  vector<int2>  *segs = NULL);				// optional line segments
-	// set points and triangles; normals, textures, quads optional
-	// return true if successful
-
-bool WriteAsciiObj(const char      *filename,
-				   vector<vec3>    &points,
-				   vector<vec3>    &normals,
-				   vector<vec2>    &uvs,
-				   vector<int3>    *triangles = NULL,
-				   vector<int4>    *quads = NULL,
-				   vector<int2>    *segs = NULL,
-				   vector<Group>   *triangleGroups = NULL);
-	// write to file mesh points, normals, and uvs
-	// optionally write triangles and/or quadrilaterals
-
-// Bounding Box
-
-void MinMax(vec2 *points, int npoints, vec2 &min, vec2 &max);
-
-void MinMax(vec3 *points, int npoints, vec3 &min, vec3 &max);
-
-mat4 NormalizeMat(vec3 *points, int npoints, float scale = 1);
-
-void Normalize(vec3 *points, int npoints, float scale = 1);
-	// translate and apply uniform scale so that vertices fit in -scale,+scale in X,Y,Z
-
-void Normalize(vector<vec3> &points, float scale = 1);
-
-void Normalize(vector<VertexSTL> &vertices, float scale = 1);
-
-// Normals
-
-void SetVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals);
-	// compute/recompute vertex normals as the average of surrounding triangle normals
-
-// Intersections
-
-bool IsInside(const vec2 &p, vector<vec2> &pts);
-
-bool IsInside(const vec2 &p, const vec2 &a, const vec2 &b, const vec2 &c);
-
-struct TriInfo {
-	vec4 plane;
-	int majorPlane = 0; // 0: XY, 1: XZ, 2: YZ
-	vec2 p1, p2, p3;    // vertices projected to majorPlane
-	TriInfo() { };
-	TriInfo(vec3 p1, vec3 p2, vec3 p3);
-};
-
-void BuildTriInfos(vector<vec3> &points, vector<int3> &triangles, vector<TriInfo> &triInfos);
-	// for interactive selection
-
-int IntersectWithLine(vec3 p1, vec3 p2, vector<TriInfo> &triInfos, float &alpha);
-	// return triangle index of nearest intersected triangle, or -1 if none
-	// intersection = p1+alpha*(p2-p1)
-
-#endif
+// Mesh.h - 3D mesh of triangles (c) 2019-2022 Jules Bloomenthal
+
+#ifndef MESH_HDR
+#define MESH_HDR
+
+#include <glad.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "CameraArcball.h"
+#include "Quaternion.h"
+#include "VecMat.h"
+
+using std::string;
+using std::vector;
+
+// Mesh Class and Operations
+
+GLuint GetMeshShader(bool lines = false);
+GLuint UseMeshShader(bool lines = false);
+	// lines true uses geometry shader to draw lines along triangle edges
+	// lines false is slightly more efficient
+
+class Frame {
+public:
+	Frame() { };
+	Frame(Quaternion q, vec3 p, float s) : orientation(q), position(p), scale(s) { };
+	Quaternion orientation;
+	vec3 position;
+	float scale = 1;
+};
+
+struct Group {
+	string name;
+	int startTriangle = 0, nTriangles = 0;
+	vec3 color = vec3(1, 1, 1);
+	Group(int start = 0, string n = "", vec3 c = vec3(1, 1, 1)) : startTriangle(start), name(n), color(c) { }
+};
+
+struct Mtl {
+	string name;
+	vec3 ka, kd, ks;
+	int startTriangle = 0, nTriangles = 0;
+	Mtl() {startTriangle = -1, nTriangles = 0; }
+	Mtl(int start, string n, vec3 a, vec3 d, vec3 s) : startTriangle(start), name(n), ka(a), kd(d), ks(s) { }
+};
+
+enum VertexFormat {
+	FloatPlanar,		// point, normal, uv as separate float arrays (32 bytes/vertex)
+	PackedInterleaved,	// interleaved float point, octahedral normal, 16-bit uv (20 bytes/vertex)
+	PackedQuantized		// as PackedInterleaved, but point quantized to 16 bits/coordinate (16 bytes/vertex)
+};
+
+struct Meshlet {
+	int				startTriangle = 0;		// meshlet triangles are contiguous
+	int				nTriangles = 0;
+	int				nVertices = 0;			// # distinct vertices
+	vec3			center;
+	float			radius = 0;				// bounding sphere
+	vec3			coneAxis;
+	float			coneCutoff = 1;			// sine of normal cone half-angle, 1 if cone cannot cull
+};
+
+struct TriInfo {
+	vec4 plane;
+	int majorPlane = 0; // 0: XY, 1: XZ, 2: YZ
+	vec2 p1, p2, p3;    // vertices projected to majorPlane
+	TriInfo() { };
+	TriInfo(vec3 p1, vec3 p2, vec3 p3);
+};
+
+struct BVHNode {
+	vec3 min, max;				// bounds of the node's triangles
+	int start = 0, count = 0;	// leaf if count > 0: triangles BVH::order[start] .. order[start+count-1]
+								// else left child is next node, right child is nodes[start]
+};
+
+class BVH {
+	// hierarchy of triangle bounds built with the surface area heuristic, for picking
+public:
+	static const int MaxDepth = 60;
+	vector<BVHNode> nodes;		// depth-first, nodes[0] is root
+	vector<int> order;			// triangle indices, grouped by leaf
+	void Build(vector<vec3> &points, vector<int3> &triangles, int maxLeafSize = 4);
+	void Refit(vector<vec3> &points, vector<int3> &triangles);
+		// update bounds after points move (triangles unchanged); triInfos must also be rebuilt
+};
+
+struct MeshLOD {
+	vector<int3>	triangles;				// simplified, indexing Mesh::points
+	vector<Group>	triangleGroups;
+	vector<Mtl>		triangleMtls;
+	float			error = 0;				// estimated object space distance from full mesh
+	int				eOffset = 0;			// offset (in triangles) within element buffer
+};
+
+class Mesh {
+public:
+	Mesh() { };
+	Mesh(const char *filename) { Read(string(filename)); }
+	~Mesh() {
+		// no GL calls for a mesh never buffered (eg, one only simplified, perhaps without a context)
+		GLuint buffers[] = {vBufferId, eBufferId, iBufferId};
+		if (vBufferId || eBufferId || iBufferId)
+			glDeleteBuffers(3, buffers);
+		if (vao)
+			glDeleteVertexArrays(1, &vao);
+	};
+	string objFilename, texFilename;
+	// vertices and facets
+	vector<vec3>	points;
+	vector<vec3>	normals;
+	vector<vec2>	uvs;
+	vector<int3>	triangles;
+	vector<int4>	quads;
+	// ancillary data
+	vector<Group>	triangleGroups;
+	vector<Mtl>		triangleMtls;
+	vector<int>	   *visibleGroups = NULL;	// if non-null, Display draws only these groups, ascending (see Cull.h)
+											// also applied to the selected LOD, and to meshlets
+	// position/orientation
+	mat4			transform;				// object to world space, set during drag
+	mat4			InverseTransform() { return inverseCache.Get(transform, InvertAffine); }
+		// world to object space, recomputed only when transform changes
+	Frame			frameDown;				// reference frame on mouse down
+	// hierarchy
+	vector<Mesh *>	children;
+	// GPU vertex buffer and texture
+	GLuint			vao = 0;				// vertex array object
+	GLuint			vBufferId = 0;			// vertex buffer
+	GLuint			eBufferId = 0;			// element (triangle) buffer
+	GLuint			textureName = 0;
+	// instances
+	GLuint			iBufferId = 0;			// per-instance transform and color, see SetInstances
+	int				nInstances = 0;
+	bool			instanceColors = false;
+	// level of detail
+	vector<MeshLOD>	lods;					// coarser triangle sets, sharing points; see BuildLODs
+	float			lodPixelError = 1;		// Display uses the coarsest LOD whose error projects within this
+	vec3			lodCenter;
+	float			lodRadius = 0;			// bounds used to project LOD error
+	// clusters
+	vector<Meshlet>	meshlets;				// if any, Display culls them (full resolution only)
+	bool			cullBackfacing = false;	// if true, also cull meshlets by normal cone
+	// picking
+	vector<TriInfo>	triInfos;				// built, with bvh, by first IntersectWithLine
+	BVH				bvh;
+	// vertex format
+	VertexFormat	vertexFormat = FloatPlanar;
+	mat4			dequantize;				// set by Buffer if vertexFormat is PackedQuantized
+	// cached inverses
+	MatrixCache<mat4> inverseCache;			// of transform
+	MatrixCache<mat3> normalMatrixCache;	// of camera modelview*transform, set by Display
+	// operations
+	void Buffer();
+	void Buffer(vector<vec3> &pts, vector<vec3> *nrms = NULL, vector<vec2> *uvs = NULL);
+		// if non-null, nrms and uvs assumed same size as pts
+		// upload in vertexFormat (set before Read or Buffer)
+	void Set(vector<vec3> &pts, vector<vec3> *nrms = NULL, vector<vec2> *tex = NULL,
+			 vector<int> *tris = NULL, vector<int> *quas = NULL);
+			 // **** maybe we don't want this routine
+			 // if tris non-null, LODs and meshlets are discarded
+	void Display(CameraAB camera, int textureUnit = 0, bool lines = false, bool useGroupColor = false);
+		// texture is enabled if textureUnit >= 0 and textureName previously set
+		// before this call, app must optionally change uniforms from their default, including:
+		//     nLights, lights, color, opacity, ambient
+		//     useLight, useTint, fwdFacingOnly, facetedShading
+		//     outlineColor, outlineWidth, transition
+//	void Display(CameraAB camera, bool lines = false, int textureUnit = -1, bool useGroupColor = false);
+	void SetInstances(vector<mat4> &transforms, vector<vec3> *colors = NULL);
+		// upload per-instance transforms (applied before transform) and optional colors (else
+		// the color uniform is used); call after Buffer, and again when instances change (a later
+		// Buffer keeps them)
+	void DisplayInstanced(CameraAB camera, int textureUnit = 0, bool lines = false);
+		// draw nInstances copies of triangles, or of the LOD Display would select, in one call;
+		// meshlets are not culled; texture and uniforms as for Display
+	bool useCache = true;					// if true, Read uses/updates binary cache (see MeshCacheName)
+	bool Read(string objFile, mat4 *m = NULL, bool normalize = true, bool buffer = true);
+		// read in object file (with normals, uvs), initialize matrix, build vertex buffer
+		// if useCache, first try binary cache; if missing or stale, read object file and write cache
+		// LODs, meshlets and picking data of a prior mesh are discarded
+	bool Read(string objFile, string texFile, mat4 *m = NULL, bool normalize = true, bool buffer = true);
+		// read in object file (with normals, uvs) and texture file, initialize matrix, build vertex buffer
+		// textureUnit must be > 0
+	void BuildLODs(vector<float> ratios = {.5f, .25f, .125f, .0625f});
+		// successively simplify triangles (see SimplifyMesh) to each ratio; buffer if vao exists
+		// limit: collapses are half-edge, with every border and uv/normal seam vertex locked, so a mesh
+		// with many seams stops early and its coarse levels lose shape: Head.obj (4042 triangles) is at
+		// 9% of its diagonal by 1/8 and stops at 376 triangles, little help for many distant heads
+	int SelectLOD(CameraAB &camera, int viewportHeight);
+		// return index of coarsest LOD with projected error within lodPixelError, or -1 if none
+		// (full resolution); Display draws the selected LOD
+	int BuildMeshlets(int maxVertices = 64, int maxTriangles = 124);
+		// partition triangles into meshlets, reordering them in place within each group and material
+		// range (so ranges, points and LODs are unchanged); clears picking, and a VertexAdjacency
+		// built before is no longer Valid; buffer if vao exists
+	int IntersectWithLine(vec3 p1, vec3 p2, float &alpha);
+		// return index of nearest triangle intersected by world space line p1p2, or -1 if none
+		// intersection = p1+alpha*(p2-p1); uses bvh and InverseTransform, so a moved mesh needs
+		// no rebuild; call ClearPicking after changing points or triangles
+	void ClearPicking();
+		// free triInfos and bvh (rebuilt on next IntersectWithLine)
+private:
+	void BufferElements();
+	void EnableInstances();
+	void BufferPacked(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *uvs);
+};
+
+// Scene Graph
+
+struct SceneNode {
+	int				parent = -1;			// index of parent node, -1 if root
+	int				nDescendants = 0;		// subtree of node i is nodes [i, i+nDescendants]
+	mat4			local;					// node to parent space
+	vec3			min, max;				// object space bounds of node's own geometry, 0 (both) if none
+	Mesh		   *mesh = NULL;			// if non-null, Update sets mesh->transform to world
+	SceneNode(int parent = -1, mat4 local = mat4(), vec3 min = vec3(), vec3 max = vec3(), Mesh *mesh = NULL)
+		: parent(parent), local(local), min(min), max(max), mesh(mesh) { }
+};
+
+class SceneGraph {
+	// nodes in preorder, so each subtree is contiguous and parents precede children
+	// changed nodes are queued, and Update recomputes only their subtrees (and ancestor bounds)
+public:
+	vector<SceneNode>	nodes;
+	vector<mat4>		world;				// node to world, per node: the renderer's transform array
+	vector<vec3>		worldMin, worldMax;	// world space bounds of each node's subtree (min > max if no geometry)
+	int Add(int parent, mat4 local, vec3 min = vec3(), vec3 max = vec3(), Mesh *mesh = NULL);
+		// insert node as parent's last child (or as last root, if parent < 0); return node index
+		// appending (parent is the last node or an ancestor of it) is O(1), else O(# nodes)
+	int Add(Mesh *mesh, int parent = -1);
+		// add mesh and, recursively, its children; local set so world equals current mesh->transform
+	int Find(Mesh *mesh);
+		// return index of node for mesh, or -1; O(1) if the same as the prior Find, else O(# nodes)
+	void SetLocal(int node, mat4 m);
+	void SetWorld(int node, mat4 m);
+		// set local transform so node's world transform is m (uses current parent world)
+	int Update();
+		// recompute world transforms and bounds of changed subtrees; return # nodes recomputed
+private:
+	vector<int>			changed;			// queued nodes, each marked in dirty
+	vector<char>		dirty;
+	int					findHint = 0;		// result of prior Find
+	int AddMesh(Mesh *mesh, int parent, mat4 parentWorld);
+	bool AncestorDirty(int node);
+	void SubtreeBounds(int node);
+};
+
+class MeshFramer { // rename Articulater? derive from Widgets::Framer?
+public:
+	Mesh *mesh = NULL;
+	SceneGraph *scene = NULL;				// if set and has mesh, drag moves mesh's node, children follow
+	Arcball arcball;
+	MeshFramer() { }
+	void Set(Mesh *m, float radius, mat4 fullview);
+	void SetFramedown(Mesh *m);
+		// set m.qstart from m.transform and recurse on m.children
+	void RotateTransform(Mesh *m, Quaternion qrot, vec3 *center = NULL);
+		// apply qrot to qstart, optionally rotate base around center
+		// set m.transform, recurse on m.children
+	void TranslateTransform(Mesh *m, vec3 pDif);
+	bool Hit(int x, int y);
+	bool Hit(int x, int y, mat4 modelview, mat4 persp);
+		// as above, or true if the line through mouse (x, y) intersects mesh (see Mesh::IntersectWithLine)
+	void Down(int x, int y, mat4 modelview, mat4 persp, bool control = false);
+	void Drag(int x, int y, mat4 modelview, mat4 persp);
+		// recursively apply to mesh.children
+	void Up();
+	void Wheel(double spin, bool shift);
+	void Draw(mat4 fullview);
+private:
+	bool moverPicked = false;
+	Mover mover;
+};
+
+// Vertex Compression
+
+unsigned int OctEncode(vec3 n);
+	// octahedral encoding of unit normal as two 16-bit snorms (x in low half), error < .0001 radian
+
+vec3 OctDecode(unsigned int e);
+
+unsigned short FloatToHalf(float f);
+	// IEEE half precision, rounded to nearest even
+
+float HalfToFloat(unsigned short h);
+
+struct PackedVertices {
+	vector<char> data;			// interleaved vertices
+	int stride = 0;				// bytes per vertex
+	int normalOffset = -1;		// byte offset in vertex of normal, or -1 if none
+	int uvOffset = -1;			// byte offset of uv, or -1 if none
+	bool uvHalf = false;		// uvs as half floats if any outside [0,1], else 16-bit unorm
+	bool quantized = false;		// point as three 16-bit unorms (and pad), else 3 floats
+	mat4 dequantize;			// maps unorm point [0,1]^3 to object space
+};
+
+void PackVertices(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *uvs, bool quantize, PackedVertices &pv);
+	// layout used by Mesh::Buffer for the Packed vertex formats
+
+// Vertex Welding
+
+class VidMap {
+	// open-addressing (linear probe) hash table from int3 key (eg, OBJ vid/tid/nid triplet)
+	// to mesh vertex id; entries are stored in one flat array, so inserts do not allocate
+	// unless the table grows; used by the OBJ readers and WeldSTL
+public:
+	VidMap(int expectedKeys = 0) { Reserve(expectedKeys); }
+	void Reserve(int nKeys) {
+		// size table so nKeys fit below the maximum load factor
+		size_t capacity = 1024;
+		while (capacity*MaxLoad < (size_t) nKeys)
+			capacity *= 2;
+		if (capacity > entries.size())
+			Rehash(capacity);
+	}
+	int Find(const int3 &key) const {
+		// return value for key, or -1 if not found
+		for (size_t i = Hash(key)&mask;; i = (i+1)&mask) {
+			const Entry &e = entries[i];
+			if (e.value < 0)
+				return -1;
+			if (e.key.i1 == key.i1 && e.key.i2 == key.i2 && e.key.i3 == key.i3)
+				return e.value;
+		}
+	}
+	int FindOrAdd(const int3 &key, int value) {
+		// return existing value for key, or add key with value and return -1
+		// value must be non-negative
+		if ((size_t) nKeys+1 > (size_t) (MaxLoad*entries.size()))
+			Rehash(2*entries.size());
+		for (size_t i = Hash(key)&mask;; i = (i+1)&mask) {
+			Entry &e = entries[i];
+			if (e.value < 0) {
+				e.key = key;
+				e.value = value;
+				nKeys++;
+				return -1;
+			}
+			if (e.key.i1 == key.i1 && e.key.i2 == key.i2 && e.key.i3 == key.i3)
+				return e.value;
+		}
+	}
+	int Size() const { return nKeys; }
+	static size_t Hash(const int3 &k) {
+		unsigned int h = (unsigned int) k.i1*0x9E3779B1u ^ (unsigned int) k.i2*0x85EBCA77u ^ (unsigned int) k.i3*0xC2B2AE3Du;
+		h ^= h >> 16;
+		h *= 0x7FEB352Du;
+		h ^= h >> 15;
+		return h;
+	}
+private:
+	struct Entry { int3 key; int value = -1; };	// value -1 marks empty slot
+	static constexpr float MaxLoad = .7f;
+	vector<Entry> entries;
+	size_t mask = 0;
+	int nKeys = 0;
+	void Rehash(size_t capacity) {
+		vector<Entry> old(capacity);
+		old.swap(entries);
+		mask = capacity-1;
+		nKeys = 0;
+		for (size_t i = 0; i < old.size(); i++)
+			if (old[i].value >= 0)
+				FindOrAdd(old[i].key, old[i].value);
+	}
+};
+
+// Read STL Format
+
+struct VertexSTL {
+	vec3 point, normal;
+	VertexSTL() { }
+	VertexSTL(float *p, float *n) : point(vec3(p[0], p[1], p[2])), normal(vec3(n[0], n[1], n[2])) { }
+};
+
+int ReadSTL(const char *filename, vector<VertexSTL> &vertices);
+	// read vertices from binary or ASCII file, three per triangle; return # triangles
+	// triangles are ordered to agree with their facet normal
+
+int ReadSTL(const char *filename, vector<vec3> &points, vector<int3> &triangles, vector<vec3> *normals = NULL);
+	// as above, but weld corners with identical position into points, indexed by triangles
+	// if non-null, set normals to vertex normals (see SetVertexNormals); return # triangles
+
+void WeldSTL(vector<VertexSTL> &vertices, vector<vec3> &points, vector<int3> &triangles,
+			 float epsilon = 0, vector<vec3> *normals = NULL, float creaseAngle = 180);
+	// convert triangle soup (three vertices per triangle) to unique points indexed by triangles
+	// corners within epsilon of an earlier corner merge with it (epsilon 0: identical positions)
+	// triangles whose corners merge are removed
+	// if non-null, set normals with SetCreaseNormals
+
+// Read OBJ Format
+
+bool ReadAsciiObj(const char    *filename,                  // must be ASCII file
+				  vector<vec3>  &points,                    // unique set of points determined by vertex/normal/uv triplets in file
+				  vector<int3>  &triangles,                 // array of triangle vertex ids
+				  vector<vec3>  *normals  = NULL,           // if non-null, read normals from file, correspond with points
+				  vector<vec2>  *textures = NULL,           // if non-null, read uvs from file, correspond with points
+				  vector<Group> *triangleGroups = NULL,     // correspond with triangle groups
+				  vector<Mtl>   *triangleMtls = NULL,		// correspond with triangle groups
+				  vector<int4>  *quads = NULL,              // optional quadrilaterals
+				  vector<int2>  *segs = NULL);				// optional line segments
+	// set points and triangles; normals, textures, quads optional
+	// return true if successful
+
+bool ReadAsciiObjParallel(const char    *filename,
+						  vector<vec3>  &points,
+						  vector<int3>  &triangles,
+						  vector<vec3>  *normals  = NULL,
+						  vector<vec2>  *textures = NULL,
+						  vector<Group> *triangleGroups = NULL,
+						  vector<Mtl>   *triangleMtls = NULL,
+						  vector<int4>  *quads = NULL,
+						  vector<int2>  *segs = NULL,
+						  string        *mtlLib = NULL);			// if non-null, set to material library file read (or empty)
+	// as ReadAsciiObj, with same results, but file is memory-mapped and parsed by multiple threads
+	// used by Mesh::Read
+
+bool WriteAsciiObj(const char      *filename,
+				   vector<vec3>    &points,
+				   vector<vec3>    &normals,
+				   vector<vec2>    &uvs,
+				   vector<int3>    *triangles = NULL,
+				   vector<int4>    *quads = NULL,
+				   vector<int2>    *segs = NULL,
+				   vector<Group>   *triangleGroups = NULL);
+	// write to file mesh points, normals, and uvs
+	// optionally write triangles and/or quadrilaterals
+
+// Binary Mesh Cache
+
+string MeshCacheName(string objFile);
+	// cache file written next to object file (objFile+".cache")
+
+bool WriteMeshCache(const char    *filename,
+					time_t         sourceModified,			// FileModified of source (object) file
+					bool           normalized,				// true if points normalized
+					vector<vec3>  &points,
+					vector<int3>  &triangles,
+					vector<vec3>  *normals = NULL,
+					vector<vec2>  *uvs = NULL,
+					vector<Group> *triangleGroups = NULL,
+					vector<Mtl>   *triangleMtls = NULL,
+					vector<int4>  *quads = NULL,
+					const char    *mtlLib = NULL);			// material library, if any, checked by ReadMeshCache
+	// write header followed by aligned point, normal, uv, triangle, quad, group, material arrays
+	// the file is written under a temporary name, then renamed, so a reader never sees it partial
+	// return true if successful
+
+bool ReadMeshCache(const char    *filename,
+				   time_t         sourceModified,
+				   bool           normalized,
+				   vector<vec3>  &points,
+				   vector<int3>  &triangles,
+				   vector<vec3>  *normals = NULL,
+				   vector<vec2>  *uvs = NULL,
+				   vector<Group> *triangleGroups = NULL,
+				   vector<Mtl>   *triangleMtls = NULL,
+				   vector<int4>  *quads = NULL);
+	// memory-map cache and copy arrays without parsing
+	// return false if no cache, cache stale (sourceModified, normalized, or modification time of
+	// the material library differ from header), or cache malformed (counts and offsets disagree)
+
+// Bounding Box
+
+void MinMax(vec2 *points, int npoints, vec2 &min, vec2 &max);
+
+void MinMax(vec3 *points, int npoints, vec3 &min, vec3 &max);
+
+void TransformBox(mat4 &m, vec3 min, vec3 max, vec3 &tMin, vec3 &tMax);
+	// bounds of the box min/max transformed by m
+
+mat4 NDCfromMinMax(vec3 min, vec3 max, float scale = 1);
+	// matrix to transform min/max to -scale/+scale (uniformly)
+
+mat4 NormalizeMat(vec3 *points, int npoints, float scale = 1);
+
+void Normalize(vec3 *points, int npoints, float scale = 1);
+	// translate and apply uniform scale so that vertices fit in -scale,+scale in X,Y,Z
+	// for large or repeated work see PointSet.h
+
+void Normalize(vector<vec3> &points, float scale = 1);
+
+void Normalize(vector<VertexSTL> &vertices, float scale = 1);
+
+// Normals
+
+void SetVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals);
+	// compute/recompute vertex normals as the average of surrounding triangle normals
+
+enum NormalWeight { AreaWeight, AngleWeight };
+	// contribution of a triangle to a vertex normal: proportional to its area, or to its angle at the vertex
+
+struct VertexAdjacency {
+	// corners (3*triangle+k) about vertex v are corners[start[v]] .. corners[start[v+1]-1]
+	vector<int> start, corners;
+	vector<vec3> faceNormals;				// per triangle, retained for UpdateVertexNormals
+	vector<vec3> cornerAngles;				// per triangle, if weight is AngleWeight
+	NormalWeight weight = AreaWeight;		// weighting of faceNormals
+	unsigned long long checksum = 0;		// of triangles, set by Build
+	void Build(int nPoints, vector<int3> &triangles);
+	bool Valid(int nPoints, vector<int3> &triangles);
+		// true if built for nPoints and for triangles in their current order; the checksum catches
+		// triangles reordered in place (eg, by OptimizeMesh or BuildMeshlets); O(# triangles)
+};
+
+void SetVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals,
+					  VertexAdjacency &adjacency, NormalWeight weight = AreaWeight);
+	// as above, in parallel; adjacency is built if not valid for points and triangles, and may be
+	// reused as points move (eg, per frame deformation)
+
+void UpdateVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals,
+						 VertexAdjacency &adjacency, vector<int> &changedTriangles, NormalWeight weight = AreaWeight);
+	// recompute normals only for vertices of changedTriangles (those with a moved vertex)
+	// adjacency must be from a prior SetVertexNormals call with the same weight, else all normals are set
+
+void SetCreaseNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals,
+					  float creaseAngle, NormalWeight weight = AreaWeight, vector<vec2> *uvs = NULL);
+	// as SetVertexNormals, but faces meeting at more than creaseAngle (degrees) do not share normals:
+	// points are duplicated and triangles re-indexed so each corner's point has its own normal
+	// the point array is rebuilt: any per-point uvs must be passed to be split alongside the points
+	// (other per-point data is invalidated); unreferenced points are kept, with zero normals
+
+// Vertex Cache Optimization
+
+float ACMR(vector<int3> &triangles, int nPoints, int cacheSize = 16);
+	// average cache miss ratio: vertices transformed per triangle with a FIFO post-transform cache
+
+float ATVR(vector<int3> &triangles, int nPoints, int cacheSize = 16);
+	// average transform to vertex ratio: vertices transformed per vertex referenced (1 is optimal)
+
+void OptimizeVertexCache(vector<int3> &triangles, int nPoints, vector<Group> *groups = NULL, vector<Mtl> *mtls = NULL, int cacheSize = 16);
+	// reorder triangles for post-transform cache locality (Tipsify); triangles are reordered only
+	// within ranges not straddled by a group or material, so their start/count remain valid
+
+void OptimizeOverdraw(vector<int3> &triangles, vector<vec3> &points, vector<Group> *groups = NULL, vector<Mtl> *mtls = NULL,
+					  int cacheSize = 16, float threshold = 1.05f);
+	// after OptimizeVertexCache, reorder clusters of triangles so outward facing clusters are first;
+	// threshold bounds the increase in ACMR
+
+void OptimizeVertexFetch(vector<vec3> &points, vector<int3> &triangles, vector<vec3> *normals = NULL, vector<vec2> *uvs = NULL,
+						 vector<int4> *quads = NULL);
+	// renumber vertices in order of first use, reordering points, normals, uvs (if same size as points)
+
+void OptimizeMesh(vector<vec3> &points, vector<int3> &triangles, vector<vec3> *normals = NULL, vector<vec2> *uvs = NULL,
+				  vector<int4> *quads = NULL, vector<Group> *groups = NULL, vector<Mtl> *mtls = NULL,
+				  bool overdraw = true, int cacheSize = 16);
+	// apply the above; deterministic (no threads, no hashing), so suitable for offline processing
+	// a group or material range keeps its input order unless reordering lowers its ACMR
+
+// Simplification
+
+int SimplifyMesh(vector<vec3> &points, vector<int3> &triangles, int targetTriangles,
+				 vector<Group> *groups = NULL, vector<Mtl> *mtls = NULL, float *error = NULL);
+	// reduce triangles toward targetTriangles by quadric error edge collapse; return # triangles
+	// collapses move a vertex onto a neighbor, so points, normals and uvs are unchanged (unused
+	// points remain); vertices on borders, uv or normal seams and group/material boundaries are
+	// fixed; group/material ranges are updated; if non-null, error set to max collapse error
+
+// Meshlets
+
+int BuildMeshlets(vector<vec3> &points, vector<int3> &triangles, vector<Meshlet> &meshlets,
+				  vector<Group> *groups = NULL, vector<Mtl> *mtls = NULL, int maxVertices = 64, int maxTriangles = 124);
+	// reorder triangles in place into spatially compact clusters of at most maxVertices and maxTriangles,
+	// each within one group and material range (groups and mtls are read, not changed); set bounding
+	// sphere and normal cone; return # meshlets; data indexed by triangle must be rebuilt
+
+int CullMeshlets(vector<Meshlet> &meshlets, mat4 modelview, mat4 persp, vector<GLsizei> &counts, vector<size_t> &offsets,
+				 bool backface = true, int eOffset = 0);
+	// cull meshlets outside frustum and, if backface, facing away; return # visible
+	// set index counts and byte offsets of visible ranges (adjacent meshlets merged) for
+	// glMultiDrawElements; eOffset is the triangle offset of the meshlets within the element buffer
+
+// Intersections
+
+bool IsInside(const vec2 &p, vector<vec2> &pts);
+
+bool IsInside(const vec2 &p, const vec2 &a, const vec2 &b, const vec2 &c);
+
+void BuildTriInfos(vector<vec3> &points, vector<int3> &triangles, vector<TriInfo> &triInfos);
+	// for interactive selection
+
+int IntersectWithLine(vec3 p1, vec3 p2, vector<TriInfo> &triInfos, float &alpha);
+	// return triangle index of nearest intersected triangle, or -1 if none
+	// intersection = p1+alpha*(p2-p1)
+
+// Bounding Volume Hierarchy
+
+void BuildTriInfos(vector<vec3> &points, vector<int3> &triangles, vector<TriInfo> &triInfos, BVH &bvh);
+	// as above, and build bvh
+
+int IntersectWithLine(vec3 p1, vec3 p2, vector<TriInfo> &triInfos, BVH &bvh, float &alpha, mat4 *inverse = NULL);
+	// as above, but test only triangles in bvh nodes crossed by the line
+	// if non-null, inverse (eg, Mesh::InverseTransform()) maps world space, in which p1, p2 are
+	// given, to the space of triInfos; so a moved mesh needs no rebuild or refit
+
+// SIMD Intersection
+
+struct TriangleSoA {
+	// triangle vertex and two edges, as structure of arrays padded to a multiple of 8
+	vector<float> v0x, v0y, v0z, e1x, e1y, e1z, e2x, e2y, e2z;
+	int count = 0;
+};
+
+void BuildTriangleSoA(vector<vec3> &points, vector<int3> &triangles, TriangleSoA &soa);
+
+int IntersectWithLine(vec3 p1, vec3 p2, TriangleSoA &soa, float &alpha);
+	// as IntersectWithLine above (same result within floating-point precision) using the
+	// Moller-Trumbore test on FloatBatch::n triangles at a time (8 with AVX, 4 with SSE or NEON, else 1)
+
+void IntersectWithLines(int nLines, vec3 *p1s, vec3 *p2s, TriangleSoA &soa, int *picked, float *alphas);
+	// as above for each line (eg, from ScreenLine for a set of pixels), lines tested in packets of FloatBatch::n
+
+#endif
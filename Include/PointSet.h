@@ -0,0 +1,55 @@
+// PointSet.h - structure-of-arrays point cloud: bounds, normalize, transform (c) 2019-2022 Jules Bloomenthal
+
+#ifndef POINTSET_HDR
+#define POINTSET_HDR
+
+#include <vector>
+#include "VecMat.h"
+
+using std::vector;
+
+// PointSet
+
+class PointSet {
+	// points as separate x, y, z arrays, each 32-byte aligned, or a view of an existing vec3 array;
+	// operations use SIMD batches (VecMat.h) and, for large sets, ParallelFor (Misc.h)
+public:
+	float *x = NULL, *y = NULL, *z = NULL;
+	int count = 0;
+	int stride = 1;					// floats between successive x: 1 if owned, 3 if a view of vec3s
+	PointSet() { }
+	PointSet(int n) { Resize(n); }
+	PointSet(vec3 *points, int n) { View(points, n); }
+	PointSet(vector<vec3> &points) { View(points); }
+	PointSet(const PointSet &) = delete;
+	PointSet &operator = (const PointSet &) = delete;
+	// storage
+	void Resize(int n);
+		// own n points (values undefined); ends any view
+	void Set(const vec3 *points, int n);
+	void Set(vector<vec3> &points);
+		// copy points into owned arrays
+	void Get(vec3 *points);
+	void Get(vector<vec3> &points);
+		// copy points out (vector resized to count)
+	void View(vec3 *points, int n);
+	void View(vector<vec3> &points);
+		// operate in place on the caller's array, without copying (eg, PointSet(mesh.points).Normalize())
+		// valid while the array is not reallocated
+	bool IsView() { return stride != 1; }
+	vec3 Point(int i) { return vec3(x[i*stride], y[i*stride], z[i*stride]); }
+	// operations
+	void MinMax(vec3 &min, vec3 &max);
+		// same values as the scalar loop: FLT_MAX, -FLT_MAX if empty, NaN coordinates ignored
+	mat4 NormalizeMat(float scale = 1);
+		// NDCfromMinMax (Mesh.h) of the bounds
+	void Normalize(float scale = 1);
+		// translate and apply uniform scale so points fit in -scale,+scale in X,Y,Z
+		// one bounds pass, then one multiply-add per coordinate; same result as m*vec4(p) with m = NormalizeMat
+	void Transform(const mat4 &m);
+		// set each point to x, y, z of m*vec4(point, 1)
+private:
+	vector<float> storage;
+};
+
+#endif
@@ -1,35 +1,101 @@
-// Quaternion.h - quaternion operations.
-// (c) 2019-2022 Ken Shoemake and Jules Bloomenthal
-
-#ifndef QUATERNION_HDR
-#define QUATERNION_HDR
-
-#include "VecMat.h"
-
-class Quaternion {
-public:
-	float x = 0, y = 0, z = 0, w = 0;
-	Quaternion() { };
-	Quaternion(vec3 axis, float radAng);
-	Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) { };
-	Quaternion(mat3 &rot); // presumes rot is pure rotation matrix (no scale)
-	Quaternion(mat4 m);
-	Quaternion(const Quaternion &a) { x = a.x; y = a.y; z = a.z; w = a.w; }
-	Quaternion& operator = (const Quaternion &a) { x = a.x; y = a.y; z = a.z; w = a.w; return *this; }
-	Quaternion operator + (const Quaternion &q) const { return Quaternion(x+q.x, y+q.y, z+q.z, w+q.w); }
-	Quaternion operator * (float s) const { return Quaternion(s*x, s*y, s*z, s*w); }
-	Quaternion operator * (const Quaternion &q) const {
-		float xx =  x*q.w+y*q.z-z*q.y+w*q.x;
-		float yy = -x*q.z+y*q.w+z*q.x+w*q.y;
-		float zz =  x*q.y-y*q.x+z*q.w+w*q.z;
-		float ww = -x*q.x-y*q.y-z*q.z+w*q.w;
-		return Quaternion(xx, yy, zz, ww);
-	}
-	float Norm() { return x*x+y*y+z*z+w*w; }
-	mat3 Get3x3();
-	mat4 GetMatrix();
-	void SetMatrix(mat4 &m, float scale = 1);
-	void Slerp(Quaternion &qu0, Quaternion &qu1, float t);
-};
-
-#endif
+// Quaternion.h - quaternion operations.
+// (c) 2019-2022 Ken Shoemake and Jules Bloomenthal
+
+#ifndef QUATERNION_HDR
+#define QUATERNION_HDR
+
+#include <vector>
+#include "VecMat.h"
+
+using std::vector;
+
+class Quaternion {
+public:
+	float x = 0, y = 0, z = 0, w = 0;
+	Quaternion() { };
+	Quaternion(vec3 axis, float radAng);
+	Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) { };
+	Quaternion(mat3 &rot); // presumes rot is pure rotation matrix (no scale)
+	Quaternion(mat4 m);
+	Quaternion(const Quaternion &a) { x = a.x; y = a.y; z = a.z; w = a.w; }
+	Quaternion& operator = (const Quaternion &a) { x = a.x; y = a.y; z = a.z; w = a.w; return *this; }
+	Quaternion operator + (const Quaternion &q) const { return Quaternion(x+q.x, y+q.y, z+q.z, w+q.w); }
+	Quaternion operator * (float s) const { return Quaternion(s*x, s*y, s*z, s*w); }
+	Quaternion operator * (const Quaternion &q) const {
+		float xx =  x*q.w+y*q.z-z*q.y+w*q.x;
+		float yy = -x*q.z+y*q.w+z*q.x+w*q.y;
+		float zz =  x*q.y-y*q.x+z*q.w+w*q.z;
+		float ww = -x*q.x-y*q.y-z*q.z+w*q.w;
+		return Quaternion(xx, yy, zz, ww);
+	}
+	float Norm() { return x*x+y*y+z*z+w*w; }
+	mat3 Get3x3();
+	mat4 GetMatrix();
+	void SetMatrix(mat4 &m, float scale = 1);
+	void Slerp(Quaternion &qu0, Quaternion &qu1, float t);
+};
+
+// Quaternion Arrays
+
+class QuaternionArray {
+	// quaternions as separate x, y, z, w arrays, each 32-byte aligned (AlignedArrays, VecMat.h);
+	// operations use SIMD batches (VecMat.h)
+public:
+	float *x = NULL, *y = NULL, *z = NULL, *w = NULL;
+	int count = 0;
+	QuaternionArray() { }
+	QuaternionArray(int n) { Resize(n); }
+	QuaternionArray(const QuaternionArray &) = delete;
+	QuaternionArray &operator = (const QuaternionArray &) = delete;
+	void Resize(int n);
+		// values undefined
+	void Set(int i, const Quaternion &q) { x[i] = q.x; y[i] = q.y; z[i] = q.z; w[i] = q.w; }
+	void Set(const Quaternion *q, int n);
+	void Set(vector<Quaternion> &q);
+	Quaternion Get(int i) const { return Quaternion(x[i], y[i], z[i], w[i]); }
+	void GetAll(Quaternion *q);
+		// copy count quaternions out (not Get, which a literal 0 would make ambiguous)
+	void Normalize();
+	void GetMatrices(mat4 *m);
+		// m[i] = Get(i).GetMatrix(), same values
+private:
+	vector<float> storage;
+};
+
+// Batch Interpolation
+//     result[i] interpolates a[i], b[i] by t (or t[i]) along the shorter arc: b[i] is negated if
+//     dot(a[i], b[i]) < 0 (unlike Quaternion::Slerp); a and b must be the same size (asserted);
+//     result is resized to a.count and may be a or b
+
+void Slerp(QuaternionArray &a, QuaternionArray &b, float t, QuaternionArray &result);
+void Slerp(QuaternionArray &a, QuaternionArray &b, const float *t, QuaternionArray &result);
+	// spherical: weights are polynomials in dot(a, b), no acos or sin, within 3e-8 of
+	// sin((1-t)w)/sin(w) and sin(tw)/sin(w) for unit quaternions
+
+void NLerp(QuaternionArray &a, QuaternionArray &b, float t, QuaternionArray &result);
+void NLerp(QuaternionArray &a, QuaternionArray &b, const float *t, QuaternionArray &result);
+	// fast approximate path: normalized linear blend; same path as Slerp and exact at t = 0, .5, 1,
+	// but not constant speed (off by up to .03 degrees between keys 30 degrees apart, .9 at 90, 8 at 180)
+
+// Keyframe Sampling
+
+class QuaternionSampler {
+	// rotation tracks, each with its own key times, evaluated together at one time
+public:
+	int Add(const vector<float> &times, const vector<Quaternion> &keys);
+		// return track index, or -1 (not added) unless there is at least one key,
+		// times and keys are the same size, and times strictly increase
+	int NTracks() { return (int) tracks.size(); }
+	void Sample(float t, QuaternionArray &result, bool fast = false);
+		// result[i] = track i at t (held at its first and last keys), via Slerp or, if fast, NLerp
+		// the key interval found for each track is tried first next call, so playback doesn't search
+	void Sample(float t, mat4 *matrices, bool fast = false);
+		// rotation matrix of each track
+private:
+	struct Track { vector<float> times; vector<Quaternion> keys; int key = 0; };
+	vector<Track> tracks;
+	QuaternionArray a, b, result;
+	vector<float> u;
+};
+
+#endif
@@ -1,435 +1,868 @@
-// VecMat.h: 2D, 3D, 4D vector classes, 3x3 and 4x4 matrix classes
-// (c) 2019-2022 Jules Bloomenthal
-
-#ifndef VEC_MAT_HDR
-#define VEC_MAT_HDR
-
-#include <math.h>
-#include <iostream>
-
-// integer pair and triplet
-
-struct int2 {
-	int i1, i2;
-	int2() { i1 = i2 = 0; }
-	int2(int i1, int i2) : i1(i1), i2(i2) { }
-	int &operator [] (int i) { return *(&i1+i); }
-	const int operator [] (int i) const { return *(&i1+i); }
-	bool operator == (const int2 &rhs) { return this->i1 == rhs.i1 && this->i2 == rhs.i2; }
-	int2 operator + (const int2 &v) const { return int2(i1+v.i1, i2+v.i2); }
-	int2 operator - (const int2 &v) const { return int2(i1-v.i1, i2-v.i2); }
-};
-
-struct int3 {
-	int i1, i2, i3;
-	int3() { i1 = i2 = i3 = 0; }
-	int3(int *i) : i1(i[0]), i2(i[1]), i3(i[2]) { }
-	int3(int i1, int i2, int i3) : i1(i1), i2(i2), i3(i3) { }
-	int &operator [] (int i) { return *(&i1+i); }
-	const int operator [] (int i) const { return *(&i1+i); }
-	bool operator == (const int3 &rhs) { return this->i1 == rhs.i1 && this->i2 == rhs.i2 && this->i3 == rhs.i3; }
-	int3 operator + (const int3 &v) const { return int3(i1+v.i1, i2+v.i2, i3+v.i3); }
-	int3 operator - (const int3 &v) const { return int3(i1-v.i1, i2-v.i2, i3-v.i3); }
-};
-
-struct int4 {
-	int i1, i2, i3, i4;
-	int4() { i1 = i2 = i3 = i4 = 0; }
-	int4(int *i) : i1(i[0]), i2(i[1]), i3(i[2]), i4(i[3]) { }
-	int4(int i1, int i2, int i3, int i4) : i1(i1), i2(i2), i3(i3), i4(i4) { }
-	int &operator [] (int i) { return *(&i1+i); }
-	const int operator [] (int i) const { return *(&i1+i); }
-	bool operator == (const int4& rhs) { return this->i1 == rhs.i1 && this->i2 == rhs.i2 && this->i3 == rhs.i3 && this->i4 == rhs.i4; }
-};
-
-// vector representation
-//     vec2/vec3/vec4 v;        // defaults to zero vector
-// access
-//     float f = v[i];
-// class operations
-//     -v                       // negate v
-//     a-b                      // subtract b from a
-//     a+b                      // add v
-//     *s                       // multiply by s
-//     /s                       // divide by s
-//     a*b                      // dot product of a and b
-//     also reflexively: -=, +=, *=, /=
-// non-class operations
-//     dot                      // dot product
-//     length                   // magnitude
-//     normalize                // set to unit length
-//     cross                    // cross product
-
-//  2D vector
-
-class vec2 {
-public:
-	float x, y;
-	// constructors
-	vec2(float s = 0) : x(s), y(s) { }
-	vec2(float x, float y) : x(x), y(y) { }
-	vec2(double x, double y) : x((float) x), y((float) y) { }
-	vec2(float *p) : x(p[0]), y(p[1]) { }
-	vec2(const vec2 &v) : x(v.x), y(v.y) { }
-	vec2(const float *p) : x(p[0]), y(p[1]) { }
-	vec2(int xa, int ya) { x = (float) xa; y = (float) ya; }
-	// access
-	float &operator [] (int i) { return *(&x+i); }
-	const float operator [] (int i) const { return *(&x+i); }
-	operator const float* () const { return static_cast<const float*>(&x); }
-	operator float* () { return static_cast<float*>(&x); }
-	// operations
-	vec2 operator - () const { return vec2(-x, -y); }
-	vec2 operator + (const vec2 &v) const { return vec2(x+v.x, y+v.y); }
-	vec2 operator - (const vec2 &v) const { return vec2(x-v.x, y-v.y); }
-	vec2 operator * (float s) const { return vec2(s*x, s*y); }
-	vec2 operator * (const vec2 &v) const { return vec2(x*v.x, y*v.y); }
-	friend vec2 operator * (float s, const vec2 &v) { return v*s; }
-	vec2 operator / (float s) const { float r = 1.f/s; return *this*r; }
-	vec2 operator / (const vec2 &v) const { return vec2(x/v.x, y/v.y); }
-	// reflexive
-	vec2 &operator += (const vec2 &v) { x += v.x; y += v.y; return *this; }
-	vec2 &operator -= (const vec2 &v) { x -= v.x; y -= v.y; return *this; }
-	vec2 &operator *= (float s) { x *= s; y *= s; return *this; }
-	vec2 &operator *= (const vec2 &v) { x *= v.x; y *= v.y; return *this; }
-	vec2 &operator /= (float s) { float r = 1.f/s; *this *= r; return *this; }
-};
-
-inline float dot(const vec2 &a, const vec2 &b) { return a.x*b.x+a.y*b.y; }
-inline float cross(const vec2 &v1, const vec2 &v2) { return v1.x*v2.y-v1.y*v2.x; }
-inline float length(const vec2 &v) { return sqrt(dot(v,v)); }
-inline vec2 normalize(const vec2 &v) { return v/length(v); }
-
-//  3D vector
-
-class vec3 {
-public:
-	float  x, y, z;
-	// constructors
-	vec3(float s = 0) : x(s), y(s), z(s) { }
-	vec3(float x, float y, float z = 0) : x(x), y(y), z(z) { }
-	vec3(const vec3 &v) { x = v.x; y = v.y; z = v.z; }
-	vec3(const vec2 &v, float f = 0) { x = v.x; y = v.y; z = f; }
-	vec3(const float *p) : x(p[0]), y(p[1]), z(p[2]) { }
-   // access
-	float &operator [] (int i) { return *(&x+i); } // causes ambiguity
-	const float operator [] (int i) const { return *(&x+i); }
-	// arithmetic
-	vec3 operator - () const { return vec3(-x, -y, -z); }
-	vec3 operator + (const vec3 &v) const { return vec3(x+v.x, y+v.y, z+v.z); }
-	vec3 operator - (const vec3 &v) const { return vec3(x-v.x, y-v.y, z-v.z); }
-	vec3 operator * (float s) const { return vec3(s*x, s*y, s*z); }
-	vec3 operator * (const vec3 &v) const { return vec3(x*v.x, y*v.y, z*v.z); }
-	friend vec3 operator * (float s, const vec3 &v) { return v*s; }
-	vec3 operator / (float s) const { float r = 1.f/s; return *this * r; }
-	vec3 operator / (const vec3 &v) const { return vec3(x/v.x, y/v.y, z/v.z); }
-	// reflexive
-	vec3 &operator += (const vec3 &v) { x += v.x; y += v.y; z += v.z; return *this; }
-	vec3 &operator -= (const vec3 &v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
-	vec3 &operator *= (float s) { x *= s; y *= s; z *= s; return *this; }
-	vec3 &operator *= (const vec3 &v) { x *= v.x; y *= v.y; z *= v.z; return *this; }
-	vec3 &operator /= (float s) { float r = 1.f/s; *this *= r; return *this; }
-};
-
-inline float dot(const vec3 &a, const vec3 &b) { return a.x*b.x+a.y*b.y+a.z*b.z; }
-inline float length(const vec3 &v) { return sqrt(dot(v,v)); }
-inline vec3 normalize(const vec3 &v) { return v/length(v); }
-inline vec3 cross(const vec3 &a, const vec3 &b) { return vec3(a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x); }
-	// right-handed cross-product
-
-// 4D vector
-
-class vec4 {
-public:
-	float x, y, z, w;
-	// constructors
-	vec4(float s = 0) : x(s), y(s), z(s), w(s) { }
-	vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) { }
-	vec4(const vec4 &v) { x = v.x; y = v.y;  z = v.z;  w = v.w; }
-	vec4(float *p) : x(p[0]), y(p[1]), z(p[2]), w(p[3]) { }
-	vec4(const vec2 &v, float z = 0, float w = 1) : x(v.x), y(v.y), z(z), w(w) { }
-	vec4(const vec3 &v, float w = 1) : x(v.x), y(v.y), z(v.z), w(w) { }
-	// access
-	float &operator [] (int i) { return *(&x+i); }
-	const float operator [] (int i) const { return *(&x+i); }
-	operator const float* () const { return static_cast<const float*>(&x); }
-	operator float* () { return static_cast<float*>(&x); }
-	// arithmetic
-	vec4 operator - () const { return vec4(-x, -y, -z, -w); }
-	vec4 operator + (const vec4 &v) const { return vec4(x+v.x, y+v.y, z+v.z, w+v.w); }
-	vec4 operator - (const vec4 &v) const { return vec4(x-v.x, y-v.y, z-v.z, w-v.w); }
-	vec4 operator * (float s) const { return vec4(s*x, s*y, s*z, s*w); }
-	vec4 operator * (const vec4 &v) const { return vec4(x*v.x, y*v.y, z*v.z, w*v.z); }
-	friend vec4 operator * (float s, const vec4& v) { return v*s; }
-	vec4 operator / (float s) const { float r = 1.f/s; return *this*r; }
-	// reflexive
-	vec4 &operator += (const vec4 &v) { x += v.x;  y += v.y;  z += v.z;  w += v.w; return *this; }
-	vec4 &operator -= (const vec4 &v) { x -= v.x;  y -= v.y;  z -= v.z;  w -= v.w; return *this; }
-	vec4 &operator *= (float s) { x *= s;  y *= s;  z *= s;  w *= s; return *this; }
-	vec4 &operator *= (const vec4 &v) { x *= v.x, y *= v.y, z *= v.z, w *= v.w; return *this; }
-	vec4 &operator /= (float s) { float r = 1.f/s; *this *= r; return *this; }
-};
-
-inline float dot(const vec4 &a, const vec4 &b) { return a.x*b.x+a.y*b.y+a.z*b.z+a.w*b.w; }
-inline float length(const vec4 &v) { return sqrt(dot(v, v)); }
-inline vec4 normalize(const vec4 &v) { return v/length(v); }
-
-// 3x3 matrix representation (used by some quaternion related operations)
-
-class mat3 {
-public:
-	vec3 row[3];
-	//  constructors
-	mat3(float diag = 1) { row[0].x = row[1].y = row[2].z = diag; }
-	mat3(const vec3 &r0, const vec3 &r1, const vec3 &r2) { row[0] = r0; row[1] = r1; row[2] = r2; }
-	mat3(const mat3 &m) { for (int i = 0; i < 3; i++) row[i] = m.row[i]; }
-	// access
-	vec3 &operator [] (int i) { return row[i]; }
-	const vec3 &operator [] (int i) const { return row[i]; }
-	operator const float *() const { return static_cast<const float*>(&row[0].x); }
-	// methods
-	mat3 operator * (float s) const { return mat3(s*row[0], s*row[1], s*row[2]); }
-	friend mat3 operator * (float s, const mat3 &m) { return m*s; }
-	mat3 operator * (const mat3 &m) const {
-		mat3 a(0);
-		for (int i = 0; i < 3; i++)
-			for (int j = 0; j < 3; j++)
-				for (int k = 0; k < 3; k++)
-					a[i][j] += row[i][k]*m[k][j];
-		return a;
-	}
-	vec3 operator * (const vec3 &v) const { return vec3(dot(row[0], v), dot(row[1], v), dot(row[2], v)); }
-};
-
-// 4x4 matrix
-
-// representation
-//     mat4 m;                  // defaults to identity matrix
-//     vec4 v0, v1, v2, v3;
-//     mat4 m(v0, v1, v2, v3);  // four rows
-//     mat4 m2(m);              // copy of m
-// access
-//     vec4 &row0 = m[0];
-//     float f = m[i][j];
-// operations
-//     mat4 mm = m1*m2;         // matrix times matrix
-//     mat4 sm = s*m1;          // matrix times scalar
-//     vec4 xv = m*v;           // matrix times vector
-// initializations
-//     Scale, Translate, RotateX, RotateY, RotateZ
-//     Orthographic, Perspective
-//     LookAt, Transpose
-
-class mat4 {
-public:
-	vec4 row[4];
-	//  constructors
-	mat4(float diag = 1) { row[0].x = row[1].y = row[2].z = row[3].w = diag; }
-	mat4(const vec4 &r0, const vec4 &r1, const vec4 &r2, const vec4 &r3) { row[0] = r0; row[1] = r1; row[2] = r2; row[3] = r3; }
-	mat4(const mat4 &m) { for (int i = 0; i < 4; i++) row[i] = m.row[i]; }
-	mat4(const mat3 &m) {
-		for (int i = 0; i < 3; i++)
-			for (int j = 0; j < 3; j++)
-				row[i][j] = m[i][j];
-		row[3][3] = 1;
-	}
-	// access
-	vec4 &operator [] (int i) { return row[i]; }
-	const vec4 &operator [] (int i) const { return row[i]; }
-	operator const float *() const { return static_cast<const float*>(&row[0].x); }
-	// methods
-	mat4 operator * (float s) const { return mat4(s*row[0], s*row[1], s*row[2], s*row[3]); }
-	friend mat4 operator * (float s, const mat4 &m) { return m*s; }
-	mat4 operator * (const mat4 &m) const {
-		mat4 a(0);
-		for (int i = 0; i < 4; i++)
-			for (int j = 0; j < 4; j++)
-				for (int k = 0; k < 4; k++)
-					a[i][j] += row[i][k]*m[k][j];
-		return a;
-	}
-	vec4 operator * (const vec4 &v) const { return vec4(dot(row[0], v), dot(row[1], v), dot(row[2], v), dot(row[3], v)); }
-};
-
-inline mat4 Scale(float x, float y, float z) {
-	mat4 c;
-	c[0][0] = x;
-	c[1][1] = y;
-	c[2][2] = z;
-	return c;
-}
-
-inline mat4 Scale(vec3 s) { return Scale(s.x, s.y, s.z); }
-
-inline mat4 Translate(float x, float y, float z) {
-	mat4 c;
-	c[0][3] = x;
-	c[1][3] = y;
-	c[2][3] = z;
-	return c;
-}
-
-inline mat4 Translate(vec3 t) { return Translate(t.x, t.y, t.z); }
-
-static float DegreesToRadians = 3.14159265358f/180.f;
-
-inline mat4 RotateX(float theta) {
-	float angle = DegreesToRadians*theta;
-	mat4 c;
-	c[2][2] = c[1][1] = cos(angle);
-	c[2][1] = sin(angle);
-	c[1][2] = -c[2][1];
-	return c;
-}
-
-inline mat4 RotateY(float theta) {
-	float angle = DegreesToRadians*theta;
-	mat4 c;
-	c[2][2] = c[0][0] = cos(angle);
-	c[0][2] = sin(angle);
-	c[2][0] = -c[0][2];
-	return c;
-}
-
-inline mat4 RotateZ(float theta) {
-	float angle = DegreesToRadians*theta;
-	mat4 c;
-	c[0][0] = c[1][1] = cos(angle);
-	c[1][0] = sin(angle);
-	c[0][1] = -c[1][0];
-	return c;
-}
-
-inline mat4 Orthographic(float left, float right, float bottom, float top, float zNear = -1, float zFar = 1) {
-	mat4 c;
-	c[0][0] = 2.f/(right-left);
-	c[1][1] = 2.f/(top-bottom);
-	c[2][2] = 2.f/(zNear-zFar);
-	c[3][3] = 1.f;
-	c[0][3] = -(right+left)/(right-left);
-	c[1][3] = -(top+bottom)/(top-bottom);
-	c[2][3] = -(zFar+zNear)/(zFar-zNear);
-	return c;
-}
-
-inline mat4 Perspective(float verticalFOV, float aspectRatio, float zNear, float zFar) {
-	// convert view frustum to +/-1 perspective/clip space
-	// zNear and zFar are positive distances (despite camera facing -z axis)
-	// view frustum defined by verticalFOV (top, bottom), aspectRatio (left, right) and near, far
-	// -1/+1 in perspective z defaults to full depth buffer
-	float t = tan(verticalFOV*DegreesToRadians/2.f);
-	float fnDif = zFar-zNear;
-	mat4 m(0);
-	m[0][0] = 1.f/(aspectRatio*t);
-	m[1][1] = 1.f/t;
-	m[2][2] = -(zFar+zNear)/fnDif;
-	m[2][3] = -2.f*zFar*zNear/fnDif;
-	m[3][2] = -1.f;
-	return m;
-}
-
-inline mat4 LookTowards(vec3 eye, vec3 lookV, vec3 up) {
-	// camera view matrix transforms standard coordinate system (origin at (0,0,0), x-axis to right) to arbitrary
-	// scene coordinate system (ie, (0,0,0) transforms to origin of new system, (1,0,0) transforms to new x-axis) 
-	// LookAt is inverse: it must transform arbitrary x-axis to (1,0,0) and arbitrary origin to (0,0,0)
-	// if rotation is pure (no scale), its inverse is simply its transpose
-	// the translation terms are projections of arbitrary origin onto arbitrary axes
-	vec3 z = normalize(lookV);					// create 3 orthonormal axes
-	vec3 x = normalize(cross(z, up)), y = cross(x, z);
-	mat4 m = {{ x.x,  x.y,  x.z, -dot(x, eye)}, // upper 3x3 is transpose of pure rotation
-		      { y.x,  y.y,  y.z, -dot(y, eye)}, // dot products move by eye projected onto new axes
-		      {-z.x, -z.y, -z.z,  dot(z, eye)}, // negated so eye looks towards -z axis
-			  { 0,    0,    0,    1}};
-	return m;
-}
-
-inline mat4 LookAt(vec3 eye, vec3 lookat, vec3 up) { return LookTowards(eye, lookat-eye, up); }
-
-inline mat4 Transpose(mat4 m) {
-	return mat4(vec4(m[0][0], m[1][0], m[2][0], m[3][0]),
-				vec4(m[0][1], m[1][1], m[2][1], m[3][1]),
-				vec4(m[0][2], m[1][2], m[2][2], m[3][2]),
-				vec4(m[0][3], m[1][3], m[2][3], m[3][3]));
-}
-
-inline bool InverseMatrix4x4(const float *m, float *out) {
-	// from https://gamesxmath.tumblr.com/post/86495837013/inverting-a-4x4-matrix-using-c-code-float
-	class Helper {
-	public:
-		int i = 0, j = 0;
-		const float *m = NULL;
-		float e(int a, int b, const float *m) {
-			return m[ (b%4)*4 + a%4 ];
-		}
-		float invf(int i,int j, const float *m) {
-			int o = 2+(j-i);
-			i += 4+o;
-			j += 4-o;
-			float inv =
-			 + e(i+1,j-1,m)*e(i+0,j+0,m)*e(i-1,j+1,m)
-			 + e(i+1,j+1,m)*e(i+0,j-1,m)*e(i-1,j+0,m)
-			 + e(i-1,j-1,m)*e(i+1,j+0,m)*e(i+0,j+1,m)
-			 - e(i-1,j-1,m)*e(i+0,j+0,m)*e(i+1,j+1,m)
-			 - e(i-1,j+1,m)*e(i+0,j-1,m)*e(i+1,j+0,m)
-			 - e(i+1,j-1,m)*e(i-1,j+0,m)*e(i+0,j+1,m);
-			return (o%2)? inv : -inv;
-			#undef e
-		}
-		bool invert(float *out) {
-			float inv[16];
-			for(int i = 0; i < 4; i++)
-				for(int j = 0; j < 4; j++)
-					inv[j*4+i] = invf(i,j,m);
-			double D = 0;
-			for (int k = 0; k < 4; k++)
-				D += (double) m[k]*inv[k*4];
-			if (D == 0)
-				return false;
-			D = 1.0/D;
-			for (int i = 0; i < 16; i++)
-				out[i] = (float) ((double) inv[i]*D);
-			return true;
-		}
-		Helper(const float *m = NULL) : m(m) { }
-	} h(m);
-	return h.invert(out);
-}
-
-inline mat4 Invert(mat4 m) {
-	mat4 inv;
-	InverseMatrix4x4(&m[0][0], &inv[0][0]);
-	return inv;
-}
-
-#endif // VEC_MAT_HDR
-
-/* void Adjoint3x3(double in[][3], double out[][3]) {
-  out[0][0] =   in[1][1]*in[2][2]-in[1][2]*in[2][1];
-  out[1][0] = -(in[1][0]*in[2][2]-in[1][2]*in[2][0]);
-  out[2][0] =   in[1][0]*in[2][1]-in[1][1]*in[2][0];
-  out[0][1] = -(in[0][1]*in[2][2]-in[0][2]*in[2][1]);
-  out[1][1] =   in[0][0]*in[2][2]-in[0][2]*in[2][0];
-  out[2][1] = -(in[0][0]*in[2][1]-in[0][1]*in[2][0]);
-  out[0][2] =   in[0][1]*in[1][2]-in[0][2]*in[1][1];
-  out[1][2] = -(in[0][0]*in[1][2]-in[0][2]*in[1][0]);
-  out[2][2] =   in[0][0]*in[1][1]-in[0][1]*in[1][0];
-};
-
-bool Invert3x3(double in[][3], double out[][3]) {
-  Adjoint3x3(in, out);
-  double det = out[0][0]*in[0][0]+out[0][1]*in[1][0]+out[0][2]*in[2][0];
-  if (IsZero(det))
-	return false;
-  double di = 1.f/det;
-  out[0][0] = di*out[0][0];
-  out[0][1] = di*out[0][1];
-  out[0][2] = di*out[0][2];
-  out[1][0] = di*out[1][0];
-  out[1][1] = di*out[1][1];
-  out[1][2] = di*out[1][2];
-  out[2][0] = di*out[2][0];
-  out[2][1] = di*out[2][1];
-  out[2][2] = di*out[2][2];
-  return true;
-}; */
-
+// VecMat.h: 2D, 3D, 4D vector classes, 3x3 and 4x4 matrix classes
+// (c) 2019-2022 Jules Bloomenthal
+
+#ifndef VEC_MAT_HDR
+#define VEC_MAT_HDR
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+// SIMD support
+//     mat4*vec4 and the batch transforms below use 4-wide SSE (x86) or NEON (AArch64),
+//     and 8-wide AVX batches if compiled with AVX; define VECMAT_SCALAR to disable
+//     results are bit-identical to scalar: same products, summed in the same order, no fused multiply-add
+//     a.Min(b) is a < b? a : b and a.Max(b) is a > b? a : b, per lane (so a NaN in a is ignored, as in scalar bounds)
+//     a.FlipSign(s) negates the lanes of a whose lane in s has its sign bit set (eg, a.FlipSign(a) is |a|)
+//     a < b, a >= b, a != b give lane masks (all bits set where true), combined with &; m.Mask() sets bit k
+//     if lane k of m is set; != is true for NaN, as in scalar
+//     FloatBatch is Float8, Float4, or (without SIMD) Float1, so a batch loop needs no scalar version
+
+#if !defined(VECMAT_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define VECMAT_SSE
+	#include <immintrin.h>
+#elif !defined(VECMAT_SCALAR) && (defined(__aarch64__) || defined(_M_ARM64))
+	#define VECMAT_NEON
+	#include <arm_neon.h>
+#endif
+
+#if defined(VECMAT_SSE) || defined(VECMAT_NEON)
+#define VECMAT_SIMD
+
+struct Float4 {
+	// four floats
+#ifdef VECMAT_SSE
+	__m128 v;
+	Float4(__m128 v) : v(v) { }
+	static Float4 Load(const float *p) { return _mm_loadu_ps(p); }
+	static Float4 Splat(float s) { return _mm_set1_ps(s); }
+	void Store(float *p) const { _mm_storeu_ps(p, v); }
+	Float4 operator + (Float4 b) const { return _mm_add_ps(v, b.v); }
+	Float4 operator - (Float4 b) const { return _mm_sub_ps(v, b.v); }
+	Float4 operator * (Float4 b) const { return _mm_mul_ps(v, b.v); }
+	Float4 operator / (Float4 b) const { return _mm_div_ps(v, b.v); }
+	Float4 Min(Float4 b) const { return _mm_min_ps(v, b.v); }
+	Float4 Max(Float4 b) const { return _mm_max_ps(v, b.v); }
+	Float4 Sqrt() const { return _mm_sqrt_ps(v); }
+	Float4 FlipSign(Float4 s) const { return _mm_xor_ps(v, _mm_and_ps(s.v, _mm_set1_ps(-0.f))); }
+	Float4 operator < (Float4 b) const { return _mm_cmplt_ps(v, b.v); }
+	Float4 operator >= (Float4 b) const { return _mm_cmpge_ps(v, b.v); }
+	Float4 operator != (Float4 b) const { return _mm_cmpneq_ps(v, b.v); }
+	Float4 operator & (Float4 b) const { return _mm_and_ps(v, b.v); }
+	int Mask() const { return _mm_movemask_ps(v); }
+	static void Transpose(Float4 &a, Float4 &b, Float4 &c, Float4 &d) { _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v); }
+#else
+	float32x4_t v;
+	Float4(float32x4_t v) : v(v) { }
+	static Float4 Load(const float *p) { return vld1q_f32(p); }
+	static Float4 Splat(float s) { return vdupq_n_f32(s); }
+	void Store(float *p) const { vst1q_f32(p, v); }
+	Float4 operator + (Float4 b) const { return vaddq_f32(v, b.v); }
+	Float4 operator - (Float4 b) const { return vsubq_f32(v, b.v); }
+	Float4 operator * (Float4 b) const { return vmulq_f32(v, b.v); }
+	Float4 operator / (Float4 b) const { return vdivq_f32(v, b.v); }
+	Float4 Min(Float4 b) const { return vbslq_f32(vcltq_f32(v, b.v), v, b.v); }
+	Float4 Max(Float4 b) const { return vbslq_f32(vcgtq_f32(v, b.v), v, b.v); }
+	Float4 Sqrt() const { return vsqrtq_f32(v); }
+	Float4 FlipSign(Float4 s) const {
+		uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(s.v), vdupq_n_u32(0x80000000));
+		return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), sign));
+	}
+	Float4 operator < (Float4 b) const { return vreinterpretq_f32_u32(vcltq_f32(v, b.v)); }
+	Float4 operator >= (Float4 b) const { return vreinterpretq_f32_u32(vcgeq_f32(v, b.v)); }
+	Float4 operator != (Float4 b) const { return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(v, b.v))); }
+	Float4 operator & (Float4 b) const {
+		return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), vreinterpretq_u32_f32(b.v)));
+	}
+	int Mask() const {
+		static const uint32_t bits[4] = {1, 2, 4, 8};
+		return (int) vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(v), vld1q_u32(bits)));
+	}
+	static void Transpose(Float4 &a, Float4 &b, Float4 &c, Float4 &d) {
+		float32x4x2_t ab = vtrnq_f32(a.v, b.v), cd = vtrnq_f32(c.v, d.v);
+		a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+		b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+		c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+		d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+	}
+#endif
+	static const int n = 4;
+	Float4() { }
+};
+
+#ifdef __AVX__
+struct Float8 {
+	// eight floats
+	__m256 v;
+	Float8() { }
+	Float8(__m256 v) : v(v) { }
+	static Float8 Load(const float *p) { return _mm256_loadu_ps(p); }
+	static Float8 Splat(float s) { return _mm256_set1_ps(s); }
+	void Store(float *p) const { _mm256_storeu_ps(p, v); }
+	Float8 operator + (Float8 b) const { return _mm256_add_ps(v, b.v); }
+	Float8 operator - (Float8 b) const { return _mm256_sub_ps(v, b.v); }
+	Float8 operator * (Float8 b) const { return _mm256_mul_ps(v, b.v); }
+	Float8 operator / (Float8 b) const { return _mm256_div_ps(v, b.v); }
+	Float8 Min(Float8 b) const { return _mm256_min_ps(v, b.v); }
+	Float8 Max(Float8 b) const { return _mm256_max_ps(v, b.v); }
+	Float8 Sqrt() const { return _mm256_sqrt_ps(v); }
+	Float8 FlipSign(Float8 s) const { return _mm256_xor_ps(v, _mm256_and_ps(s.v, _mm256_set1_ps(-0.f))); }
+	Float8 operator < (Float8 b) const { return _mm256_cmp_ps(v, b.v, _CMP_LT_OQ); }
+	Float8 operator >= (Float8 b) const { return _mm256_cmp_ps(v, b.v, _CMP_GE_OQ); }
+	Float8 operator != (Float8 b) const { return _mm256_cmp_ps(v, b.v, _CMP_NEQ_UQ); }
+	Float8 operator & (Float8 b) const { return _mm256_and_ps(v, b.v); }
+	int Mask() const { return _mm256_movemask_ps(v); }
+	static const int n = 8;
+};
+typedef Float8 FloatBatch;
+#else
+typedef Float4 FloatBatch;
+#endif
+
+#endif // VECMAT_SIMD
+
+struct Float1 {
+	// one float, with the interface of Float4 (a mask lane is 0 or all bits set)
+	float v;
+	Float1() { }
+	Float1(float v) : v(v) { }
+	static Float1 Load(const float *p) { return *p; }
+	static Float1 Splat(float s) { return s; }
+	void Store(float *p) const { *p = v; }
+	Float1 operator + (Float1 b) const { return v+b.v; }
+	Float1 operator - (Float1 b) const { return v-b.v; }
+	Float1 operator * (Float1 b) const { return v*b.v; }
+	Float1 operator / (Float1 b) const { return v/b.v; }
+	Float1 Min(Float1 b) const { return v < b.v? v : b.v; }
+	Float1 Max(Float1 b) const { return v > b.v? v : b.v; }
+	Float1 Sqrt() const { return sqrtf(v); }
+	Float1 FlipSign(Float1 s) const { return FromBits(Bits() ^ (s.Bits() & 0x80000000u)); }
+	Float1 operator < (Float1 b) const { return FromBits(v < b.v? ~0u : 0); }
+	Float1 operator >= (Float1 b) const { return FromBits(v >= b.v? ~0u : 0); }
+	Float1 operator != (Float1 b) const { return FromBits(v != b.v? ~0u : 0); }
+	Float1 operator & (Float1 b) const { return FromBits(Bits() & b.Bits()); }
+	int Mask() const { return (int) (Bits() >> 31); }
+	static const int n = 1;
+private:
+	unsigned int Bits() const { unsigned int b; memcpy(&b, &v, sizeof(b)); return b; }
+	static Float1 FromBits(unsigned int b) { Float1 f; memcpy(&f.v, &b, sizeof(b)); return f; }
+};
+
+#ifndef VECMAT_SIMD
+typedef Float1 FloatBatch;
+#endif
+
+// Aligned arrays
+//     storage for structures of arrays (eg, PointSet, QuaternionArray): nArrays arrays of n floats in one
+//     allocation, each on a 32-byte boundary and padded to a multiple of 8 floats, so batches load and
+//     store whole; return the first array, the others follow every padded floats
+
+inline float *AlignedArrays(std::vector<float> &storage, int nArrays, int n, int &padded) {
+	padded = (n+7) & ~7;
+	storage.resize(nArrays*padded+8);
+	return (float *) (((uintptr_t) storage.data()+31) & ~(uintptr_t) 31);
+}
+
+// Fixed-size vectors and matrices
+//     VecOps<T, N> and MatOps<T, R, C> implement the operations once, for every size; Vec<T, N> and
+//     Mat<T, R, C> hold the components and the constructors particular to each size
+//     int2, int3, int4, vec2, vec3, vec4, mat3, mat4 are aliases
+//     operations are constexpr (except matrix products) and evaluate components in written-out
+//     order, so results are the same as separate classes per size
+//     components are written out (c[0], c[1], ...), not passed to helpers, so unoptimized (debug)
+//     builds make the same calls as they did with separate classes; but each component is reached
+//     through a member pointer, which unoptimized code does not fold: at -O0 vector arithmetic runs
+//     about 1.2 to 2 times slower than with separate classes (optimized builds fold the pointers)
+
+template <class T, int N> struct Vec;
+template <class T, int R, int C> struct Mat;
+
+template <class T, int N> struct VecOps {
+	// operations of Vec<T, N> (V), which derives from VecOps; V::c[i] is a pointer to component i
+	typedef Vec<T, N> V;
+	// access
+	T &operator [] (int i) { return (&(static_cast<V &>(*this).*V::c[0]))[i]; }
+	const T operator [] (int i) const { return (&(static_cast<const V &>(*this).*V::c[0]))[i]; }
+	// arithmetic, each component of the result written out (as a hand-written class would)
+	constexpr V operator - () const {
+		V r = static_cast<const V &>(*this);
+		r.*V::c[0] = -(r.*V::c[0]); r.*V::c[1] = -(r.*V::c[1]);
+		if constexpr (N > 2) r.*V::c[2] = -(r.*V::c[2]);
+		if constexpr (N > 3) r.*V::c[3] = -(r.*V::c[3]);
+		return r;
+	}
+	constexpr V operator + (const V &v) const {
+		const V &a = static_cast<const V &>(*this);
+		V r;
+		r.*V::c[0] = a.*V::c[0]+v.*V::c[0]; r.*V::c[1] = a.*V::c[1]+v.*V::c[1];
+		if constexpr (N > 2) r.*V::c[2] = a.*V::c[2]+v.*V::c[2];
+		if constexpr (N > 3) r.*V::c[3] = a.*V::c[3]+v.*V::c[3];
+		return r;
+	}
+	constexpr V operator - (const V &v) const {
+		const V &a = static_cast<const V &>(*this);
+		V r;
+		r.*V::c[0] = a.*V::c[0]-v.*V::c[0]; r.*V::c[1] = a.*V::c[1]-v.*V::c[1];
+		if constexpr (N > 2) r.*V::c[2] = a.*V::c[2]-v.*V::c[2];
+		if constexpr (N > 3) r.*V::c[3] = a.*V::c[3]-v.*V::c[3];
+		return r;
+	}
+	constexpr V operator * (T s) const {
+		const V &a = static_cast<const V &>(*this);
+		V r;
+		r.*V::c[0] = a.*V::c[0]*s; r.*V::c[1] = a.*V::c[1]*s;
+		if constexpr (N > 2) r.*V::c[2] = a.*V::c[2]*s;
+		if constexpr (N > 3) r.*V::c[3] = a.*V::c[3]*s;
+		return r;
+	}
+	constexpr V operator * (const V &v) const {
+		const V &a = static_cast<const V &>(*this);
+		V r;
+		r.*V::c[0] = a.*V::c[0]*v.*V::c[0]; r.*V::c[1] = a.*V::c[1]*v.*V::c[1];
+		if constexpr (N > 2) r.*V::c[2] = a.*V::c[2]*v.*V::c[2];
+		if constexpr (N > 3) r.*V::c[3] = a.*V::c[3]*v.*V::c[3];
+		return r;
+	}
+	friend constexpr V operator * (T s, const V &v) { return v*s; }
+	constexpr V operator / (T s) const {
+		// floats multiply by the reciprocal
+		if constexpr (std::is_floating_point<T>::value)
+			return static_cast<const V &>(*this)*(1/s);
+		V r = static_cast<const V &>(*this);
+		return r /= s;
+	}
+	constexpr V operator / (const V &v) const {
+		const V &a = static_cast<const V &>(*this);
+		V r;
+		r.*V::c[0] = a.*V::c[0]/v.*V::c[0]; r.*V::c[1] = a.*V::c[1]/v.*V::c[1];
+		if constexpr (N > 2) r.*V::c[2] = a.*V::c[2]/v.*V::c[2];
+		if constexpr (N > 3) r.*V::c[3] = a.*V::c[3]/v.*V::c[3];
+		return r;
+	}
+	template <class U = T, typename std::enable_if<std::is_integral<U>::value, int>::type = 0>
+	constexpr bool operator == (const V &v) const {
+		for (int i = 0; i < N; i++)
+			if (static_cast<const V &>(*this).*V::c[i] != v.*V::c[i])
+				return false;
+		return true;
+	}
+	// reflexive
+	constexpr V &operator += (const V &v) {
+		V &a = static_cast<V &>(*this);
+		a.*V::c[0] += v.*V::c[0]; a.*V::c[1] += v.*V::c[1];
+		if constexpr (N > 2) a.*V::c[2] += v.*V::c[2];
+		if constexpr (N > 3) a.*V::c[3] += v.*V::c[3];
+		return a;
+	}
+	constexpr V &operator -= (const V &v) {
+		V &a = static_cast<V &>(*this);
+		a.*V::c[0] -= v.*V::c[0]; a.*V::c[1] -= v.*V::c[1];
+		if constexpr (N > 2) a.*V::c[2] -= v.*V::c[2];
+		if constexpr (N > 3) a.*V::c[3] -= v.*V::c[3];
+		return a;
+	}
+	constexpr V &operator *= (T s) {
+		V &a = static_cast<V &>(*this);
+		a.*V::c[0] *= s; a.*V::c[1] *= s;
+		if constexpr (N > 2) a.*V::c[2] *= s;
+		if constexpr (N > 3) a.*V::c[3] *= s;
+		return a;
+	}
+	constexpr V &operator *= (const V &v) {
+		V &a = static_cast<V &>(*this);
+		a.*V::c[0] *= v.*V::c[0]; a.*V::c[1] *= v.*V::c[1];
+		if constexpr (N > 2) a.*V::c[2] *= v.*V::c[2];
+		if constexpr (N > 3) a.*V::c[3] *= v.*V::c[3];
+		return a;
+	}
+	constexpr V &operator /= (T s) {
+		// floats multiply by the reciprocal
+		V &a = static_cast<V &>(*this);
+		if constexpr (std::is_floating_point<T>::value)
+			return a *= 1/s;
+		for (int i = 0; i < N; i++)
+			a.*V::c[i] /= s;
+		return a;
+	}
+	constexpr V &operator /= (const V &v) {
+		V &a = static_cast<V &>(*this);
+		a.*V::c[0] /= v.*V::c[0]; a.*V::c[1] /= v.*V::c[1];
+		if constexpr (N > 2) a.*V::c[2] /= v.*V::c[2];
+		if constexpr (N > 3) a.*V::c[3] /= v.*V::c[3];
+		return a;
+	}
+	// non-class operations, as friends so arguments convert as for members (eg, dot(vec3, float *))
+	friend constexpr T dot(const V &a, const V &b) {
+		T d = a.*V::c[0]*b.*V::c[0]+a.*V::c[1]*b.*V::c[1];
+		if constexpr (N > 2) d += a.*V::c[2]*b.*V::c[2];
+		if constexpr (N > 3) d += a.*V::c[3]*b.*V::c[3];
+		return d;
+	}
+	friend T length(const V &v) { return sqrt(dot(v, v)); }
+	friend V normalize(const V &v) { return v/length(v); }
+};
+
+// integer pair, triplet, quadruple
+
+template <> struct Vec<int, 2> : VecOps<int, 2> {
+	int i1, i2;
+	constexpr Vec() : i1(0), i2(0) { }
+	constexpr Vec(int i1, int i2) : i1(i1), i2(i2) { }
+	static constexpr int Vec::*c[] = {&Vec::i1, &Vec::i2};
+};
+
+template <> struct Vec<int, 3> : VecOps<int, 3> {
+	int i1, i2, i3;
+	constexpr Vec() : i1(0), i2(0), i3(0) { }
+	constexpr Vec(const int *i) : i1(i[0]), i2(i[1]), i3(i[2]) { }
+	constexpr Vec(int i1, int i2, int i3) : i1(i1), i2(i2), i3(i3) { }
+	static constexpr int Vec::*c[] = {&Vec::i1, &Vec::i2, &Vec::i3};
+};
+
+template <> struct Vec<int, 4> : VecOps<int, 4> {
+	int i1, i2, i3, i4;
+	constexpr Vec() : i1(0), i2(0), i3(0), i4(0) { }
+	constexpr Vec(const int *i) : i1(i[0]), i2(i[1]), i3(i[2]), i4(i[3]) { }
+	constexpr Vec(int i1, int i2, int i3, int i4) : i1(i1), i2(i2), i3(i3), i4(i4) { }
+	static constexpr int Vec::*c[] = {&Vec::i1, &Vec::i2, &Vec::i3, &Vec::i4};
+};
+
+typedef Vec<int, 2> int2;
+typedef Vec<int, 3> int3;
+typedef Vec<int, 4> int4;
+
+// vector representation
+//     vec2/vec3/vec4 v;        // defaults to zero vector
+// access
+//     float f = v[i];
+// class operations
+//     -v                       // negate v
+//     a-b                      // subtract b from a
+//     a+b                      // add v
+//     *s                       // multiply by s
+//     /s                       // divide by s
+//     a*b                      // component-wise product of a and b
+//     also reflexively: -=, +=, *=, /=
+// non-class operations
+//     dot                      // dot product
+//     length                   // magnitude
+//     normalize                // set to unit length
+//     cross                    // cross product
+
+//  2D vector
+
+template <class T> struct Vec<T, 2> : VecOps<T, 2> {
+	T x, y;
+	// constructors
+	constexpr Vec(T s = 0) : x(s), y(s) { }
+	constexpr Vec(T x, T y) : x(x), y(y) { }
+	template <class U, typename std::enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+	constexpr Vec(U x, U y) : x((T) x), y((T) y) { }
+	constexpr Vec(const T *p) : x(p[0]), y(p[1]) { }
+	// access
+	operator const T* () const { return &x; }
+	operator T* () { return &x; }
+	static constexpr T Vec::*c[] = {&Vec::x, &Vec::y};
+};
+
+typedef Vec<float, 2> vec2;
+
+inline constexpr float cross(const vec2 &v1, const vec2 &v2) { return v1.x*v2.y-v1.y*v2.x; }
+
+//  3D vector
+
+template <class T> struct Vec<T, 3> : VecOps<T, 3> {
+	T x, y, z;
+	// constructors
+	constexpr Vec(T s = 0) : x(s), y(s), z(s) { }
+	constexpr Vec(T x, T y, T z = 0) : x(x), y(y), z(z) { }
+	constexpr Vec(const Vec<T, 2> &v, T f = 0) : x(v.x), y(v.y), z(f) { }
+	constexpr Vec(const T *p) : x(p[0]), y(p[1]), z(p[2]) { }
+	static constexpr T Vec::*c[] = {&Vec::x, &Vec::y, &Vec::z};
+};
+
+typedef Vec<float, 3> vec3;
+
+inline constexpr vec3 cross(const vec3 &a, const vec3 &b) { return vec3(a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x); }
+	// right-handed cross-product
+
+// 4D vector
+
+template <class T> struct Vec<T, 4> : VecOps<T, 4> {
+	T x, y, z, w;
+	// constructors
+	constexpr Vec(T s = 0) : x(s), y(s), z(s), w(s) { }
+	constexpr Vec(T x, T y, T z, T w) : x(x), y(y), z(z), w(w) { }
+	constexpr Vec(const T *p) : x(p[0]), y(p[1]), z(p[2]), w(p[3]) { }
+	constexpr Vec(const Vec<T, 2> &v, T z = 0, T w = 1) : x(v.x), y(v.y), z(z), w(w) { }
+	constexpr Vec(const Vec<T, 3> &v, T w = 1) : x(v.x), y(v.y), z(v.z), w(w) { }
+	// access
+	operator const T* () const { return &x; }
+	operator T* () { return &x; }
+	static constexpr T Vec::*c[] = {&Vec::x, &Vec::y, &Vec::z, &Vec::w};
+};
+
+typedef Vec<float, 4> vec4;
+
+// matrices
+
+template <class T, int R, int C> struct MatOps {
+	// operations of Mat<T, R, C> (M), which derives from MatOps
+	typedef Mat<T, R, C> M;
+	// access
+	constexpr Vec<T, C> &operator [] (int i) { return static_cast<M &>(*this).row[i]; }
+	constexpr const Vec<T, C> &operator [] (int i) const { return static_cast<const M &>(*this).row[i]; }
+	operator const T *() const { return (const T *) static_cast<const M &>(*this).row; }
+	// methods
+	constexpr M operator * (T s) const {
+		M a = static_cast<const M &>(*this);
+		for (int i = 0; i < R; i++)
+			a.row[i] *= s;
+		return a;
+	}
+	friend constexpr M operator * (T s, const M &m) { return m*s; }
+	M operator * (const M &m) const {
+		// product of square matrices (an R by C times an R by C matrix requires R == C)
+		static_assert(R == C, "Mat product of non-square matrices");
+		const Vec<T, C> *row = static_cast<const M &>(*this).row;
+		// scalar: compilers vectorize this as well as SSE does, and can fold constant matrices (eg, Translate)
+		M a(0);
+		for (int i = 0; i < R; i++)
+			for (int j = 0; j < C; j++)
+				for (int k = 0; k < C; k++)
+					a[i][j] += row[i][k]*m[k][j];
+		return a;
+	}
+	Vec<T, R> operator * (const Vec<T, C> &v) const {
+		const Vec<T, C> *row = static_cast<const M &>(*this).row;
+#ifdef VECMAT_SIMD
+		if constexpr (std::is_same<T, float>::value && R == 4 && C == 4) {
+			// multiply rows by v, transpose, sum products in dot order
+			Float4 x = Float4::Load(v), p0 = Float4::Load(row[0])*x, p1 = Float4::Load(row[1])*x;
+			Float4 p2 = Float4::Load(row[2])*x, p3 = Float4::Load(row[3])*x;
+			Float4::Transpose(p0, p1, p2, p3);
+			Vec<T, R> r;
+			(((p0+p1)+p2)+p3).Store(r);
+			return r;
+		}
+#endif
+		Vec<T, R> r;
+		for (int i = 0; i < R; i++)
+			r[i] = dot(row[i], v);
+		return r;
+	}
+};
+
+// 3x3 matrix representation (used by some quaternion related operations)
+
+template <class T> struct Mat<T, 3, 3> : MatOps<T, 3, 3> {
+	Vec<T, 3> row[3];
+	//  constructors
+	constexpr Mat(T diag = 1) : row{Vec<T, 3>(diag, 0, 0), Vec<T, 3>(0, diag, 0), Vec<T, 3>(0, 0, diag)} { }
+	constexpr Mat(const Vec<T, 3> &r0, const Vec<T, 3> &r1, const Vec<T, 3> &r2) : row{r0, r1, r2} { }
+};
+
+typedef Mat<float, 3, 3> mat3;
+
+// 4x4 matrix
+
+// representation
+//     mat4 m;                  // defaults to identity matrix
+//     vec4 v0, v1, v2, v3;
+//     mat4 m(v0, v1, v2, v3);  // four rows
+//     mat4 m2(m);              // copy of m
+// access
+//     vec4 &row0 = m[0];
+//     float f = m[i][j];
+// operations
+//     mat4 mm = m1*m2;         // matrix times matrix
+//     mat4 sm = s*m1;          // matrix times scalar
+//     vec4 xv = m*v;           // matrix times vector
+// initializations
+//     Scale, Translate, RotateX, RotateY, RotateZ
+//     Orthographic, Perspective
+//     LookAt, Transpose
+
+template <class T> struct Mat<T, 4, 4> : MatOps<T, 4, 4> {
+	Vec<T, 4> row[4];
+	//  constructors
+	constexpr Mat(T diag = 1)
+		: row{Vec<T, 4>(diag, 0, 0, 0), Vec<T, 4>(0, diag, 0, 0), Vec<T, 4>(0, 0, diag, 0), Vec<T, 4>(0, 0, 0, diag)} { }
+	constexpr Mat(const Vec<T, 4> &r0, const Vec<T, 4> &r1, const Vec<T, 4> &r2, const Vec<T, 4> &r3) : row{r0, r1, r2, r3} { }
+	constexpr Mat(const Mat<T, 3, 3> &m) : row{Vec<T, 4>(m[0], 0), Vec<T, 4>(m[1], 0), Vec<T, 4>(m[2], 0), Vec<T, 4>(0, 0, 0, 1)} { }
+};
+
+typedef Mat<float, 4, 4> mat4;
+
+inline constexpr mat4 Scale(float x, float y, float z) {
+	return mat4(vec4(x, 0, 0, 0), vec4(0, y, 0, 0), vec4(0, 0, z, 0), vec4(0, 0, 0, 1));
+}
+
+inline constexpr mat4 Scale(vec3 s) { return Scale(s.x, s.y, s.z); }
+
+inline constexpr mat4 Translate(float x, float y, float z) {
+	return mat4(vec4(1, 0, 0, x), vec4(0, 1, 0, y), vec4(0, 0, 1, z), vec4(0, 0, 0, 1));
+}
+
+inline constexpr mat4 Translate(vec3 t) { return Translate(t.x, t.y, t.z); }
+
+static constexpr float DegreesToRadians = 3.14159265358f/180.f;
+
+inline mat4 RotateX(float theta) {
+	float angle = DegreesToRadians*theta;
+	mat4 c;
+	c[2][2] = c[1][1] = cos(angle);
+	c[2][1] = sin(angle);
+	c[1][2] = -c[2][1];
+	return c;
+}
+
+inline mat4 RotateY(float theta) {
+	float angle = DegreesToRadians*theta;
+	mat4 c;
+	c[2][2] = c[0][0] = cos(angle);
+	c[0][2] = sin(angle);
+	c[2][0] = -c[0][2];
+	return c;
+}
+
+inline mat4 RotateZ(float theta) {
+	float angle = DegreesToRadians*theta;
+	mat4 c;
+	c[0][0] = c[1][1] = cos(angle);
+	c[1][0] = sin(angle);
+	c[0][1] = -c[1][0];
+	return c;
+}
+
+inline constexpr mat4 Orthographic(float left, float right, float bottom, float top, float zNear = -1, float zFar = 1) {
+	return mat4(vec4(2.f/(right-left), 0, 0, -(right+left)/(right-left)),
+				vec4(0, 2.f/(top-bottom), 0, -(top+bottom)/(top-bottom)),
+				vec4(0, 0, 2.f/(zNear-zFar), -(zFar+zNear)/(zFar-zNear)),
+				vec4(0, 0, 0, 1.f));
+}
+
+inline mat4 Perspective(float verticalFOV, float aspectRatio, float zNear, float zFar) {
+	// convert view frustum to +/-1 perspective/clip space
+	// zNear and zFar are positive distances (despite camera facing -z axis)
+	// view frustum defined by verticalFOV (top, bottom), aspectRatio (left, right) and near, far
+	// -1/+1 in perspective z defaults to full depth buffer
+	float t = tan(verticalFOV*DegreesToRadians/2.f);
+	float fnDif = zFar-zNear;
+	mat4 m(0);
+	m[0][0] = 1.f/(aspectRatio*t);
+	m[1][1] = 1.f/t;
+	m[2][2] = -(zFar+zNear)/fnDif;
+	m[2][3] = -2.f*zFar*zNear/fnDif;
+	m[3][2] = -1.f;
+	return m;
+}
+
+inline mat4 LookTowards(vec3 eye, vec3 lookV, vec3 up) {
+	// camera view matrix transforms standard coordinate system (origin at (0,0,0), x-axis to right) to arbitrary
+	// scene coordinate system (ie, (0,0,0) transforms to origin of new system, (1,0,0) transforms to new x-axis) 
+	// LookAt is inverse: it must transform arbitrary x-axis to (1,0,0) and arbitrary origin to (0,0,0)
+	// if rotation is pure (no scale), its inverse is simply its transpose
+	// the translation terms are projections of arbitrary origin onto arbitrary axes
+	vec3 z = normalize(lookV);					// create 3 orthonormal axes
+	vec3 x = normalize(cross(z, up)), y = cross(x, z);
+	mat4 m = {{ x.x,  x.y,  x.z, -dot(x, eye)}, // upper 3x3 is transpose of pure rotation
+		      { y.x,  y.y,  y.z, -dot(y, eye)}, // dot products move by eye projected onto new axes
+		      {-z.x, -z.y, -z.z,  dot(z, eye)}, // negated so eye looks towards -z axis
+			  { 0,    0,    0,    1}};
+	return m;
+}
+
+inline mat4 LookAt(vec3 eye, vec3 lookat, vec3 up) { return LookTowards(eye, lookat-eye, up); }
+
+inline constexpr mat4 Transpose(mat4 m) {
+	return mat4(vec4(m[0].x, m[1].x, m[2].x, m[3].x),
+				vec4(m[0].y, m[1].y, m[2].y, m[3].y),
+				vec4(m[0].z, m[1].z, m[2].z, m[3].z),
+				vec4(m[0].w, m[1].w, m[2].w, m[3].w));
+}
+
+// Batch transforms
+//     as m*vec4(p, 1) per point, but in SIMD batches of FloatBatch::n points; results bit-identical
+
+inline void TransformPoints(const mat4 &m, const float *x, const float *y, const float *z,
+							float *ox, float *oy, float *oz, float *ow, int n) {
+	// structure of arrays; any output may be NULL, and outputs may be the inputs
+	int i = 0;
+#ifdef VECMAT_SIMD
+	// matrix elements as named locals, not an array, so stores to outputs can't force reloads
+	FloatBatch m00 = FloatBatch::Splat(m[0][0]), m01 = FloatBatch::Splat(m[0][1]), m02 = FloatBatch::Splat(m[0][2]), m03 = FloatBatch::Splat(m[0][3]);
+	FloatBatch m10 = FloatBatch::Splat(m[1][0]), m11 = FloatBatch::Splat(m[1][1]), m12 = FloatBatch::Splat(m[1][2]), m13 = FloatBatch::Splat(m[1][3]);
+	FloatBatch m20 = FloatBatch::Splat(m[2][0]), m21 = FloatBatch::Splat(m[2][1]), m22 = FloatBatch::Splat(m[2][2]), m23 = FloatBatch::Splat(m[2][3]);
+	FloatBatch m30 = FloatBatch::Splat(m[3][0]), m31 = FloatBatch::Splat(m[3][1]), m32 = FloatBatch::Splat(m[3][2]), m33 = FloatBatch::Splat(m[3][3]);
+	for (; i+FloatBatch::n <= n; i += FloatBatch::n) {
+		FloatBatch px = FloatBatch::Load(x+i), py = FloatBatch::Load(y+i), pz = FloatBatch::Load(z+i);
+		FloatBatch rx = ((m00*px+m01*py)+m02*pz)+m03, ry = ((m10*px+m11*py)+m12*pz)+m13;
+		FloatBatch rz = ((m20*px+m21*py)+m22*pz)+m23, rw = ((m30*px+m31*py)+m32*pz)+m33;
+		if (ox) rx.Store(ox+i);
+		if (oy) ry.Store(oy+i);
+		if (oz) rz.Store(oz+i);
+		if (ow) rw.Store(ow+i);
+	}
+#endif
+	for (; i < n; i++) {
+		vec4 p = m*vec4(x[i], y[i], z[i], 1);
+		if (ox) ox[i] = p.x;
+		if (oy) oy[i] = p.y;
+		if (oz) oz[i] = p.z;
+		if (ow) ow[i] = p.w;
+	}
+}
+
+inline void TransformPoints(const mat4 &m, const vec3 *in, vec4 *out, int n) {
+	// array of structures, converted to structure of arrays in blocks
+	const int nb = 64;
+	float x[nb], y[nb], z[nb], ow[nb];
+	for (int i = 0; i < n; i += nb) {
+		int nn = n-i < nb? n-i : nb;
+		for (int j = 0; j < nn; j++) {
+			x[j] = in[i+j].x;
+			y[j] = in[i+j].y;
+			z[j] = in[i+j].z;
+		}
+		TransformPoints(m, x, y, z, x, y, z, ow, nn);
+		for (int j = 0; j < nn; j++)
+			out[i+j] = vec4(x[j], y[j], z[j], ow[j]);
+	}
+}
+
+inline void TransformPoints(const mat4 &m, const vec3 *in, vec3 *out, int n) {
+	// as above, set out[i] to x, y, z of m*vec4(in[i], 1)
+	const int nb = 64;
+	float x[nb], y[nb], z[nb];
+	for (int i = 0; i < n; i += nb) {
+		int nn = n-i < nb? n-i : nb;
+		for (int j = 0; j < nn; j++) {
+			x[j] = in[i+j].x;
+			y[j] = in[i+j].y;
+			z[j] = in[i+j].z;
+		}
+		TransformPoints(m, x, y, z, x, y, z, NULL, nn);
+		for (int j = 0; j < nn; j++)
+			out[i+j] = vec3(x[j], y[j], z[j]);
+	}
+}
+
+inline void TransformToViewport(const mat4 &m, const vec3 *in, vec2 *out, int n, const vec4 &viewport) {
+	// as ScreenPoint (Draw.h) per point: viewport is (x, y, width, height) in pixels
+	const int nb = 64;
+	float x[nb], y[nb], z[nb];
+	const vec4 &v = viewport;
+	for (int i = 0; i < n; i += nb) {
+		int nn = n-i < nb? n-i : nb, k = 0;
+		for (int j = 0; j < nn; j++) {
+			x[j] = in[i+j].x;
+			y[j] = in[i+j].y;
+			z[j] = in[i+j].z;
+		}
+#ifdef VECMAT_SIMD
+		FloatBatch one = FloatBatch::Splat(1), half = FloatBatch::Splat(.5f);
+		FloatBatch vx = FloatBatch::Splat(v.x), vy = FloatBatch::Splat(v.y), vw = FloatBatch::Splat(v.z), vh = FloatBatch::Splat(v.w);
+		FloatBatch m00 = FloatBatch::Splat(m[0][0]), m01 = FloatBatch::Splat(m[0][1]), m02 = FloatBatch::Splat(m[0][2]), m03 = FloatBatch::Splat(m[0][3]);
+		FloatBatch m10 = FloatBatch::Splat(m[1][0]), m11 = FloatBatch::Splat(m[1][1]), m12 = FloatBatch::Splat(m[1][2]), m13 = FloatBatch::Splat(m[1][3]);
+		FloatBatch m30 = FloatBatch::Splat(m[3][0]), m31 = FloatBatch::Splat(m[3][1]), m32 = FloatBatch::Splat(m[3][2]), m33 = FloatBatch::Splat(m[3][3]);
+		for (; k+FloatBatch::n <= nn; k += FloatBatch::n) {
+			FloatBatch px = FloatBatch::Load(x+k), py = FloatBatch::Load(y+k), pz = FloatBatch::Load(z+k);
+			FloatBatch xx = ((m00*px+m01*py)+m02*pz)+m03, yy = ((m10*px+m11*py)+m12*pz)+m13;
+			FloatBatch ww = ((m30*px+m31*py)+m32*pz)+m33;
+			(vx+((xx/ww)+one)*half*vw).Store(x+k);
+			(vy+((yy/ww)+one)*half*vh).Store(y+k);
+		}
+#endif
+		for (; k < nn; k++) {
+			vec4 p = m*vec4(x[k], y[k], z[k], 1);
+			x[k] = v.x+((p.x/p.w)+1)*.5f*v.z;
+			y[k] = v.y+((p.y/p.w)+1)*.5f*v.w;
+		}
+		for (int j = 0; j < nn; j++)
+			out[i+j] = vec2(x[j], y[j]);
+	}
+}
+
+inline bool InverseMatrix4x4(const float *m, float *out) {
+	// from https://gamesxmath.tumblr.com/post/86495837013/inverting-a-4x4-matrix-using-c-code-float
+	class Helper {
+	public:
+		int i = 0, j = 0;
+		const float *m = NULL;
+		float e(int a, int b, const float *m) {
+			return m[ (b%4)*4 + a%4 ];
+		}
+		float invf(int i,int j, const float *m) {
+			int o = 2+(j-i);
+			i += 4+o;
+			j += 4-o;
+			float inv =
+			 + e(i+1,j-1,m)*e(i+0,j+0,m)*e(i-1,j+1,m)
+			 + e(i+1,j+1,m)*e(i+0,j-1,m)*e(i-1,j+0,m)
+			 + e(i-1,j-1,m)*e(i+1,j+0,m)*e(i+0,j+1,m)
+			 - e(i-1,j-1,m)*e(i+0,j+0,m)*e(i+1,j+1,m)
+			 - e(i-1,j+1,m)*e(i+0,j-1,m)*e(i+1,j+0,m)
+			 - e(i+1,j-1,m)*e(i-1,j+0,m)*e(i+0,j+1,m);
+			return (o%2)? inv : -inv;
+			#undef e
+		}
+		bool invert(float *out) {
+			float inv[16];
+			for(int i = 0; i < 4; i++)
+				for(int j = 0; j < 4; j++)
+					inv[j*4+i] = invf(i,j,m);
+			double D = 0;
+			for (int k = 0; k < 4; k++)
+				D += (double) m[k]*inv[k*4];
+			if (D == 0)
+				return false;
+			D = 1.0/D;
+			for (int i = 0; i < 16; i++)
+				out[i] = (float) ((double) inv[i]*D);
+			return true;
+		}
+		Helper(const float *m = NULL) : m(m) { }
+	} h(m);
+	return h.invert(out);
+}
+
+inline mat4 Invert(mat4 m) {
+	// general inverse; identity if m is singular
+#ifdef VECMAT_SSE
+	// block-wise, from the 2x2 sub-matrices A, B (top) and C, D (bottom), each held row-major in
+	// one register: M-inverse = 1/|M| [X Y; Z W], with X = adj(|D|A-B adj(D)C), etc (after Eric Zhang)
+	// single precision throughout, whereas InverseMatrix4x4 divides by a double determinant
+	#define VECMAT_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+	#define VECMAT_SWIZZLE(a, x, y, z, w) _mm_shuffle_ps(a, a, _MM_SHUFFLE(w, z, y, x))
+	auto Mul = [](__m128 a, __m128 b) {			// a*b
+		return _mm_add_ps(_mm_mul_ps(a, VECMAT_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(VECMAT_SWIZZLE(a, 1, 0, 3, 2), VECMAT_SWIZZLE(b, 2, 1, 2, 1)));
+	};
+	auto AdjMul = [](__m128 a, __m128 b) {		// adj(a)*b
+		return _mm_sub_ps(_mm_mul_ps(VECMAT_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(VECMAT_SWIZZLE(a, 1, 1, 2, 2), VECMAT_SWIZZLE(b, 2, 3, 0, 1)));
+	};
+	auto MulAdj = [](__m128 a, __m128 b) {		// a*adj(b)
+		return _mm_sub_ps(_mm_mul_ps(a, VECMAT_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(VECMAT_SWIZZLE(a, 1, 0, 3, 2), VECMAT_SWIZZLE(b, 2, 1, 2, 1)));
+	};
+	__m128 r0 = _mm_loadu_ps(m[0]), r1 = _mm_loadu_ps(m[1]), r2 = _mm_loadu_ps(m[2]), r3 = _mm_loadu_ps(m[3]);
+	__m128 A = _mm_movelh_ps(r0, r1), B = _mm_movehl_ps(r1, r0), C = _mm_movelh_ps(r2, r3), D = _mm_movehl_ps(r3, r2);
+	// |A|, |B|, |C|, |D|
+	__m128 dets = _mm_sub_ps(_mm_mul_ps(VECMAT_SHUFFLE(r0, r2, 0, 2, 0, 2), VECMAT_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+							 _mm_mul_ps(VECMAT_SHUFFLE(r0, r2, 1, 3, 1, 3), VECMAT_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+	__m128 detA = VECMAT_SWIZZLE(dets, 0, 0, 0, 0), detB = VECMAT_SWIZZLE(dets, 1, 1, 1, 1);
+	__m128 detC = VECMAT_SWIZZLE(dets, 2, 2, 2, 2), detD = VECMAT_SWIZZLE(dets, 3, 3, 3, 3);
+	__m128 DC = AdjMul(D, C), AB = AdjMul(A, B);
+	__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mul(B, DC)), W = _mm_sub_ps(_mm_mul_ps(detA, D), Mul(C, AB));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), MulAdj(D, AB)), Z = _mm_sub_ps(_mm_mul_ps(detC, B), MulAdj(A, DC));
+	// |M| = |A||D|+|B||C|-trace(adj(A)B adj(D)C)
+	__m128 tr = _mm_mul_ps(AB, VECMAT_SWIZZLE(DC, 0, 2, 1, 3));
+	tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+	tr = _mm_add_ps(tr, VECMAT_SWIZZLE(tr, 1, 1, 1, 1));
+	__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), VECMAT_SWIZZLE(tr, 0, 0, 0, 0));
+	if (_mm_cvtss_f32(det) == 0)
+		return mat4();
+	__m128 s = _mm_div_ps(_mm_setr_ps(1, -1, -1, 1), det);
+	X = _mm_mul_ps(X, s); Y = _mm_mul_ps(Y, s); Z = _mm_mul_ps(Z, s); W = _mm_mul_ps(W, s);
+	mat4 inv;
+	_mm_storeu_ps(inv[0], VECMAT_SHUFFLE(X, Y, 3, 1, 3, 1));
+	_mm_storeu_ps(inv[1], VECMAT_SHUFFLE(X, Y, 2, 0, 2, 0));
+	_mm_storeu_ps(inv[2], VECMAT_SHUFFLE(Z, W, 3, 1, 3, 1));
+	_mm_storeu_ps(inv[3], VECMAT_SHUFFLE(Z, W, 2, 0, 2, 0));
+	#undef VECMAT_SHUFFLE
+	#undef VECMAT_SWIZZLE
+	return inv;
+#else
+	mat4 inv;
+	InverseMatrix4x4(&m[0][0], &inv[0][0]);
+	return inv;
+#endif
+}
+
+// Special inverses
+//     for matrices whose last row is 0, 0, 0, 1 (model, view and modelview matrices, but not persp)
+
+inline mat4 InvertRigid(const mat4 &m) {
+	// rotation and translation only: transpose the rotation, rotate and negate the translation
+	vec3 t(m[0].w, m[1].w, m[2].w);
+	vec3 r0(m[0].x, m[1].x, m[2].x), r1(m[0].y, m[1].y, m[2].y), r2(m[0].z, m[1].z, m[2].z);
+	return mat4(vec4(r0, -dot(r0, t)), vec4(r1, -dot(r1, t)), vec4(r2, -dot(r2, t)), vec4(0, 0, 0, 1));
+}
+
+inline mat3 NormalMatrix(const mat4 &m) {
+	// cofactor matrix of the upper 3x3 (its inverse transpose times its determinant), negated if the
+	// determinant is negative (else a reflection would flip every normal): transforms normals correctly
+	// under non-uniform scale and reflection, and exists even if m is singular; normalize the results
+	// (they are scaled by |determinant|)
+	vec3 c0(m[0].x, m[1].x, m[2].x), c1(m[0].y, m[1].y, m[2].y), c2(m[0].z, m[1].z, m[2].z);
+	vec3 x = cross(c1, c2), y = cross(c2, c0), z = cross(c0, c1);
+	if (dot(c0, x) < 0) {
+		x = -x; y = -y; z = -z;
+	}
+	return mat3(vec3(x.x, y.x, z.x), vec3(x.y, y.y, z.y), vec3(x.z, y.z, z.z));
+}
+
+inline mat4 InvertAffine(const mat4 &m) {
+	// any rotation, scale, shear and translation: inverse upper 3x3 from cofactors; identity if singular
+	vec3 c0(m[0].x, m[1].x, m[2].x), c1(m[0].y, m[1].y, m[2].y), c2(m[0].z, m[1].z, m[2].z);
+	vec3 x = cross(c1, c2), y = cross(c2, c0), z = cross(c0, c1);
+	float det = dot(c0, x);
+	if (det == 0)
+		return mat4();
+	float s = 1/det;
+	vec3 t(m[0].w, m[1].w, m[2].w);
+	x *= s; y *= s; z *= s;
+	return mat4(vec4(x, -dot(x, t)), vec4(y, -dot(y, t)), vec4(z, -dot(z, t)), vec4(0, 0, 0, 1));
+}
+
+// Derived matrix cache
+
+template <class M> struct MatrixCache {
+	// f(source), recomputed only if source differs from the last (eg, InvertAffine of a mesh transform)
+	mat4 source;
+	M value;
+	bool valid = false;
+	template <class F> const M &Get(const mat4 &m, F f) {
+		if (!valid || memcmp(&m, &source, sizeof(mat4))) {
+			source = m;
+			value = f(m);
+			valid = true;
+		}
+		return value;
+	}
+};
+
+#endif // VEC_MAT_HDR
+
+/* void Adjoint3x3(double in[][3], double out[][3]) {
+  out[0][0] =   in[1][1]*in[2][2]-in[1][2]*in[2][1];
+  out[1][0] = -(in[1][0]*in[2][2]-in[1][2]*in[2][0]);
+  out[2][0] =   in[1][0]*in[2][1]-in[1][1]*in[2][0];
+  out[0][1] = -(in[0][1]*in[2][2]-in[0][2]*in[2][1]);
+  out[1][1] =   in[0][0]*in[2][2]-in[0][2]*in[2][0];
+  out[2][1] = -(in[0][0]*in[2][1]-in[0][1]*in[2][0]);
+  out[0][2] =   in[0][1]*in[1][2]-in[0][2]*in[1][1];
+  out[1][2] = -(in[0][0]*in[1][2]-in[0][2]*in[1][0]);
+  out[2][2] =   in[0][0]*in[1][1]-in[0][1]*in[1][0];
+};
+
+bool Invert3x3(double in[][3], double out[][3]) {
+  Adjoint3x3(in, out);
+  double det = out[0][0]*in[0][0]+out[0][1]*in[1][0]+out[0][2]*in[2][0];
+  if (IsZero(det))
+	return false;
+  double di = 1.f/det;
+  out[0][0] = di*out[0][0];
+  out[0][1] = di*out[0][1];
+  out[0][2] = di*out[0][2];
+  out[1][0] = di*out[1][0];
+  out[1][1] = di*out[1][1];
+  out[1][2] = di*out[1][2];
+  out[2][0] = di*out[2][0];
+  out[2][1] = di*out[2][1];
+  out[2][2] = di*out[2][2];
+  return true;
+}; */
+
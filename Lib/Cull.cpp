@@ -0,0 +1,267 @@
+// Cull.cpp - frustum and occlusion culling of bounding boxes (c) 2019-2022 Jules Bloomenthal
+
+#include "Cull.h"
+#include <float.h>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULL_SSE
+#include <emmintrin.h>
+#endif
+
+// Frustum
+
+Frustum::Frustum(mat4 m) {
+	// row 3 plus or minus rows 0, 1, 2 (mat4 is row-major)
+	for (int i = 0; i < 3; i++) {
+		planes[2*i] = m[3]+m[i];
+		planes[2*i+1] = m[3]-m[i];
+	}
+	for (vec4 &p : planes) {
+		float len = length(vec3(p.x, p.y, p.z));
+		if (len > 0)
+			p = p/len;
+	}
+}
+
+bool Frustum::Outside(vec3 min, vec3 max) {
+	// test the box corner farthest along each plane normal
+	for (vec4 &p : planes)
+		if (p.x*(p.x > 0? max.x : min.x)+p.y*(p.y > 0? max.y : min.y)+p.z*(p.z > 0? max.z : min.z)+p.w < 0)
+			return true;
+	return false;
+}
+
+// Boxes
+
+void Boxes::Clear() {
+	for (vector<float> *v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ})
+		v->resize(0);
+}
+
+void Boxes::Add(vec3 min, vec3 max, mat4 *transform) {
+	if (transform)
+		TransformBox(*transform, min, max, min, max);
+	minX.push_back(min.x); minY.push_back(min.y); minZ.push_back(min.z);
+	maxX.push_back(max.x); maxY.push_back(max.y); maxZ.push_back(max.z);
+}
+
+void Boxes::Get(int i, vec3 &min, vec3 &max) {
+	min = vec3(minX[i], minY[i], minZ[i]);
+	max = vec3(maxX[i], maxY[i], maxZ[i]);
+}
+
+void SetMeshBoxes(vector<Mesh *> &meshes, Boxes &boxes) {
+	boxes.Clear();
+	for (Mesh *m : meshes) {
+		vec3 min, max;
+		MinMax(m->points.data(), (int) m->points.size(), min, max);
+		boxes.Add(min, max, &m->transform);
+	}
+}
+
+void SetGroupBoxes(Mesh &mesh, Boxes &boxes) {
+	boxes.Clear();
+	for (Group &g : mesh.triangleGroups) {
+		vec3 min(FLT_MAX, FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (int t = g.startTriangle; t < g.startTriangle+g.nTriangles; t++)
+			for (int k = 0; k < 3; k++) {
+				vec3 &p = mesh.points[mesh.triangles[t][k]];
+				for (int j = 0; j < 3; j++) {
+					min[j] = std::min(min[j], p[j]);
+					max[j] = std::max(max[j], p[j]);
+				}
+			}
+		if (!g.nTriangles)
+			min = max = vec3(0, 0, 0);
+		boxes.Add(min, max);
+	}
+}
+
+// Hierarchical depth buffer
+
+namespace {
+
+int Pixel(float f, int n) {
+	// screen coordinate to int, clamped in float (it may exceed the int range, or be NaN) to
+	// [-2, n+1], which stays outside pixels [0, n-1] after widening by a pixel
+	return f >= -2? (f <= n+1? (int) f : n+1) : -2;
+}
+
+} // end namespace
+
+void HiZBuffer::Resize(int w, int h) {
+	width = w;
+	height = h;
+	levels.resize(0);
+	for (int lw = w, lh = h; ; lw = (lw+1)/2, lh = (lh+1)/2) {
+		levels.push_back(vector<float>(lw*lh, 1.f));
+		if (lw == 1 && lh == 1)
+			break;
+	}
+}
+
+void HiZBuffer::Clear() {
+	for (vector<float> &l : levels)
+		std::fill(l.begin(), l.end(), 1.f);
+}
+
+void HiZBuffer::Rasterize(vector<vec3> &points, vector<int3> &triangles, mat4 fullview) {
+	// project points once, then scan convert with edge functions at pixel centers;
+	// normalized device z is affine in screen space, so it interpolates linearly
+	int nPoints = (int) points.size();
+	vector<vec3> screen(nPoints);
+	vector<char> clip(nPoints);
+	for (int i = 0; i < nPoints; i++) {
+		vec4 c = fullview*vec4(points[i], 1);
+		// bits: behind near plane, left, right, below, above, beyond far
+		clip[i] = (c.z < -c.w)|(c.x < -c.w)<<1|(c.x > c.w)<<2|(c.y < -c.w)<<3|(c.y > c.w)<<4|(c.z > c.w)<<5;
+		if (c.w > 0)
+			screen[i] = vec3((.5f*c.x/c.w+.5f)*width, (.5f*c.y/c.w+.5f)*height, c.z/c.w);
+	}
+	vector<float> &depth = levels[0];
+	for (int3 &t : triangles) {
+		int c1 = clip[t.i1], c2 = clip[t.i2], c3 = clip[t.i3];
+		if ((c1 | c2 | c3) & 1 || c1 & c2 & c3)
+			continue;
+		vec3 &a = screen[t.i1], &b = screen[t.i2], &c = screen[t.i3];
+		float area = (b.x-a.x)*(c.y-a.y)-(b.y-a.y)*(c.x-a.x);
+		if (area == 0)
+			continue;
+		int x0 = std::max(0, Pixel(floor(std::min({a.x, b.x, c.x})), width)), x1 = std::min(width-1, Pixel(ceil(std::max({a.x, b.x, c.x})), width));
+		int y0 = std::max(0, Pixel(floor(std::min({a.y, b.y, c.y})), height)), y1 = std::min(height-1, Pixel(ceil(std::max({a.y, b.y, c.y})), height));
+		for (int y = y0; y <= y1; y++) {
+			float py = y+.5f;
+			for (int x = x0; x <= x1; x++) {
+				float px = x+.5f;
+				float w1 = ((c.x-b.x)*(py-b.y)-(c.y-b.y)*(px-b.x))/area;
+				float w2 = ((a.x-c.x)*(py-c.y)-(a.y-c.y)*(px-c.x))/area;
+				float w3 = 1-w1-w2;
+				if (w1 < 0 || w2 < 0 || w3 < 0)
+					continue;
+				float z = w1*a.z+w2*b.z+w3*c.z;
+				float &d = depth[y*width+x];
+				d = z < d? z : d;
+			}
+		}
+	}
+}
+
+void HiZBuffer::Rasterize(Mesh &mesh, mat4 fullview) {
+	Rasterize(mesh.points, mesh.lods.size()? mesh.lods.back().triangles : mesh.triangles, fullview*mesh.transform);
+}
+
+void HiZBuffer::BuildPyramid() {
+	// each texel holds the farthest depth of the (up to four) texels it covers
+	for (int l = 1, w = width, h = height; l < (int) levels.size(); l++) {
+		int lw = (w+1)/2, lh = (h+1)/2;
+		vector<float> &src = levels[l-1], &dst = levels[l];
+		for (int y = 0; y < lh; y++)
+			for (int x = 0; x < lw; x++) {
+				int sx = 2*x, sy = 2*y, sx1 = std::min(sx+1, w-1), sy1 = std::min(sy+1, h-1);
+				dst[y*lw+x] = std::max(std::max(src[sy*w+sx], src[sy*w+sx1]), std::max(src[sy1*w+sx], src[sy1*w+sx1]));
+			}
+		w = lw;
+		h = lh;
+	}
+}
+
+bool HiZBuffer::Visible(vec3 min, vec3 max, mat4 fullview) {
+	// compare nearest depth of box with farthest occluder depth over the box's screen rectangle,
+	// at the pyramid level where the rectangle spans at most a few texels
+	float x0 = FLT_MAX, y0 = FLT_MAX, x1 = -FLT_MAX, y1 = -FLT_MAX, zNear = FLT_MAX;
+	for (int i = 0; i < 8; i++) {
+		vec4 c = fullview*vec4(i&1? max.x : min.x, i&2? max.y : min.y, i&4? max.z : min.z, 1);
+		if (c.z < -c.w)
+			return true;						// box crosses near plane
+		float x = (.5f*c.x/c.w+.5f)*width, y = (.5f*c.y/c.w+.5f)*height;
+		x0 = std::min(x0, x); x1 = std::max(x1, x);
+		y0 = std::min(y0, y); y1 = std::max(y1, y);
+		zNear = std::min(zNear, c.z/c.w);
+	}
+	// occluders cover pixels whose centers they contain, so widen rectangle by a pixel to include
+	// the uncovered pixel beyond any occluder edge that the box extends past
+	int ix0 = std::max(0, Pixel(floor(x0), width)-1), ix1 = std::min(width-1, Pixel(floor(x1), width)+1);
+	int iy0 = std::max(0, Pixel(floor(y0), height)-1), iy1 = std::min(height-1, Pixel(floor(y1), height)+1);
+	if (ix0 > ix1 || iy0 > iy1)
+		return true;							// off-screen: leave to frustum test
+	int level = 0, w = width;
+	while (level+1 < (int) levels.size() && std::max(ix1-ix0, iy1-iy0) > 3) {
+		ix0 /= 2; ix1 /= 2; iy0 /= 2; iy1 /= 2;
+		w = (w+1)/2;
+		level++;
+	}
+	vector<float> &depth = levels[level];
+	for (int y = iy0; y <= iy1; y++)
+		for (int x = ix0; x <= ix1; x++)
+			if (zNear <= depth[y*w+x])
+				return true;
+	return false;
+}
+
+// Culling
+
+int CullBoxes(Frustum &frustum, Boxes &boxes, vector<int> &visible, HiZBuffer *hiz, mat4 *fullview) {
+	// for each plane, the box corner farthest along the normal selects min or max per axis
+	int n = boxes.Size(), i = 0;
+	const float *sel[6][3];
+	for (int p = 0; p < 6; p++) {
+		vec4 &pl = frustum.planes[p];
+		sel[p][0] = pl.x > 0? boxes.maxX.data() : boxes.minX.data();
+		sel[p][1] = pl.y > 0? boxes.maxY.data() : boxes.minY.data();
+		sel[p][2] = pl.z > 0? boxes.maxZ.data() : boxes.minZ.data();
+	}
+	visible.resize(0);
+#ifdef CULL_SSE
+	__m128 zero = _mm_setzero_ps();
+	for (; i+4 <= n; i += 4) {
+		__m128 outside = zero;
+		for (int p = 0; p < 6; p++) {
+			vec4 &pl = frustum.planes[p];
+			// summed in the order of the scalar test, so results agree exactly
+			__m128 d = _mm_mul_ps(_mm_set1_ps(pl.x), _mm_loadu_ps(sel[p][0]+i));
+			d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(pl.y), _mm_loadu_ps(sel[p][1]+i)));
+			d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(pl.z), _mm_loadu_ps(sel[p][2]+i)));
+			d = _mm_add_ps(d, _mm_set1_ps(pl.w));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(d, zero));
+		}
+		int mask = _mm_movemask_ps(outside);
+		for (int k = 0; k < 4; k++)
+			if (!(mask & 1 << k))
+				visible.push_back(i+k);
+	}
+#endif
+	for (; i < n; i++) {
+		bool outside = false;
+		for (int p = 0; p < 6 && !outside; p++) {
+			vec4 &pl = frustum.planes[p];
+			outside = pl.x*sel[p][0][i]+pl.y*sel[p][1][i]+pl.z*sel[p][2][i]+pl.w < 0;
+		}
+		if (!outside)
+			visible.push_back(i);
+	}
+	if (hiz && fullview) {
+		int nVisible = 0;
+		for (int v : visible) {
+			vec3 min, max;
+			boxes.Get(v, min, max);
+			if (hiz->Visible(min, max, *fullview))
+				visible[nVisible++] = v;
+		}
+		visible.resize(nVisible);
+	}
+	return (int) visible.size();
+}
+
+int CullMeshes(CameraAB &camera, Boxes &meshBoxes, vector<int> &visible, HiZBuffer *hiz) {
+	mat4 fullview = camera.persp*camera.modelview;
+	Frustum frustum(fullview);
+	return CullBoxes(frustum, meshBoxes, visible, hiz, &fullview);
+}
+
+int CullGroups(CameraAB &camera, Mesh &mesh, Boxes &groupBoxes, vector<int> &visible, HiZBuffer *hiz) {
+	// cull object space boxes against object space frustum
+	mat4 fullview = camera.persp*camera.modelview*mesh.transform;
+	Frustum frustum(fullview);
+	return CullBoxes(frustum, groupBoxes, visible, hiz, &fullview);
+}
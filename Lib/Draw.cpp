@@ -1,667 +1,847 @@
-// Draw.cpp - various draw operations (c) 2019-2022 Jules Bloomenthal
-
-#include <glad.h>
-#include <gl/glu.h>
-#include "Draw.h"
-#include "GLXtras.h"
-#include "Misc.h"
-#include <float.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <vector>
-
-// Screen Mode
-
-void GetViewportSize(int &width, int &height) {
-	int vp[4];
-	glGetIntegerv(GL_VIEWPORT, vp);
-	width = vp[2];
-	height = vp[3];
-}
-
-vec4 VP() {
-	vec4 vp;
-	glGetFloatv(GL_VIEWPORT, (float *) &vp);
-	return vp;
-}
-
-int VPw() {
-	vec4 vp = VP();
-	return (int) vp[2];
-}
-
-int VPh() {
-	vec4 vp = VP();
-	return (int) vp[3];
-}
-
-mat4 Viewport() {
-	// map +/-1 space to screen space viewport
-	float vp[4];
-	glGetFloatv(GL_VIEWPORT, vp);
-	float x = vp[0], y = vp[1], w = vp[2], h = vp[3];
-	return mat4(vec4(w/2,0,0,x+w/2), vec4(0,h/2,0,y+h/2), vec4(0,0,1,0), vec4(0,0,0,1));
-}
-
-mat4 ScreenMode() {
-	// map pixel space (xorigin, yorigin)-(xorigin+width,yorigin+height) to NDC (clip) space (-1,-1)-(1,1)
-	float vp[4];
-	glGetFloatv(GL_VIEWPORT, vp);
-	float x = vp[0], y = vp[1], w = vp[2], h = vp[3];
-	return Translate(-1, -1, 0)*Scale(2/w, 2/h, 1)*Translate(-x, -y, 0);
-}
-
-vec2 ScreenPoint(vec3 p, mat4 m, float *zscreen) {
-	int vp[4];
-	glGetIntegerv(GL_VIEWPORT, vp);
-	vec4 xp = m*vec4(p, 1);
-	if (zscreen)
-		*zscreen = xp.z; // /xp.w;
-	return vec2(vp[0]+((xp.x/xp.w)+1)*.5f*(float)vp[2], vp[1]+((xp.y/xp.w)+1)*.5f*(float)vp[3]);
-}
-
-bool IsVisible(vec3 p, mat4 fullview, vec2 *screenA, int *w, int *h, float fudge) {
-	int width, height;
-	if (w && h) {
-		width = *w;
-		height = *h;
-	}
-	else
-		GetViewportSize(width, height);
-	vec4 xp = fullview*vec4(p, 1);
-	vec2 clip(xp.x/xp.w, xp.y/xp.w);    // clip space, +/-1
-	vec2 screen(((float) width/2.f)*(1.f+clip.x), ((float) height/2.f)*(1.f+clip.y));
-	if (screenA)
-		*screenA = screen;
-	float z = xp.z/xp.w, zScreen;
-	glReadPixels((int)screen.x, (int)screen.y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &zScreen);
-		// **** this is slow when used during rendering!
-	zScreen = 2*zScreen-1; // seems to work (clip range +/-1 but zbuffer range 0-1)
-	return z < zScreen+fudge;
-}
-
-bool DepthXY(int x, int y, float &depth) {
-	if (glIsEnabled(GL_DEPTH_TEST)) {
-		float v, depthRange[2]; // depthRange maps to window coordinates +/-1
-		glGetFloatv(GL_DEPTH_RANGE, depthRange);
-		glReadPixels(x, y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &v);
-		depth = -1+2*(v-depthRange[0])/(depthRange[1]-depthRange[0]);
-		return true;
-	}
-	depth = 0;
-	return false;
-}
-
-float ScreenDSq(double x, double y, vec3 p, mat4 m, float *zscreen, bool invertVertical) {
-	// y presumed in original mouse/screen space (increasing y is downwards)
-	vec2 screen = ScreenPoint(p, m, zscreen);
-	if (invertVertical) y = VPh()-y;
-	double dx = x-screen.x, dy = y-screen.y;
-	return (float) (dx*dx+dy*dy);
-}
-
-float ScreenDSq(int x, int y, vec3 p, mat4 m, float *zscreen, bool invertVertical) {
-	return ScreenDSq((double) x, (double) y, p, m, zscreen, invertVertical);
-}
-
-void ScreenRay(float xscreen, float yscreen, mat4 modelview, mat4 persp, vec3 &p, vec3 &v) {
-	// compute ray from p in direction v; p is transformed eyepoint, xscreen, yscreen determine v
-	int vp[4];
-	glGetIntegerv(GL_VIEWPORT, vp);
-	// origin of ray is always eye (translated origin)
-	p = vec3(modelview[0][3], modelview[1][3], modelview[2][3]);
-	// create transposes for gluUnproject
-	double tpersp[4][4], tmodelview[4][4], a[3], b[3];
-	for (int i = 0; i < 4; i++)
-		for (int j = 0; j < 4; j++) {
-			tmodelview[i][j] = modelview[j][i];
-			tpersp[i][j] = persp[j][i];
-		}
-	// un-project two screen points of differing depth to determine v
-	if (gluUnProject(xscreen, yscreen, .25, (const double*) tmodelview, (const double*) tpersp, vp, &a[0], &a[1], &a[2]) == GL_FALSE)
-		printf("UnProject false\n");
-	if (gluUnProject(xscreen, yscreen, .50, (const double*) tmodelview, (const double*) tpersp, vp, &b[0], &b[1], &b[2]) == GL_FALSE)
-		printf("UnProject false\n");
-	v = normalize(vec3((float) (b[0]-a[0]), (float) (b[1]-a[1]), (float) (b[2]-a[2])));
-}
-
-void ScreenLine(float xscreen, float yscreen, mat4 modelview, mat4 persp, vec3 &p1, vec3 &p2) {
-	// compute 3D world space line, given by p1 and p2, that transforms
-	// to a line perpendicular to the screen at (xscreen, yscreen)
-	double tpersp[4][4], tmodelview[4][4], a[3], b[3];
-	// get viewport
-	int vp[4];
-	glGetIntegerv(GL_VIEWPORT, vp);
-	// create transposes
-	for (int i = 0; i < 4; i++)
-		for (int j = 0; j < 4; j++) {
-			tmodelview[i][j] = modelview[j][i];
-			tpersp[i][j] = persp[j][i];
-		}
-	if (gluUnProject(xscreen, yscreen, .25, (const double*) tmodelview, (const double*) tpersp, vp, &a[0], &a[1], &a[2]) == GL_FALSE)
-		printf("UnProject false\n");
-	if (gluUnProject(xscreen, yscreen, .50, (const double*) tmodelview, (const double*) tpersp, vp, &b[0], &b[1], &b[2]) == GL_FALSE)
-		printf("UnProject false\n");
-		// alternatively, a second point can be determined by transforming the origin by the inverse of modelview
-		// this would yield in world space the camera location, through which all view lines pass
-	p1 = vec3(static_cast<float>(a[0]), static_cast<float>(a[1]), static_cast<float>(a[2]));
-	p2 = vec3(static_cast<float>(b[0]), static_cast<float>(b[1]), static_cast<float>(b[2]));
-}
-
-bool FrontFacing(vec3 base, vec3 vec, mat4 view) {
-	vec4 xbase = view*vec4(base, 1), xhead = view*vec4(base+.1f*vec, 1);
-	vec3 xb(xbase.x, xbase.y, xbase.z), xh(xhead.x, xhead.y, xhead.z), xv(xh-xb);
-	return dot(xb, xv) < 0;
-}
-
-// double ScreenZ(vec3 p, mat4 m) {
-//	return (m*vec4(p, 1)).z;
-// }
-
-// bool FrontFacing(vec3 base, vec3 vec, mat4 view) {
-//	return ScreenZ(base, view) >= ScreenZ(base+vec, view);
-// }
-
-// Draw Shader
-
-int drawShader = 0;
-
-const char *drawVShader = R"(
-	#version 130
-	in vec3 position;
-	in vec3 color;
-	out vec3 vColor;
-	uniform mat4 view;
-	void main() {
-		gl_Position = view*vec4(position, 1);
-		vColor = color;
-	}
-)";
-
-const char *drawPShader = R"(
-	#version 130
-	in vec3 vColor;
-	out vec4 pColor;
-	uniform float opacity = 1;
-	uniform bool fadeToCenter = false;
-	uniform bool ring = false;
-	float Fade(float t) {
-		if (t < .95) return 1;
-		if (t > 1.05) return 0;
-		float a = (t-.95)/(1.05-.95);
-		return 1-smoothstep(0, 1, a);
-			// does smoothstep help?
-	}
-	float Ring(float t) {
-		if (t < .7) return 0;
-		if (t > .9) return 1;
-		float a = (t-.7)/(.9-.7);
-		return smoothstep(0, 1, a);
-	}
-	float DistanceToCenter() {
-		// gl_PointCoord wrt point primitive size
-		float dx = 1-2*gl_PointCoord.x;
-		float dy = 1-2*gl_PointCoord.y;
-		return sqrt(dx*dx+dy*dy);
-	  }
-	void main() {
-		// GL_POINT_SMOOTH deprecated, so calc here
-		// needs GL_POINT_SPRITE or 0x8861 enabled
-		float o = opacity;
-		if (fadeToCenter)
-			o *= Fade(DistanceToCenter());
-		if (ring)
-			o *= Ring(DistanceToCenter());
-		pColor = vec4(vColor, o);
-	}
-)";
-
-int UseDrawShader() {
-	int was = 0;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &was);
-	bool init = !drawShader;
-	if (init)
-		drawShader = LinkProgramViaCode(&drawVShader, &drawPShader);
-	glUseProgram(drawShader);
-	if (init)
-		SetUniform(drawShader, "view", mat4());
-	return was;
-}
-
-int UseDrawShader(mat4 viewMatrix) {
-	int was = UseDrawShader();
-	SetUniform(drawShader, "view", viewMatrix);
-	return was;
-}
-
-// Disks
-
-GLuint diskBuffer = -1;
-
-void Disk(vec2 p, float diameter, vec3 color, float opacity, bool ring) {
-	Disk(vec3(p), diameter, color, opacity, ring);
-}
-
-void Disk(vec3 p, float diameter, vec3 color, float opacity, bool ring) {
-	// diameter should be >= 0, <= 20
-	UseDrawShader();
-	// create buffer for single vertex (x,y,z,r,g,b)
-	if (diskBuffer < 0) {
-		glGenBuffers(1, &diskBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, diskBuffer);
-		int bufferSize = 6*sizeof(float);
-		glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STATIC_DRAW);
-	}
-	glBindBuffer(GL_ARRAY_BUFFER, diskBuffer); // set active buffer
-	// allocate buffer memory and load location and color data
-	glBufferData(GL_ARRAY_BUFFER, 6*sizeof(float), NULL, GL_STATIC_DRAW); // *** needed??
-	glBufferSubData(GL_ARRAY_BUFFER, 0, 3*sizeof(float), &p.x);
-	glBufferSubData(GL_ARRAY_BUFFER, 3*sizeof(float), 3*sizeof(float), &color.x);
-	// connect shader inputs
-	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
-	VertexAttribPointer(drawShader, "color", 3, 0, (void *) sizeof(vec3));
-	// draw
-	SetUniform(drawShader, "opacity", opacity);
-	SetUniform(drawShader, "ring", ring);
-	glPointSize(diameter);
-#ifdef GL_POINT_SMOOTH
-	glEnable(GL_POINT_SMOOTH);
-#endif
-#if !defined(GL_POINT_SMOOTH) && defined(GL_POINT_SPRITE)
-	glEnable(GL_POINT_SPRITE);
-#endif
-#if !defined(GL_POINT_SMOOTH) && !defined(GL_POINT_SPRITE)
-	glEnable(0x8861); // same as GL_POINT_SMOOTH [this is a 4.5 core bug]
-	SetUniform(drawShader, "fadeToCenter", 1); // needed if GL_POINT_SMOOTH and GL_POINT_SPRITE fail
-#endif
-	glDrawArrays(GL_POINTS, 0, 1);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
-
-// Lines
-
-GLuint lineBuffer = -1;
-
-void Line(vec3 p1, vec3 p2, float width, vec3 col1, vec3 col2, float opacity) {
-	UseDrawShader();
-	// create a vertex buffer for the array
-	vec3 data[] = {p1, p2, col1, col2};
-	if (lineBuffer <= 0)
-		glGenBuffers(1, &lineBuffer);
-	// set active vertex buffer, load location and color data
-	glBindBuffer(GL_ARRAY_BUFFER, lineBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
-	// connect shader inputs, set uniforms
-	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
-	VertexAttribPointer(drawShader, "color", 3, 0, (void *) (2*sizeof(vec3)));
-	SetUniform(drawShader, "fadeToCenter", 0);  // gl_PointCoord fails for lines (instead, use GL_LINE_SMOOTH)
-	SetUniform(drawShader, "opacity", opacity);
-	// draw
-	glLineWidth(width);
-	glDrawArrays(GL_LINES, 0, 2);
-	// cleanup
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
-
-void Line(vec3 p1, vec3 p2, float width, vec3 col, float opacity) {
-	Line(p1, p2, width, col, col, opacity);
-}
-
-void Line(vec2 p1, vec2 p2, float width, vec3 col1, vec3 col2, float opacity) {
-	vec3 pp1(p1, 0), pp2(p2, 0);
-	Line(pp1, pp2, width, col1, col2, opacity);
-}
-
-void Line(vec2 p1, vec2 p2, float width, vec3 col, float opacity) {
-	Line(p1, p2, width, col, col, opacity);
-}
-
-void Line(int x1, int y1, int x2, int y2, float width, vec3 col, float opacity) {
-	vec3 p1((float) x1, (float) y1, 0), p2((float) x2, (float) y2, 0);
-	Line(p1, p2, width, col, col, opacity);
-}
-
-// LineDash and LineDot are messed up
-
-void LineDash(vec3 p1, vec3 p2, mat4 view, float width, vec3 col1, vec3 col2, float opacity) {
-	UseDrawShader(view);
-	float totalLen = length(ScreenPoint(p2, view)-ScreenPoint(p1, view));
-//	float dashLen = 10; // in pixels
-	float nDashes = totalLen/20;
-	vec3 dash = .5f*(p2-p1)/nDashes;
-	for (int i = 0; i < (int) nDashes; i++) {
-		vec3 start = p1+(float)i*2*dash;
-		Line(start, start+dash, width, col1, col2, opacity);
-	}
-}
-
-void LineDot(vec3 p1, vec3 p2, mat4 view, float width, vec3 col, float opacity) {
-	int pixelSpacing = 7;
-	UseDrawShader(view);
-	float totalLen = length(ScreenPoint(p2, view)-ScreenPoint(p1, view));
-	int nDots = (int) (totalLen/(float)pixelSpacing);
-	vec3 d = .5f*(p2-p1)/(float)nDots;
-	for (int i = 0; i < nDots; i++) {
-		vec3 p = p1+(float)i*d;
-		Disk(p, 4, col);
-	}
-}
-
-GLuint lineStripBuffer = 0;
-
-void LineStrip(int nPoints, vec3 *points, vec3 &color, float opacity, float width) {
-	if (!lineStripBuffer)
-		glGenBuffers(1, &lineStripBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, lineStripBuffer);
-	int pSize = nPoints*sizeof(vec3);
-	std::vector<vec3> colors(nPoints, color);
-	glBufferData(GL_ARRAY_BUFFER, 2*pSize, NULL, GL_STATIC_DRAW);
-	glBufferSubData(GL_ARRAY_BUFFER, 0, pSize, points);
-	glBufferSubData(GL_ARRAY_BUFFER, pSize, pSize, &colors[0]);
-	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
-	VertexAttribPointer(drawShader, "color", 3, 0, (void *) pSize);
-	SetUniform(drawShader, "fadeToCenter", 0);
-	SetUniform(drawShader, "opacity", opacity);
-	glLineWidth(width);
-	glDrawArrays(GL_LINE_STRIP, 0, nPoints);
-}
-
-// Quads
-
-GLuint quadBuffer = 0;
-
-void Quad(vec3 p1, vec3 p2, vec3 p3, vec3 p4, bool solid, vec3 col, float opacity, float lineWidth) {
-#ifndef GL_QUADS
-	Triangle(p1, p2, p3, col, col, col, opacity, !solid, col, lineWidth);
-	Triangle(p1, p3, p4, col, col, col, opacity, !solid, col, lineWidth);
-#else
-	vec3 data[] = { p1, p2, p3, p4, col, col, col, col };
-	UseDrawShader();
-	if (quadBuffer == 0) {
-		glGenBuffers(1, &quadBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(data), NULL, GL_STATIC_DRAW);
-	}
-	glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
-	VertexAttribPointer(drawShader, "position", 3, 0, (void *) 0);
-	VertexAttribPointer(drawShader, "color", 3, 0, (void *) (4*sizeof(vec3)));
-	SetUniform(drawShader, "opacity", opacity);
-	SetUniform(drawShader, "fadeToCenter", 0);
-	glLineWidth(lineWidth);
-	glDrawArrays(solid? GL_QUADS : GL_LINE_LOOP, 0, 4);
-#endif
-}
-
-void Quad(int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, bool solid, vec3 color, float opacity, float lineWidth) {
-	Quad(vec3((float)x1,(float)y1,0), vec3((float)x2,(float)y2,0), vec3((float)x3,(float)y3,0), vec3((float)x4,(float)y4,0), solid, color, opacity, lineWidth);
-}
-
-// Star
-
-void Star(vec3 p, float size, vec3 color, mat4 fullview) {
-	vec2 s = ScreenPoint(p, fullview);
-	UseDrawShader(ScreenMode());
-	Disk(s, size, color);
-	for (int i = 0, nRays = 8; i < nRays; i++) {
-		float a = 3.1415f*(float)i/nRays;
-		float r1 = 1.02f*size, r2 = size*(i%2? 2.1f : 2.8f), w = i%2? 1 : 1.75f;
-		vec2 d(cos(a), sin(a));
-		Line(s+r1*d, s+r2*d, w, color);
-		Line(s-r1*d, s-r2*d, w, color);
-	}
-}
-
-// Arrows
-
-void Arrow(vec2 base, vec2 head, vec3 col, float lineWidth, double headSize) {
-	Line(base, head, lineWidth, col);
-	if (headSize > 0) {
-		vec2 v1 = (float)headSize*normalize(head-base), v2(v1.y/2.f, -v1.x/2.f);
-		vec2 head1(head-v1+v2), head2(head-v1-v2);
-		Line(head, head1, lineWidth, col);
-		Line(head, head2, lineWidth, col);
-	}
-}
-
-vec3 ProjectToLine(vec3 p, vec3 p1, vec3 p2) {
-	// project p to line p1p2
-	vec3 delta(p2-p1);
-	float magSq = dot(delta, delta);
-	float alpha = magSq > FLT_EPSILON? dot(delta, p-p1)/magSq : 0;
-	return p1+alpha*delta;
-}
-
-void PointScreen(vec3 p, vec2 s, mat4 modelview, mat4 persp, float lineWidth, vec3 col) {
-	// draw between p and the nearest point on a 3D screen line through s
-	vec3 p1, p2;
-	ScreenLine(s.x, s.y, modelview, persp, p1, p2);
-	vec3 pp = ProjectToLine(p, vec3(p1), vec3(p2));
-	Line(p, pp, lineWidth, col);
-}
-
-void ArrowV(vec3 base, vec3 v, mat4 modelview, mat4 persp, vec3 col, float lineWidth, double headSize) {
-	mat4 m = persp*modelview;
-	vec3 head(base+v);
-	float zbase, zhead;
-	vec2 base2 = ScreenPoint(base, m, &zbase), head2 = ScreenPoint(head, m, &zhead);
-	vec2 v1 = (float)headSize*normalize(head2-base2), v2(v1.y/2.f, -v1.x/2.f);
-	vec2 h1(head2-v1+v2), h2(head2-v1-v2);
-//	col = zbase > zhead? vec3(0,1,0) : vec3(0,0,1);
-	// could draw in screen mode, using base2, head2, h1, & h2, but prefer draw in 3D (allows for depth test)
-	UseDrawShader(m);
-	Line(base, head, lineWidth, col);
-	PointScreen(head, h1, modelview, persp, lineWidth, col);
-	PointScreen(head, h2, modelview, persp, lineWidth, col);
-}
-
-// Cylinders
-
-GLuint cylinderShader = 0;
-
-void Cylinder(vec3 p1, vec3 p2, float r1, float r2, mat4 modelview, mat4 persp, vec4 color) {
-	const char *vShader = "void main() { gl_Position = vec4(0); }";
-	const char *tcShader = R"(
-		#version 400 core
-		layout (vertices = 4) out;
-		void main() {
-			if (gl_InvocationID == 0) {
-				gl_TessLevelOuter[0] = gl_TessLevelOuter[2] = 1;
-				gl_TessLevelOuter[1] = gl_TessLevelOuter[3] = 24;
-				gl_TessLevelInner[0] = gl_TessLevelInner[1] = 24;
-			}
-		}
-	)";
-	const char *teShader = R"(
-		#version 400 core
-		layout (quads, equal_spacing, ccw) in;
-		uniform vec3 p1;
-		uniform vec3 p2;
-		uniform float r1;
-		uniform float r2;
-		uniform mat4 modelview;
-		uniform mat4 persp;
-		out vec3 tePoint;
-		out vec3 teNormal;
-		void main() {
-			vec2 uv = gl_TessCoord.st;
-			float c = cos(2*3.1415*uv.s), s = sin(2*3.1415*uv.s);
-			vec3 dp = p2-p1;
-			vec3 crosser = dp.x < dp.y? (dp.x < dp.z? vec3(1,0,0) : vec3(0,0,1)) : (dp.y < dp.z? vec3(0,1,0) : vec3(0,0,1));
-			vec3 xcross = normalize(cross(crosser, dp));
-			vec3 ycross = normalize(cross(xcross, dp));
-			vec3 n = c*xcross+s*ycross;
-			vec3 p = mix(p1, p2, uv.t)+mix(r1, r2, uv.t)*n;
-			tePoint = (modelview*vec4(p, 1)).xyz;
-			teNormal = (modelview*vec4(n, 0)).xyz;
-			gl_Position = persp*vec4(tePoint, 1);
-		}
-	)";
-	const char *pShader = R"(
-		#version 130
-		in vec3 tePoint;
-		in vec3 teNormal;
-		out vec4 pColor;
-		uniform vec4 color;
-		uniform vec3 light;
-		void main() {
-			vec3 N = normalize(teNormal);      // surface normal
-			vec3 L = normalize(light-tePoint); // light vector
-			vec3 E = normalize(tePoint);       // eye vector
-			vec3 R = reflect(L, N);            // highlight vector
-			float d = abs(dot(N, L));          // two-sided diffuse
-			float s = abs(dot(R, E));          // two-sided specular
-			float intensity = clamp(d+pow(s, 50), 0, 1);
-			pColor = intensity*color;
-		}
-	)";
-	if (!cylinderShader)
-		cylinderShader = LinkProgramViaCode(&vShader, &tcShader, &teShader, NULL, &pShader);
-	//	cylinderShader = LinkProgramViaCode(&vShader, NULL, &teShader, NULL, &pShader);
-	glUseProgram(cylinderShader);
-	SetUniform(cylinderShader, "modelview", modelview);
-	SetUniform(cylinderShader, "persp", persp);
-	SetUniform(cylinderShader, "color", color);
-	SetUniform(cylinderShader, "p1", p1);
-	SetUniform(cylinderShader, "p2", p2);
-	SetUniform(cylinderShader, "r1", r1);
-	SetUniform(cylinderShader, "r2", r2);
-	// float r = 24, outerLevels[] = {1, r, 1, r}, innerLevels[] = {r, r};
-	// glPatchParameteri(GL_PATCH_VERTICES, 4);
-	// glPatchParameterfv(GL_PATCH_DEFAULT_OUTER_LEVEL, outerLevels);
-	// glPatchParameterfv(GL_PATCH_DEFAULT_INNER_LEVEL, innerLevels);
-#ifdef GL_PATCHES
-	glDrawArrays(GL_PATCHES, 0, 4);
-#endif
-}
-
-// Triangles with optional outline
-
-GLuint triShader = 0, triBuffer = 0;
-
-// vertex shader
-const char *triVShaderCode = R"(
-	#version 330 core
-	in vec3 point;
-	in vec3 color;
-	out vec3 vColor;
-	uniform mat4 view;
-	void main() {
-		gl_Position = view*vec4(point, 1);
-		vColor = color;
-	}
-)";
-
-// geometry shader with line-drawing
-const char *triGShaderCode = R"(
-	#version 330 core
-	layout (triangles) in;
-	layout (triangle_strip, max_vertices = 3) out;
-	in vec3 vPoint[];
-	in vec3 vColor[];
-	out vec3 gColor;
-	noperspective out vec3 gEdgeDistance;
-	uniform mat4 viewptM;
-	vec3 ViewPoint(int i) {
-		return vec3(viewptM*(gl_in[i].gl_Position/gl_in[i].gl_Position.w));
-	}
-	void main() {
-		float ha = 0, hb = 0, hc = 0;
-		// transform each vertex into viewport space
-		vec3 p0 = ViewPoint(0), p1 = ViewPoint(1), p2 = ViewPoint(2);
-		// find altitudes ha, hb, hc
-		float a = length(p2-p1), b = length(p2-p0), c = length(p1-p0);
-		float alpha = acos((b*b+c*c-a*a)/(2.*b*c));
-		float beta = acos((a*a+c*c-b*b)/(2.*a*c));
-		ha = abs(c*sin(beta));
-		hb = abs(c*sin(alpha));
-		hc = abs(b*sin(alpha));
-		// send triangle vertices and edge distances
-		for (int i = 0; i < 3; i++) {
-		    gEdgeDistance = i==0? vec3(ha, 0, 0) : i==1? vec3(0, hb, 0) : vec3(0, 0, hc);
-			gColor = vColor[i];
-			gl_Position = gl_in[i].gl_Position;
-			EmitVertex();
-		}
-		EndPrimitive();
-	}
-)";
-
-// pixel shader
-const char *triPShaderCode = R"(
-	#version 410 core
-	in vec3 gColor;
-	noperspective in vec3 gEdgeDistance;
-	uniform vec4 outlineColor = vec4(0, 0, 0, 1);
-	uniform float opacity = 1;
-	uniform float outlineWidth = 1;
-	uniform float transition = 1;
-	uniform int outlineOn = 1;
-	out vec4 pColor;
-	void main() {
-		pColor = vec4(gColor, opacity);
-		if (outlineOn > 0) {
-			float minDist = min(gEdgeDistance.x, min(gEdgeDistance.y, gEdgeDistance.z));
-			float t = smoothstep(outlineWidth-transition, outlineWidth+transition, minDist);
-			if (outlineOn == 2) pColor = vec4(1,1,1,1);
-			pColor = mix(outlineColor, pColor, t);
-		}
-	}
-)";
-
- void UseTriangleShader() {
-	bool init = triShader == 0;
-	if (init)
-		triShader = LinkProgramViaCode(&triVShaderCode, NULL, NULL, &triGShaderCode, &triPShaderCode);
-	glUseProgram(triShader);
-	if (init)
-		SetUniform(triShader, "view", mat4());
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_LINE_SMOOTH);
-}
-
-void UseTriangleShader(mat4 view) {
-	UseTriangleShader();
-	SetUniform(triShader, "view", view);
-}
-
-void Triangle(vec3 p1, vec3 p2, vec3 p3, vec3 c1, vec3 c2, vec3 c3,
-			  float opacity, bool outline, vec4 outlineCol, float outlineWidth, float transition) {
-	vec3 data[] = { p1, p2, p3, c1, c2, c3 };
-	UseTriangleShader();
-	if (triBuffer == 0)
-		glGenBuffers(1, &triBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, triBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
-	VertexAttribPointer(triShader, "point", 3, 0, (void *) 0);
-	VertexAttribPointer(triShader, "color", 3, 0, (void *) (3*sizeof(vec3)));
-	SetUniform(triShader, "viewptM", Viewport()); // **** ????
-	SetUniform(triShader, "opacity", opacity);
-	SetUniform(triShader, "outlineOn", outline? 1 : 0);
-	SetUniform(triShader, "outlineColor", outlineCol);
-	SetUniform(triShader, "outlineWidth", outlineWidth);
-	SetUniform(triShader, "transition", transition);
-	glDrawArrays(GL_TRIANGLES, 0, 3);
-}
-
-// Boxes
-
-void Box(vec3 a, vec3 b, float width, vec3 col) {
-	float x1=a.x, x2=b.x, y1=a.y, y2=b.y, z1=a.z, z2=b.z;
-	// left-right
-	Line(vec3(x1,y1,z1), vec3(x2,y1,z1), width, col);
-	Line(vec3(x1,y2,z1), vec3(x2,y2,z1), width, col);
-	Line(vec3(x1,y1,z2), vec3(x2,y1,z2), width, col);
-	Line(vec3(x1,y2,z2), vec3(x2,y2,z2), width, col);
-	// bottom-top
-	Line(vec3(x1,y1,z1), vec3(x1,y2,z1), width, col);
-	Line(vec3(x1,y1,z2), vec3(x1,y2,z2), width, col);
-	Line(vec3(x2,y1,z1), vec3(x2,y2,z1), width, col);
-	Line(vec3(x2,y1,z2), vec3(x2,y2,z2), width, col);
-	// near-far
-	Line(vec3(x1,y1,z1), vec3(x1,y1,z2), width, col);
-	Line(vec3(x1,y2,z1), vec3(x1,y2,z2), width, col);
-	Line(vec3(x2,y1,z1), vec3(x2,y1,z2), width, col);
-	Line(vec3(x2,y2,z1), vec3(x2,y2,z2), width, col);
-}
+// Draw.cpp - various draw operations (c) 2019-2022 Jules Bloomenthal
+
+#include <glad.h>
+#include "CameraArcball.h"
+#include "Draw.h"
+#include "FrameRing.h"
+#include "GLXtras.h"
+#include "Misc.h"
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+// Screen Mode
+
+void GetViewportSize(int &width, int &height) {
+	int vp[4];
+	glGetIntegerv(GL_VIEWPORT, vp);
+	width = vp[2];
+	height = vp[3];
+}
+
+vec4 VP() {
+	vec4 vp;
+	glGetFloatv(GL_VIEWPORT, (float *) &vp);
+	return vp;
+}
+
+int VPw() {
+	vec4 vp = VP();
+	return (int) vp[2];
+}
+
+int VPh() {
+	vec4 vp = VP();
+	return (int) vp[3];
+}
+
+mat4 Viewport() {
+	// map +/-1 space to screen space viewport
+	float vp[4];
+	glGetFloatv(GL_VIEWPORT, vp);
+	float x = vp[0], y = vp[1], w = vp[2], h = vp[3];
+	return mat4(vec4(w/2,0,0,x+w/2), vec4(0,h/2,0,y+h/2), vec4(0,0,1,0), vec4(0,0,0,1));
+}
+
+mat4 ScreenMode() {
+	// map pixel space (xorigin, yorigin)-(xorigin+width,yorigin+height) to NDC (clip) space (-1,-1)-(1,1)
+	float vp[4];
+	glGetFloatv(GL_VIEWPORT, vp);
+	float x = vp[0], y = vp[1], w = vp[2], h = vp[3];
+	return Translate(-1, -1, 0)*Scale(2/w, 2/h, 1)*Translate(-x, -y, 0);
+}
+
+vec2 ScreenPoint(vec3 p, mat4 m, float *zscreen) {
+	int vp[4];
+	glGetIntegerv(GL_VIEWPORT, vp);
+	vec4 xp = m*vec4(p, 1);
+	if (zscreen)
+		*zscreen = xp.z; // /xp.w;
+	return vec2(vp[0]+((xp.x/xp.w)+1)*.5f*(float)vp[2], vp[1]+((xp.y/xp.w)+1)*.5f*(float)vp[3]);
+}
+
+void ScreenPoints(const vec3 *points, int n, mat4 m, vec2 *screen) {
+	vec4 vp = VP();
+	TransformToViewport(m, points, screen, n, vp);
+}
+
+bool IsVisible(vec3 p, mat4 fullview, vec2 *screenA, int *w, int *h, float fudge) {
+	int width, height;
+	if (w && h) {
+		width = *w;
+		height = *h;
+	}
+	else
+		GetViewportSize(width, height);
+	vec4 xp = fullview*vec4(p, 1);
+	vec2 clip(xp.x/xp.w, xp.y/xp.w);    // clip space, +/-1
+	vec2 screen(((float) width/2.f)*(1.f+clip.x), ((float) height/2.f)*(1.f+clip.y));
+	if (screenA)
+		*screenA = screen;
+	float z = xp.z/xp.w, zScreen;
+	glReadPixels((int)screen.x, (int)screen.y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &zScreen);
+		// **** this is slow when used during rendering!
+	zScreen = 2*zScreen-1; // seems to work (clip range +/-1 but zbuffer range 0-1)
+	return z < zScreen+fudge;
+}
+
+bool DepthXY(int x, int y, float &depth) {
+	if (glIsEnabled(GL_DEPTH_TEST)) {
+		float v, depthRange[2]; // depthRange maps to window coordinates +/-1
+		glGetFloatv(GL_DEPTH_RANGE, depthRange);
+		glReadPixels(x, y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &v);
+		depth = -1+2*(v-depthRange[0])/(depthRange[1]-depthRange[0]);
+		return true;
+	}
+	depth = 0;
+	return false;
+}
+
+float ScreenDSq(double x, double y, vec3 p, mat4 m, float *zscreen, bool invertVertical) {
+	// y presumed in original mouse/screen space (increasing y is downwards)
+	vec2 screen = ScreenPoint(p, m, zscreen);
+	if (invertVertical) y = VPh()-y;
+	double dx = x-screen.x, dy = y-screen.y;
+	return (float) (dx*dx+dy*dy);
+}
+
+float ScreenDSq(int x, int y, vec3 p, mat4 m, float *zscreen, bool invertVertical) {
+	return ScreenDSq((double) x, (double) y, p, m, zscreen, invertVertical);
+}
+
+vec3 UnProject(float xscreen, float yscreen, float zscreen, const mat4 &inverseFullview, const vec4 &vp) {
+	// as gluUnProject, given the inverse of persp*modelview: pixel to +/-1 space to world
+	vec4 ndc(2*(xscreen-vp[0])/vp[2]-1, 2*(yscreen-vp[1])/vp[3]-1, 2*zscreen-1, 1), w = inverseFullview*ndc;
+	return vec3(w.x, w.y, w.z)/w.w;
+}
+
+void ScreenRay(float xscreen, float yscreen, mat4 modelview, mat4 persp, vec3 &p, vec3 &v) {
+	// compute ray from p in direction v; p is transformed eyepoint, xscreen, yscreen determine v
+	vec3 a, b;
+	// origin of ray is always eye (translated origin)
+	p = vec3(modelview[0][3], modelview[1][3], modelview[2][3]);
+	// un-project two screen points of differing depth to determine v
+	ScreenLine(xscreen, yscreen, Invert(persp*modelview), a, b);
+	v = normalize(b-a);
+}
+
+void ScreenRay(float xscreen, float yscreen, CameraAB &camera, vec3 &p, vec3 &v) {
+	vec3 a, b;
+	p = vec3(camera.modelview[0][3], camera.modelview[1][3], camera.modelview[2][3]);
+	ScreenLine(xscreen, yscreen, camera.InverseFullview(), a, b);
+	v = normalize(b-a);
+}
+
+void ScreenLine(float xscreen, float yscreen, const mat4 &inverseFullview, vec3 &p1, vec3 &p2) {
+	// compute 3D world space line, given by p1 and p2, that transforms
+	// to a line perpendicular to the screen at (xscreen, yscreen)
+	vec4 vp = VP();
+	p1 = UnProject(xscreen, yscreen, .25f, inverseFullview, vp);
+	p2 = UnProject(xscreen, yscreen, .50f, inverseFullview, vp);
+		// alternatively, a second point can be determined by transforming the origin by the inverse of modelview
+		// this would yield in world space the camera location, through which all view lines pass
+}
+
+void ScreenLine(float xscreen, float yscreen, mat4 modelview, mat4 persp, vec3 &p1, vec3 &p2) {
+	ScreenLine(xscreen, yscreen, Invert(persp*modelview), p1, p2);
+}
+
+void ScreenLine(float xscreen, float yscreen, CameraAB &camera, vec3 &p1, vec3 &p2) {
+	ScreenLine(xscreen, yscreen, camera.InverseFullview(), p1, p2);
+}
+
+bool FrontFacing(vec3 base, vec3 vec, mat4 view) {
+	vec4 xbase = view*vec4(base, 1), xhead = view*vec4(base+.1f*vec, 1);
+	vec3 xb(xbase.x, xbase.y, xbase.z), xh(xhead.x, xhead.y, xhead.z), xv(xh-xb);
+	return dot(xb, xv) < 0;
+}
+
+// double ScreenZ(vec3 p, mat4 m) {
+//	return (m*vec4(p, 1)).z;
+// }
+
+// bool FrontFacing(vec3 base, vec3 vec, mat4 view) {
+//	return ScreenZ(base, view) >= ScreenZ(base+vec, view);
+// }
+
+// Draw Shader
+
+int drawShader = 0;
+
+const char *drawVShader = R"(
+	#version 130
+	in vec4 position;
+	in vec3 color;
+	out vec3 vColor;
+	uniform mat4 view;
+	void main() {
+		gl_Position = view*position;
+		vColor = color;
+	}
+)";
+
+const char *drawPShader = R"(
+	#version 130
+	in vec3 vColor;
+	out vec4 pColor;
+	uniform float opacity = 1;
+	uniform bool fadeToCenter = false;
+	uniform bool ring = false;
+	float Fade(float t) {
+		if (t < .95) return 1.;
+		if (t > 1.05) return 0.;
+		float a = (t-.95)/(1.05-.95);
+		return 1-smoothstep(0, 1, a);
+			// does smoothstep help?
+	}
+	float Ring(float t) {
+		if (t < .7) return 0.;
+		if (t > .9) return 1.;
+		float a = (t-.7)/(.9-.7);
+		return smoothstep(0, 1, a);
+	}
+	float DistanceToCenter() {
+		// gl_PointCoord wrt point primitive size
+		float dx = 1-2*gl_PointCoord.x;
+		float dy = 1-2*gl_PointCoord.y;
+		return sqrt(dx*dx+dy*dy);
+	  }
+	void main() {
+		// GL_POINT_SMOOTH deprecated, so calc here
+		// needs GL_POINT_SPRITE or 0x8861 enabled
+		float o = opacity;
+		if (fadeToCenter)
+			o *= Fade(DistanceToCenter());
+		if (ring)
+			o *= Ring(DistanceToCenter());
+		pColor = vec4(vColor, o);
+	}
+)";
+
+// Batch State
+
+namespace {
+
+LazyProgram drawProgram("Draw", &drawVShader, NULL, NULL, NULL, &drawPShader);
+
+struct DrawVertex {
+	vec4 position; // clip space
+	vec3 color;
+	DrawVertex() { }
+	DrawVertex(vec4 p, vec3 c) : position(p), color(c) { }
+};
+
+struct DrawKey {
+	// buckets draw triangles beneath lines beneath disks, then by width, opacity, ring
+	int rank = 0;
+	GLenum mode = GL_POINTS;
+	float width = 1, opacity = 1;
+	bool ring = false;
+	DrawKey() { }
+	DrawKey(GLenum mode, float width, float opacity, bool ring = false)
+		: rank(mode == GL_TRIANGLES? 0 : mode == GL_LINES? 1 : 2), mode(mode), width(width), opacity(opacity), ring(ring) { }
+	bool operator==(const DrawKey &k) const {
+		return mode == k.mode && width == k.width && opacity == k.opacity && ring == k.ring;
+	}
+	bool operator<(const DrawKey &k) const {
+		if (rank != k.rank) return rank < k.rank;
+		if (width != k.width) return width < k.width;
+		if (opacity != k.opacity) return opacity < k.opacity;
+		return ring < k.ring;
+	}
+};
+
+struct TriangleKey {
+	// opacity, outline on, outline rgba, outline width, transition
+	float v[8];
+	TriangleKey(float opacity, bool outline, vec4 col, float width, float transition) {
+		float t[] = {opacity, outline? 1.f : 0.f, col.x, col.y, col.z, col.w, width, transition};
+		std::copy(t, t+8, v);
+	}
+	bool operator==(const TriangleKey &k) const { return std::equal(v, v+8, k.v); }
+	bool operator<(const TriangleKey &k) const { return std::lexicographical_compare(v, v+8, k.v, k.v+8); }
+};
+
+typedef std::vector<DrawVertex> Bucket;
+
+bool batching = false;
+mat4 drawView, triView;					// view matrices as last set, applied when appending
+std::map<DrawKey, Bucket> drawBatch;	// Disk, Line, LineStrip, Quad
+std::map<TriangleKey, Bucket> triBatch;	// Triangle
+DrawKey lastKey;
+Bucket *lastBucket = NULL;				// most calls repeat the previous key
+
+Bucket &DrawBucket(DrawKey k) {
+	if (!lastBucket || !(k == lastKey)) {
+		lastKey = k;
+		lastBucket = &drawBatch[k];
+	}
+	return *lastBucket;
+}
+
+void Append(Bucket &b, vec3 p, vec3 c) {
+	b.push_back(DrawVertex(drawView*vec4(p, 1), c));
+}
+
+void EnablePointSmooth() {
+#ifdef GL_POINT_SMOOTH
+	glEnable(GL_POINT_SMOOTH);
+#endif
+#if !defined(GL_POINT_SMOOTH) && defined(GL_POINT_SPRITE)
+	glEnable(GL_POINT_SPRITE);
+#endif
+#if !defined(GL_POINT_SMOOTH) && !defined(GL_POINT_SPRITE)
+	glEnable(0x8861); // same as GL_POINT_SMOOTH [this is a 4.5 core bug]
+	SetUniform(drawShader, "fadeToCenter", 1); // needed if GL_POINT_SMOOTH and GL_POINT_SPRITE fail
+#endif
+}
+
+} // end namespace
+
+int UseDrawShader() {
+	int was = CurrentProgram();
+	bool init = !drawShader;
+	if (init)
+		drawShader = drawProgram.Get();
+	glUseProgram(drawShader);
+	if (init)
+		SetUniform(drawShader, "view", mat4());
+	return was;
+}
+
+int UseDrawShader(mat4 viewMatrix) {
+	int was = UseDrawShader();
+	SetUniform(drawShader, "view", viewMatrix);
+	drawView = viewMatrix;
+	return was;
+}
+
+// Disks
+
+void Disk(vec2 p, float diameter, vec3 color, float opacity, bool ring) {
+	Disk(vec3(p), diameter, color, opacity, ring);
+}
+
+void Disk(vec3 p, float diameter, vec3 color, float opacity, bool ring) {
+	// diameter should be >= 0, <= 20
+	if (batching) {
+		Append(DrawBucket(DrawKey(GL_POINTS, diameter, opacity, ring)), p, color);
+		return;
+	}
+	UseDrawShader();
+	// load single vertex (x,y,z,r,g,b) into frame ring
+	vec3 data[] = {p, color};
+	GLintptr offset = FrameRingWrite(data, sizeof(data));
+	// connect shader inputs
+	VertexAttribPointer(drawShader, "position", 3, 0, (void *) offset);
+	VertexAttribPointer(drawShader, "color", 3, 0, (void *) (offset+sizeof(vec3)));
+	// draw
+	SetUniform(drawShader, "opacity", opacity);
+	SetUniform(drawShader, "ring", ring);
+	glPointSize(diameter);
+	EnablePointSmooth();
+	glDrawArrays(GL_POINTS, 0, 1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Lines
+
+void Line(vec3 p1, vec3 p2, float width, vec3 col1, vec3 col2, float opacity) {
+	if (batching) {
+		Bucket &b = DrawBucket(DrawKey(GL_LINES, width, opacity));
+		Append(b, p1, col1);
+		Append(b, p2, col2);
+		return;
+	}
+	UseDrawShader();
+	// load location and color data into frame ring
+	vec3 data[] = {p1, p2, col1, col2};
+	GLintptr offset = FrameRingWrite(data, sizeof(data));
+	// connect shader inputs, set uniforms
+	VertexAttribPointer(drawShader, "position", 3, 0, (void *) offset);
+	VertexAttribPointer(drawShader, "color", 3, 0, (void *) (offset+2*sizeof(vec3)));
+	SetUniform(drawShader, "fadeToCenter", 0);  // gl_PointCoord fails for lines (instead, use GL_LINE_SMOOTH)
+	SetUniform(drawShader, "opacity", opacity);
+	// draw
+	glLineWidth(width);
+	glDrawArrays(GL_LINES, 0, 2);
+	// cleanup
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Line(vec3 p1, vec3 p2, float width, vec3 col, float opacity) {
+	Line(p1, p2, width, col, col, opacity);
+}
+
+void Line(vec2 p1, vec2 p2, float width, vec3 col1, vec3 col2, float opacity) {
+	vec3 pp1(p1, 0), pp2(p2, 0);
+	Line(pp1, pp2, width, col1, col2, opacity);
+}
+
+void Line(vec2 p1, vec2 p2, float width, vec3 col, float opacity) {
+	Line(p1, p2, width, col, col, opacity);
+}
+
+void Line(int x1, int y1, int x2, int y2, float width, vec3 col, float opacity) {
+	vec3 p1((float) x1, (float) y1, 0), p2((float) x2, (float) y2, 0);
+	Line(p1, p2, width, col, col, opacity);
+}
+
+// LineDash and LineDot are messed up
+
+void LineDash(vec3 p1, vec3 p2, mat4 view, float width, vec3 col1, vec3 col2, float opacity) {
+	UseDrawShader(view);
+	float totalLen = length(ScreenPoint(p2, view)-ScreenPoint(p1, view));
+//	float dashLen = 10; // in pixels
+	float nDashes = totalLen/20;
+	vec3 dash = .5f*(p2-p1)/nDashes;
+	for (int i = 0; i < (int) nDashes; i++) {
+		vec3 start = p1+(float)i*2*dash;
+		Line(start, start+dash, width, col1, col2, opacity);
+	}
+}
+
+void LineDot(vec3 p1, vec3 p2, mat4 view, float width, vec3 col, float opacity) {
+	int pixelSpacing = 7;
+	UseDrawShader(view);
+	float totalLen = length(ScreenPoint(p2, view)-ScreenPoint(p1, view));
+	int nDots = (int) (totalLen/(float)pixelSpacing);
+	vec3 d = .5f*(p2-p1)/(float)nDots;
+	for (int i = 0; i < nDots; i++) {
+		vec3 p = p1+(float)i*d;
+		Disk(p, 4, col);
+	}
+}
+
+void LineStrip(int nPoints, vec3 *points, vec3 &color, float opacity, float width) {
+	if (batching) {
+		Bucket &b = DrawBucket(DrawKey(GL_LINES, width, opacity));
+		for (int i = 1; i < nPoints; i++) {
+			Append(b, points[i-1], color);
+			Append(b, points[i], color);
+		}
+		return;
+	}
+	// points followed by colors
+	std::vector<vec3> data(points, points+nPoints);
+	data.resize(2*nPoints, color);
+	GLintptr offset = FrameRingWrite(data.data(), data.size()*sizeof(vec3));
+	VertexAttribPointer(drawShader, "position", 3, 0, (void *) offset);
+	VertexAttribPointer(drawShader, "color", 3, 0, (void *) (offset+nPoints*sizeof(vec3)));
+	SetUniform(drawShader, "fadeToCenter", 0);
+	SetUniform(drawShader, "opacity", opacity);
+	glLineWidth(width);
+	glDrawArrays(GL_LINE_STRIP, 0, nPoints);
+}
+
+// Quads
+
+void Quad(vec3 p1, vec3 p2, vec3 p3, vec3 p4, bool solid, vec3 col, float opacity, float lineWidth) {
+	if (batching) {
+		// solid as two triangles, else as four lines
+		vec3 tris[] = {p1, p2, p3, p1, p3, p4}, lines[] = {p1, p2, p2, p3, p3, p4, p4, p1}, *v = solid? tris : lines;
+		Bucket &b = DrawBucket(solid? DrawKey(GL_TRIANGLES, 1, opacity) : DrawKey(GL_LINES, lineWidth, opacity));
+		for (int i = 0, n = solid? 6 : 8; i < n; i++)
+			Append(b, v[i], col);
+		return;
+	}
+#ifndef GL_QUADS
+	Triangle(p1, p2, p3, col, col, col, opacity, !solid, col, lineWidth);
+	Triangle(p1, p3, p4, col, col, col, opacity, !solid, col, lineWidth);
+#else
+	vec3 data[] = { p1, p2, p3, p4, col, col, col, col };
+	UseDrawShader();
+	GLintptr offset = FrameRingWrite(data, sizeof(data));
+	VertexAttribPointer(drawShader, "position", 3, 0, (void *) offset);
+	VertexAttribPointer(drawShader, "color", 3, 0, (void *) (offset+4*sizeof(vec3)));
+	SetUniform(drawShader, "opacity", opacity);
+	SetUniform(drawShader, "fadeToCenter", 0);
+	glLineWidth(lineWidth);
+	glDrawArrays(solid? GL_QUADS : GL_LINE_LOOP, 0, 4);
+#endif
+}
+
+void Quad(int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, bool solid, vec3 color, float opacity, float lineWidth) {
+	Quad(vec3((float)x1,(float)y1,0), vec3((float)x2,(float)y2,0), vec3((float)x3,(float)y3,0), vec3((float)x4,(float)y4,0), solid, color, opacity, lineWidth);
+}
+
+// Star
+
+void Star(vec3 p, float size, vec3 color, mat4 fullview) {
+	vec2 s = ScreenPoint(p, fullview);
+	UseDrawShader(ScreenMode());
+	Disk(s, size, color);
+	for (int i = 0, nRays = 8; i < nRays; i++) {
+		float a = 3.1415f*(float)i/nRays;
+		float r1 = 1.02f*size, r2 = size*(i%2? 2.1f : 2.8f), w = i%2? 1 : 1.75f;
+		vec2 d(cos(a), sin(a));
+		Line(s+r1*d, s+r2*d, w, color);
+		Line(s-r1*d, s-r2*d, w, color);
+	}
+}
+
+// Arrows
+
+void Arrow(vec2 base, vec2 head, vec3 col, float lineWidth, double headSize) {
+	Line(base, head, lineWidth, col);
+	if (headSize > 0) {
+		vec2 v1 = (float)headSize*normalize(head-base), v2(v1.y/2.f, -v1.x/2.f);
+		vec2 head1(head-v1+v2), head2(head-v1-v2);
+		Line(head, head1, lineWidth, col);
+		Line(head, head2, lineWidth, col);
+	}
+}
+
+vec3 ProjectToLine(vec3 p, vec3 p1, vec3 p2) {
+	// project p to line p1p2
+	vec3 delta(p2-p1);
+	float magSq = dot(delta, delta);
+	float alpha = magSq > FLT_EPSILON? dot(delta, p-p1)/magSq : 0;
+	return p1+alpha*delta;
+}
+
+void PointScreen(vec3 p, vec2 s, mat4 modelview, mat4 persp, float lineWidth, vec3 col) {
+	// draw between p and the nearest point on a 3D screen line through s
+	vec3 p1, p2;
+	ScreenLine(s.x, s.y, modelview, persp, p1, p2);
+	vec3 pp = ProjectToLine(p, vec3(p1), vec3(p2));
+	Line(p, pp, lineWidth, col);
+}
+
+void ArrowV(vec3 base, vec3 v, mat4 modelview, mat4 persp, vec3 col, float lineWidth, double headSize) {
+	mat4 m = persp*modelview;
+	vec3 head(base+v);
+	float zbase, zhead;
+	vec2 base2 = ScreenPoint(base, m, &zbase), head2 = ScreenPoint(head, m, &zhead);
+	vec2 v1 = (float)headSize*normalize(head2-base2), v2(v1.y/2.f, -v1.x/2.f);
+	vec2 h1(head2-v1+v2), h2(head2-v1-v2);
+//	col = zbase > zhead? vec3(0,1,0) : vec3(0,0,1);
+	// could draw in screen mode, using base2, head2, h1, & h2, but prefer draw in 3D (allows for depth test)
+	UseDrawShader(m);
+	Line(base, head, lineWidth, col);
+	PointScreen(head, h1, modelview, persp, lineWidth, col);
+	PointScreen(head, h2, modelview, persp, lineWidth, col);
+}
+
+// Cylinders
+
+GLuint cylinderShader = 0;
+
+namespace {
+
+const char *cylinderVShader = "void main() { gl_Position = vec4(0); }";
+const char *cylinderTCShader = R"(
+	#version 400 core
+	layout (vertices = 4) out;
+	void main() {
+		if (gl_InvocationID == 0) {
+			gl_TessLevelOuter[0] = gl_TessLevelOuter[2] = 1;
+			gl_TessLevelOuter[1] = gl_TessLevelOuter[3] = 24;
+			gl_TessLevelInner[0] = gl_TessLevelInner[1] = 24;
+		}
+	}
+)";
+const char *cylinderTEShader = R"(
+	#version 400 core
+	layout (quads, equal_spacing, ccw) in;
+	uniform vec3 p1;
+	uniform vec3 p2;
+	uniform float r1;
+	uniform float r2;
+	uniform mat4 modelview;
+	uniform mat4 persp;
+	out vec3 tePoint;
+	out vec3 teNormal;
+	void main() {
+		vec2 uv = gl_TessCoord.st;
+		float c = cos(2*3.1415*uv.s), s = sin(2*3.1415*uv.s);
+		vec3 dp = p2-p1;
+		vec3 crosser = dp.x < dp.y? (dp.x < dp.z? vec3(1,0,0) : vec3(0,0,1)) : (dp.y < dp.z? vec3(0,1,0) : vec3(0,0,1));
+		vec3 xcross = normalize(cross(crosser, dp));
+		vec3 ycross = normalize(cross(xcross, dp));
+		vec3 n = c*xcross+s*ycross;
+		vec3 p = mix(p1, p2, uv.t)+mix(r1, r2, uv.t)*n;
+		tePoint = (modelview*vec4(p, 1)).xyz;
+		teNormal = (modelview*vec4(n, 0)).xyz;
+		gl_Position = persp*vec4(tePoint, 1);
+	}
+)";
+const char *cylinderPShader = R"(
+	#version 130
+	in vec3 tePoint;
+	in vec3 teNormal;
+	out vec4 pColor;
+	uniform vec4 color;
+	uniform vec3 light;
+	void main() {
+		vec3 N = normalize(teNormal);      // surface normal
+		vec3 L = normalize(light-tePoint); // light vector
+		vec3 E = normalize(tePoint);       // eye vector
+		vec3 R = reflect(L, N);            // highlight vector
+		float d = abs(dot(N, L));          // two-sided diffuse
+		float s = abs(dot(R, E));          // two-sided specular
+		float intensity = clamp(d+pow(s, 50), 0, 1);
+		pColor = intensity*color;
+	}
+)";
+LazyProgram cylinderProgram("Draw cylinders", &cylinderVShader, &cylinderTCShader, &cylinderTEShader, NULL, &cylinderPShader, false);
+
+} // end namespace
+
+void Cylinder(vec3 p1, vec3 p2, float r1, float r2, mat4 modelview, mat4 persp, vec4 color) {
+	if (!cylinderShader)
+		cylinderShader = cylinderProgram.Get();
+	//	cylinderShader = LinkProgramViaCode(&vShader, NULL, &teShader, NULL, &pShader);
+	glUseProgram(cylinderShader);
+	SetUniform(cylinderShader, "modelview", modelview);
+	SetUniform(cylinderShader, "persp", persp);
+	SetUniform(cylinderShader, "color", color);
+	SetUniform(cylinderShader, "p1", p1);
+	SetUniform(cylinderShader, "p2", p2);
+	SetUniform(cylinderShader, "r1", r1);
+	SetUniform(cylinderShader, "r2", r2);
+	// float r = 24, outerLevels[] = {1, r, 1, r}, innerLevels[] = {r, r};
+	// glPatchParameteri(GL_PATCH_VERTICES, 4);
+	// glPatchParameterfv(GL_PATCH_DEFAULT_OUTER_LEVEL, outerLevels);
+	// glPatchParameterfv(GL_PATCH_DEFAULT_INNER_LEVEL, innerLevels);
+#ifdef GL_PATCHES
+	glDrawArrays(GL_PATCHES, 0, 4);
+#endif
+}
+
+// Triangles with optional outline
+
+GLuint triShader = 0;
+
+// vertex shader
+const char *triVShaderCode = R"(
+	#version 330 core
+	in vec4 point;
+	in vec3 color;
+	out vec3 vColor;
+	uniform mat4 view;
+	void main() {
+		gl_Position = view*point;
+		vColor = color;
+	}
+)";
+
+// geometry shader with line-drawing
+const char *triGShaderCode = R"(
+	#version 330 core
+	layout (triangles) in;
+	layout (triangle_strip, max_vertices = 3) out;
+	in vec3 vPoint[];
+	in vec3 vColor[];
+	out vec3 gColor;
+	noperspective out vec3 gEdgeDistance;
+	uniform mat4 viewptM;
+	vec3 ViewPoint(int i) {
+		return vec3(viewptM*(gl_in[i].gl_Position/gl_in[i].gl_Position.w));
+	}
+	void main() {
+		float ha = 0, hb = 0, hc = 0;
+		// transform each vertex into viewport space
+		vec3 p0 = ViewPoint(0), p1 = ViewPoint(1), p2 = ViewPoint(2);
+		// find altitudes ha, hb, hc
+		float a = length(p2-p1), b = length(p2-p0), c = length(p1-p0);
+		float alpha = acos((b*b+c*c-a*a)/(2.*b*c));
+		float beta = acos((a*a+c*c-b*b)/(2.*a*c));
+		ha = abs(c*sin(beta));
+		hb = abs(c*sin(alpha));
+		hc = abs(b*sin(alpha));
+		// send triangle vertices and edge distances
+		for (int i = 0; i < 3; i++) {
+		    gEdgeDistance = i==0? vec3(ha, 0, 0) : i==1? vec3(0, hb, 0) : vec3(0, 0, hc);
+			gColor = vColor[i];
+			gl_Position = gl_in[i].gl_Position;
+			EmitVertex();
+		}
+		EndPrimitive();
+	}
+)";
+
+// pixel shader
+const char *triPShaderCode = R"(
+	#version 410 core
+	in vec3 gColor;
+	noperspective in vec3 gEdgeDistance;
+	uniform vec4 outlineColor = vec4(0, 0, 0, 1);
+	uniform float opacity = 1;
+	uniform float outlineWidth = 1;
+	uniform float transition = 1;
+	uniform int outlineOn = 1;
+	out vec4 pColor;
+	void main() {
+		pColor = vec4(gColor, opacity);
+		if (outlineOn > 0) {
+			float minDist = min(gEdgeDistance.x, min(gEdgeDistance.y, gEdgeDistance.z));
+			float t = smoothstep(outlineWidth-transition, outlineWidth+transition, minDist);
+			if (outlineOn == 2) pColor = vec4(1,1,1,1);
+			pColor = mix(outlineColor, pColor, t);
+		}
+	}
+)";
+
+namespace {
+
+LazyProgram triProgram("Draw triangles", &triVShaderCode, NULL, NULL, &triGShaderCode, &triPShaderCode);
+
+} // end namespace
+
+ void UseTriangleShader() {
+	bool init = triShader == 0;
+	if (init)
+		triShader = triProgram.Get();
+	glUseProgram(triShader);
+	if (init)
+		SetUniform(triShader, "view", mat4());
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_LINE_SMOOTH);
+}
+
+void UseTriangleShader(mat4 view) {
+	UseTriangleShader();
+	SetUniform(triShader, "view", view);
+	triView = view;
+}
+
+void Triangle(vec3 p1, vec3 p2, vec3 p3, vec3 c1, vec3 c2, vec3 c3,
+			  float opacity, bool outline, vec4 outlineCol, float outlineWidth, float transition) {
+	if (batching) {
+		Bucket &b = triBatch[TriangleKey(opacity, outline, outlineCol, outlineWidth, transition)];
+		vec3 p[] = {p1, p2, p3}, c[] = {c1, c2, c3};
+		for (int i = 0; i < 3; i++)
+			b.push_back(DrawVertex(triView*vec4(p[i], 1), c[i]));
+		return;
+	}
+	vec3 data[] = { p1, p2, p3, c1, c2, c3 };
+	UseTriangleShader();
+	GLintptr offset = FrameRingWrite(data, sizeof(data));
+	VertexAttribPointer(triShader, "point", 3, 0, (void *) offset);
+	VertexAttribPointer(triShader, "color", 3, 0, (void *) (offset+3*sizeof(vec3)));
+	SetUniform(triShader, "viewptM", Viewport()); // **** ????
+	SetUniform(triShader, "opacity", opacity);
+	SetUniform(triShader, "outlineOn", outline? 1 : 0);
+	SetUniform(triShader, "outlineColor", outlineCol);
+	SetUniform(triShader, "outlineWidth", outlineWidth);
+	SetUniform(triShader, "transition", transition);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+// Boxes
+
+void Box(vec3 a, vec3 b, float width, vec3 col) {
+	float x1=a.x, x2=b.x, y1=a.y, y2=b.y, z1=a.z, z2=b.z;
+	// left-right
+	Line(vec3(x1,y1,z1), vec3(x2,y1,z1), width, col);
+	Line(vec3(x1,y2,z1), vec3(x2,y2,z1), width, col);
+	Line(vec3(x1,y1,z2), vec3(x2,y1,z2), width, col);
+	Line(vec3(x1,y2,z2), vec3(x2,y2,z2), width, col);
+	// bottom-top
+	Line(vec3(x1,y1,z1), vec3(x1,y2,z1), width, col);
+	Line(vec3(x1,y1,z2), vec3(x1,y2,z2), width, col);
+	Line(vec3(x2,y1,z1), vec3(x2,y2,z1), width, col);
+	Line(vec3(x2,y1,z2), vec3(x2,y2,z2), width, col);
+	// near-far
+	Line(vec3(x1,y1,z1), vec3(x1,y1,z2), width, col);
+	Line(vec3(x1,y2,z1), vec3(x1,y2,z2), width, col);
+	Line(vec3(x2,y1,z1), vec3(x2,y1,z2), width, col);
+	Line(vec3(x2,y2,z1), vec3(x2,y2,z2), width, col);
+}
+
+// Batching
+
+namespace {
+
+std::vector<DrawVertex> batchStream;
+
+template<class Key> int Gather(std::map<Key, Bucket> &batch, GLintptr &offset) {
+	// concatenate non-empty buckets into batchStream and the frame ring, drop buckets unused since last flush
+	batchStream.resize(0);
+	for (auto it = batch.begin(); it != batch.end();)
+		if (it->second.empty())
+			it = batch.erase(it);
+		else {
+			batchStream.insert(batchStream.end(), it->second.begin(), it->second.end());
+			it++;
+		}
+	if (!batchStream.empty())
+		offset = FrameRingWrite(batchStream.data(), batchStream.size()*sizeof(DrawVertex));
+	return (int) batchStream.size();
+}
+
+void VertexAttributes(int program, const char *position, GLintptr offset) {
+	VertexAttribPointer(program, position, 4, sizeof(DrawVertex), (void *) offset);
+	VertexAttribPointer(program, "color", 3, sizeof(DrawVertex), (void *) (offset+sizeof(vec4)));
+}
+
+} // end namespace
+
+void BeginDrawBatch() {
+	batching = true;
+}
+
+bool DrawBatching() {
+	return batching;
+}
+
+void FlushDrawBatch() {
+	int was = CurrentProgram(), first = 0;
+	GLintptr offset = 0;
+	if (Gather(triBatch, offset)) {
+		// vertices are in clip space, so draw with identity view, then restore
+		UseTriangleShader();
+		VertexAttributes(triShader, "point", offset);
+		SetUniform(triShader, "view", mat4());
+		SetUniform(triShader, "viewptM", Viewport());
+		for (auto &b : triBatch) {
+			const float *v = b.first.v;
+			int n = (int) b.second.size();
+			SetUniform(triShader, "opacity", v[0]);
+			SetUniform(triShader, "outlineOn", v[1] > 0? 1 : 0);
+			SetUniform(triShader, "outlineColor", vec4(v[2], v[3], v[4], v[5]));
+			SetUniform(triShader, "outlineWidth", v[6]);
+			SetUniform(triShader, "transition", v[7]);
+			glDrawArrays(GL_TRIANGLES, first, n);
+			first += n;
+			b.second.resize(0);
+		}
+		SetUniform(triShader, "view", triView);
+	}
+	first = 0;
+	lastBucket = NULL;
+	if (Gather(drawBatch, offset)) {
+		UseDrawShader();
+		VertexAttributes(drawShader, "position", offset);
+		SetUniform(drawShader, "view", mat4());
+		for (auto &b : drawBatch) {
+			const DrawKey &k = b.first;
+			int n = (int) b.second.size();
+			SetUniform(drawShader, "opacity", k.opacity);
+			SetUniform(drawShader, "ring", k.ring);
+			SetUniform(drawShader, "fadeToCenter", 0);
+			if (k.mode == GL_POINTS) {
+				glPointSize(k.width);
+				EnablePointSmooth();
+			}
+			if (k.mode == GL_LINES)
+				glLineWidth(k.width);
+			glDrawArrays(k.mode, first, n);
+			first += n;
+			b.second.resize(0);
+		}
+		SetUniform(drawShader, "view", drawView);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glUseProgram(was);
+}
+
+void EndDrawBatch() {
+	FlushDrawBatch();
+	batching = false;
+}
@@ -0,0 +1,126 @@
+// FrameRing.cpp - shared ring buffer for per-frame dynamic geometry (c) 2019-2022 Jules Bloomenthal
+
+#include "FrameRing.h"
+#include <string.h>
+
+namespace {
+
+const int nRegions = 3;
+
+GLuint ringBuffer = 0;
+size_t regionSize = 0, requestedSize = 1 << 20;
+char *mapped = NULL;			// persistent mapping, else NULL
+int region = 0;					// region being written
+size_t head = 0;				// next free byte in region
+GLsync fences[nRegions] = {};	// set when a region is left
+FrameRingStats stats;
+
+void Wait(GLsync &fence) {
+	if (!fence)
+		return;
+	if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+		stats.fenceWaits++;
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+			;
+	}
+	glDeleteSync(fence);
+	fence = NULL;
+}
+
+void Create() {
+	// wait for draws that read the old buffer, then allocate and (if possible) map the new one
+	for (GLsync &f : fences)
+		Wait(f);
+	if (ringBuffer) {
+		glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+		if (mapped)
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		glDeleteBuffers(1, &ringBuffer);
+	}
+	mapped = NULL;
+	regionSize = requestedSize;
+	GLsizeiptr size = nRegions*regionSize;
+	glGenBuffers(1, &ringBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+	if (GLAD_GL_ARB_buffer_storage && glBufferStorage) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+		mapped = (char *) glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+		if (!mapped) {
+			// storage is immutable, so start over with a mutable buffer
+			glDeleteBuffers(1, &ringBuffer);
+			glGenBuffers(1, &ringBuffer);
+			glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+		}
+	}
+	if (!mapped)
+		glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+	region = 0;
+	head = 0;
+}
+
+void NextRegion() {
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	region = (region+1)%nRegions;
+	stats.regionChanges++;
+	if (region == 0)
+		stats.wraps++;
+	Wait(fences[region]);
+	head = 0;
+}
+
+} // end namespace
+
+// Allocation
+
+GLintptr FrameRingWrite(const void *data, size_t bytes) {
+	size_t aligned = (bytes+15) & ~(size_t) 15;
+	if (aligned > requestedSize) {
+		while (requestedSize < aligned)
+			requestedSize *= 2;
+		stats.grows++;
+	}
+	if (!ringBuffer || regionSize != requestedSize)
+		Create();
+	if (head+aligned > regionSize)
+		NextRegion();
+	GLintptr offset = region*regionSize+head;
+	head += aligned;
+	stats.writes++;
+	glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+	if (mapped)
+		memcpy(mapped+offset, data, bytes);
+	else {
+		// the fences guarantee the range is idle, so skip the driver's synchronization
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+		void *p = glMapBufferRange(GL_ARRAY_BUFFER, offset, bytes, flags);
+		if (p) {
+			memcpy(p, data, bytes);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+	}
+	return offset;
+}
+
+GLuint FrameRingBuffer() {
+	return ringBuffer;
+}
+
+void FrameRingEndFrame() {
+	if (ringBuffer && head > 0)
+		NextRegion();
+}
+
+// Configuration
+
+void FrameRingSize(size_t regionBytes) {
+	requestedSize = regionBytes < 16? 16 : (regionBytes+15) & ~(size_t) 15;
+}
+
+bool FrameRingPersistent() {
+	return mapped != NULL;
+}
+
+FrameRingStats GetFrameRingStats() {
+	return stats;
+}
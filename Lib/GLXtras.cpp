@@ -1,468 +1,1117 @@
-// GLXtras.cpp - GLSL support (c) 2019-2022 Jules Bloomenthal
-
-#include <glad.h>
-#include <GL/glu.h>
-#include "GLXtras.h"
-#include <stdio.h>
-#include <string.h>
-#include <time.h>
-#include <vector>
-
-// Print OpenGL, GLSL Details
-
-int PrintGLErrors(const char *title) {
-	char buf[1000];
-	int nErrors = 0;
-	buf[0] = 0;
-	for (;;) {
-		GLenum n = glGetError();
-		if (n == GL_NO_ERROR)
-			break;
-		sprintf(buf+strlen(buf), "%s%s", !nErrors++? "" : ", ", gluErrorString(n));
-			// do not call Debug() while looping through errors, so accumulate in buf
-	}
-	if (nErrors) {
-		if (title) printf("%s (GL errors): %s\n", title, buf);
-		else printf("GL errors: %s\n", buf);
-	}
-	return nErrors;
-}
-
-void PrintVersionInfo() {
-	const GLubyte *renderer    = glGetString(GL_RENDERER);
-	const GLubyte *vendor      = glGetString(GL_VENDOR);
-	const GLubyte *version     = glGetString(GL_VERSION);
-	const GLubyte *glslVersion = glGetString(GL_SHADING_LANGUAGE_VERSION);
-	printf("GL vendor: %s\n", vendor);
-	printf("GL renderer: %s\n", renderer);
-	printf("GL version: %s\n", version);
-	printf("GLSL version: %s\n", glslVersion);
-	// GLint major, minor;
-	// glGetIntegerv(GL_MAJOR_VERSION, &major);
-	// glGetIntegerv(GL_MINOR_VERSION, &minor);
-	// printf("GL version (integer): %d.%d\n", major, minor);
-}
-
-void PrintExtensions() {
-	const GLubyte *extensions = glGetString(GL_EXTENSIONS);
-	const char *skip = "(, \t\n";
-	char buf[100];
-	printf("\nGL extensions:\n");
-	if (extensions)
-		for (char *c = (char *) extensions; *c; ) {
-				c += strspn(c, skip);
-				size_t nchars = strcspn(c, skip);
-				strncpy(buf, c, nchars);
-				buf[nchars] = 0;
-				printf("  %s\n", buf);
-				c += nchars;
-		}
-}
-
-void PrintProgramLog(int programID) {
-	GLint logLen;
-	glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLen);
-	if (logLen > 0) {
-		char *log = new char[logLen];
-		GLsizei written;
-		glGetProgramInfoLog(programID, logLen, &written, log);
-		printf("Program log:\n%s", log);
-		delete [] log;
-	}
-}
-
-void PrintProgramAttributes(int programID) {
-	GLint maxLength, nAttribs;
-	glGetProgramiv(programID, GL_ACTIVE_ATTRIBUTES, &nAttribs);
-	glGetProgramiv(programID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
-	char *name = new char[maxLength];
-	GLint written, size;
-	GLenum type;
-	for (int i = 0; i < nAttribs; i++) {
-		glGetActiveAttrib(programID, i, maxLength, &written, &size, &type, name);
-		GLint location = glGetAttribLocation(programID, name);
-		printf("    %-5i  |  %s\n", location, name);
-	}
-	delete [] name;
-}
-
-void PrintProgramUniforms(int programID) {
-	GLenum type;
-	GLchar name[201];
-	GLint nUniforms, length, size;
-	glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &nUniforms);
-	printf("  uniforms\n");
-	for (int i = 0; i < nUniforms; i++) {
-		glGetActiveUniform(programID, i,  200,  &length, &size, &type, name);
-		printf("    %s\n", name);
-	}
-}
-
-// Compilation
-
-GLuint CompileShaderViaFile(const char *filename, GLint type) {
-		FILE* fp = fopen(filename, "r");
-		if (fp == NULL) {
-			printf("can't open file\n");
-			return 0;
-		}
-		fseek(fp, 0L, SEEK_END);
-		long maxSize = ftell(fp);
-		fseek(fp, 0L, SEEK_SET);
-		char *buf = new char[maxSize+1], c;
-		int nchars = 0;
-		while ((c = fgetc(fp)) != EOF)
-			buf[nchars++] = c;
-		buf[nchars] = 0;
-		fclose(fp);
-		GLuint s = CompileShaderViaCode((const char **) &buf, type);
-		delete [] buf;
-		return s;
-}
-
-GLuint CompileShaderViaCode(const char **code, GLint type) {
-	GLuint shader = glCreateShader(type);
-	if (!shader) {
-		//		PrintGLErrors();
-		return false;
-	}
-	glShaderSource(shader, 1, code, NULL);
-	glCompileShader(shader);
-	// check compile status
-	GLint result;
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
-	if (result == GL_FALSE) {
-		// squawk logged errors
-		GLint logLen;
-		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLen);
-		if (logLen > 0) {
-			GLsizei written;
-			char *log = new char[logLen];
-			glGetShaderInfoLog(shader, logLen, &written, log);
-			printf("compilation failed: %s", log);
-			delete [] log;
-		}
-		else printf("shader compilation failed\n");
-		return 0;
-	}
-	return shader;
-}
-
-// Linking
-
-GLuint LinkProgramViaCode(const char **vertexCode, const char **pixelCode) {
-	GLuint vshader = CompileShaderViaCode(vertexCode, GL_VERTEX_SHADER);
-	GLuint pshader = CompileShaderViaCode(pixelCode, GL_FRAGMENT_SHADER);
-	GLuint p = LinkProgram(vshader, pshader);
-	glDetachShader(p, vshader);
-	glDetachShader(p, pshader);
-	glDeleteShader(vshader);
-	glDeleteShader(pshader);
-	return p;
-}
-
-GLuint LinkProgramViaCode(const char **vertexCode,
-						  const char **tessellationControlCode,
-						  const char **tessellationEvalCode,
-						  const char **geometryCode,
-						  const char **pixelCode) {
-	GLuint vshader = CompileShaderViaCode(vertexCode, GL_VERTEX_SHADER);
-	GLuint tcshader = 0;
-#ifdef GL_TESS_EVALUATION_SHADER
-	if (tessellationControlCode)
-		tcshader = CompileShaderViaCode(tessellationControlCode, GL_TESS_CONTROL_SHADER);
-#endif
-	GLuint teshader = 0;
-#ifdef GL_TESS_EVALUATION_SHADER
-	if (tessellationEvalCode)
-		teshader = CompileShaderViaCode(tessellationEvalCode, GL_TESS_EVALUATION_SHADER);
-#endif
-	GLuint gshader = geometryCode? CompileShaderViaCode(geometryCode, GL_GEOMETRY_SHADER) : 0;
-	GLuint pshader = CompileShaderViaCode(pixelCode, GL_FRAGMENT_SHADER);
-	return LinkProgram(vshader, tcshader, teshader, gshader, pshader);
-}
-
-// **** COMPUTE SHADER NOT SUPPORTED BY OPENGL3.x
-
-void LinkProgramViaCode(GLuint computeProgram, const char **computeCode) {
-	GLuint computeShader = CompileShaderViaCode(computeCode, GL_COMPUTE_SHADER);
-	glAttachShader(computeProgram, computeShader);
-	glLinkProgram(computeProgram);
-	glDetachShader(computeProgram, computeShader);
-	glDeleteShader(computeShader);
-	GLint status;
-	glGetProgramiv(computeProgram, GL_LINK_STATUS, &status);
-	if (status == GL_FALSE) PrintProgramLog(computeProgram);
-}
-
-GLuint LinkProgramViaCode(const char **computeCode) {
-	GLuint computeProgram = glCreateProgram();
-	LinkProgramViaCode(computeProgram, computeCode);
-	return computeProgram;
-}
-
-GLuint LinkProgramViaFile(const char *computeShaderFile) {
-	GLuint cshader = CompileShaderViaFile(computeShaderFile, GL_COMPUTE_SHADER);
-	if (!cshader)
-		return 0;
-	GLuint program = glCreateProgram();
-	glAttachShader(program, cshader);
-	glLinkProgram(program);
-	GLint status;
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if (status == GL_FALSE) PrintProgramLog(program);
-	return program;
-}
-
-GLuint LinkProgram(GLuint vshader, GLuint pshader) {
-	return LinkProgram(vshader, 0, 0, 0, pshader);
-}
-
-GLuint LinkProgram(GLuint vshader, GLuint tcshader, GLuint teshader, GLuint gshader, GLuint pshader) {
-	GLuint program = 0;
-	// create shader program
-	if (vshader && pshader)
-		program = glCreateProgram();
-	if (program > 0) {
-		// attach shaders to program
-		glAttachShader(program, vshader);
-		if (tcshader > 0) glAttachShader(program, tcshader);
-		if (teshader > 0) glAttachShader(program, teshader);
-		if (gshader > 0) glAttachShader(program, gshader);
-		glAttachShader(program, pshader);
-		// link and verify
-		glLinkProgram(program);
-		GLint status;
-		glGetProgramiv(program, GL_LINK_STATUS, &status);
-		if (status == GL_FALSE) PrintProgramLog(program);
-	}
-	return program;
-}
-
-GLuint LinkProgramViaFile(const char *vertexShaderFile, const char *pixelShaderFile) {
-	GLuint vshader = CompileShaderViaFile(vertexShaderFile, GL_VERTEX_SHADER);
-	GLuint fshader = CompileShaderViaFile(pixelShaderFile, GL_FRAGMENT_SHADER);
-	return LinkProgram(vshader, fshader);
-}
-
-// Miscellany
-
-int CurrentProgram() {
-	int program = 0;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
-	return program;
-}
-
-void DeleteProgram(int program) {
-	GLint nShaders = 0;
-	GLuint shaderNames[10];
-	glGetProgramiv(program, GL_ATTACHED_SHADERS, &nShaders);
-	glGetAttachedShaders(program, nShaders, NULL, shaderNames);
-	for (int i = 0; i < nShaders; i++)
-		glDeleteShader(shaderNames[i]);
-	glDeleteProgram(program);
-}
-
-// Binary Read/Write **** NOT SUPPORTED BY OPENGL3.x
-// Binary Read/Write **** NOT SUPPORTED BY OPENGL3.x
-
-void WriteProgramBinary(GLuint program, const char *filename) {
-	GLenum binaryFormat = 0;
-	GLsizei sizeBinary = 0, sizeEnum = sizeof(GLenum);
-	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &sizeBinary);
-	std::vector<std::byte> data(sizeBinary);
-	glGetProgramBinary(program, sizeBinary, NULL, &binaryFormat, &data[0]);
-	FILE *out = fopen(filename, "wb");
-	fwrite(&binaryFormat, sizeEnum, 1, out);
-	fwrite(&data[0], 1, sizeBinary, out);
-	fclose(out);
-}
-
-bool ReadProgramBinary(GLuint program, const char *filename) {
-	FILE *in = fopen(filename, "rb");
-	if (in != NULL) {
-		fseek(in, 0, SEEK_END);
-		long filesize = ftell(in);
-		int sizeEnum = sizeof(GLenum), sizeBinary = filesize-sizeEnum;
-		std::vector<std::byte> data(sizeBinary);
-		GLenum binaryFormat;
-		fseek(in, 0, 0);
-		fread((char *) &binaryFormat, sizeEnum, 1, in);
-		fread((char *) &data[0], 1, sizeBinary, in);
-		fclose(in);
-		glProgramBinary(program, binaryFormat, &data[0], sizeBinary);
-		return true;
-	}
-	return false;
-}
-
-GLuint ReadProgramBinary(const char *filename) {
-	GLuint program = glCreateProgram();
-	if (!ReadProgramBinary(program, filename)) {
-		glDeleteProgram(program);
-		return 0;
-	}
-	return program;
-}
-
-// Uniform Access
-
-bool squawk = false;
-
-void SetReport(bool report) {
-	squawk = report;
-}
-
-bool Bad(const char *name) {
-	if (squawk)
-		printf("can't find named uniform: %s\n", name);
-	return false;
-}
-
-bool SetUniform(int program, const char *name, bool val) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform1ui(id, val? 1 : 0);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, int val) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform1i(id, val);
-	return true;
-}
-
-// following might confuse some compilers
-bool SetUniform(int program, const char *name, GLuint val) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform1ui(id, val);
-	return true;
-}
-
-bool SetUniformv(int program, const char *name, int count, int *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform1iv(id, count, v);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, float val) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform1f(id, val);
-	return true;
-}
-
-bool SetUniformv(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform1fv(id, count, v);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, vec2 v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform2f(id, v.x, v.y);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, vec3 v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform3f(id, v.x, v.y, v.z);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, vec4 v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform4f(id, v.x, v.y, v.z, v.w);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, vec3 *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform3fv(id, 1, (float *) v);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, vec4 *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform4fv(id, 1, (float *) v);
-	return true;
-}
-
-bool SetUniform3(int program, const char *name, float *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform3fv(id, 1, v);
-	return true;
-}
-
-bool SetUniform3v(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform3fv(id, count, v);
-	return true;
-}
-
-bool SetUniform4v(int program, const char *name, int count, float *v) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniform4fv(id, count, v);
-	return true;
-}
-
-bool SetUniform(int program, const char *name, mat4 m) {
-	GLint id = glGetUniformLocation(program, name);
-	if (id < 0)
-		return Bad(name);
-	glUniformMatrix4fv(id, 1, true, (float *) &m[0][0]);
-	return true;
-}
-
-// Attribute Access
-
-void DisableVertexAttribute(int program, const char *name) {
-	GLint id = glGetAttribLocation(program, name);
-	if (id < 0 && squawk)
-		printf("cant find attribute %s\n", name);
-	if (id >= 0)
-		glDisableVertexAttribArray(id);
-}
-
-int EnableVertexAttribute(int program, const char *name) {
-	GLint id = glGetAttribLocation(program, name);
-	if (id < 0 && squawk)
-		printf("cant find attribute %s\n", name);
-	if (id >= 0)
-		glEnableVertexAttribArray(id);
-	return id;
-}
-
-void VertexAttribPointer(int program, const char *name, GLint ncomponents, GLsizei stride, const GLvoid *offset) {
-	GLint id = EnableVertexAttribute(program, name);
-	if (id < 0 && squawk)
-		printf("cant find attribute %s\n", name);
-	if (id >= 0)
-		glVertexAttribPointer(id, ncomponents, GL_FLOAT, GL_FALSE, stride, offset);
-}
+// GLXtras.cpp - GLSL support (c) 2019-2022 Jules Bloomenthal
+
+#include <glad.h>
+#include <GL/glu.h>
+#include "GLXtras.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+// Print OpenGL, GLSL Details
+
+int PrintGLErrors(const char *title) {
+	char buf[1000];
+	int nErrors = 0;
+	buf[0] = 0;
+	for (;;) {
+		GLenum n = glGetError();
+		if (n == GL_NO_ERROR)
+			break;
+		sprintf(buf+strlen(buf), "%s%s", !nErrors++? "" : ", ", gluErrorString(n));
+			// do not call Debug() while looping through errors, so accumulate in buf
+	}
+	if (nErrors) {
+		if (title) printf("%s (GL errors): %s\n", title, buf);
+		else printf("GL errors: %s\n", buf);
+	}
+	return nErrors;
+}
+
+void PrintVersionInfo() {
+	const GLubyte *renderer    = glGetString(GL_RENDERER);
+	const GLubyte *vendor      = glGetString(GL_VENDOR);
+	const GLubyte *version     = glGetString(GL_VERSION);
+	const GLubyte *glslVersion = glGetString(GL_SHADING_LANGUAGE_VERSION);
+	printf("GL vendor: %s\n", vendor);
+	printf("GL renderer: %s\n", renderer);
+	printf("GL version: %s\n", version);
+	printf("GLSL version: %s\n", glslVersion);
+	// GLint major, minor;
+	// glGetIntegerv(GL_MAJOR_VERSION, &major);
+	// glGetIntegerv(GL_MINOR_VERSION, &minor);
+	// printf("GL version (integer): %d.%d\n", major, minor);
+}
+
+void PrintExtensions() {
+	const GLubyte *extensions = glGetString(GL_EXTENSIONS);
+	const char *skip = "(, \t\n";
+	char buf[100];
+	printf("\nGL extensions:\n");
+	if (extensions)
+		for (char *c = (char *) extensions; *c; ) {
+				c += strspn(c, skip);
+				size_t nchars = strcspn(c, skip);
+				strncpy(buf, c, nchars);
+				buf[nchars] = 0;
+				printf("  %s\n", buf);
+				c += nchars;
+		}
+}
+
+void PrintProgramLog(int programID) {
+	GLint logLen;
+	glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &logLen);
+	if (logLen > 0) {
+		char *log = new char[logLen];
+		GLsizei written;
+		glGetProgramInfoLog(programID, logLen, &written, log);
+		printf("Program log:\n%s", log);
+		delete [] log;
+	}
+}
+
+void PrintProgramAttributes(int programID) {
+	GLint maxLength, nAttribs;
+	glGetProgramiv(programID, GL_ACTIVE_ATTRIBUTES, &nAttribs);
+	glGetProgramiv(programID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+	char *name = new char[maxLength];
+	GLint written, size;
+	GLenum type;
+	for (int i = 0; i < nAttribs; i++) {
+		glGetActiveAttrib(programID, i, maxLength, &written, &size, &type, name);
+		GLint location = glGetAttribLocation(programID, name);
+		printf("    %-5i  |  %s\n", location, name);
+	}
+	delete [] name;
+}
+
+void PrintProgramUniforms(int programID) {
+	GLenum type;
+	GLchar name[201];
+	GLint nUniforms, length, size;
+	glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &nUniforms);
+	printf("  uniforms\n");
+	for (int i = 0; i < nUniforms; i++) {
+		glGetActiveUniform(programID, i,  200,  &length, &size, &type, name);
+		printf("    %s\n", name);
+	}
+}
+
+// Compilation
+
+GLuint CompileShaderViaFile(const char *filename, GLint type) {
+		FILE* fp = fopen(filename, "r");
+		if (fp == NULL) {
+			printf("can't open file\n");
+			return 0;
+		}
+		fseek(fp, 0L, SEEK_END);
+		long maxSize = ftell(fp);
+		fseek(fp, 0L, SEEK_SET);
+		char *buf = new char[maxSize+1], c;
+		int nchars = 0;
+		while ((c = fgetc(fp)) != EOF)
+			buf[nchars++] = c;
+		buf[nchars] = 0;
+		fclose(fp);
+		GLuint s = CompileShaderViaCode((const char **) &buf, type);
+		delete [] buf;
+		return s;
+}
+
+namespace {
+
+void PrintShaderLog(GLuint shader) {
+	GLint logLen;
+	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLen);
+	if (logLen > 0) {
+		GLsizei written;
+		char *log = new char[logLen];
+		glGetShaderInfoLog(shader, logLen, &written, log);
+		printf("compilation failed: %s", log);
+		delete [] log;
+	}
+	else printf("shader compilation failed\n");
+}
+
+} // end namespace
+
+GLuint CompileShaderViaCode(const char **code, GLint type) {
+	GLuint shader = glCreateShader(type);
+	if (!shader) {
+		//		PrintGLErrors();
+		return false;
+	}
+	glShaderSource(shader, 1, code, NULL);
+	glCompileShader(shader);
+	// check compile status
+	GLint result;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+	if (result == GL_FALSE) {
+		// squawk logged errors
+		PrintShaderLog(shader);
+		return 0;
+	}
+	return shader;
+}
+
+// Uniform Tables
+
+namespace {
+
+struct UniformSlot {
+	GLint location = -1;
+	bool known = false;					// if true, value is the last upload
+	std::vector<char> value;
+	std::vector<int> overlaps;			// slots of an array and its elements (eg, "lights" and "lights[2]")
+};
+
+struct UniformTable {
+	int generation = 0;					// distinguishes successive links of a program name
+	std::unordered_map<std::string, int> slots;
+	std::vector<UniformSlot> uniforms;
+};
+
+std::unordered_map<int, UniformTable> uniformTables;
+UniformTable *lastTable = NULL;			// most programs set several uniforms in a row
+int lastProgram = 0, nGenerations = 0;
+
+void DeleteUniformTable(int program) {
+	uniformTables.erase(program);
+	lastTable = NULL;
+}
+
+// Current Program
+
+// the current program is recorded by wrapping glad's glUseProgram, so SetUniform need not query GL
+// (a glGet can stall a threaded driver); glDeleteProgram is wrapped to drop the program's table
+
+PFNGLUSEPROGRAMPROC useProgram = NULL;
+PFNGLDELETEPROGRAMPROC deleteProgram = NULL;
+GLint currentProgram = 0;
+
+void APIENTRY TrackedUseProgram(GLuint program) {
+	currentProgram = program;
+	useProgram(program);
+}
+
+void APIENTRY TrackedDeleteProgram(GLuint program) {
+	DeleteUniformTable(program);
+	deleteProgram(program);
+}
+
+void TrackProgram() {
+	// wrap glad's pointers on first use (a later wrapper, eg a call counter, calls through to these),
+	// and query the current program this once
+	if (useProgram || !glad_glUseProgram)
+		return;
+	useProgram = glad_glUseProgram;
+	deleteProgram = glad_glDeleteProgram;
+	glad_glUseProgram = TrackedUseProgram;
+	glad_glDeleteProgram = TrackedDeleteProgram;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+}
+
+int AddSlot(UniformTable &t, const std::string &name, GLint location) {
+	int slot = (int) t.uniforms.size();
+	t.uniforms.resize(slot+1);
+	t.uniforms[slot].location = location;
+	t.slots[name] = slot;
+	return slot;
+}
+
+UniformTable &BuildUniformTable(int program) {
+	// enumerate active uniforms; an array is entered as both "name[0]" and "name"
+	TrackProgram();
+	UniformTable &t = uniformTables[program];
+	t = UniformTable();
+	t.generation = ++nGenerations;
+	GLint linked = GL_FALSE, nUniforms = 0, maxLength = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+		return t;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &nUniforms);
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	std::vector<char> name(maxLength+1, 0);
+	for (int i = 0; i < nUniforms; i++) {
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(program, i, maxLength+1, NULL, &size, &type, name.data());
+		GLint location = glGetUniformLocation(program, name.data());
+		if (location < 0)
+			continue;					// uniform block member
+		int slot = AddSlot(t, name.data(), location);
+		size_t len = strlen(name.data());
+		if (len > 3 && !strcmp(name.data()+len-3, "[0]"))
+			t.slots[std::string(name.data(), len-3)] = slot;
+	}
+	return t;
+}
+
+UniformTable &Table(int program) {
+	TrackProgram();
+	if (program != lastProgram || !lastTable) {
+		std::unordered_map<int, UniformTable>::iterator it = uniformTables.find(program);
+		lastTable = it != uniformTables.end()? &it->second : &BuildUniformTable(program);
+		lastProgram = program;
+	}
+	return *lastTable;
+}
+
+int SlotIndex(UniformTable &t, int program, const char *name) {
+	// names not enumerated at link (eg, "lights[2]" or misspellings) are resolved once
+	std::unordered_map<std::string, int>::iterator it = t.slots.find(name);
+	if (it != t.slots.end())
+		return it->second;
+	int slot = AddSlot(t, name, glGetUniformLocation(program, name));
+	const char *bracket = strchr(name, '[');
+	if (bracket && t.uniforms[slot].location >= 0) {
+		// an element overlaps its array: setting either invalidates the other
+		it = t.slots.find(std::string(name, bracket-name));
+		if (it != t.slots.end()) {
+			t.uniforms[slot].overlaps.push_back(it->second);
+			t.uniforms[it->second].overlaps.push_back(slot);
+		}
+	}
+	return slot;
+}
+
+void ForgetValues(UniformTable &t) {
+	for (UniformSlot &u : t.uniforms)
+		u.known = false;
+}
+
+UniformSlot unrecorded;
+
+UniformSlot *Current(int program, UniformSlot &u) {
+	// glUniform sets the current program: if not program, record no value, and forget those of the current program
+	if (u.location < 0)
+		return NULL;
+#ifndef NDEBUG
+	GLint current = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+	assert(current == currentProgram);	// else glUseProgram was called other than through glad
+#endif
+	if (currentProgram == program)
+		return &u;
+	std::unordered_map<int, UniformTable>::iterator it = uniformTables.find(currentProgram);
+	if (it != uniformTables.end())
+		ForgetValues(it->second);
+	unrecorded = UniformSlot();
+	unrecorded.location = u.location;
+	return &unrecorded;
+}
+
+UniformSlot *Slot(int program, const char *name) {
+	if (program <= 0)
+		return NULL;
+	UniformTable &t = Table(program);
+	return Current(program, t.uniforms[SlotIndex(t, program, name)]);
+}
+
+UniformSlot *Slot(UniformHandle &h) {
+	if (h.program <= 0)
+		return NULL;
+	UniformTable &t = Table(h.program);
+	if (h.generation != t.generation) {
+		h.slot = SlotIndex(t, h.program, h.name.c_str());
+		h.generation = t.generation;
+	}
+	return Current(h.program, t.uniforms[h.slot]);
+}
+
+bool Changed(UniformSlot &u, const void *data, size_t nBytes) {
+	// compare data with last upload, record data (u is in lastTable, per Slot)
+	if (u.known && u.value.size() == nBytes && !memcmp(u.value.data(), data, nBytes))
+		return false;
+	u.value.assign((const char *) data, (const char *) data+nBytes);
+	u.known = &u != &unrecorded;
+	for (int i : u.overlaps)
+		lastTable->uniforms[i].known = false;
+	return true;
+}
+
+} // end namespace
+
+// Program Cache
+
+namespace {
+
+std::string DefaultCacheDirectory() {
+	// per user: LOCALAPPDATA on Windows, else XDG_CACHE_HOME (if absolute) or HOME/.cache; "" if none
+#ifdef _WIN32
+	const char *base = getenv("LOCALAPPDATA");
+	return base && *base? std::string(base)+"/GLXtras/ShaderCache" : "";
+#else
+	const char *xdg = getenv("XDG_CACHE_HOME"), *home = getenv("HOME");
+	if (xdg && *xdg == '/')
+		return std::string(xdg)+"/GLXtras/ShaderCache";
+	return home && *home? std::string(home)+"/.cache/GLXtras/ShaderCache" : "";
+#endif
+}
+
+std::string cacheDirectory = DefaultCacheDirectory();
+bool cacheChecked = false;				// cacheDirectory created and verified private
+
+bool PrivateDirectory(std::string &dir) {
+	// create dir (and any missing parents) accessible only by the user; false if that fails or,
+	// other than on Windows, dir is a link, isn't owned by the user, or is writable by others
+	for (size_t i = 1; i <= dir.size(); i++)
+		if (i == dir.size() || dir[i] == '/' || dir[i] == '\\') {
+			std::string d = dir.substr(0, i);
+#ifdef _WIN32
+			_mkdir(d.c_str());
+#else
+			mkdir(d.c_str(), 0700);
+#endif
+		}
+#ifdef _WIN32
+	struct _stat st;
+	return _stat(dir.c_str(), &st) == 0 && (st.st_mode & _S_IFDIR);
+#else
+	struct stat st;
+	return lstat(dir.c_str(), &st) == 0 && S_ISDIR(st.st_mode) && st.st_uid == getuid() && !(st.st_mode & 022);
+#endif
+}
+
+typedef unsigned long long Hash64;
+
+Hash64 Hash(Hash64 h, const void *data, size_t nBytes) {
+	// FNV-1a
+	for (size_t i = 0; i < nBytes; i++)
+		h = (h^((const unsigned char *) data)[i])*1099511628211ull;
+	return h;
+}
+
+std::string CacheFile(int nStages, const char ***codes, const GLenum *types) {
+	// name of binary for given shader sources on this driver, or "" if no cache or no binary support
+	GLint nFormats = 0;
+	if (!cacheChecked) {
+		cacheChecked = true;
+		if (!cacheDirectory.empty() && !PrivateDirectory(cacheDirectory)) {
+			printf("shader cache %s not private to user: disabled\n", cacheDirectory.c_str());
+			cacheDirectory = "";
+		}
+	}
+	if (cacheDirectory.empty() || !glProgramBinary || !glGetProgramBinary)
+		return "";
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+	if (nFormats < 1)
+		return "";
+	Hash64 h = 14695981039346656037ull;
+	GLenum driver[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+	for (GLenum d : driver) {
+		const char *s = (const char *) glGetString(d);
+		if (s) h = Hash(h, s, strlen(s)+1);
+	}
+	for (int i = 0; i < nStages; i++)
+		if (codes[i] && *codes[i]) {
+			h = Hash(h, &types[i], sizeof(GLenum));
+			h = Hash(h, *codes[i], strlen(*codes[i])+1);
+		}
+	char name[32];
+	snprintf(name, sizeof(name), "/%016llx.bin", h);
+	return cacheDirectory+name;
+}
+
+GLuint ReadCachedProgram(std::string &file) {
+	// return linked program from file, else 0; remove file if driver rejects it
+	if (file.empty())
+		return 0;
+	FILE *in = fopen(file.c_str(), "rb");
+	if (!in)
+		return 0;
+	fclose(in);
+	GLuint program = glCreateProgram();
+	GLint status = GL_FALSE;
+	if (ReadProgramBinary(program, file.c_str()))
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) {
+		DeleteProgram(program);
+		remove(file.c_str());
+		return 0;
+	}
+	return program;
+}
+
+void SetRetrievable(GLuint program) {
+	// hint, before linking, that the binary will be read back for the cache
+	if (!cacheDirectory.empty() && glProgramParameteri)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void WriteCachedProgram(GLuint program, std::string &file) {
+	// write via temporary file so a concurrent reader never sees a partial binary
+	GLint status = GL_FALSE;
+	if (file.empty() || !program)
+		return;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	std::string temp = file+".tmp";
+	if (status == GL_TRUE && WriteProgramBinary(program, temp.c_str())) {
+		if (rename(temp.c_str(), file.c_str()) != 0) {
+			remove(file.c_str());
+			if (rename(temp.c_str(), file.c_str()) != 0)
+				remove(temp.c_str());
+		}
+	}
+}
+
+} // end namespace
+
+void SetShaderCache(const char *directory) {
+	cacheDirectory = directory? directory : "";
+	cacheChecked = false;
+}
+
+// Linking
+
+GLuint LinkProgramViaCode(const char **vertexCode, const char **pixelCode) {
+	const char **codes[] = { vertexCode, pixelCode };
+	GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	std::string cacheFile = CacheFile(2, codes, types);
+	GLuint p = ReadCachedProgram(cacheFile);
+	if (p)
+		return p;
+	GLuint vshader = CompileShaderViaCode(vertexCode, GL_VERTEX_SHADER);
+	GLuint pshader = CompileShaderViaCode(pixelCode, GL_FRAGMENT_SHADER);
+	p = LinkProgram(vshader, pshader);
+	glDetachShader(p, vshader);
+	glDetachShader(p, pshader);
+	glDeleteShader(vshader);
+	glDeleteShader(pshader);
+	WriteCachedProgram(p, cacheFile);
+	return p;
+}
+
+GLuint LinkProgramViaCode(const char **vertexCode,
+						  const char **tessellationControlCode,
+						  const char **tessellationEvalCode,
+						  const char **geometryCode,
+						  const char **pixelCode) {
+	const char **codes[] = { vertexCode, tessellationControlCode, tessellationEvalCode, geometryCode, pixelCode };
+	GLenum types[] = { GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+	std::string cacheFile = CacheFile(5, codes, types);
+	GLuint p = ReadCachedProgram(cacheFile);
+	if (p)
+		return p;
+	GLuint vshader = CompileShaderViaCode(vertexCode, GL_VERTEX_SHADER);
+	GLuint tcshader = 0;
+#ifdef GL_TESS_EVALUATION_SHADER
+	if (tessellationControlCode)
+		tcshader = CompileShaderViaCode(tessellationControlCode, GL_TESS_CONTROL_SHADER);
+#endif
+	GLuint teshader = 0;
+#ifdef GL_TESS_EVALUATION_SHADER
+	if (tessellationEvalCode)
+		teshader = CompileShaderViaCode(tessellationEvalCode, GL_TESS_EVALUATION_SHADER);
+#endif
+	GLuint gshader = geometryCode? CompileShaderViaCode(geometryCode, GL_GEOMETRY_SHADER) : 0;
+	GLuint pshader = CompileShaderViaCode(pixelCode, GL_FRAGMENT_SHADER);
+	p = LinkProgram(vshader, tcshader, teshader, gshader, pshader);
+	WriteCachedProgram(p, cacheFile);
+	return p;
+}
+
+// **** COMPUTE SHADER NOT SUPPORTED BY OPENGL3.x
+
+void LinkProgramViaCode(GLuint computeProgram, const char **computeCode) {
+	GLuint computeShader = CompileShaderViaCode(computeCode, GL_COMPUTE_SHADER);
+	glAttachShader(computeProgram, computeShader);
+	glLinkProgram(computeProgram);
+	glDetachShader(computeProgram, computeShader);
+	glDeleteShader(computeShader);
+	GLint status;
+	glGetProgramiv(computeProgram, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) PrintProgramLog(computeProgram);
+	BuildUniformTable(computeProgram);
+}
+
+GLuint LinkProgramViaCode(const char **computeCode) {
+	const char **codes[] = { computeCode };
+	GLenum types[] = { GL_COMPUTE_SHADER };
+	std::string cacheFile = CacheFile(1, codes, types);
+	GLuint computeProgram = ReadCachedProgram(cacheFile);
+	if (computeProgram)
+		return computeProgram;
+	computeProgram = glCreateProgram();
+	SetRetrievable(computeProgram);
+	LinkProgramViaCode(computeProgram, computeCode);
+	WriteCachedProgram(computeProgram, cacheFile);
+	return computeProgram;
+}
+
+GLuint LinkProgramViaFile(const char *computeShaderFile) {
+	GLuint cshader = CompileShaderViaFile(computeShaderFile, GL_COMPUTE_SHADER);
+	if (!cshader)
+		return 0;
+	GLuint program = glCreateProgram();
+	glAttachShader(program, cshader);
+	glLinkProgram(program);
+	GLint status;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) PrintProgramLog(program);
+	BuildUniformTable(program);
+	return program;
+}
+
+GLuint LinkProgram(GLuint vshader, GLuint pshader) {
+	return LinkProgram(vshader, 0, 0, 0, pshader);
+}
+
+GLuint LinkProgram(GLuint vshader, GLuint tcshader, GLuint teshader, GLuint gshader, GLuint pshader) {
+	GLuint program = 0;
+	// create shader program
+	if (vshader && pshader)
+		program = glCreateProgram();
+	if (program > 0) {
+		SetRetrievable(program);
+		// attach shaders to program
+		glAttachShader(program, vshader);
+		if (tcshader > 0) glAttachShader(program, tcshader);
+		if (teshader > 0) glAttachShader(program, teshader);
+		if (gshader > 0) glAttachShader(program, gshader);
+		glAttachShader(program, pshader);
+		// link and verify
+		glLinkProgram(program);
+		GLint status;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status == GL_FALSE) PrintProgramLog(program);
+		BuildUniformTable(program);
+	}
+	return program;
+}
+
+GLuint LinkProgramViaFile(const char *vertexShaderFile, const char *pixelShaderFile) {
+	GLuint vshader = CompileShaderViaFile(vertexShaderFile, GL_VERTEX_SHADER);
+	GLuint fshader = CompileShaderViaFile(pixelShaderFile, GL_FRAGMENT_SHADER);
+	return LinkProgram(vshader, fshader);
+}
+
+// Asynchronous Linking
+
+bool ParallelShaderCompile() {
+	static int parallel = -1;
+	if (parallel < 0) {
+		parallel = GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+		if (GLAD_GL_KHR_parallel_shader_compile)
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		else if (GLAD_GL_ARB_parallel_shader_compile)
+			glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+	}
+	return parallel == 1;
+}
+
+namespace {
+
+ProgramFuture LinkProgramAsync(int nStages, const char ***codes, const GLenum *types) {
+	ProgramFuture f;
+	f.cacheFile = CacheFile(nStages, codes, types);
+	f.program = ReadCachedProgram(f.cacheFile);
+	if (f.program) {
+		f.done = true;
+		return f;
+	}
+	ParallelShaderCompile();
+	f.program = glCreateProgram();
+	SetRetrievable(f.program);
+	for (int i = 0; i < nStages; i++)
+		if (codes[i]) {
+			GLuint shader = glCreateShader(types[i]);
+			glShaderSource(shader, 1, codes[i], NULL);
+			glCompileShader(shader);
+			glAttachShader(f.program, shader);
+			f.shaders[f.nShaders++] = shader;
+		}
+	glLinkProgram(f.program);
+	return f;
+}
+
+} // end namespace
+
+ProgramFuture LinkProgramAsync(const char **vertexCode, const char **pixelCode) {
+	const char **codes[] = { vertexCode, pixelCode };
+	GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	return LinkProgramAsync(2, codes, types);
+}
+
+ProgramFuture LinkProgramAsync(const char **vertexCode,
+							   const char **tessellationControlCode,
+							   const char **tessellationEvalCode,
+							   const char **geometryCode,
+							   const char **pixelCode) {
+	const char **codes[] = { vertexCode, tessellationControlCode, tessellationEvalCode, geometryCode, pixelCode };
+	GLenum types[] = { GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+	return LinkProgramAsync(5, codes, types);
+}
+
+bool ProgramFuture::Ready() {
+	if (done || !ParallelShaderCompile())
+		return true;
+	GLint complete = GL_FALSE;
+	glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+	return complete == GL_TRUE;
+}
+
+GLuint ProgramFuture::Get() {
+	if (done)
+		return program;
+	done = true;
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) {
+		for (int i = 0; i < nShaders; i++) {
+			GLint compiled = GL_FALSE;
+			glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &compiled);
+			if (compiled == GL_FALSE)
+				PrintShaderLog(shaders[i]);
+		}
+		PrintProgramLog(program);
+	}
+	for (int i = 0; i < nShaders; i++) {
+		glDetachShader(program, shaders[i]);
+		glDeleteShader(shaders[i]);
+	}
+	nShaders = 0;
+	if (status == GL_FALSE) {
+		glDeleteProgram(program);
+		return program = 0;
+	}
+	BuildUniformTable(program);
+	WriteCachedProgram(program, cacheFile);
+	return program;
+}
+
+// Library Programs
+
+namespace {
+
+std::vector<LazyProgram *> &LazyPrograms() {
+	// registered at static initialization, hence a function static
+	static std::vector<LazyProgram *> programs;
+	return programs;
+}
+
+bool startupLog = false;
+
+void StartupLog(const char *event, const char *name, double wait = -1) {
+	// milliseconds since the first event
+	static double start = -1;
+	if (!startupLog)
+		return;
+	double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	if (start < 0)
+		start = now;
+	printf("startup %7.1f ms: %s %s", 1000*(now-start), name, event);
+	if (wait >= 0)
+		printf(" (waited %.1f ms)", 1000*wait);
+	printf("\n");
+}
+
+} // end namespace
+
+LazyProgram::LazyProgram(const char *name, const char **vertexCode, const char **tessellationControlCode,
+						 const char **tessellationEvalCode, const char **geometryCode, const char **pixelCode, bool prepare)
+	: name(name), prepare(prepare) {
+	const char **c[] = { vertexCode, tessellationControlCode, tessellationEvalCode, geometryCode, pixelCode };
+	for (int i = 0; i < 5; i++)
+		codes[i] = c[i];
+	LazyPrograms().push_back(this);
+}
+
+void LazyProgram::Submit() {
+	if (submitted)
+		return;
+	submitted = true;
+	future = LinkProgramAsync(codes[0], codes[1], codes[2], codes[3], codes[4]);
+	StartupLog(future.done? "submitted (cached)" : "submitted", name);
+}
+
+GLuint LazyProgram::Get() {
+	if (got)
+		return future.program;
+	got = true;
+	Submit();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	GLuint program = future.Get();
+	StartupLog(program? "linked" : "failed", name, std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+	return program;
+}
+
+void PrepareLibraryPrograms() {
+	for (LazyProgram *p : LazyPrograms())
+		if (p->prepare)
+			p->Submit();
+}
+
+void SetStartupLog(bool log) {
+	startupLog = log;
+}
+
+// Miscellany
+
+int CurrentProgram() {
+	TrackProgram();
+	return currentProgram;
+}
+
+void DeleteProgram(int program) {
+	GLint nShaders = 0;
+	GLuint shaderNames[10];
+	glGetProgramiv(program, GL_ATTACHED_SHADERS, &nShaders);
+	glGetAttachedShaders(program, nShaders, NULL, shaderNames);
+	for (int i = 0; i < nShaders; i++)
+		glDeleteShader(shaderNames[i]);
+	glDeleteProgram(program);
+	DeleteUniformTable(program);
+}
+
+// Binary Read/Write **** NOT SUPPORTED BY OPENGL3.x
+// Binary Read/Write **** NOT SUPPORTED BY OPENGL3.x
+
+bool WriteProgramBinary(GLuint program, const char *filename) {
+	GLenum binaryFormat = 0;
+	GLsizei sizeBinary = 0, sizeEnum = sizeof(GLenum);
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &sizeBinary);
+	if (sizeBinary <= 0)
+		return false;
+	std::vector<std::byte> data(sizeBinary);
+	glGetProgramBinary(program, sizeBinary, NULL, &binaryFormat, &data[0]);
+	FILE *out = fopen(filename, "wb");
+	if (!out)
+		return false;
+	bool ok = fwrite(&binaryFormat, sizeEnum, 1, out) == 1 && fwrite(&data[0], 1, sizeBinary, out) == (size_t) sizeBinary;
+	return fclose(out) == 0 && ok;
+}
+
+bool ReadProgramBinary(GLuint program, const char *filename) {
+	FILE *in = fopen(filename, "rb");
+	if (in != NULL) {
+		fseek(in, 0, SEEK_END);
+		long filesize = ftell(in);
+		int sizeEnum = sizeof(GLenum), sizeBinary = filesize-sizeEnum;
+		GLenum binaryFormat;
+		std::vector<std::byte> data(sizeBinary > 0? sizeBinary : 1);
+		fseek(in, 0, 0);
+		bool ok = sizeBinary > 0 &&
+				  fread((char *) &binaryFormat, sizeEnum, 1, in) == 1 &&
+				  fread((char *) &data[0], 1, sizeBinary, in) == (size_t) sizeBinary;
+		fclose(in);
+		// a format the driver no longer supports would be a GL error
+		GLint nFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+		std::vector<GLint> formats(nFormats > 0? nFormats : 1, 0);
+		if (nFormats > 0)
+			glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+		bool supported = false;
+		for (int i = 0; i < nFormats; i++)
+			supported = supported || (GLenum) formats[i] == binaryFormat;
+		if (!ok || !supported)
+			return false;
+		glProgramBinary(program, binaryFormat, &data[0], sizeBinary);
+		BuildUniformTable(program);
+		return true;
+	}
+	return false;
+}
+
+GLuint ReadProgramBinary(const char *filename) {
+	GLuint program = glCreateProgram();
+	if (!ReadProgramBinary(program, filename)) {
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+// Uniform Access
+
+bool squawk = false;
+
+void SetReport(bool report) {
+	squawk = report;
+}
+
+bool Bad(const char *name) {
+	if (squawk)
+		printf("can't find named uniform: %s\n", name);
+	return false;
+}
+
+int UniformLocation(int program, const char *name) {
+	UniformSlot *u = Slot(program, name);
+	return u? u->location : -1;
+}
+
+void InvalidateUniforms(int program) {
+	// the table is rebuilt on next use; handles re-resolve as it has a new generation
+	DeleteUniformTable(program);
+}
+
+bool SetUniform(int program, const char *name, bool val) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	GLuint v = val? 1 : 0;
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform1ui(u->location, v);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, int val) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &val, sizeof(val)))
+		glUniform1i(u->location, val);
+	return true;
+}
+
+// following might confuse some compilers
+bool SetUniform(int program, const char *name, GLuint val) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &val, sizeof(val)))
+		glUniform1ui(u->location, val);
+	return true;
+}
+
+bool SetUniformv(int program, const char *name, int count, int *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, count*sizeof(int)))
+		glUniform1iv(u->location, count, v);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, float val) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &val, sizeof(val)))
+		glUniform1f(u->location, val);
+	return true;
+}
+
+bool SetUniformv(int program, const char *name, int count, float *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, count*sizeof(float)))
+		glUniform1fv(u->location, count, v);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, vec2 v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform2f(u->location, v.x, v.y);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, vec3 v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform3f(u->location, v.x, v.y, v.z);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, vec4 v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform4f(u->location, v.x, v.y, v.z, v.w);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, vec3 *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, sizeof(vec3)))
+		glUniform3fv(u->location, 1, (float *) v);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, vec4 *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, sizeof(vec4)))
+		glUniform4fv(u->location, 1, (float *) v);
+	return true;
+}
+
+bool SetUniform3(int program, const char *name, float *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, 3*sizeof(float)))
+		glUniform3fv(u->location, 1, v);
+	return true;
+}
+
+bool SetUniform3v(int program, const char *name, int count, float *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, 3*count*sizeof(float)))
+		glUniform3fv(u->location, count, v);
+	return true;
+}
+
+bool SetUniform4v(int program, const char *name, int count, float *v) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, v, 4*count*sizeof(float)))
+		glUniform4fv(u->location, count, v);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, mat3 m) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &m, sizeof(m)))
+		glUniformMatrix3fv(u->location, 1, true, (float *) &m[0][0]);
+	return true;
+}
+
+bool SetUniform(int program, const char *name, mat4 m) {
+	UniformSlot *u = Slot(program, name);
+	if (!u)
+		return Bad(name);
+	if (Changed(*u, &m, sizeof(m)))
+		glUniformMatrix4fv(u->location, 1, true, (float *) &m[0][0]);
+	return true;
+}
+
+// Uniform Handles
+
+UniformHandle::UniformHandle(int program, const char *name) : program(program), name(name) {
+	Location();
+}
+
+GLint UniformHandle::Location() {
+	UniformSlot *u = Slot(*this);
+	return u? u->location : -1;
+}
+
+bool SetUniform(UniformHandle &h, bool val) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	GLuint v = val? 1 : 0;
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform1ui(u->location, v);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, int val) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &val, sizeof(val)))
+		glUniform1i(u->location, val);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, float val) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &val, sizeof(val)))
+		glUniform1f(u->location, val);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, vec2 v) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform2f(u->location, v.x, v.y);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, vec3 v) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform3f(u->location, v.x, v.y, v.z);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, vec4 v) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &v, sizeof(v)))
+		glUniform4f(u->location, v.x, v.y, v.z, v.w);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, mat3 m) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &m, sizeof(m)))
+		glUniformMatrix3fv(u->location, 1, true, (float *) &m[0][0]);
+	return true;
+}
+
+bool SetUniform(UniformHandle &h, mat4 m) {
+	UniformSlot *u = Slot(h);
+	if (!u)
+		return Bad(h.name.c_str());
+	if (Changed(*u, &m, sizeof(m)))
+		glUniformMatrix4fv(u->location, 1, true, (float *) &m[0][0]);
+	return true;
+}
+
+// Attribute Access
+
+void DisableVertexAttribute(int program, const char *name) {
+	GLint id = glGetAttribLocation(program, name);
+	if (id < 0 && squawk)
+		printf("cant find attribute %s\n", name);
+	if (id >= 0)
+		glDisableVertexAttribArray(id);
+}
+
+int EnableVertexAttribute(int program, const char *name) {
+	GLint id = glGetAttribLocation(program, name);
+	if (id < 0 && squawk)
+		printf("cant find attribute %s\n", name);
+	if (id >= 0)
+		glEnableVertexAttribArray(id);
+	return id;
+}
+
+void VertexAttribPointer(int program, const char *name, GLint ncomponents, GLsizei stride, const GLvoid *offset) {
+	GLint id = EnableVertexAttribute(program, name);
+	if (id < 0 && squawk)
+		printf("cant find attribute %s\n", name);
+	if (id >= 0)
+		glVertexAttribPointer(id, ncomponents, GL_FLOAT, GL_FALSE, stride, offset);
+}
@@ -1,1188 +1,3692 @@
-// Mesh.cpp - mesh IO and operations (c) 2019-2022 Jules Bloomenthal
-
-#include "CameraArcball.h"
-#include "GLXtras.h"
-#include "Draw.h"
-#include "Mesh.h"
-#include "Misc.h"
-#include "Quaternion.h"
-#include <assert.h>
-#include <iostream>
-#include <fstream>
-#include <direct.h>
-#include <float.h>
-#include <string.h>
-#include <cstdlib>
-#include "VecMat.h"
-#include "Widgets.h"
-
-using std::string;
-using std::vector;
-using std::ios;
-using std::ifstream;
-
-// Mesh Framer
-
-bool MeshFramer::Hit(int x, int y) {
-	return arcball.Hit(x, y);
-}
-
-void MeshFramer::Up() {
-	arcball.Up();
-}
-
-void MeshFramer::Set(Mesh *m, float radius, mat4 fullview) {
-	mesh = m;
-	m->frameDown = Frame(Quaternion(m->transform), MatrixOrigin(m->transform), MatrixScale(m->transform));
-	arcball.SetBody(m->transform, radius);
-	arcball.SetCenter(ScreenPoint(m->frameDown.position, fullview));
-	moverPicked = false;
-}
-
-void MeshFramer::SetFramedown(Mesh *m) {
-	m->frameDown = Frame(Quaternion(m->transform), MatrixOrigin(m->transform), MatrixScale(m->transform));
-	for (int i = 0; i < (int) m->children.size(); i++)
-		SetFramedown(m->children[i]);
-}
-
-void MeshFramer::Down(int x, int y, mat4 modelview, mat4 persp, bool control) {
-	moverPicked = arcball.MouseOver(x, y);
-	SetFramedown(mesh);
-	if (moverPicked)
-		mover.Down(&mesh->frameDown.position, x, y, modelview, persp);
-	else
-		arcball.Down(x, y, control, &mesh->transform);
-			// mesh->transform used by arcball.SetNearestAxis
-}
-
-void MeshFramer::Drag(int x, int y, mat4 modelview, mat4 persp) {
-	if (moverPicked) {
-		vec3 pDif = mover.Drag(x, y, modelview, persp);
-		SetMatrixOrigin(mesh->transform, mesh->frameDown.position);
-		for (int i = 0; i < (int) mesh->children.size(); i++)
-			TranslateTransform(mesh->children[i], pDif);
-		arcball.SetCenter(ScreenPoint(mesh->frameDown.position, persp*modelview));
-	}
-	else {
-		Quaternion qrot = arcball.Drag(x, y);
-		// recurse on children
-		RotateTransform(mesh, qrot, NULL);
-	}
-}
-
-void MeshFramer::RotateTransform(Mesh *m, Quaternion qrot, vec3 *center) {
-	// rotate selected mesh and child meshes by qrot (returned by Arcball::Drag)
-	//   apply qrot to rotation elements of m->transform (upper left 3x3)
-	//   if non-null center, rotate origin of m about center
-	// recursive routine initially called with null center
-	Quaternion qq = m->frameDown.orientation*qrot; // arcball:use=Camera(?) works (qrot*m->qstart Body? fails)
-	// rotate m
-	qq.SetMatrix(m->transform, m->frameDown.scale);
-	if (center) {
-		// this is a child mesh: rotate origin of mesh around center
-		mat4 rot = qrot.GetMatrix();
-		mat4 x = Translate((*center))*rot*Translate(-(*center));
-		vec4 xbase = x*vec4(m->frameDown.position, 1);
-		SetMatrixOrigin(m->transform, vec3(xbase.x, xbase.y, xbase.z));
-	}
-	for (int i = 0; i < (int) m->children.size(); i++)
-		RotateTransform(m->children[i], qrot, center? center : &m->frameDown.position);
-			// rotate descendant children around initial mesh base  
-}
-
-void MeshFramer::TranslateTransform(Mesh *m, vec3 pDif) {
-	SetMatrixOrigin(m->transform, m->frameDown.position+pDif);
-	for (int i = 0; i < (int) m->children.size(); i++)
-		TranslateTransform(m->children[i], pDif);
-}
-
-void MeshFramer::Wheel(double spin, bool shift) {
-	mesh->frameDown.scale *= (spin > 0? 1.01f : .99f);
-	Scale3x3(mesh->transform, mesh->frameDown.scale/MatrixScale(mesh->transform));
-}
-
-void MeshFramer::Draw(mat4 fullview) {
-	UseDrawShader(ScreenMode());
-	arcball.Draw(Control(), &mesh->transform);
-	UseDrawShader(fullview);
-	Disk(mesh->frameDown.position, 9, arcball.pink);
-}
-
-namespace {
-
-GLuint meshShaderLines = 0, meshShaderNoLines = 0;
-
-// vertex shader
-const char *meshVertexShader = R"(
-	#version 330
-	layout (location = 0) in vec3 point;
-	layout (location = 1) in vec3 normal;
-	layout (location = 2) in vec2 uv;
-	layout (location = 3) in mat4 instance; // for use with glDrawArrays/ElementsInstanced
-											// uses locations 3,4,5,6 for 4 vec4s = mat4
-	layout (location = 7) in vec3 color;	// for instanced color (vec4?)
-	out vec3 vPoint;
-	out vec3 vNormal;
-	out vec2 vUv;
-//	out vec3 vColor;
-	uniform bool useInstance = false;
-	uniform mat4 modelview;
-	uniform mat4 persp;
-	void main() {
-		mat4 m = useInstance? modelview*instance : modelview;
-		vPoint = (m*vec4(point, 1)).xyz;
-		vNormal = (m*vec4(normal, 0)).xyz;
-		gl_Position = persp*vec4(vPoint, 1);
-		vUv = uv;
-//		vColor = color;
-	}
-)";
-
-// geometry shader
-const char *meshGeometryShader = R"(
-	#version 330
-	layout (triangles) in;
-	layout (triangle_strip, max_vertices = 3) out;
-	in vec3 vPoint[], vNormal[];
-	in vec2 vUv[];
-	out vec3 gPoint, gNormal;
-	out vec2 gUv;
-	noperspective out vec3 gEdgeDistance;
-	uniform mat4 vp;
-	vec3 ViewPoint(int i) { return vec3(vp*(gl_in[i].gl_Position/gl_in[i].gl_Position.w)); }
-	void main() {
-		float ha = 0, hb = 0, hc = 0;
-		// transform each vertex to viewport space
-		vec3 p0 = ViewPoint(0), p1 = ViewPoint(1), p2 = ViewPoint(2);
-		// find altitudes ha, hb, hc
-		float a = length(p2-p1), b = length(p2-p0), c = length(p1-p0);
-		float alpha = acos((b*b+c*c-a*a)/(2.*b*c));
-		float beta = acos((a*a+c*c-b*b)/(2.*a*c));
-		ha = abs(c*sin(beta));
-		hb = abs(c*sin(alpha));
-		hc = abs(b*sin(alpha));
-		// send triangle vertices and edge distances
-		for (int i = 0; i < 3; i++) {
-			gEdgeDistance = i==0? vec3(ha, 0, 0) : i==1? vec3(0, hb, 0) : vec3(0, 0, hc);
-			gPoint = vPoint[i];
-			gNormal = vNormal[i];
-			gUv = vUv[i];
-			gl_Position = gl_in[i].gl_Position;
-			EmitVertex();
-		}
-		EndPrimitive();
-	}
-)";
-
-// pixel shader
-const char *meshPixelShaderLines = R"(
-	#version 330
-	in vec3 gPoint, gNormal;
-	in vec2 gUv;
-	noperspective in vec3 gEdgeDistance;
-	uniform sampler2D textureImage;
-	uniform int nLights = 1;
-	uniform vec3 lights[20] = vec3[20](vec3(1, 1, 1));
-	uniform vec3 color = vec3(1);
-	uniform float opacity = 1;
-	uniform float ambient = .2;
-	uniform bool useLight = true;
-	uniform bool useTexture = true;
-	uniform bool useTint = false;
-	uniform bool fwdFacingOnly = false;
-	uniform bool facetedShading = false;
-	uniform vec4 outlineColor = vec4(0, 0, 0, 1);
-	uniform float outlineWidth = 1;
-	uniform float outlineTransition = 1;
-	out vec4 pColor;
-	float Intensity(vec3 normalV, vec3 eyeV, vec3 point, vec3 light) {
-		vec3 lightV = normalize(light-point);		// light vector
-		vec3 reflectV = reflect(lightV, normalV);   // highlight vector
-		float d = max(0, dot(normalV, lightV));     // one-sided diffuse
-		float s = max(0, dot(reflectV, eyeV));      // one-sided specular
-		return clamp(d+pow(s, 50), 0, 1);
-	}
-	void main() {
-		vec3 N = normalize(facetedShading? cross(dFdx(gPoint), dFdy(gPoint)) : gNormal);
-		if (fwdFacingOnly && N.z < 0)
-			discard;
-		vec3 E = normalize(gPoint);					// eye vector
-		float intensity = useLight? 0 : 1;
-		if (useLight)
-			for (int i = 0; i < nLights; i++)
-				intensity += Intensity(N, E, gPoint, lights[i]);
-		intensity = clamp(intensity, 0, 1);
-		if (useTexture) {
-			pColor = vec4(intensity*texture(textureImage, gUv).rgb, opacity);
-			if (useTint) {
-				pColor.r *= color.r;
-				pColor.g *= color.g;
-				pColor.b *= color.b;
-			}
-		}
-		else
-			pColor = vec4(intensity*color, opacity);
-		float minDist = min(gEdgeDistance.x, gEdgeDistance.y);
-		minDist = min(minDist, gEdgeDistance.z);
-		float t = smoothstep(outlineWidth-outlineTransition, outlineWidth+outlineTransition, minDist);
-		// mix edge and surface colors(t=0: edgeColor, t=1: surfaceColor)
-		pColor = mix(outlineColor, pColor, t);
-	}
-)";
-
-const char *meshPixelShaderNoLines = R"(
-	#version 330
-	in vec3 vPoint, vNormal;
-	in vec2 vUv;
-	uniform sampler2D textureImage;
-	uniform int nLights = 1;
-	uniform vec3 lights[20] = vec3[20](vec3(1, 1, 1));
-	uniform vec3 color = vec3(1);
-	uniform float opacity = 1;
-	uniform float ambient = .2;
-	uniform bool useLight = true;
-	uniform bool useTexture = true;
-	uniform bool useTint = false;
-	uniform bool fwdFacingOnly = false;
-	uniform bool facetedShading = false;
-	out vec4 pColor;
-	float Intensity(vec3 normalV, vec3 eyeV, vec3 point, vec3 light) {
-		vec3 lightV = normalize(light-point);		// light vector
-		vec3 reflectV = reflect(lightV, normalV);   // highlight vector
-		float d = max(0, dot(normalV, lightV));     // one-sided diffuse
-		float s = max(0, dot(reflectV, eyeV));      // one-sided specular
-		return clamp(d+pow(s, 50), 0, 1);
-	}
-	void main() {
-		vec3 N = normalize(facetedShading? cross(dFdx(vPoint), dFdy(vPoint)) : vNormal);
-		if (fwdFacingOnly && N.z < 0)
-			discard;
-		vec3 E = normalize(vPoint);					// eye vector
-		float intensity = useLight? 0 : 1;
-		if (useLight)
-			for (int i = 0; i < nLights; i++)
-				intensity += Intensity(N, E, vPoint, lights[i]);
-		intensity = clamp(intensity, 0, 1);
-		if (useTexture) {
-			pColor = vec4(intensity*texture(textureImage, vUv).rgb, opacity);
-			if (useTint) {
-				pColor.r *= color.r;
-				pColor.g *= color.g;
-				pColor.b *= color.b;
-			}
-		}
-		else
-			pColor = vec4(intensity*color, opacity);
-	}
-)";
-
-} // end namespace
-
-GLuint GetMeshShader(bool lines) {
-	if (lines) {
-		if (!meshShaderLines)
-			meshShaderLines = LinkProgramViaCode(&meshVertexShader, NULL, NULL, &meshGeometryShader, &meshPixelShaderLines);
-		return meshShaderLines;
-	}
-	else {
-		if (!meshShaderNoLines)
-			meshShaderNoLines = LinkProgramViaCode(&meshVertexShader, &meshPixelShaderNoLines);
-		return meshShaderNoLines;
-	}
-}
-
-GLuint UseMeshShader(bool lines) {
-	GLuint s = GetMeshShader(lines);
-	glUseProgram(s);
-	return s;
-}
-
-// Mesh Class
-
-void Mesh::Display(CameraAB camera, int textureUnit, bool lines, bool useGroupColor) {
-	int nTris = triangles.size(), nQuads = quads.size();
-	// enable shader and vertex array object
-	int shader = UseMeshShader(lines);
-	glBindVertexArray(vao);
-	// texture
-	if (!textureName || !uvs.size() || textureUnit < 0)
-		SetUniform(shader, "useTexture", false);
-	else {
-		glActiveTexture(GL_TEXTURE0+textureUnit);
-		glBindTexture(GL_TEXTURE_2D, textureName);
-		SetUniform(shader, "textureImage", textureUnit); // but app can unset useTexture
-	}
-	// set custom transform and draw (xform = mesh transform X view transform)
-	SetUniform(shader, "modelview", camera.modelview*transform);
-	SetUniform(shader, "persp", camera.persp);
-	int textureSet = 0;
-	glGetUniformiv(shader, glGetUniformLocation(shader, "useTexture"), &textureSet);
-	if (lines)
-		SetUniform(shader, "vp", Viewport());
-	if (useGroupColor) {
-		// show ungrouped triangles without texture mapping
-		int nGroups = triangleGroups.size(), nUngrouped = nGroups? triangleGroups[0].startTriangle : nTris;
-		SetUniform(shader, "useTexture", false);
-		glDrawElements(GL_TRIANGLES, 3*nUngrouped, GL_UNSIGNED_INT, triangles.data());
-		// show grouped triangles with texture mapping
-		SetUniform(shader, "useTexture", textureSet == 1);
-		for (int i = 0; i < nGroups; i++) {
-			Group g = triangleGroups[i];
-			SetUniform(shader, "color", g.color);
-			glDrawElements(GL_TRIANGLES, 3*g.nTriangles, GL_UNSIGNED_INT, &triangles[g.startTriangle]);
-		}
-	}
-	else {
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eBufferId);
-		glDrawElements(GL_TRIANGLES, 3*nTris, GL_UNSIGNED_INT, 0);
-//		glDrawElements(GL_TRIANGLES, 3*nTris, GL_UNSIGNED_INT, triangles.data());
-#ifdef GL_QUADS
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		glDrawElements(GL_QUADS, 4*nQuads, GL_UNSIGNED_INT, quads.data());
-#endif
-	}
-	glBindVertexArray(0);
-}
-
-void Enable(int id, int ncomps, int offset) {
-	glEnableVertexAttribArray(id);
-	glVertexAttribPointer(id, ncomps, GL_FLOAT, GL_FALSE, 0, (void *) offset);
-}
-
-void Mesh::Buffer(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex) {
-	int nPts = pts.size(), nNrms = nrms? nrms->size() : 0, nUvs = tex? tex->size() : 0;
-	if (!nPts) { printf("Buffer: no points!\n"); return; }
-	// create vertex buffer
-	if (!vBufferId)
-		glGenBuffers(1, &vBufferId);
-	glBindBuffer(GL_ARRAY_BUFFER, vBufferId);
-	// allocate GPU memory for vertex position, texture, normals
-	int sizePoints = nPts*sizeof(vec3), sizeNormals = nNrms*sizeof(vec3), sizeUvs = nUvs*sizeof(vec2);
-	int bufferSize = sizePoints+sizeUvs+sizeNormals;
-	glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STATIC_DRAW);
-	// load vertex buffer
-	if (nPts) glBufferSubData(GL_ARRAY_BUFFER, 0, sizePoints, pts.data());
-	if (nNrms) glBufferSubData(GL_ARRAY_BUFFER, sizePoints, sizeNormals, nrms->data());
-	if (nUvs) glBufferSubData(GL_ARRAY_BUFFER, sizePoints+sizeNormals, sizeUvs, tex->data());
-	// create and load element buffer for triangles
-	int sizeTriangles = sizeof(int3)*triangles.size();
-	glGenBuffers(1, &eBufferId);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eBufferId);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeTriangles, triangles.data(), GL_STATIC_DRAW);
-	// create vertex array object for mesh
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-	// enable attributes
-	if (nPts) Enable(0, 3, 0);						// VertexAttribPointer(shader, "point", 3, 0, (void *) 0);
-	if (nNrms) Enable(1, 3, sizePoints);			// VertexAttribPointer(shader, "normal", 3, 0, (void *) sizePoints);
-	if (nUvs) Enable(2, 2, sizePoints+sizeNormals); // VertexAttribPointer(shader, "uv", 2, 0, (void *) (sizePoints+sizeNormals));
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-}
-
-void Mesh::Buffer() { Buffer(points, normals.size()? &normals : NULL, uvs.size()? &uvs : NULL); }
-
-void Mesh::Set(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex, vector<int> *tris, vector<int> *quas) {
-	if (tris) {
-		triangles.resize(tris->size()/3);
-		for (int i = 0; i < (int) triangles.size(); i++)
-			triangles[i] = { (*tris)[3*i], (*tris)[3*i+1], (*tris)[3*i+2] };
-	}
-	if (quas) {
-		quads.resize(quas->size()/4);
-		for (int i = 0; i < (int) quads.size(); i++)
-			quads[i] = { (*quas)[4*i], (*quas)[4*i+1], (*quas)[4*i+2], (*quas)[4*i+3] };
-	}
-	Buffer(pts, nrms, tex);
-}
-
-bool Mesh::Read(string objFile, mat4 *m, bool normalize, bool buffer) {
-	if (!ReadAsciiObj((char *) objFile.c_str(), points, triangles, &normals, &uvs, &triangleGroups, &triangleMtls, &quads, NULL)) {
-		printf("Mesh.Read: can't read %s\n", objFile.c_str());
-		return false;
-	}
-	objFilename = objFile;
-	if (normalize)
-		Normalize(points, 1);
-	if (buffer)
-		Buffer();
-	if (m)
-		transform = *m;
-	return true;
-}
-
-bool Mesh::Read(string objFile, string texFile, mat4 *m, bool normalize, bool buffer) {
-	if (!Read(objFile, m, normalize, buffer))
-		return false;
-	objFilename = objFile;
-	texFilename = texFile;
-	textureName = LoadTexture((char *) texFile.c_str());
-	if (!textureName)
-		printf("Mesh.Read: bad texture name\n");
-	return textureName > 0;
-}
-
-// intersections
-
-vec2 MajPln(vec3 &p, int mp) { return mp == 1? vec2(p.y, p.z) : mp == 2? vec2(p.x, p.z) : vec2(p.x, p.y); }
-
-TriInfo::TriInfo(vec3 a, vec3 b, vec3 c) {
-	vec3 v1(b-a), v2(c-b), x = normalize(cross(v1, v2));
-	plane = vec4(x.x, x.y, x.z, -dot(a, x));
-	float ax = fabs(x.x), ay = fabs(x.y), az = fabs(x.z);
-	majorPlane = ax > ay? (ax > az? 1 : 3) : (ay > az? 2 : 3);
-	p1 = MajPln(a, majorPlane);
-	p2 = MajPln(b, majorPlane);
-	p3 = MajPln(c, majorPlane);
-}
-
-bool LineIntersectPlane(vec3 p1, vec3 p2, vec4 plane, vec3 *intersection, float *alpha) {
-  vec3 normal(plane.x, plane.y, plane.z);
-  vec3 axis(p2-p1);
-  float pdDot = dot(axis, normal);
-  if (fabs(pdDot) < FLT_MIN)
-	  return false;
-  float a = (-plane.w-dot(p1, normal))/pdDot;
-  if (intersection != NULL)
-	  *intersection = p1+a*axis;
-  if (alpha)
-	  *alpha = a;
-  return true;
-}
-
-static bool IsZero(float d) { return d < FLT_EPSILON && d > -FLT_EPSILON; };
-
-int CompareVs(vec2 &v1, vec2 &v2) {
-	if ((v1.y > 0 && v2.y > 0) ||           // edge is fully above query point p'
-		(v1.y < 0 && v2.y < 0) ||           // edge is fully below p'
-		(v1.x < 0 && v2.x < 0))             // edge is fully left of p'
-		return 0;                           // can't cross
-	float zcross = v2.y*v1.x-v1.y*v2.x;     // right-handed cross-product
-	zcross /= length(v1-v2);
-	if (IsZero(zcross) && (v1.x <= 0 || v2.x <= 0))
-		return 1;                           // on or very close to edge
-	if ((v1.y > 0 || v2.y > 0) && ((v1.y-v2.y < 0) != (zcross < 0)))
-		return 2;                           // edge is crossed
-	else
-		return 0;                           // edge not crossed
-}
-
-bool IsInside(const vec2 &p, vector<vec2> &pts) {
-	bool odd = false;
-	int npts = pts.size();
-	vec2 q = p, v2 = pts[npts-1]-q;
-	for (int n = 0; n < npts; n++) {
-		vec2 v1 = v2;
-		v2 = pts[n]-q;
-		if (CompareVs(v1, v2) == 2)
-			odd = !odd;
-	}
-	return odd;
-}
-
-bool IsInside(const vec2 &p, const vec2 &a, const vec2 &b, const vec2 &c) {
-	bool odd = false;
-	vec2 q = p, v2 = c-q;
-	for (int n = 0; n < 3; n++) {
-		vec2 v1 = v2;
-		v2 = (n==0? a : n==1? b : c)-q;
-		if (CompareVs(v1, v2) == 2)
-			odd = !odd;
-	}
-	return odd;
-}
-
-void BuildTriInfos(vector<vec3> &points, vector<int3> &triangles, vector<TriInfo> &triInfos) {
-	triInfos.resize(triangles.size());
-	for (size_t i = 0; i < triangles.size(); i++) {
-		int3 &t = triangles[i];
-		triInfos[i] = TriInfo(points[t.i1], points[t.i2], points[t.i3]);
-	}
-}
-
-int IntersectWithLine(vec3 p1, vec3 p2, vector<TriInfo> &triInfos, float &retAlpha) {
-	int picked = -1;
-	float alpha, minAlpha = FLT_MAX;
-	for (size_t i = 0; i < triInfos.size(); i++) {
-		TriInfo &t = triInfos[i];
-		vec3 inter;
-		if (LineIntersectPlane(p1, p2, t.plane, &inter, &alpha)) {
-			if (alpha < minAlpha) {
-				if (IsInside(MajPln(inter, t.majorPlane), t.p1, t.p2, t.p3)) {
-					minAlpha = alpha;
-					picked = i;
-				}
-			}
-		}
-	}
-	retAlpha = minAlpha;
-	return picked;
-}
-
-// center/scale for unit size models
-
-void UpdateMinMax(vec3 p, vec3 &min, vec3 &max) {
-	for (int k = 0; k < 3; k++) {
-		if (p[k] < min[k]) min[k] = p[k];
-		if (p[k] > max[k]) max[k] = p[k];
-	}
-}
-
-float GetScaleCenter(vec3 &min, vec3 &max, float scale, vec3 &center) {
-	center = .5f*(min+max);
-	float maxrange = 0;
-	for (int k = 0; k < 3; k++)
-		if ((max[k]-min[k]) > maxrange)
-			maxrange = max[k]-min[k];
-	return scale*2.f/maxrange;
-}
-
-// normalize STL models
-
-void MinMax(vector<VertexSTL> &points, vec3 &min, vec3 &max) {
-	min.x = min.y = min.z = FLT_MAX;
-	max.x = max.y = max.z = -FLT_MAX;
-	for (int i = 0; i < (int) points.size(); i++)
-		UpdateMinMax(points[i].point, min, max);
-}
-
-void Normalize(vector<VertexSTL> &vertices, float scale) {
-	vec3 min, max, center;
-	MinMax(vertices, min, max);
-	float s = GetScaleCenter(min, max, scale, center);
-	for (int i = 0; i < (int) vertices.size(); i++) {
-		vec3 &v = vertices[i].point;
-		v = s*(v-center);
-	}
-}
-
-// normalize vec3 models
-
-mat4 NDCfromMinMax(vec3 min, vec3 max, float scale = 1) {
-	// matrix to transform min/max to -1/+1 (uniformly)
-	float maxrange = 0;
-	for (int k = 0; k < 3; k++)
-		if ((max[k]-min[k]) > maxrange)
-			maxrange = max[k]-min[k];
-	float s = scale*2.f/maxrange;
-	vec3 center = .5f*(max+min);
-	return Scale(s)*Translate(-center);
-}
-
-void MinMax(vec2 *points, int npoints, vec2 &min, vec2 &max) {
-	min[0] = min[1] = FLT_MAX;
-	max[0] = max[1] = -FLT_MAX;
-	for (int i = 0; i < npoints; i++) {
-		vec2 &v = points[i];
-		for (int k = 0; k < 2; k++) {
-			if (v[k] < min[k]) min[k] = v[k];
-			if (v[k] > max[k]) max[k] = v[k];
-		}
-	}
-}
-
-void MinMax(vec3 *points, int npoints, vec3 &min, vec3 &max) {
-	min[0] = min[1] = min[2] = FLT_MAX;
-	max[0] = max[1] = max[2] = -FLT_MAX;
-	for (int i = 0; i < npoints; i++) {
-		vec3 &v = points[i];
-		for (int k = 0; k < 3; k++) {
-			if (v[k] < min[k]) min[k] = v[k];
-			if (v[k] > max[k]) max[k] = v[k];
-		}
-	}
-}
-
-void MinMax(vector<vec3> &points, vec3 &min, vec3 &max) {
-	MinMax(points.data(), points.size(), min, max);
-}
-
-mat4 NormalizeMat(vec3 *points, int npoints, float scale) {
-	vec3 min, max;
-	MinMax(points, npoints, min, max);
-	return NDCfromMinMax(min, max, scale);
-}
-
-void Normalize(vec3 *points, int npoints, float scale) {
-	mat4 m = NormalizeMat(points, npoints, scale);
-	for (int i = 0; i < npoints; i++) {
-		vec4 xp = m*vec4(points[i]);
-		points[i] = vec3(xp.x, xp.y, xp.z);
-	}
-/*	vec3 center(.5f*(min[0]+max[0]), .5f*(min[1]+max[1]), .5f*(min[2]+max[2]));
-	float maxrange = 0;
-	for (int k = 0; k < 3; k++)
-		if ((max[k]-min[k]) > maxrange)
-			maxrange = max[k]-min[k];
-	float s = scale*2.f/maxrange;
-	for (int i = 0; i < npoints; i++) {
-		vec3 &v = points[i];
-		for (int k = 0; k < 3; k++)
-			v[k] = s*(v[k]-center[k]);
-	} */
-}
-
-void Normalize(vector<vec3> &points, float scale) {
-	Normalize(points.data(), points.size(), scale);
-}
-
-void SetVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals) {
-	// size normals array and initialize to zero
-	int nverts = (int) points.size();
-	normals.resize(nverts, vec3(0,0,0));
-	// accumulate each triangle normal into its three vertex normals
-	for (int i = 0; i < (int) triangles.size(); i++) {
-		int3 &t = triangles[i];
-		vec3 &p1 = points[t.i1], &p2 = points[t.i2], &p3 = points[t.i3];
-		vec3 n(cross(p2-p1, p3-p2));
-//		vec3 n(normalize(cross(p2-p1, p3-p2)));
-		normals[t.i1] += n;
-		normals[t.i2] += n;
-		normals[t.i3] += n;
-	}
-	// set to unit length
-	for (int i = 0; i < nverts; i++)
-		normals[i] = normalize(normals[i]);
-}
-
-// ASCII support
-
-bool ReadWord(char* &ptr, char *word, int charLimit) {
-	ptr += strspn(ptr, " \t");                  // skip white space
-	int nChars = strcspn(ptr, " \t");           // get # non-white-space characters
-	if (!nChars)
-		return false;                           // no non-space characters
-	int nRead = charLimit-1 < nChars? charLimit-1 : nChars;
-	strncpy(word, ptr, nRead);
-	word[nRead] = 0;                            // strncpy does not null terminate
-	ptr += nChars;
-	return true;
-}
-
-// STL
-
-char *Lower(char *word) {
-	for (char *c = word; *c; c++)
-		*c = tolower(*c);
-	return word;
-}
-
-int ReadSTL(const char *filename, vector<VertexSTL> &vertices) {
-	// the facet normal should point outwards from the solid object; if this is zero,
-	// most software will calculate a normal from the ordered triangle vertices using the right-hand rule
-	class Helper {
-	public:
-		bool status = false;
-		int nTriangles = 0;
-		vector<VertexSTL> *verts;
-		vector<string> vSpecs;                              // ASCII only
-		Helper(const char *filename, vector<VertexSTL> *verts) : verts(verts) {
-			char line[1000], word[1000], *ptr = line;
-			ifstream inText(filename, ios::in);             // text default mode
-			inText.getline(line, 10);
-			bool ascii = ReadWord(ptr, word, 10) && !strcmp(Lower(word), "solid");
-			// bool ascii = ReadWord(ptr, word, 10) && !_stricmp(word, "solid");
-			ascii = false; // hmm!
-			if (ascii)
-				status = ReadASCII(inText);
-			inText.close();
-			if (!ascii) {
-				FILE *inBinary = fopen(filename, "rb");     // inText.setmode(ios::binary) fails
-				if (inBinary) {
-					nTriangles = 0;
-					status = ReadBinary(inBinary);
-					fclose(inBinary);
-				}
-				else
-					status = false;
-			}
-		}
-		bool ReadASCII(ifstream &in) {
-			printf("can't read ASCII STL\n");
-			return true;
-		}
-		bool ReadBinary(FILE *in) {
-				  // # bytes      use                  significance
-				  // -------      ---                  ------------
-				  //      80      header               none
-				  //       4      unsigned long int    number of triangles
-				  //      12      3 floats             triangle normal
-				  //      12      3 floats             x,y,z for vertex 1
-				  //      12      3 floats             vertex 2
-				  //      12      3 floats             vertex 3
-				  //       2      unsigned short int   attribute (0)
-				  // endianness is assumed to be little endian
-			// in.setmode(ios::binary); doc says setmode good, but compiler says not so
-			// sizeof(bool)=1, sizeof(char)=1, sizeof(short)=2, sizeof(int)=4, sizeof(float)=4
-			char buf[81];
-			int nTriangle = 0;//, vid1, vid2, vid3;
-			if (fread(buf, 1, 80, in) != 80) // header
-				return false;
-			if (fread(&nTriangles, sizeof(int), 1, in) != 1)
-				return false;
-			while (!feof(in)) {
-				vec3 v[3], n;
-				if (nTriangle == nTriangles)
-					break;
-				if (nTriangles > 5000 && nTriangle && nTriangle%1000 == 0)
-					printf("\rread %i/%i triangles", nTriangle, nTriangles);
-				if (fread(&n.x, sizeof(float), 3, in) != 3)
-					printf("\ncan't read triangle %d normal\n", nTriangle);
-				for (int k = 0; k < 3; k++)
-					if (fread(&v[k].x, sizeof(float), 3, in) != 3)
-						printf("\ncan't read vid %d\n", verts->size());
-				vec3 a(v[1]-v[0]), b(v[2]-v[1]);
-				vec3 ntmp = cross(a, b);
-				if (dot(ntmp, n) < 0) {
-					vec3 vtmp = v[0];
-					v[0] = v[2];
-					v[2] = vtmp;
-				}
-				for (int k = 0; k < 3; k++)
-					verts->push_back(VertexSTL((float *) &v[k].x, (float *) &n.x));
-				unsigned short attribute;
-				if (fread(&attribute, sizeof(short), 1, in) != 1)
-					printf("\ncan't read attribute\n");
-				nTriangle++;
-			}
-			printf("\r\t\t\t\t\t\t\r");
-			return true;
-		}
-	};
-	Helper h(filename, &vertices);
-	return h.nTriangles;
-} // end ReadSTL
-
-// ASCII OBJ
-
-#include <map>
-
-static const int LineLim = 10000, WordLim = 1000;
-
-struct CompareS {
-	bool operator() (const string &a, const string &b) const { return (a < b); }
-};
-
-typedef std::map<string, Mtl, CompareS> MtlMap;
-	// string is key, Mtl is value
-
-MtlMap ReadMaterial(const char *filename) {
-	MtlMap mtlMap;
-	char line[LineLim], word[WordLim];
-	Mtl m;
-	FILE *in = fopen(filename, "r");
-	string key;
-	Mtl value;
-	if (in)
-		for (int lineNum = 0;; lineNum++) {
-			line[0] = 0;
-			fgets(line, LineLim, in);                   // \ line continuation not supported
-			if (feof(in))                               // hit end of file
-				break;
-			if (strlen(line) >= LineLim-1) {            // getline reads LineLim-1 max
-				printf("line %d too long\n", lineNum);
-				continue;
-			}
-			line[strlen(line)-1] = 0;							// remove carriage-return
-			char *ptr = line;
-			if (!ReadWord(ptr, word, WordLim) || *word == '#')
-				continue;
-			Lower(word);
-			if (!strcmp(word, "newmtl") && ReadWord(ptr, word, WordLim)) {
-				key = string(word);
-				value.name = string(word);
-			}
-			if (!strcmp(word, "kd")) {
-				if (sscanf(ptr, "%g%g%g", &value.kd.x, &value.kd.y, &value.kd.z) != 3)
-					printf("bad line %d in material file", lineNum);
-				else
-					mtlMap[key] = value;
-			}
-		}
-//	else printf("can't open %s\n", filename);
-	return mtlMap;
-}
-
-struct CompareVid {
-	bool operator() (const int3 &a, const int3 &b) const {
-		return (a.i1==b.i1? (a.i2==b.i2? a.i3 < b.i3 : a.i2 < b.i2) : a.i1 < b.i1);
-	}
-};
-
-typedef std::map<int3, int, CompareVid> VidMap;
-	// int3 is key, int is value
-
-bool ReadAsciiObj(const char      *filename,
-				  vector<vec3>    &points,
-				  vector<int3>    &triangles,
-				  vector<vec3>    *normals,
-				  vector<vec2>    *textures,
-				  vector<Group>   *triangleGroups,
-				  vector<Mtl>     *triangleMtls,
-				  vector<int4>    *quads,
-				  vector<int2>	  *segs) {
-	// read 'object' file (Alias/Wavefront .obj format); return true if successful;
-	// polygons are assumed simple (ie, no holes and not self-intersecting);
-	// some file attributes are not supported by this implementation;
-	// obj format indexes vertices from 1
-	FILE *in = fopen(filename, "r");
-	if (!in)
-		return false;
-	vec2 t;
-	vec3 v;
-	int group = 0;
-	char line[LineLim], word[WordLim];
-	bool hashedTriangles = false;	// true if any triangle vertex specified with different point/normal/texture id
-	bool hashedVertices = false;	// true if point/normal/texture arrays different (non-zero) size
-	vector<vec3> tmpVertices, tmpNormals;
-	vector<vec2> tmpTextures;
-	VidMap vidMap;
-	MtlMap mtlMap;
-	for (int lineNum = 0;; lineNum++) {
-		line[0] = 0;
-		fgets(line, LineLim, in);                           // \ line continuation not supported
-		if (feof(in))                                       // hit end of file
-			break;
-		if (strlen(line) >= LineLim-1) {                    // getline reads LineLim-1 max
-			printf("line %d too long\n", lineNum);
-			return false;
-		}
-		line[strlen(line)-1] = 0;							// remove carriage-return
-		char *ptr = line;
-		if (!ReadWord(ptr, word, WordLim))
-			continue;
-		Lower(word);
-		if (*word == '#') {
-			continue;
-		}
-		else if (!strcmp(word, "mtllib")) {
-			if (ReadWord(ptr, word, WordLim)) {
-				char name[100];
-				const char *p = strrchr(filename, '/'); //-filename, count = 0;
-				if (p) {
-					int nchars = p-filename;
-					strncpy(name, filename, nchars+1);
-					name[nchars+1] = 0;
-					strcat(name, word);
-				}
-				else
-					strcpy(name, word);
-				mtlMap = ReadMaterial(name);
-				if (false) {
-					int count = 0;
-					for (MtlMap::iterator iter = mtlMap.begin(); iter != mtlMap.end(); iter++) {
-						string s = (string) iter->first;
-						Mtl m = (Mtl) iter->second;
-						printf("m[%i].name=%s,.kd=(%3.2f,%3.2f,%3.2f),s=%s\n", count++, m.name.c_str(), m.kd.x, m.kd.y, m.kd.z, s.c_str());
-					}
-				}					
-			}
-		}
-		else if (!strcmp(word, "usemtl")) {
-			if (ReadWord(ptr, word, WordLim)) {
-				MtlMap::iterator it = mtlMap.find(string(word));
-				if (it == mtlMap.end())
-					printf(""); // "no such material: %s\n", word);
-				else {
-					Mtl m = it->second;
-					m.startTriangle = triangles.size();
-					if (triangleMtls)
-						triangleMtls->push_back(m);
-				}
-			}
-		}
-		else if (!strcmp(word, "g")) {
-			char *s = strchr(ptr, '(');
-			if (s) *s = 0;
-			if (triangleGroups) {
-			//	printf("adding to triangleGroups: name = %s\n", ptr);
-				triangleGroups->push_back(Group(triangles.size(), string(ptr)));
-			}
-		}
-		else if (!strcmp(word, "v")) {                      // read vertex coordinates
-			if (sscanf(ptr, "%g%g%g", &v.x, &v.y, &v.z) != 3) {
-				printf("bad line %d in object file", lineNum);
-				return false;
-			}
-			tmpVertices.push_back(vec3(v.x, v.y, v.z));
-		}
-		else if (!strcmp(word, "vn")) {                     // read vertex normal
-			if (sscanf(ptr, "%g%g%g", &v.x, &v.y, &v.z) != 3) {
-				printf("bad line %d in object file", lineNum);
-				return false;
-			}
-			tmpNormals.push_back(vec3(v.x, v.y, v.z));
-		}
-		else if (!strcmp(word, "vt")) {                     // read vertex texture
-			if (sscanf(ptr, "%g%g", &t.x, &t.y) != 2) {
-				printf("bad line in object file");
-				return false;
-			}
-			tmpTextures.push_back(vec2(t.x, t.y));
-		}
-		else if (!strcmp(word, "f")) {                      // read triangle or polygon
-			int nvids = tmpVertices.size(), ntids = tmpTextures.size(), nnids = tmpNormals.size();
-			if ((ntids && ntids != nvids) || (nnids && nnids != nvids))
-				hashedVertices = true;
-			static vector<int> vids;
-			vids.resize(0);
-			while (ReadWord(ptr, word, WordLim)) {          // read arbitrary # face vid/tid/nid
-				// set texture and normal pointers to preceding /
-				char *tPtr = strchr(word+1, '/');           // pointer to /, or null if not found
-				char *nPtr = tPtr? strchr(tPtr+1, '/') : NULL;
-				// use of / is optional (ie, '3' is same as '3/3/3')
-				// convert to vid, tid, nid indices (vertex, texture, normal)
-				int vid = atoi(word);
-				if (!vid)                                   // atoi returns 0 if failure to convert
-					break;
-				int tid = tPtr && *++tPtr != '/'? atoi(tPtr) : vid;
-				int nid = nPtr && *++nPtr != 0? atoi(nPtr) : vid;
-				// standard .obj is indexed from 1, mesh indexes from 0
-				vid--;
-				tid--;
-				nid--;
-				if (vid < 0 || tid < 0 || nid < 0) {        // atoi conversion failure
-					printf("bad format on line %d\n", lineNum);
-					break;
-				}
-				if ((tid >= 0 && tid != vid) || (nid >= 0 && nid != vid))
-					hashedTriangles = true;
-				bool hashed = hashedVertices || hashedTriangles;
-				if (!hashedVertices && !hashedTriangles) {
-					vids.push_back(vid);
-				}
-				if (hashedVertices || hashedTriangles) {
-					int3 key(vid, tid, nid);
-					VidMap::iterator it = vidMap.find(key);
-					// following can fail on early vertices
-					// to support OBJ must support triangle vid1/tid1/nid1, vid2/tid2/nid2, vid3/tid3/nid3
-					// which would mean changing current implementation
-					// instead, test for hashed vertices (ie, has vid ever not equaled tid or nid?)
-					// but we add specific test for simple impl
-					// need a straightforward implementation for when
-					// vid=tid=nid and/or there is no tid, no nid
-				//	printf("incoming vid = %i, ", vid);
-					if (it == vidMap.end()) {
-						int nvrts = points.size();
-						vidMap[key] = nvrts;
-						points.push_back(tmpVertices[vid]); // *** suspect
-						if (normals && (int) tmpNormals.size() > nid)
-							normals->push_back(tmpNormals[nid]);
-						if (textures && (int) tmpTextures.size() > tid)
-							textures->push_back(tmpTextures[tid]);
-						vids.push_back(nvrts);
-				//		printf("pushed %i\n", nvrts);
-					}
-					else {
-						vids.push_back(it->second);
-				//		printf("pushed second = %i\n", it->second);
-					}
-				}
-			}
-			int nids = vids.size();
-			if (nids == 3) {
-				int id1 = vids[0], id2 = vids[1], id3 = vids[2];
-				if (normals && (int) normals->size() > id1) {
-					vec3 p1, p2, p3;
-					if (hashedVertices || hashedTriangles) { p1 = points[id1]; p2 = points[id2]; p3 = points[id3]; }
-					else { p1 = tmpVertices[id1]; p2 = tmpVertices[id2]; p3 = tmpVertices[id3]; }
-				//	vec3 &p1 = points[id1], &p2 = points[id2], &p3 = points[id3];
-					vec3 a(p2-p1), b(p3-p2), n(cross(a, b));
-					if (dot(n, (*normals)[id1]) < 0) {
-						// reverse triangle order to correspond with vertex normal
-						int tmp = id1;
-						id1 = id3;
-						id3 = tmp;
-					}
-				}
-				// create triangle
-				triangles.push_back(int3(id1, id2, id3));
-			//	printf("triangle[%i] = (%i, %i, %i)\n", triangles.size()-1, id1+1, id2+1, id3+1);
-			}
-			else if (nids == 4 && quads)
-				quads->push_back(int4(vids[0], vids[1], vids[2], vids[3]));
-			else if (nids == 2 && segs)
-				segs->push_back(int2(vids[0], vids[1]));
-			else
-				// create polygon as nvids-2 triangles
-				for (int i = 1; i < nids-1; i++) {
-					triangles.push_back(int3(vids[0], vids[i], vids[(i+1)%nids]));
-				}
-		} // end "f"
-		else if (*word == 0 || *word == '\n')               // skip blank line
-			continue;
-		else {                                              // unrecognized attribute
-			// printf("unsupported attribute in object file: %s", word);
-			continue; // return false;
-		}
-	} // end read til end of file
-//	printf("hashedVertices = %s, hashedTriangles = %s\n", hashedVertices? "true" : "false", hashedTriangles? "true" : "false");
-	if (!hashedVertices && !hashedTriangles) {
-		int nPoints = tmpVertices.size();
-		points.resize(nPoints);
-		for (int i = 0; i < nPoints; i++)
-			points[i] = tmpVertices[i];
-		if (normals) {
-			int nNormals = tmpNormals.size();
-			normals->resize(nNormals);
-			for (int i = 0; i < nNormals; i++)
-				(*normals)[i] = tmpNormals[i];
-		}
-		if (textures) {
-			int nTextures = tmpTextures.size();
-			textures->resize(nTextures);
-			for (int i = 0; i < nTextures; i++)
-				(*textures)[i] = tmpTextures[i];
-		}
-	}
-	if (triangleGroups) {
-		int nGroups = triangleGroups->size();
-		for (int i = 0; i < nGroups; i++) {
-			int next = i < nGroups-1? (*triangleGroups)[i+1].startTriangle : triangles.size();
-			(*triangleGroups)[i].nTriangles = next-(*triangleGroups)[i].startTriangle;
-		}
-	}
-	if (triangleMtls) {
-		int nMtls = triangleMtls->size();
-		for (int i = 0; i < nMtls; i++) {
-			int next = i < nMtls-1? (*triangleMtls)[i+1].startTriangle : triangles.size();
-			(*triangleMtls)[i].nTriangles = next-(*triangleMtls)[i].startTriangle;
-		}
-	}
-	return true;
-} // end ReadAsciiObj
-
-bool WriteAsciiObj(const char    *filename,
-				   vector<vec3>  &points,
-				   vector<vec3>  &normals,
-				   vector<vec2>  &uvs,
-				   vector<int3>  *triangles,
-				   vector<int4>  *quads,
-				   vector<int2>  *segs,
-				   vector<Group> *triangleGroups) {
-	FILE *file = fopen(filename, "w");
-	if (!file) {
-		printf("can't write %s\n", filename);
-		return false;
-	}
-	int nPoints = points.size(), nNormals = normals.size(), nUvs = uvs.size(), nTriangles = triangles? triangles->size() : 0;
-	if (nPoints) {
-		fprintf(file, "# %i vertices\n", nPoints);
-		for (int i = 0; i < nPoints; i++)
-			fprintf(file, "v %f %f %f \n", points[i].x, points[i].y, points[i].z);
-		fprintf(file, "\n");
-	}
-	if (nNormals) {
-		fprintf(file, "# %i normals\n", nNormals);
-		for (int i = 0; i < nNormals; i++)
-			fprintf(file, "vn %f %f %f \n", normals[i].x, normals[i].y, normals[i].z);
-		fprintf(file, "\n");
-	}
-	if (nUvs) {
-		fprintf(file, "# %i textures\n", nUvs);
-		for (int i = 0; i < nUvs; i++)
-			fprintf(file, "vt %f %f \n", uvs[i].x, uvs[i].y);
-		fprintf(file, "\n");
-	}
-	// write triangles, quads (adding 1 to all vertex indices per OBJ format)
-	if (triangles) {
-		// non-grouped triangles
-		size_t nNonGrouped = triangleGroups && triangleGroups->size()? (*triangleGroups)[0].startTriangle : nTriangles; 
-		if (nTriangles) fprintf(file, "# %i triangles\n", nTriangles);
-		for (size_t i = 0; i < nNonGrouped; i++)
-			fprintf(file, "f %d %d %d \n", 1+(*triangles)[i].i1, 1+(*triangles)[i].i2, 1+(*triangles)[i].i3);
-		if (triangleGroups)
-			for (size_t i = 0; i < triangleGroups->size(); i++) {
-				Group g = (*triangleGroups)[i];
-				if (g.nTriangles) {
-					fprintf(file, "g %s (%i triangles)\n", g.name.c_str(), g.nTriangles);
-					for (int t = g.startTriangle; t < g.startTriangle+g.nTriangles; t++)
-						fprintf(file, "f %d %d %d \n", 1+(*triangles)[t].i1, 1+(*triangles)[t].i2, 1+(*triangles)[t].i3);
-				}
-			}
-	//	else
-	//		for (size_t i = 0; i < triangles->size(); i++)
-	//			fprintf(file, "f %d %d %d \n", 1+(*triangles)[i].i1, 1+(*triangles)[i].i2, 1+(*triangles)[i].i3);
-		fprintf(file, "\n");
-	}
-	if (quads)
-		for (size_t i = 0; i < quads->size(); i++)
-			fprintf(file, "f %d %d %d %d \n", 1+(*quads)[i].i1, 1+(*quads)[i].i2, 1+(*quads)[i].i3, 1+(*quads)[i].i4);
-	if (segs)
-		for (size_t i = 0; i < segs->size(); i++)
-			fprintf(file, "f %d %d \n", 1+(*segs)[i].i1, 1+(*segs)[i].i2);
-	fclose(file);
-	return true;
-}
-
-// OLD shaders
-
-const char *OLDmeshVertexShader = R"(
-	#version 330
-	layout (location = 0) in vec3 point;
-	layout (location = 1) in vec3 normal;
-	layout (location = 2) in vec2 uv;
-	layout (location = 3) in mat4 instance; // for use with glDrawArrays/ElementsInstanced
-											// uses locations 3,4,5,6 for 4 vec4s = mat4
-	layout (location = 7) in vec3 color;	// for instanced color (vec4?)
-	out vec3 vPoint;
-	out vec3 vNormal;
-	out vec2 vUv;
-	out vec3 vColor;
-	uniform bool useInstance = false;
-	uniform mat4 modelview;
-	uniform mat4 persp;
-	void main() {
-		mat4 m = useInstance? modelview*instance : modelview;
-		vPoint = (m*vec4(point, 1)).xyz;
-		vNormal = (m*vec4(normal, 0)).xyz;
-		gl_Position = persp*vec4(vPoint, 1);
-		vUv = uv;
-		vColor = color;
-	}
-)";
-
-const char *OLDmeshPixelShader = R"(
-	#version 330
-	in vec3 vPoint;
-	in vec3 vNormal;
-	in vec2 vUv;
-	in vec3 vColor;
-	out vec4 pColor;
-	uniform int nLights = 1;
-	uniform vec3 lights[20] = vec3[20](vec3(1, 1, 1));
-	uniform bool useLight = true;
-	uniform sampler2D textureUnit;
-	uniform vec3 defaultColor = vec3(1);
-	uniform bool useDefaultColor = true;
-	uniform float opacity = 1;
-	uniform bool useTexture = false;
-	uniform bool useTint = false;
-	uniform bool fwdFacing = false;
-	uniform bool facetedShading = false;
-	float Intensity(vec3 normalV, vec3 eyeV, vec3 point, vec3 light) {
-		vec3 lightV = normalize(light-point);		// light vector
-		vec3 reflectV = reflect(lightV, normalV);   // highlight vector
-		float d = max(0, dot(normalV, lightV));     // one-sided diffuse
-		float s = max(0, dot(reflectV, eyeV));      // one-sided specular
-		return clamp(d+pow(s, 50), 0, 1);
-	}
-	void main() {
-		vec3 N = normalize(facetedShading? cross(dFdx(vPoint), dFdy(vPoint)) : vNormal);
-		if (fwdFacing && N.z < 0) discard;
-		vec3 E = normalize(vPoint);					// eye vector
-		float intensity = useLight? 0 : 1;
-		if (useLight) {
-			for (int i = 0; i < nLights; i++)
-				intensity += Intensity(N, E, vPoint, lights[i]);
-			intensity = clamp(intensity, 0, 1);
-		}
-		vec3 color = useTexture? texture(textureUnit, vUv).rgb : useDefaultColor? defaultColor : vColor;
-		if (useTexture && useTint) {
-			color.r *= defaultColor.r;
-			color.g *= defaultColor.g;
-			color.b *= defaultColor.b;
-		}
-		pColor = vec4(intensity*color, opacity);
-	}
-)";
+// Mesh.cpp - mesh IO and operations (c) 2019-2022 Jules Bloomenthal
+
+#include "CameraArcball.h"
+#include "Cull.h"
+#include "GLXtras.h"
+#include "Draw.h"
+#include "Mesh.h"
+#include "Misc.h"
+#include "PointSet.h"
+#include "Quaternion.h"
+#include <assert.h>
+#include <iostream>
+#include <fstream>
+#include <direct.h>
+#include <float.h>
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+#include <cstdlib>
+#include "VecMat.h"
+#include "Widgets.h"
+
+using std::string;
+using std::vector;
+using std::ios;
+using std::ifstream;
+
+// Mesh Framer
+
+bool MeshFramer::Hit(int x, int y) {
+	return arcball.Hit(x, y);
+}
+
+bool MeshFramer::Hit(int x, int y, mat4 modelview, mat4 persp) {
+	if (arcball.Hit(x, y))
+		return true;
+	if (!mesh)
+		return false;
+	vec3 p1, p2;
+	float alpha;
+	ScreenLine((float) x, (float) (VPh()-y), modelview, persp, p1, p2);
+	return mesh->IntersectWithLine(p1, p2, alpha) >= 0;
+}
+
+void MeshFramer::Up() {
+	arcball.Up();
+}
+
+void MeshFramer::Set(Mesh *m, float radius, mat4 fullview) {
+	mesh = m;
+	m->frameDown = Frame(Quaternion(m->transform), MatrixOrigin(m->transform), MatrixScale(m->transform));
+	arcball.SetBody(m->transform, radius);
+	arcball.SetCenter(ScreenPoint(m->frameDown.position, fullview));
+	moverPicked = false;
+}
+
+void MeshFramer::SetFramedown(Mesh *m) {
+	m->frameDown = Frame(Quaternion(m->transform), MatrixOrigin(m->transform), MatrixScale(m->transform));
+	for (int i = 0; i < (int) m->children.size(); i++)
+		SetFramedown(m->children[i]);
+}
+
+void MeshFramer::Down(int x, int y, mat4 modelview, mat4 persp, bool control) {
+	moverPicked = arcball.MouseOver(x, y);
+	SetFramedown(mesh);
+	if (moverPicked)
+		mover.Down(&mesh->frameDown.position, x, y, modelview, persp);
+	else
+		arcball.Down(x, y, control, &mesh->transform);
+			// mesh->transform used by arcball.SetNearestAxis
+}
+
+void MeshFramer::Drag(int x, int y, mat4 modelview, mat4 persp) {
+	int node = scene? scene->Find(mesh) : -1;
+	if (node >= 0) {
+		// move only mesh, then propagate through scene graph
+		if (moverPicked) {
+			mover.Drag(x, y, modelview, persp);
+			SetMatrixOrigin(mesh->transform, mesh->frameDown.position);
+			arcball.SetCenter(ScreenPoint(mesh->frameDown.position, persp*modelview));
+		}
+		else
+			(mesh->frameDown.orientation*arcball.Drag(x, y)).SetMatrix(mesh->transform, mesh->frameDown.scale);
+		scene->SetWorld(node, mesh->transform);
+		scene->Update();
+	}
+	else if (moverPicked) {
+		vec3 pDif = mover.Drag(x, y, modelview, persp);
+		SetMatrixOrigin(mesh->transform, mesh->frameDown.position);
+		for (int i = 0; i < (int) mesh->children.size(); i++)
+			TranslateTransform(mesh->children[i], pDif);
+		arcball.SetCenter(ScreenPoint(mesh->frameDown.position, persp*modelview));
+	}
+	else {
+		Quaternion qrot = arcball.Drag(x, y);
+		// recurse on children
+		RotateTransform(mesh, qrot, NULL);
+	}
+}
+
+void MeshFramer::RotateTransform(Mesh *m, Quaternion qrot, vec3 *center) {
+	// rotate selected mesh and child meshes by qrot (returned by Arcball::Drag)
+	//   apply qrot to rotation elements of m->transform (upper left 3x3)
+	//   if non-null center, rotate origin of m about center
+	// recursive routine initially called with null center
+	Quaternion qq = m->frameDown.orientation*qrot; // arcball:use=Camera(?) works (qrot*m->qstart Body? fails)
+	// rotate m
+	qq.SetMatrix(m->transform, m->frameDown.scale);
+	if (center) {
+		// this is a child mesh: rotate origin of mesh around center
+		mat4 rot = qrot.GetMatrix();
+		mat4 x = Translate((*center))*rot*Translate(-(*center));
+		vec4 xbase = x*vec4(m->frameDown.position, 1);
+		SetMatrixOrigin(m->transform, vec3(xbase.x, xbase.y, xbase.z));
+	}
+	for (int i = 0; i < (int) m->children.size(); i++)
+		RotateTransform(m->children[i], qrot, center? center : &m->frameDown.position);
+			// rotate descendant children around initial mesh base  
+}
+
+void MeshFramer::TranslateTransform(Mesh *m, vec3 pDif) {
+	SetMatrixOrigin(m->transform, m->frameDown.position+pDif);
+	for (int i = 0; i < (int) m->children.size(); i++)
+		TranslateTransform(m->children[i], pDif);
+}
+
+void MeshFramer::Wheel(double spin, bool shift) {
+	mesh->frameDown.scale *= (spin > 0? 1.01f : .99f);
+	Scale3x3(mesh->transform, mesh->frameDown.scale/MatrixScale(mesh->transform));
+}
+
+void MeshFramer::Draw(mat4 fullview) {
+	UseDrawShader(ScreenMode());
+	arcball.Draw(Control(), &mesh->transform);
+	UseDrawShader(fullview);
+	Disk(mesh->frameDown.position, 9, arcball.pink);
+}
+
+namespace {
+
+GLuint meshShaderLines = 0, meshShaderNoLines = 0;
+
+// vertex shader
+const char *meshVertexShader = R"(
+	#version 330
+	layout (location = 0) in vec3 point;
+	layout (location = 1) in vec3 normal;
+	layout (location = 2) in vec2 uv;
+	layout (location = 3) in mat4 instance; // for use with glDrawArrays/ElementsInstanced
+											// uses locations 3,4,5,6 for 4 vec4s = mat4
+	layout (location = 7) in vec3 instanceColor;
+	out vec3 vPoint;
+	out vec3 vNormal;
+	out vec2 vUv;
+	out vec3 vColor;
+	uniform bool useInstance = false;
+	uniform bool useInstanceColor = false;
+	uniform vec3 color = vec3(1);
+	uniform bool octNormal = false;			// normal.xy is octahedral encoding, in +/-32767
+	uniform mat4 dequantize = mat4(1);		// maps quantized point to object space
+	uniform mat4 modelview;
+	uniform mat3 normalMatrix = mat3(1);	// cofactor of modelview: correct under non-uniform scale
+	uniform mat4 persp;
+	mat3 Cofactor(mat3 m) {
+		// as NormalMatrix: inverse transpose up to scale, negated if det < 0 so normals don't flip
+		mat3 c = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1]));
+		return determinant(m) < 0? -c : c;
+	}
+	vec3 OctDecode(vec2 e) {
+		vec3 n = vec3(e, 1-abs(e.x)-abs(e.y));
+		if (n.z < 0)
+			n.xy = (1-abs(n.yx))*vec2(n.x >= 0? 1 : -1, n.y >= 0? 1 : -1);
+		return normalize(n);
+	}
+	void main() {
+		mat4 m = useInstance? modelview*instance : modelview;
+		vPoint = (m*(dequantize*vec4(point, 1))).xyz;
+		vec3 n = octNormal? OctDecode(normal.xy/32767.) : normal;
+		vNormal = normalMatrix*(useInstance? Cofactor(mat3(instance))*n : n);
+		gl_Position = persp*vec4(vPoint, 1);
+		vUv = uv;
+		vColor = useInstance && useInstanceColor? instanceColor : color;
+	}
+)";
+
+// geometry shader
+const char *meshGeometryShader = R"(
+	#version 330
+	layout (triangles) in;
+	layout (triangle_strip, max_vertices = 3) out;
+	in vec3 vPoint[], vNormal[], vColor[];
+	in vec2 vUv[];
+	out vec3 gPoint, gNormal, gColor;
+	out vec2 gUv;
+	noperspective out vec3 gEdgeDistance;
+	uniform mat4 vp;
+	vec3 ViewPoint(int i) { return vec3(vp*(gl_in[i].gl_Position/gl_in[i].gl_Position.w)); }
+	void main() {
+		float ha = 0, hb = 0, hc = 0;
+		// transform each vertex to viewport space
+		vec3 p0 = ViewPoint(0), p1 = ViewPoint(1), p2 = ViewPoint(2);
+		// find altitudes ha, hb, hc
+		float a = length(p2-p1), b = length(p2-p0), c = length(p1-p0);
+		float alpha = acos((b*b+c*c-a*a)/(2.*b*c));
+		float beta = acos((a*a+c*c-b*b)/(2.*a*c));
+		ha = abs(c*sin(beta));
+		hb = abs(c*sin(alpha));
+		hc = abs(b*sin(alpha));
+		// send triangle vertices and edge distances
+		for (int i = 0; i < 3; i++) {
+			gEdgeDistance = i==0? vec3(ha, 0, 0) : i==1? vec3(0, hb, 0) : vec3(0, 0, hc);
+			gPoint = vPoint[i];
+			gNormal = vNormal[i];
+			gColor = vColor[i];
+			gUv = vUv[i];
+			gl_Position = gl_in[i].gl_Position;
+			EmitVertex();
+		}
+		EndPrimitive();
+	}
+)";
+
+// pixel shader
+const char *meshPixelShaderLines = R"(
+	#version 330
+	in vec3 gPoint, gNormal, gColor;
+	in vec2 gUv;
+	noperspective in vec3 gEdgeDistance;
+	uniform sampler2D textureImage;
+	uniform int nLights = 1;
+	uniform vec3 lights[20] = vec3[20](vec3(1, 1, 1));
+	uniform float opacity = 1;
+	uniform float ambient = .2;
+	uniform bool useLight = true;
+	uniform bool useTexture = true;
+	uniform bool useTint = false;
+	uniform bool fwdFacingOnly = false;
+	uniform bool facetedShading = false;
+	uniform vec4 outlineColor = vec4(0, 0, 0, 1);
+	uniform float outlineWidth = 1;
+	uniform float outlineTransition = 1;
+	out vec4 pColor;
+	float Intensity(vec3 normalV, vec3 eyeV, vec3 point, vec3 light) {
+		vec3 lightV = normalize(light-point);		// light vector
+		vec3 reflectV = reflect(lightV, normalV);   // highlight vector
+		float d = max(0, dot(normalV, lightV));     // one-sided diffuse
+		float s = max(0, dot(reflectV, eyeV));      // one-sided specular
+		return clamp(d+pow(s, 50), 0, 1);
+	}
+	void main() {
+		vec3 N = normalize(facetedShading? cross(dFdx(gPoint), dFdy(gPoint)) : gNormal);
+		if (fwdFacingOnly && N.z < 0)
+			discard;
+		vec3 E = normalize(gPoint);					// eye vector
+		float intensity = useLight? 0 : 1;
+		if (useLight)
+			for (int i = 0; i < nLights; i++)
+				intensity += Intensity(N, E, gPoint, lights[i]);
+		intensity = clamp(intensity, 0, 1);
+		if (useTexture) {
+			pColor = vec4(intensity*texture(textureImage, gUv).rgb, opacity);
+			if (useTint) {
+				pColor.r *= gColor.r;
+				pColor.g *= gColor.g;
+				pColor.b *= gColor.b;
+			}
+		}
+		else
+			pColor = vec4(intensity*gColor, opacity);
+		float minDist = min(gEdgeDistance.x, gEdgeDistance.y);
+		minDist = min(minDist, gEdgeDistance.z);
+		float t = smoothstep(outlineWidth-outlineTransition, outlineWidth+outlineTransition, minDist);
+		// mix edge and surface colors(t=0: edgeColor, t=1: surfaceColor)
+		pColor = mix(outlineColor, pColor, t);
+	}
+)";
+
+const char *meshPixelShaderNoLines = R"(
+	#version 330
+	in vec3 vPoint, vNormal, vColor;
+	in vec2 vUv;
+	uniform sampler2D textureImage;
+	uniform int nLights = 1;
+	uniform vec3 lights[20] = vec3[20](vec3(1, 1, 1));
+	uniform float opacity = 1;
+	uniform float ambient = .2;
+	uniform bool useLight = true;
+	uniform bool useTexture = true;
+	uniform bool useTint = false;
+	uniform bool fwdFacingOnly = false;
+	uniform bool facetedShading = false;
+	out vec4 pColor;
+	float Intensity(vec3 normalV, vec3 eyeV, vec3 point, vec3 light) {
+		vec3 lightV = normalize(light-point);		// light vector
+		vec3 reflectV = reflect(lightV, normalV);   // highlight vector
+		float d = max(0, dot(normalV, lightV));     // one-sided diffuse
+		float s = max(0, dot(reflectV, eyeV));      // one-sided specular
+		return clamp(d+pow(s, 50), 0, 1);
+	}
+	void main() {
+		vec3 N = normalize(facetedShading? cross(dFdx(vPoint), dFdy(vPoint)) : vNormal);
+		if (fwdFacingOnly && N.z < 0)
+			discard;
+		vec3 E = normalize(vPoint);					// eye vector
+		float intensity = useLight? 0 : 1;
+		if (useLight)
+			for (int i = 0; i < nLights; i++)
+				intensity += Intensity(N, E, vPoint, lights[i]);
+		intensity = clamp(intensity, 0, 1);
+		if (useTexture) {
+			pColor = vec4(intensity*texture(textureImage, vUv).rgb, opacity);
+			if (useTint) {
+				pColor.r *= vColor.r;
+				pColor.g *= vColor.g;
+				pColor.b *= vColor.b;
+			}
+		}
+		else
+			pColor = vec4(intensity*vColor, opacity);
+	}
+)";
+
+LazyProgram meshProgram("Mesh", &meshVertexShader, NULL, NULL, NULL, &meshPixelShaderNoLines);
+LazyProgram meshLinesProgram("Mesh lines", &meshVertexShader, NULL, NULL, &meshGeometryShader, &meshPixelShaderLines);
+
+} // end namespace
+
+GLuint GetMeshShader(bool lines) {
+	if (lines) {
+		if (!meshShaderLines)
+			meshShaderLines = meshLinesProgram.Get();
+		return meshShaderLines;
+	}
+	else {
+		if (!meshShaderNoLines)
+			meshShaderNoLines = meshProgram.Get();
+		return meshShaderNoLines;
+	}
+}
+
+GLuint UseMeshShader(bool lines) {
+	GLuint s = GetMeshShader(lines);
+	glUseProgram(s);
+	return s;
+}
+
+// vertex compression
+
+unsigned int OctEncode(vec3 n) {
+	// project onto octahedron |x|+|y|+|z| = 1, fold lower hemisphere over diagonals, round to snorm
+	float s = fabs(n.x)+fabs(n.y)+fabs(n.z);
+	vec2 e = s > 0? vec2(n.x/s, n.y/s) : vec2(0, 0);
+	if (n.z < 0)
+		e = vec2((1-fabs(e.y))*(e.x >= 0? 1 : -1), (1-fabs(e.x))*(e.y >= 0? 1 : -1));
+	short x = (short) lround(32767*(e.x < -1? -1 : e.x > 1? 1 : e.x));
+	short y = (short) lround(32767*(e.y < -1? -1 : e.y > 1? 1 : e.y));
+	return (unsigned short) x | (unsigned int) (unsigned short) y << 16;
+}
+
+vec3 OctDecode(unsigned int e) {
+	vec2 f((short) (e & 0xffff)/32767.f, (short) (e >> 16)/32767.f);
+	vec3 n(f.x, f.y, 1-fabs(f.x)-fabs(f.y));
+	if (n.z < 0) {
+		float x = n.x;
+		n.x = (1-fabs(n.y))*(x >= 0? 1 : -1);
+		n.y = (1-fabs(x))*(n.y >= 0? 1 : -1);
+	}
+	return normalize(n);
+}
+
+unsigned short FloatToHalf(float f) {
+	// round to nearest even; overflow to infinity, underflow to (signed) zero via denormals
+	unsigned int b;
+	memcpy(&b, &f, 4);
+	unsigned int sign = (b >> 16) & 0x8000, mag = b & 0x7fffffff;
+	if (mag >= 0x7f800000)									// inf or NaN
+		return (unsigned short) (sign | 0x7c00 | (mag > 0x7f800000? 0x200 : 0));
+	if (mag >= 0x477ff000)									// rounds beyond 65504
+		return (unsigned short) (sign | 0x7c00);
+	if (mag < 0x38800000) {									// half denormal or zero
+		int shift = 126-(int) (mag >> 23);					// 14 or more
+		if (shift > 25)
+			return (unsigned short) sign;
+		unsigned int m = (mag & 0x7fffff) | 0x800000, h = m >> shift, rest = m & ((1u << shift)-1), half = 1u << (shift-1);
+		h += rest > half || (rest == half && (h & 1));
+		return (unsigned short) (sign | h);
+	}
+	unsigned int h = (mag >> 13)-(112 << 10), rest = mag & 0x1fff;
+	h += rest > 0x1000 || (rest == 0x1000 && (h & 1));
+	return (unsigned short) (sign | h);
+}
+
+float HalfToFloat(unsigned short h) {
+	unsigned int sign = (h & 0x8000) << 16, e = (h >> 10) & 0x1f, m = h & 0x3ff, b;
+	if (e == 31)
+		b = sign | 0x7f800000 | (m << 13);
+	else if (e)
+		b = sign | ((e+112) << 23) | (m << 13);
+	else {
+		float f = m/16777216.f;								// denormal: m*2^-24
+		return sign? -f : f;
+	}
+	float f;
+	memcpy(&f, &b, 4);
+	return f;
+}
+
+void PackVertices(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex, bool quantize, PackedVertices &pv) {
+	int nPts = (int) pts.size();
+	bool hasNormals = nrms && (int) nrms->size() >= nPts, hasUvs = tex && (int) tex->size() >= nPts;
+	pv.quantized = quantize;
+	pv.dequantize = mat4();
+	pv.uvHalf = false;
+	if (hasUvs)
+		for (int i = 0; i < nPts && !pv.uvHalf; i++) {
+			vec2 &t = (*tex)[i];
+			pv.uvHalf = t.x < 0 || t.x > 1 || t.y < 0 || t.y > 1;
+		}
+	int sizePoint = quantize? 8 : 12;						// quantized: 3 shorts + pad
+	pv.normalOffset = hasNormals? sizePoint : -1;
+	pv.uvOffset = hasUvs? sizePoint+(hasNormals? 4 : 0) : -1;
+	pv.stride = sizePoint+(hasNormals? 4 : 0)+(hasUvs? 4 : 0);
+	pv.data.assign((size_t) nPts*pv.stride, 0);
+	vec3 min, max, range(1, 1, 1);
+	if (quantize && nPts) {
+		MinMax(pts.data(), nPts, min, max);
+		for (int k = 0; k < 3; k++)
+			range[k] = max[k] > min[k]? max[k]-min[k] : 1;
+		pv.dequantize = Translate(min)*Scale(range);
+	}
+	ParallelFor(nPts, [&](int i1, int i2) {
+		for (int i = i1; i < i2; i++) {
+			char *v = pv.data.data()+(size_t) i*pv.stride;
+			if (quantize) {
+				unsigned short q[4] = {0, 0, 0, 0};
+				for (int k = 0; k < 3; k++)
+					q[k] = (unsigned short) lround(65535*((pts[i][k]-min[k])/range[k]));
+				memcpy(v, q, 8);
+			}
+			else
+				memcpy(v, &pts[i], 12);
+			if (hasNormals) {
+				unsigned int e = OctEncode((*nrms)[i]);
+				memcpy(v+pv.normalOffset, &e, 4);
+			}
+			if (hasUvs) {
+				vec2 &t = (*tex)[i];
+				unsigned short u[2];
+				for (int k = 0; k < 2; k++) {
+					float c = k? t.y : t.x;
+					u[k] = pv.uvHalf? FloatToHalf(c) : (unsigned short) lround(65535*c);
+				}
+				memcpy(v+pv.uvOffset, u, 4);
+			}
+		}
+	}, 50000);
+}
+
+// Scene Graph
+
+namespace {
+
+bool NoGeometry(vec3 min, vec3 max) { return dot(min, min) == 0 && dot(max, max) == 0; }
+
+} // end namespace
+
+int SceneGraph::Add(int parent, mat4 local, vec3 min, vec3 max, Mesh *mesh) {
+	int n = (int) nodes.size(), i = parent < 0? n : parent+nodes[parent].nDescendants+1;
+	nodes.insert(nodes.begin()+i, SceneNode(parent, local, min, max, mesh));
+	world.insert(world.begin()+i, mat4());
+	worldMin.insert(worldMin.begin()+i, vec3());
+	worldMax.insert(worldMax.begin()+i, vec3());
+	dirty.insert(dirty.begin()+i, 0);
+	if (i < n) {
+		// shift indices past insertion
+		for (int k = i+1; k <= n; k++)
+			if (nodes[k].parent >= i)
+				nodes[k].parent++;
+		for (int &c : changed)
+			if (c >= i)
+				c++;
+	}
+	for (int a = parent; a >= 0; a = nodes[a].parent)
+		nodes[a].nDescendants++;
+	SetLocal(i, local);
+	return i;
+}
+
+int SceneGraph::Add(Mesh *mesh, int parent) {
+	if (AncestorDirty(parent))
+		Update();
+	return AddMesh(mesh, parent, parent < 0? mat4() : world[parent]);
+}
+
+int SceneGraph::AddMesh(Mesh *mesh, int parent, mat4 parentWorld) {
+	vec3 min, max;
+	MinMax(mesh->points.data(), (int) mesh->points.size(), min, max);
+	int i = Add(parent, InvertAffine(parentWorld)*mesh->transform, min, max, mesh);
+	for (Mesh *child : mesh->children)
+		AddMesh(child, i, mesh->transform);
+	return i;
+}
+
+int SceneGraph::Find(Mesh *mesh) {
+	// repeated finds (eg, each drag) return the prior result after one comparison
+	if (findHint < (int) nodes.size() && nodes[findHint].mesh == mesh)
+		return findHint;
+	for (int i = 0; i < (int) nodes.size(); i++)
+		if (nodes[i].mesh == mesh)
+			return findHint = i;
+	return -1;
+}
+
+void SceneGraph::SetLocal(int node, mat4 m) {
+	nodes[node].local = m;
+	if (!dirty[node]) {
+		dirty[node] = 1;
+		changed.push_back(node);
+	}
+}
+
+void SceneGraph::SetWorld(int node, mat4 m) {
+	int parent = nodes[node].parent;
+	if (AncestorDirty(parent))
+		Update();
+	SetLocal(node, parent < 0? m : InvertAffine(world[parent])*m);
+}
+
+bool SceneGraph::AncestorDirty(int node) {
+	// true if node or an ancestor awaits Update
+	for (; node >= 0; node = nodes[node].parent)
+		if (dirty[node])
+			return true;
+	return false;
+}
+
+void SceneGraph::SubtreeBounds(int node) {
+	// union of node's own bounds (if it has geometry) and its children's subtree bounds
+	SceneNode &n = nodes[node];
+	vec3 &min = worldMin[node], &max = worldMax[node];
+	if (NoGeometry(n.min, n.max)) {
+		min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+		max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	}
+	else
+		TransformBox(world[node], n.min, n.max, min, max);
+	for (int c = node+1; c <= node+n.nDescendants; c += nodes[c].nDescendants+1)
+		for (int k = 0; k < 3; k++) {
+			min[k] = fmin(min[k], worldMin[c][k]);
+			max[k] = fmax(max[k], worldMax[c][k]);
+		}
+}
+
+int SceneGraph::Update() {
+	// preorder: a changed node's subtree is the range after it; skip queued nodes already covered
+	int nUpdated = 0, end = -1;
+	std::sort(changed.begin(), changed.end());
+	for (int i : changed) {
+		dirty[i] = 0;
+		if (i < end)
+			continue;
+		end = i+nodes[i].nDescendants+1;
+		for (int k = i; k < end; k++) {
+			SceneNode &n = nodes[k];
+			world[k] = n.parent < 0? n.local : world[n.parent]*n.local;
+			if (n.mesh)
+				n.mesh->transform = world[k];
+		}
+		// children follow parents, so a reverse sweep finds children's bounds first
+		for (int k = end-1; k >= i; k--)
+			SubtreeBounds(k);
+		for (int a = nodes[i].parent; a >= 0; a = nodes[a].parent)
+			SubtreeBounds(a);
+		nUpdated += end-i;
+	}
+	changed.resize(0);
+	return nUpdated;
+}
+
+// Mesh Class
+
+namespace {
+
+void IntersectRanges(vector<GLsizei> &counts, vector<size_t> &offsets, vector<GLsizei> &counts2, vector<size_t> &offsets2) {
+	// set ranges (index counts at byte offsets, each list ascending) to their intersection with ranges2
+	vector<GLsizei> c;
+	vector<size_t> o;
+	for (size_t i = 0, j = 0; i < counts.size() && j < counts2.size(); ) {
+		size_t end = offsets[i]+counts[i]*sizeof(int), end2 = offsets2[j]+counts2[j]*sizeof(int);
+		size_t start = std::max(offsets[i], offsets2[j]), stop = std::min(end, end2);
+		if (start < stop) {
+			c.push_back((GLsizei) ((stop-start)/sizeof(int)));
+			o.push_back(start);
+		}
+		if (end < end2)
+			i++;
+		else
+			j++;
+	}
+	counts.swap(c);
+	offsets.swap(o);
+}
+
+} // end namespace
+
+void Mesh::Display(CameraAB camera, int textureUnit, bool lines, bool useGroupColor) {
+	int width, height;
+	GetViewportSize(width, height);
+	int lod = lods.size()? SelectLOD(camera, height) : -1;
+	vector<int3> &tris = lod < 0? triangles : lods[lod].triangles;
+	vector<Group> &groups = lod < 0? triangleGroups : lods[lod].triangleGroups;
+	int nTris = tris.size(), nQuads = quads.size(), eOffset = lod < 0? 0 : lods[lod].eOffset;
+	// visibleGroups index triangleGroups; an LOD has the same groups, in the same order
+	vector<int> *visible = visibleGroups && groups.size() == triangleGroups.size()? visibleGroups : NULL;
+	// enable shader and vertex array object
+	int shader = UseMeshShader(lines);
+	glBindVertexArray(vao);
+	// texture
+	if (!textureName || !uvs.size() || textureUnit < 0)
+		SetUniform(shader, "useTexture", false);
+	else {
+		glActiveTexture(GL_TEXTURE0+textureUnit);
+		glBindTexture(GL_TEXTURE_2D, textureName);
+		SetUniform(shader, "textureImage", textureUnit); // but app can unset useTexture
+	}
+	// set custom transform and draw (xform = mesh transform X view transform)
+	mat4 modelview = camera.modelview*transform;
+	SetUniform(shader, "modelview", modelview);
+	SetUniform(shader, "normalMatrix", normalMatrixCache.Get(modelview, NormalMatrix));
+	SetUniform(shader, "dequantize", dequantize);
+	SetUniform(shader, "octNormal", vertexFormat != FloatPlanar);
+	SetUniform(shader, "persp", camera.persp);
+	int textureSet = 0;
+	glGetUniformiv(shader, UniformLocation(shader, "useTexture"), &textureSet);
+	if (lines)
+		SetUniform(shader, "vp", Viewport());
+	if (useGroupColor) {
+		// show ungrouped triangles without texture mapping
+		int nGroups = groups.size(), nUngrouped = nGroups? groups[0].startTriangle : nTris;
+		SetUniform(shader, "useTexture", false);
+		glDrawElements(GL_TRIANGLES, 3*nUngrouped, GL_UNSIGNED_INT, tris.data());
+		// show grouped triangles with texture mapping
+		SetUniform(shader, "useTexture", textureSet == 1);
+		for (int i = 0; i < (visible? (int) visible->size() : nGroups); i++) {
+			Group g = groups[visible? (*visible)[i] : i];
+			SetUniform(shader, "color", g.color);
+			glDrawElements(GL_TRIANGLES, 3*g.nTriangles, GL_UNSIGNED_INT, &tris[g.startTriangle]);
+		}
+	}
+	else {
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eBufferId);
+		bool cullMeshlets = lod < 0 && meshlets.size();
+		if (visible || cullMeshlets) {
+			// ranges of ungrouped triangles and visible groups, and/or of visible meshlets
+			vector<GLsizei> counts, meshletCounts;
+			vector<size_t> offsets, meshletOffsets;
+			if (visible) {
+				int nUngrouped = groups.size()? groups[0].startTriangle : nTris;
+				for (int i = -1; i < (int) visible->size(); i++) {
+					int start = i < 0? 0 : groups[(*visible)[i]].startTriangle;
+					int count = i < 0? nUngrouped : groups[(*visible)[i]].nTriangles;
+					size_t offset = (eOffset+start)*sizeof(int3);
+					if (counts.size() && offsets.back()+counts.back()*sizeof(int) == offset)
+						counts.back() += 3*count;
+					else if (count) {
+						counts.push_back(3*count);
+						offsets.push_back(offset);
+					}
+				}
+			}
+			if (cullMeshlets) {
+				CullMeshlets(meshlets, modelview, camera.persp, meshletCounts, meshletOffsets, cullBackfacing);
+				if (visible)
+					IntersectRanges(counts, offsets, meshletCounts, meshletOffsets);
+				else {
+					counts.swap(meshletCounts);
+					offsets.swap(meshletOffsets);
+				}
+			}
+			glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, (const void **) offsets.data(), (GLsizei) counts.size());
+		}
+		else
+			glDrawElements(GL_TRIANGLES, 3*nTris, GL_UNSIGNED_INT, (void *) (eOffset*sizeof(int3)));
+//		glDrawElements(GL_TRIANGLES, 3*nTris, GL_UNSIGNED_INT, triangles.data());
+#ifdef GL_QUADS
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		glDrawElements(GL_QUADS, 4*nQuads, GL_UNSIGNED_INT, quads.data());
+#endif
+	}
+	glBindVertexArray(0);
+}
+
+void Enable(int id, int ncomps, int offset) {
+	glEnableVertexAttribArray(id);
+	glVertexAttribPointer(id, ncomps, GL_FLOAT, GL_FALSE, 0, (void *) offset);
+}
+
+void Enable(int id, int ncomps, GLenum type, bool normalized, int stride, size_t offset) {
+	glEnableVertexAttribArray(id);
+	glVertexAttribPointer(id, ncomps, type, normalized? GL_TRUE : GL_FALSE, stride, (void *) offset);
+}
+
+namespace {
+
+struct Instance { mat4 m; vec3 color; };	// transform (transposed: a mat4 attribute is four column vec4s), color
+
+} // end namespace
+
+void Mesh::EnableInstances() {
+	// instance attributes, advanced once per instance
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, iBufferId);
+	for (int i = 0; i < 5; i++) {
+		Enable(3+i, i < 4? 4 : 3, GL_FLOAT, false, sizeof(Instance), i*sizeof(vec4));
+		glVertexAttribDivisor(3+i, 1);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Mesh::SetInstances(vector<mat4> &transforms, vector<vec3> *colors) {
+	// interleave instance transform and color
+	int stride = sizeof(Instance);
+	nInstances = (int) transforms.size();
+	instanceColors = colors != NULL;
+	vector<Instance> instances(nInstances);
+	for (int i = 0; i < nInstances; i++)
+		instances[i] = {Transpose(transforms[i]), colors? (*colors)[i] : vec3(1, 1, 1)};
+	if (!iBufferId)
+		glGenBuffers(1, &iBufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, iBufferId);
+	// keep the buffer's storage unless it must grow
+	GLint size = 0;
+	glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+	if (size < nInstances*stride)
+		glBufferData(GL_ARRAY_BUFFER, nInstances*stride, instances.data(), GL_DYNAMIC_DRAW);
+	else
+		glBufferSubData(GL_ARRAY_BUFFER, 0, nInstances*stride, instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	EnableInstances();
+}
+
+void Mesh::DisplayInstanced(CameraAB camera, int textureUnit, bool lines) {
+	// one draw call for all instances; uniforms set once
+	// the LOD is selected for transform, not per instance; meshlets aren't culled (each instance moves them)
+	int width, height;
+	GetViewportSize(width, height);
+	int lod = lods.size()? SelectLOD(camera, height) : -1;
+	int nTris = lod < 0? (int) triangles.size() : (int) lods[lod].triangles.size(), eOffset = lod < 0? 0 : lods[lod].eOffset;
+	int shader = UseMeshShader(lines);
+	glBindVertexArray(vao);
+	if (!textureName || !uvs.size() || textureUnit < 0)
+		SetUniform(shader, "useTexture", false);
+	else {
+		glActiveTexture(GL_TEXTURE0+textureUnit);
+		glBindTexture(GL_TEXTURE_2D, textureName);
+		SetUniform(shader, "textureImage", textureUnit); // but app can unset useTexture
+	}
+	mat4 modelview = camera.modelview*transform;
+	SetUniform(shader, "modelview", modelview);
+	SetUniform(shader, "normalMatrix", normalMatrixCache.Get(modelview, NormalMatrix));
+	SetUniform(shader, "persp", camera.persp);
+	SetUniform(shader, "dequantize", dequantize);
+	SetUniform(shader, "octNormal", vertexFormat != FloatPlanar);
+	SetUniform(shader, "useInstance", true);
+	SetUniform(shader, "useInstanceColor", instanceColors);
+	if (lines)
+		SetUniform(shader, "vp", Viewport());
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eBufferId);
+	glDrawElementsInstanced(GL_TRIANGLES, 3*nTris, GL_UNSIGNED_INT, (void *) (eOffset*sizeof(int3)), nInstances);
+	SetUniform(shader, "useInstance", false);
+	glBindVertexArray(0);
+}
+
+void Mesh::Buffer(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex) {
+	int nPts = pts.size(), nNrms = nrms? nrms->size() : 0, nUvs = tex? tex->size() : 0;
+	if (!nPts) { printf("Buffer: no points!\n"); return; }
+	dequantize = mat4();
+	if (vertexFormat != FloatPlanar) {
+		BufferPacked(pts, nrms, tex);
+		return;
+	}
+	// create vertex buffer
+	if (!vBufferId)
+		glGenBuffers(1, &vBufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, vBufferId);
+	// allocate GPU memory for vertex position, texture, normals
+	int sizePoints = nPts*sizeof(vec3), sizeNormals = nNrms*sizeof(vec3), sizeUvs = nUvs*sizeof(vec2);
+	int bufferSize = sizePoints+sizeUvs+sizeNormals;
+	glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_STATIC_DRAW);
+	// load vertex buffer
+	if (nPts) glBufferSubData(GL_ARRAY_BUFFER, 0, sizePoints, pts.data());
+	if (nNrms) glBufferSubData(GL_ARRAY_BUFFER, sizePoints, sizeNormals, nrms->data());
+	if (nUvs) glBufferSubData(GL_ARRAY_BUFFER, sizePoints+sizeNormals, sizeUvs, tex->data());
+	// create and load element buffer for triangles
+	BufferElements();
+	// create vertex array object for mesh, or reuse it (keeping SetInstances attributes)
+	if (!vao)
+		glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	// enable attributes (disable any a prior Buffer enabled)
+	if (nPts) Enable(0, 3, 0);						// VertexAttribPointer(shader, "point", 3, 0, (void *) 0);
+	if (nNrms) Enable(1, 3, sizePoints);			// VertexAttribPointer(shader, "normal", 3, 0, (void *) sizePoints);
+	else glDisableVertexAttribArray(1);
+	if (nUvs) Enable(2, 2, sizePoints+sizeNormals); // VertexAttribPointer(shader, "uv", 2, 0, (void *) (sizePoints+sizeNormals));
+	else glDisableVertexAttribArray(2);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	if (iBufferId)
+		EnableInstances();
+}
+
+void Mesh::Buffer() { Buffer(points, normals.size()? &normals : NULL, uvs.size()? &uvs : NULL); }
+
+void Mesh::BufferElements() {
+	// triangles, followed by the triangles of each LOD
+	int nTriangles = (int) triangles.size();
+	for (size_t i = 0; i < lods.size(); i++) {
+		lods[i].eOffset = nTriangles;
+		nTriangles += (int) lods[i].triangles.size();
+	}
+	if (!eBufferId)
+		glGenBuffers(1, &eBufferId);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eBufferId);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, nTriangles*sizeof(int3), NULL, GL_STATIC_DRAW);
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, triangles.size()*sizeof(int3), triangles.data());
+	for (size_t i = 0; i < lods.size(); i++)
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, lods[i].eOffset*sizeof(int3), lods[i].triangles.size()*sizeof(int3), lods[i].triangles.data());
+}
+
+void Mesh::BuildLODs(vector<float> ratios) {
+	// each LOD is simplified from the previous; its error bound is the sum of errors along the chain
+	vec3 min, max;
+	MinMax(points.data(), (int) points.size(), min, max);
+	lodCenter = .5f*(min+max);
+	lodRadius = .5f*length(max-min);
+	lods.resize(ratios.size());
+	for (size_t i = 0; i < ratios.size(); i++) {
+		MeshLOD &lod = lods[i], *prev = i? &lods[i-1] : NULL;
+		lod.triangles = prev? prev->triangles : triangles;
+		lod.triangleGroups = prev? prev->triangleGroups : triangleGroups;
+		lod.triangleMtls = prev? prev->triangleMtls : triangleMtls;
+		float error = 0;
+		SimplifyMesh(points, lod.triangles, (int) (ratios[i]*triangles.size()), &lod.triangleGroups, &lod.triangleMtls, &error);
+		lod.error = error+(prev? prev->error : 0);
+	}
+	if (vao)
+		BufferElements();
+}
+
+int Mesh::BuildMeshlets(int maxVertices, int maxTriangles) {
+	::BuildMeshlets(points, triangles, meshlets, &triangleGroups, &triangleMtls, maxVertices, maxTriangles);
+	ClearPicking();
+	if (vao)
+		BufferElements();
+	return (int) meshlets.size();
+}
+
+int Mesh::SelectLOD(CameraAB &camera, int viewportHeight) {
+	// project LOD error at the depth of the nearest point of the bounding sphere
+	mat4 m = camera.modelview*transform;
+	float scale = length(vec3(m[0][0], m[1][0], m[2][0]));
+	vec4 c = m*vec4(lodCenter, 1);
+	float depth = -c.z-scale*lodRadius;						// camera looks down -z
+	if (depth <= 0)
+		return -1;
+	float pixelsPerUnit = .5f*viewportHeight*camera.persp[1][1]/depth;
+	int lod = -1;
+	for (int i = 0; i < (int) lods.size(); i++)
+		if (lods[i].error*scale*pixelsPerUnit <= lodPixelError)
+			lod = i;
+	return lod;
+}
+
+void Mesh::BufferPacked(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex) {
+	// interleave vertices per PackVertices, upload, and enable attributes at their offsets
+	PackedVertices pv;
+	PackVertices(pts, nrms, tex, vertexFormat == PackedQuantized, pv);
+	if (!vBufferId)
+		glGenBuffers(1, &vBufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, vBufferId);
+	glBufferData(GL_ARRAY_BUFFER, pv.data.size(), pv.data.data(), GL_STATIC_DRAW);
+	dequantize = pv.dequantize;
+	BufferElements();
+	if (!vao)
+		glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	if (pv.quantized)
+		Enable(0, 3, GL_UNSIGNED_SHORT, true, pv.stride, 0);
+	else
+		Enable(0, 3, GL_FLOAT, false, pv.stride, 0);
+	if (pv.normalOffset >= 0)
+		Enable(1, 2, GL_SHORT, false, pv.stride, pv.normalOffset);	// scaled by shader
+	else
+		glDisableVertexAttribArray(1);
+	if (pv.uvOffset >= 0)
+		Enable(2, 2, pv.uvHalf? GL_HALF_FLOAT : GL_UNSIGNED_SHORT, !pv.uvHalf, pv.stride, pv.uvOffset);
+	else
+		glDisableVertexAttribArray(2);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	if (iBufferId)
+		EnableInstances();
+}
+
+void Mesh::Set(vector<vec3> &pts, vector<vec3> *nrms, vector<vec2> *tex, vector<int> *tris, vector<int> *quas) {
+	if (tris) {
+		triangles.resize(tris->size()/3);
+		for (int i = 0; i < (int) triangles.size(); i++)
+			triangles[i] = { (*tris)[3*i], (*tris)[3*i+1], (*tris)[3*i+2] };
+		lods.clear();
+		meshlets.clear();
+	}
+	if (quas) {
+		quads.resize(quas->size()/4);
+		for (int i = 0; i < (int) quads.size(); i++)
+			quads[i] = { (*quas)[4*i], (*quas)[4*i+1], (*quas)[4*i+2], (*quas)[4*i+3] };
+	}
+	ClearPicking();
+	Buffer(pts, nrms, tex);
+}
+
+bool Mesh::Read(string objFile, mat4 *m, bool normalize, bool buffer) {
+	time_t objModified = useCache? FileModified(objFile.c_str()) : 0;
+	string cacheFile = MeshCacheName(objFile);
+	if (!useCache || !ReadMeshCache(cacheFile.c_str(), objModified, normalize, points, triangles,
+									&normals, &uvs, &triangleGroups, &triangleMtls, &quads)) {
+		points.resize(0);
+		triangles.resize(0);
+		normals.resize(0);
+		uvs.resize(0);
+		triangleGroups.resize(0);
+		triangleMtls.resize(0);
+		quads.resize(0);
+		string mtlLib;
+		if (!ReadAsciiObjParallel(objFile.c_str(), points, triangles, &normals, &uvs, &triangleGroups, &triangleMtls, &quads, NULL, &mtlLib)) {
+			printf("Mesh.Read: can't read %s\n", objFile.c_str());
+			return false;
+		}
+		if (normalize)
+			Normalize(points, 1);
+		if (useCache)
+			WriteMeshCache(cacheFile.c_str(), objModified, normalize, points, triangles,
+						   &normals, &uvs, &triangleGroups, &triangleMtls, &quads, mtlLib.empty()? NULL : mtlLib.c_str());
+	}
+	objFilename = objFile;
+	lods.clear();
+	meshlets.clear();
+	ClearPicking();
+	if (buffer)
+		Buffer();
+	if (m)
+		transform = *m;
+	return true;
+}
+
+bool Mesh::Read(string objFile, string texFile, mat4 *m, bool normalize, bool buffer) {
+	if (!Read(objFile, m, normalize, buffer))
+		return false;
+	objFilename = objFile;
+	texFilename = texFile;
+	textureName = LoadTexture((char *) texFile.c_str());
+	if (!textureName)
+		printf("Mesh.Read: bad texture name\n");
+	return textureName > 0;
+}
+
+int Mesh::IntersectWithLine(vec3 p1, vec3 p2, float &alpha) {
+	if (triInfos.size() != triangles.size())
+		BuildTriInfos(points, triangles, triInfos, bvh);
+	mat4 inverse = InverseTransform();
+	return ::IntersectWithLine(p1, p2, triInfos, bvh, alpha, &inverse);
+}
+
+void Mesh::ClearPicking() {
+	triInfos.clear();
+	bvh.nodes.clear();
+	bvh.order.clear();
+}
+
+// intersections
+
+vec2 MajPln(vec3 &p, int mp) { return mp == 1? vec2(p.y, p.z) : mp == 2? vec2(p.x, p.z) : vec2(p.x, p.y); }
+
+TriInfo::TriInfo(vec3 a, vec3 b, vec3 c) {
+	vec3 v1(b-a), v2(c-b), x = normalize(cross(v1, v2));
+	plane = vec4(x.x, x.y, x.z, -dot(a, x));
+	float ax = fabs(x.x), ay = fabs(x.y), az = fabs(x.z);
+	majorPlane = ax > ay? (ax > az? 1 : 3) : (ay > az? 2 : 3);
+	p1 = MajPln(a, majorPlane);
+	p2 = MajPln(b, majorPlane);
+	p3 = MajPln(c, majorPlane);
+}
+
+bool LineIntersectPlane(vec3 p1, vec3 p2, vec4 plane, vec3 *intersection, float *alpha) {
+  vec3 normal(plane.x, plane.y, plane.z);
+  vec3 axis(p2-p1);
+  float pdDot = dot(axis, normal);
+  if (fabs(pdDot) < FLT_MIN)
+	  return false;
+  float a = (-plane.w-dot(p1, normal))/pdDot;
+  if (intersection != NULL)
+	  *intersection = p1+a*axis;
+  if (alpha)
+	  *alpha = a;
+  return true;
+}
+
+static bool IsZero(float d) { return d < FLT_EPSILON && d > -FLT_EPSILON; };
+
+int CompareVs(vec2 &v1, vec2 &v2) {
+	if ((v1.y > 0 && v2.y > 0) ||           // edge is fully above query point p'
+		(v1.y < 0 && v2.y < 0) ||           // edge is fully below p'
+		(v1.x < 0 && v2.x < 0))             // edge is fully left of p'
+		return 0;                           // can't cross
+	float zcross = v2.y*v1.x-v1.y*v2.x;     // right-handed cross-product
+	zcross /= length(v1-v2);
+	if (IsZero(zcross) && (v1.x <= 0 || v2.x <= 0))
+		return 1;                           // on or very close to edge
+	if ((v1.y > 0 || v2.y > 0) && ((v1.y-v2.y < 0) != (zcross < 0)))
+		return 2;                           // edge is crossed
+	else
+		return 0;                           // edge not crossed
+}
+
+bool IsInside(const vec2 &p, vector<vec2> &pts) {
+	bool odd = false;
+	int npts = pts.size();
+	vec2 q = p, v2 = pts[npts-1]-q;
+	for (int n = 0; n < npts; n++) {
+		vec2 v1 = v2;
+		v2 = pts[n]-q;
+		if (CompareVs(v1, v2) == 2)
+			odd = !odd;
+	}
+	return odd;
+}
+
+bool IsInside(const vec2 &p, const vec2 &a, const vec2 &b, const vec2 &c) {
+	bool odd = false;
+	vec2 q = p, v2 = c-q;
+	for (int n = 0; n < 3; n++) {
+		vec2 v1 = v2;
+		v2 = (n==0? a : n==1? b : c)-q;
+		if (CompareVs(v1, v2) == 2)
+			odd = !odd;
+	}
+	return odd;
+}
+
+void BuildTriInfos(vector<vec3> &points, vector<int3> &triangles, vector<TriInfo> &triInfos) {
+	triInfos.resize(triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++) {
+		int3 &t = triangles[i];
+		triInfos[i] = TriInfo(points[t.i1], points[t.i2], points[t.i3]);
+	}
+}
+
+int IntersectWithLine(vec3 p1, vec3 p2, vector<TriInfo> &triInfos, float &retAlpha) {
+	int picked = -1;
+	float alpha, minAlpha = FLT_MAX;
+	for (size_t i = 0; i < triInfos.size(); i++) {
+		TriInfo &t = triInfos[i];
+		vec3 inter;
+		if (LineIntersectPlane(p1, p2, t.plane, &inter, &alpha)) {
+			if (alpha < minAlpha) {
+				if (IsInside(MajPln(inter, t.majorPlane), t.p1, t.p2, t.p3)) {
+					minAlpha = alpha;
+					picked = i;
+				}
+			}
+		}
+	}
+	retAlpha = minAlpha;
+	return picked;
+}
+
+// bounding volume hierarchy
+
+namespace {
+
+float HalfArea(const vec3 &min, const vec3 &max) {
+	vec3 d = max-min;
+	return d.x*d.y+d.y*d.z+d.z*d.x;
+}
+
+void Grow(vec3 &min, vec3 &max, const vec3 &bmin, const vec3 &bmax) {
+	for (int k = 0; k < 3; k++) {
+		min[k] = bmin[k] < min[k]? bmin[k] : min[k];
+		max[k] = bmax[k] > max[k]? bmax[k] : max[k];
+	}
+}
+
+void TriangleBounds(vector<vec3> &points, int3 &t, vec3 &min, vec3 &max) {
+	min = max = points[t.i1];
+	Grow(min, max, points[t.i2], points[t.i2]);
+	Grow(min, max, points[t.i3], points[t.i3]);
+}
+
+void Pad(BVHNode &n) {
+	// grow bounds slightly so that a computed intersection on a triangle at a box face isn't culled
+	for (int k = 0; k < 3; k++) {
+		float m = fabs(n.min[k]) > fabs(n.max[k])? fabs(n.min[k]) : fabs(n.max[k]);
+		float pad = 1e-5f*(m+n.max[k]-n.min[k])+FLT_MIN;
+		n.min[k] -= pad;
+		n.max[k] += pad;
+	}
+}
+
+struct BVHBuilder {
+	static const int NBins = 16;
+	BVH &bvh;
+	vector<vec3> &bmin, &bmax, &centers;
+	int maxLeafSize;
+	BVHBuilder(BVH &bvh, vector<vec3> &bmin, vector<vec3> &bmax, vector<vec3> &centers, int maxLeafSize) :
+		bvh(bvh), bmin(bmin), bmax(bmax), centers(centers), maxLeafSize(maxLeafSize) { }
+	void Build(int start, int count, int depth) {
+		// binned surface area heuristic: cost of split = 1+(aLeft*nLeft+aRight*nRight)/aNode,
+		// cost of leaf = count; split at bin boundary of least cost among all three axes
+		int *order = bvh.order.data(), nodeId = (int) bvh.nodes.size();
+		vec3 min(FLT_MAX), max(-FLT_MAX), cmin(FLT_MAX), cmax(-FLT_MAX);
+		for (int i = start; i < start+count; i++) {
+			Grow(min, max, bmin[order[i]], bmax[order[i]]);
+			Grow(cmin, cmax, centers[order[i]], centers[order[i]]);
+		}
+		BVHNode node;
+		node.min = min;
+		node.max = max;
+		node.start = start;
+		node.count = count;
+		bvh.nodes.push_back(node);
+		if (count <= maxLeafSize || depth >= BVH::MaxDepth)
+			return;
+		float bestCost = (float) count, aNode = HalfArea(min, max);
+		int bestAxis = -1, bestSplit = 0;
+		for (int k = 0; k < 3; k++) {
+			float extent = cmax[k]-cmin[k];
+			if (extent <= 0)
+				continue;
+			int nBin[NBins] = {0};
+			vec3 binMin[NBins], binMax[NBins];
+			for (int b = 0; b < NBins; b++) {
+				binMin[b] = vec3(FLT_MAX);
+				binMax[b] = vec3(-FLT_MAX);
+			}
+			float scale = NBins/extent;
+			for (int i = start; i < start+count; i++) {
+				int t = order[i], b = (int) (scale*(centers[t][k]-cmin[k]));
+				b = b < NBins? b : NBins-1;
+				nBin[b]++;
+				Grow(binMin[b], binMax[b], bmin[t], bmax[t]);
+			}
+			// sweep from right for right-side areas, then from left evaluating each split
+			float rightArea[NBins];
+			vec3 rMin(FLT_MAX), rMax(-FLT_MAX);
+			for (int b = NBins-1; b > 0; b--) {
+				Grow(rMin, rMax, binMin[b], binMax[b]);
+				rightArea[b] = HalfArea(rMin, rMax);
+			}
+			vec3 lMin(FLT_MAX), lMax(-FLT_MAX);
+			int nLeft = 0;
+			for (int b = 1; b < NBins; b++) {
+				Grow(lMin, lMax, binMin[b-1], binMax[b-1]);
+				nLeft += nBin[b-1];
+				int nRight = count-nLeft;
+				if (!nLeft || !nRight)
+					continue;
+				float cost = 1+(HalfArea(lMin, lMax)*nLeft+rightArea[b]*nRight)/aNode;
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestAxis = k;
+					bestSplit = b;
+				}
+			}
+		}
+		if (bestAxis < 0)
+			return;									// leaf is cheaper, or centers coincide
+		float scale = NBins/(cmax[bestAxis]-cmin[bestAxis]), c = cmin[bestAxis];
+		int *mid = std::partition(order+start, order+start+count, [&](int t) {
+			int b = (int) (scale*(centers[t][bestAxis]-c));
+			return (b < NBins? b : NBins-1) < bestSplit;
+		});
+		int nLeft = (int) (mid-(order+start));
+		bvh.nodes[nodeId].count = 0;
+		Build(start, nLeft, depth+1);
+		bvh.nodes[nodeId].start = (int) bvh.nodes.size();
+		Build(start+nLeft, count-nLeft, depth+1);
+	}
+};
+
+bool LineBox(const vec3 &p, const vec3 &axis, const vec3 &invAxis, const BVHNode &n, float maxAlpha, float &alpha) {
+	// set alpha at which line p+alpha*axis enters box; return false if line misses box
+	// or enters beyond maxAlpha
+	float lo = -FLT_MAX, hi = maxAlpha;
+	for (int k = 0; k < 3; k++) {
+		if (fabs(axis[k]) < FLT_MIN) {
+			if (p[k] < n.min[k] || p[k] > n.max[k])
+				return false;
+			continue;
+		}
+		float t1 = (n.min[k]-p[k])*invAxis[k], t2 = (n.max[k]-p[k])*invAxis[k];
+		lo = t1 < t2? (t1 > lo? t1 : lo) : (t2 > lo? t2 : lo);
+		hi = t1 < t2? (t2 < hi? t2 : hi) : (t1 < hi? t1 : hi);
+	}
+	alpha = lo;
+	return lo <= hi;
+}
+
+} // end namespace
+
+void BVH::Build(vector<vec3> &points, vector<int3> &triangles, int maxLeafSize) {
+	int nTriangles = (int) triangles.size();
+	vector<vec3> bmin(nTriangles), bmax(nTriangles), centers(nTriangles);
+	ParallelFor(nTriangles, [&](int t1, int t2) {
+		for (int t = t1; t < t2; t++) {
+			TriangleBounds(points, triangles[t], bmin[t], bmax[t]);
+			centers[t] = .5f*(bmin[t]+bmax[t]);
+		}
+	}, 100000);
+	nodes.resize(0);
+	nodes.reserve(nTriangles > 0? 2*nTriangles/(maxLeafSize > 1? maxLeafSize-1 : 1) : 0);
+	order.resize(nTriangles);
+	for (int t = 0; t < nTriangles; t++)
+		order[t] = t;
+	if (nTriangles)
+		BVHBuilder(*this, bmin, bmax, centers, maxLeafSize > 0? maxLeafSize : 1).Build(0, nTriangles, 0);
+	for (size_t i = 0; i < nodes.size(); i++)
+		Pad(nodes[i]);
+}
+
+void BVH::Refit(vector<vec3> &points, vector<int3> &triangles) {
+	// children follow their parent in nodes, so a reverse sweep updates children first
+	for (int i = (int) nodes.size()-1; i >= 0; i--) {
+		BVHNode &n = nodes[i];
+		if (n.count) {
+			TriangleBounds(points, triangles[order[n.start]], n.min, n.max);
+			for (int j = n.start+1; j < n.start+n.count; j++) {
+				vec3 tmin, tmax;
+				TriangleBounds(points, triangles[order[j]], tmin, tmax);
+				Grow(n.min, n.max, tmin, tmax);
+			}
+			Pad(n);
+		}
+		else {
+			BVHNode &l = nodes[i+1], &r = nodes[n.start];
+			n.min = l.min;
+			n.max = l.max;
+			Grow(n.min, n.max, r.min, r.max);
+		}
+	}
+}
+
+void BuildTriInfos(vector<vec3> &points, vector<int3> &triangles, vector<TriInfo> &triInfos, BVH &bvh) {
+	BuildTriInfos(points, triangles, triInfos);
+	bvh.Build(points, triangles);
+}
+
+int IntersectWithLine(vec3 p1, vec3 p2, vector<TriInfo> &triInfos, BVH &bvh, float &retAlpha, mat4 *inverse) {
+	// nodes are visited nearest first and culled once beyond the nearest hit so far; equal alphas
+	// resolve to the lowest triangle index, as with the linear search
+	if (inverse) {
+		// alpha is invariant under the (affine) mapping of the line into object space
+		vec4 q1 = *inverse*vec4(p1, 1), q2 = *inverse*vec4(p2, 1);
+		p1 = vec3(q1.x, q1.y, q1.z);
+		p2 = vec3(q2.x, q2.y, q2.z);
+	}
+	vec3 axis(p2-p1), invAxis(1/axis.x, 1/axis.y, 1/axis.z);
+	int picked = -1, stack[BVH::MaxDepth+4], nStack = 0;
+	float alpha, minAlpha = FLT_MAX;
+	if (!bvh.nodes.empty())
+		stack[nStack++] = 0;
+	while (nStack) {
+		const BVHNode &n = bvh.nodes[stack[--nStack]];
+		if (!LineBox(p1, axis, invAxis, n, minAlpha, alpha))
+			continue;
+		if (n.count) {
+			for (int i = n.start; i < n.start+n.count; i++) {
+				int id = bvh.order[i];
+				TriInfo &t = triInfos[id];
+				vec3 inter;
+				if (LineIntersectPlane(p1, p2, t.plane, &inter, &alpha)) {
+					if (alpha < minAlpha || (alpha == minAlpha && id < picked)) {
+						if (IsInside(MajPln(inter, t.majorPlane), t.p1, t.p2, t.p3)) {
+							minAlpha = alpha;
+							picked = id;
+						}
+					}
+				}
+			}
+		}
+		else {
+			// push farther child first
+			int left = (int) (&n-bvh.nodes.data())+1, right = n.start;
+			float aLeft, aRight;
+			bool hitLeft = LineBox(p1, axis, invAxis, bvh.nodes[left], minAlpha, aLeft);
+			bool hitRight = LineBox(p1, axis, invAxis, bvh.nodes[right], minAlpha, aRight);
+			if (hitLeft && hitRight) {
+				stack[nStack++] = aLeft < aRight? right : left;
+				stack[nStack++] = aLeft < aRight? left : right;
+			}
+			else if (hitLeft || hitRight)
+				stack[nStack++] = hitLeft? left : right;
+		}
+	}
+	retAlpha = minAlpha;
+	return picked;
+}
+
+// SIMD intersection
+
+namespace {
+
+const int NLanes = FloatBatch::n;
+
+struct Vec3N {
+	FloatBatch x, y, z;
+	Vec3N() { }
+	Vec3N(const vec3 &v) : x(FloatBatch::Splat(v.x)), y(FloatBatch::Splat(v.y)), z(FloatBatch::Splat(v.z)) { }
+	Vec3N(FloatBatch x, FloatBatch y, FloatBatch z) : x(x), y(y), z(z) { }
+	Vec3N(const float *x, const float *y, const float *z) : x(FloatBatch::Load(x)), y(FloatBatch::Load(y)), z(FloatBatch::Load(z)) { }
+	Vec3N operator - (const Vec3N &b) const { return Vec3N(x-b.x, y-b.y, z-b.z); }
+};
+
+inline FloatBatch Dot(const Vec3N &a, const Vec3N &b) { return (a.x*b.x+a.y*b.y)+a.z*b.z; }
+
+inline Vec3N Cross(const Vec3N &a, const Vec3N &b) {
+	return Vec3N(a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x);
+}
+
+inline int MollerTrumbore(const Vec3N &o, const Vec3N &d, const Vec3N &v0, const Vec3N &e1, const Vec3N &e2, FloatBatch maxAlpha, FloatBatch &alpha) {
+	// lane mask of lines o+alpha*d that cross triangles (v0, v0+e1, v0+e2) with alpha < maxAlpha
+	FloatBatch zero = FloatBatch::Splat(0), one = FloatBatch::Splat(1);
+	Vec3N pvec = Cross(d, e2), tvec = o-v0, qvec = Cross(tvec, e1);
+	FloatBatch det = Dot(e1, pvec), inv = one/det;
+	FloatBatch u = Dot(tvec, pvec)*inv, v = Dot(d, qvec)*inv;
+	alpha = Dot(e2, qvec)*inv;
+	FloatBatch hit = (det != zero) & (u >= zero) & (v >= zero) & (one >= u+v) & (alpha < maxAlpha);
+	return hit.Mask();
+}
+
+} // end namespace
+
+void BuildTriangleSoA(vector<vec3> &points, vector<int3> &triangles, TriangleSoA &soa) {
+	int n = (int) triangles.size(), nPadded = (n+7)/8*8;
+	vector<float> *a[] = {&soa.v0x, &soa.v0y, &soa.v0z, &soa.e1x, &soa.e1y, &soa.e1z, &soa.e2x, &soa.e2y, &soa.e2z};
+	for (int k = 0; k < 9; k++)
+		a[k]->assign(nPadded, 0);						// padding is degenerate (never hit)
+	soa.count = n;
+	ParallelFor(n, [&](int t1, int t2) {
+		for (int i = t1; i < t2; i++) {
+			int3 &t = triangles[i];
+			vec3 v0 = points[t.i1], e1 = points[t.i2]-v0, e2 = points[t.i3]-v0;
+			for (int k = 0; k < 3; k++) {
+				(*a[k])[i] = v0[k];
+				(*a[3+k])[i] = e1[k];
+				(*a[6+k])[i] = e2[k];
+			}
+		}
+	}, 100000);
+}
+
+int IntersectWithLine(vec3 p1, vec3 p2, TriangleSoA &soa, float &retAlpha) {
+	// NLanes triangles per step; lanes that hit (rare) are resolved in order, so equal alphas
+	// resolve to the lowest triangle index
+	Vec3N o(p1), d(p2-p1);
+	int picked = -1;
+	float minAlpha = FLT_MAX, alphas[NLanes];
+	for (int i = 0; i < soa.count; i += NLanes) {
+		FloatBatch alpha;
+		int mask = MollerTrumbore(o, d, Vec3N(&soa.v0x[i], &soa.v0y[i], &soa.v0z[i]),
+			Vec3N(&soa.e1x[i], &soa.e1y[i], &soa.e1z[i]), Vec3N(&soa.e2x[i], &soa.e2y[i], &soa.e2z[i]), FloatBatch::Splat(minAlpha), alpha);
+		if (mask) {
+			alpha.Store(alphas);
+			for (int k = 0; k < NLanes; k++)
+				if ((mask & (1 << k)) && alphas[k] < minAlpha) {
+					minAlpha = alphas[k];
+					picked = i+k;
+				}
+		}
+	}
+	retAlpha = minAlpha;
+	return picked;
+}
+
+void IntersectWithLines(int nLines, vec3 *p1s, vec3 *p2s, TriangleSoA &soa, int *picked, float *retAlphas) {
+	// packets of NLanes lines (one per lane) are tested against each triangle in turn
+	for (int i = 0; i < nLines; i += NLanes) {
+		float ox[NLanes], oy[NLanes], oz[NLanes], dx[NLanes], dy[NLanes], dz[NLanes], minAlphas[NLanes], alphas[NLanes];
+		int ids[NLanes];
+		for (int k = 0; k < NLanes; k++) {
+			// replicate last line to fill packet
+			int n = i+k < nLines? i+k : nLines-1;
+			vec3 d = p2s[n]-p1s[n];
+			ox[k] = p1s[n].x; oy[k] = p1s[n].y; oz[k] = p1s[n].z;
+			dx[k] = d.x; dy[k] = d.y; dz[k] = d.z;
+			minAlphas[k] = FLT_MAX;
+			ids[k] = -1;
+		}
+		Vec3N o(ox, oy, oz), d(dx, dy, dz);
+		FloatBatch minAlpha = FloatBatch::Load(minAlphas);
+		for (int t = 0; t < soa.count; t++) {
+			FloatBatch alpha;
+			int mask = MollerTrumbore(o, d, Vec3N(vec3(soa.v0x[t], soa.v0y[t], soa.v0z[t])), Vec3N(vec3(soa.e1x[t], soa.e1y[t], soa.e1z[t])),
+				Vec3N(vec3(soa.e2x[t], soa.e2y[t], soa.e2z[t])), minAlpha, alpha);
+			if (mask) {
+				alpha.Store(alphas);
+				for (int k = 0; k < NLanes; k++)
+					if (mask & (1 << k)) {
+						minAlphas[k] = alphas[k];
+						ids[k] = t;
+					}
+				minAlpha = FloatBatch::Load(minAlphas);
+			}
+		}
+		for (int k = 0; k < NLanes && i+k < nLines; k++) {
+			picked[i+k] = ids[k];
+			retAlphas[i+k] = minAlphas[k];
+		}
+	}
+}
+
+// center/scale for unit size models
+
+void UpdateMinMax(vec3 p, vec3 &min, vec3 &max) {
+	for (int k = 0; k < 3; k++) {
+		if (p[k] < min[k]) min[k] = p[k];
+		if (p[k] > max[k]) max[k] = p[k];
+	}
+}
+
+float GetScaleCenter(vec3 &min, vec3 &max, float scale, vec3 &center) {
+	center = .5f*(min+max);
+	float maxrange = 0;
+	for (int k = 0; k < 3; k++)
+		if ((max[k]-min[k]) > maxrange)
+			maxrange = max[k]-min[k];
+	return scale*2.f/maxrange;
+}
+
+// normalize STL models
+
+void MinMax(vector<VertexSTL> &points, vec3 &min, vec3 &max) {
+	min.x = min.y = min.z = FLT_MAX;
+	max.x = max.y = max.z = -FLT_MAX;
+	for (int i = 0; i < (int) points.size(); i++)
+		UpdateMinMax(points[i].point, min, max);
+}
+
+void Normalize(vector<VertexSTL> &vertices, float scale) {
+	vec3 min, max, center;
+	MinMax(vertices, min, max);
+	float s = GetScaleCenter(min, max, scale, center);
+	for (int i = 0; i < (int) vertices.size(); i++) {
+		vec3 &v = vertices[i].point;
+		v = s*(v-center);
+	}
+}
+
+// normalize vec3 models
+
+mat4 NDCfromMinMax(vec3 min, vec3 max, float scale) {
+	// matrix to transform min/max to -1/+1 (uniformly)
+	float maxrange = 0;
+	for (int k = 0; k < 3; k++)
+		if ((max[k]-min[k]) > maxrange)
+			maxrange = max[k]-min[k];
+	float s = scale*2.f/maxrange;
+	vec3 center = .5f*(max+min);
+	return Scale(s)*Translate(-center);
+}
+
+void MinMax(vec2 *points, int npoints, vec2 &min, vec2 &max) {
+	min[0] = min[1] = FLT_MAX;
+	max[0] = max[1] = -FLT_MAX;
+	for (int i = 0; i < npoints; i++) {
+		vec2 &v = points[i];
+		for (int k = 0; k < 2; k++) {
+			if (v[k] < min[k]) min[k] = v[k];
+			if (v[k] > max[k]) max[k] = v[k];
+		}
+	}
+}
+
+void MinMax(vec3 *points, int npoints, vec3 &min, vec3 &max) {
+	PointSet(points, npoints).MinMax(min, max);
+}
+
+void MinMax(vector<vec3> &points, vec3 &min, vec3 &max) {
+	MinMax(points.data(), points.size(), min, max);
+}
+
+void TransformBox(mat4 &m, vec3 min, vec3 max, vec3 &tMin, vec3 &tMax) {
+	// transform center, and extent by absolute value of the 3x3 (Arvo)
+	vec3 c = .5f*(min+max), e = .5f*(max-min), tc, te;
+	for (int i = 0; i < 3; i++) {
+		tc[i] = m[i][0]*c.x+m[i][1]*c.y+m[i][2]*c.z+m[i][3];
+		te[i] = fabs(m[i][0])*e.x+fabs(m[i][1])*e.y+fabs(m[i][2])*e.z;
+	}
+	tMin = tc-te;
+	tMax = tc+te;
+}
+
+mat4 NormalizeMat(vec3 *points, int npoints, float scale) {
+	vec3 min, max;
+	MinMax(points, npoints, min, max);
+	return NDCfromMinMax(min, max, scale);
+}
+
+void Normalize(vec3 *points, int npoints, float scale) {
+	PointSet(points, npoints).Normalize(scale);
+/*	vec3 center(.5f*(min[0]+max[0]), .5f*(min[1]+max[1]), .5f*(min[2]+max[2]));
+	float maxrange = 0;
+	for (int k = 0; k < 3; k++)
+		if ((max[k]-min[k]) > maxrange)
+			maxrange = max[k]-min[k];
+	float s = scale*2.f/maxrange;
+	for (int i = 0; i < npoints; i++) {
+		vec3 &v = points[i];
+		for (int k = 0; k < 3; k++)
+			v[k] = s*(v[k]-center[k]);
+	} */
+}
+
+void Normalize(vector<vec3> &points, float scale) {
+	Normalize(points.data(), points.size(), scale);
+}
+
+// normals
+
+namespace {
+
+unsigned long long TriangleChecksum(vector<int3> &triangles) {
+	// order-dependent hash of vertex ids, as four interleaved streams so it runs near memory speed
+	const unsigned int *v = (const unsigned int *) triangles.data();
+	const unsigned long long m = 0x9E3779B97F4A7C15ull;
+	size_t n = 3*triangles.size(), i = 0;
+	unsigned long long h[4] = {1, 2, 3, 4};
+	for (; i+4 <= n; i += 4)
+		for (int k = 0; k < 4; k++)
+			h[k] = (h[k]+v[i+k])*m;
+	for (; i < n; i++)
+		h[0] = (h[0]+v[i])*m;
+	return (((h[0]*m+h[1])*m+h[2])*m+h[3])^n;
+}
+
+} // end namespace
+
+void VertexAdjacency::Build(int nPoints, vector<int3> &triangles) {
+	// counting sort of corners by vertex, so each vertex's corners are in triangle order
+	int nCorners = 3*(int) triangles.size();
+	const int *vids = (int *) triangles.data();
+	start.assign(nPoints+1, 0);
+	corners.resize(nCorners);
+	for (int c = 0; c < nCorners; c++)
+		start[vids[c]+1]++;
+	for (int p = 0; p < nPoints; p++)
+		start[p+1] += start[p];
+	vector<int> fill(start.begin(), start.end()-1);
+	for (int c = 0; c < nCorners; c++)
+		corners[fill[vids[c]]++] = c;
+	faceNormals.resize(0);
+	checksum = TriangleChecksum(triangles);
+}
+
+bool VertexAdjacency::Valid(int nPoints, vector<int3> &triangles) {
+	return (int) start.size() == nPoints+1 && corners.size() == 3*triangles.size() &&
+		   checksum == TriangleChecksum(triangles);
+}
+
+namespace {
+
+void SetFaceNormals(vector<vec3> &points, vector<int3> &triangles, VertexAdjacency &adj, NormalWeight weight, vector<int> *which = NULL) {
+	// area weighting: unnormalized cross product (length twice area)
+	// angle weighting: unit normal, and the triangle's angle at each corner
+	int n = which? (int) which->size() : (int) triangles.size();
+	adj.faceNormals.resize(triangles.size());
+	adj.cornerAngles.resize(weight == AngleWeight? triangles.size() : 0);
+	adj.weight = weight;
+	ParallelFor(n, [&](int i1, int i2) {
+		for (int i = i1; i < i2; i++) {
+			int t = which? (*which)[i] : i;
+			int3 &tri = triangles[t];
+			vec3 &p1 = points[tri.i1], &p2 = points[tri.i2], &p3 = points[tri.i3], f(cross(p2-p1, p3-p2));
+			if (weight == AngleWeight) {
+				vec3 e[] = {p2-p1, p3-p2, p1-p3};
+				float len = length(f), lens[] = {length(e[0]), length(e[1]), length(e[2])};
+				for (int k = 0; k < 3; k++) {
+					// angle between edge leaving corner k and edge arriving at k
+					int kk = (k+2)%3;
+					float d = lens[k]*lens[kk], c = d > 0? -dot(e[k], e[kk])/d : 1;
+					adj.cornerAngles[t][k] = acos(c < -1? -1 : c > 1? 1 : c);
+				}
+				f = len > 0? f/len : vec3(0, 0, 0);
+			}
+			adj.faceNormals[t] = f;
+		}
+	}, 50000);
+}
+
+vec3 CornerContribution(VertexAdjacency &adj, int corner) {
+	vec3 &f = adj.faceNormals[corner/3];
+	return adj.weight == AngleWeight? adj.cornerAngles[corner/3][corner%3]*f : f;
+}
+
+vec3 GatherNormal(VertexAdjacency &adj, int p) {
+	vec3 n(0, 0, 0);
+	for (int i = adj.start[p]; i < adj.start[p+1]; i++)
+		n += CornerContribution(adj, adj.corners[i]);
+	return normalize(n);
+}
+
+} // end namespace
+
+void SetVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals) {
+	VertexAdjacency adjacency;
+	SetVertexNormals(points, triangles, normals, adjacency);
+}
+
+void SetVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals, VertexAdjacency &adjacency, NormalWeight weight) {
+	// each vertex gathers its own normal from adjacent faces, so there are no write conflicts
+	int nPoints = (int) points.size();
+	if (!adjacency.Valid(nPoints, triangles))
+		adjacency.Build(nPoints, triangles);
+	SetFaceNormals(points, triangles, adjacency, weight);
+	normals.resize(nPoints);
+	ParallelFor(nPoints, [&](int p1, int p2) {
+		for (int p = p1; p < p2; p++)
+			normals[p] = GatherNormal(adjacency, p);
+	}, 50000);
+}
+
+void UpdateVertexNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals, VertexAdjacency &adjacency, vector<int> &changedTriangles, NormalWeight weight) {
+	int nPoints = (int) points.size();
+	if (!adjacency.Valid(nPoints, triangles) || adjacency.weight != weight ||
+		adjacency.faceNormals.size() != triangles.size() || normals.size() != points.size()) {
+		SetVertexNormals(points, triangles, normals, adjacency, weight);
+		return;
+	}
+	vector<int> changed(changedTriangles), touched;
+	std::sort(changed.begin(), changed.end());
+	changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+	SetFaceNormals(points, triangles, adjacency, weight, &changed);
+	touched.reserve(3*changed.size());
+	for (int t : changed)
+		for (int k = 0; k < 3; k++)
+			touched.push_back(triangles[t][k]);
+	std::sort(touched.begin(), touched.end());
+	touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+	ParallelFor((int) touched.size(), [&](int i1, int i2) {
+		for (int i = i1; i < i2; i++)
+			normals[touched[i]] = GatherNormal(adjacency, touched[i]);
+	}, 50000);
+}
+
+void SetCreaseNormals(vector<vec3> &points, vector<int3> &triangles, vector<vec3> &normals, float creaseAngle, NormalWeight weight, vector<vec2> *uvs) {
+	// a corner averages only those faces about its vertex within creaseAngle of its own face; the
+	// vertex is split so corners with differing normals reference separate (coincident) points
+	// an unreferenced point keeps one (zero-normal) copy
+	VertexAdjacency adj;
+	if (creaseAngle >= 180) {
+		SetVertexNormals(points, triangles, normals, adj, weight);
+		return;
+	}
+	int nPoints = (int) points.size(), nTriangles = (int) triangles.size(), nCorners = 3*nTriangles;
+	adj.Build(nPoints, triangles);
+	SetFaceNormals(points, triangles, adj, weight);
+	vector<vec3> unitN(nTriangles);
+	ParallelFor(nTriangles, [&](int t1, int t2) {
+		for (int t = t1; t < t2; t++) {
+			float len = length(adj.faceNormals[t]);
+			unitN[t] = len > 0? adj.faceNormals[t]/len : vec3(0, 0, 0);
+		}
+	}, 50000);
+	// per-corner normal and group (index of distinct normal about its point)
+	float cosCrease = cos(creaseAngle*3.1415926f/180);
+	vector<vec3> cornerN(nCorners);
+	vector<int> group(nCorners), nGroups(nPoints+1, 0);
+	ParallelFor(nPoints, [&](int p1, int p2) {
+		for (int p = p1; p < p2; p++) {
+			int i1 = adj.start[p], i2 = adj.start[p+1], count = 0;
+			for (int i = i1; i < i2; i++) {
+				int c = adj.corners[i];
+				vec3 &u = unitN[c/3], n(0, 0, 0);
+				bool degenerate = dot(u, u) == 0;			// zero-area face: use all faces
+				for (int j = i1; j < i2; j++)
+					if (degenerate || dot(u, unitN[adj.corners[j]/3]) >= cosCrease)
+						n += CornerContribution(adj, adj.corners[j]);
+				cornerN[c] = n;
+				int g = count;
+				for (int j = i1; j < i && g == count; j++)
+					if (memcmp(&cornerN[adj.corners[j]], &n, sizeof(vec3)) == 0)
+						g = group[adj.corners[j]];
+				group[c] = g;
+				count += g == count? 1 : 0;
+			}
+			nGroups[p+1] = count > 0? count : 1;
+		}
+	}, 50000);
+	for (int p = 0; p < nPoints; p++)
+		nGroups[p+1] += nGroups[p];
+	// nGroups[p] is now the first split point for point p
+	bool splitUvs = uvs && (int) uvs->size() == nPoints;
+	vector<vec3> split(nGroups[nPoints]);
+	vector<vec2> splitUv(splitUvs? nGroups[nPoints] : 0);
+	normals.resize(nGroups[nPoints]);
+	int *vids = (int *) triangles.data();
+	ParallelFor(nPoints, [&](int p1, int p2) {
+		for (int p = p1; p < p2; p++) {
+			for (int id = nGroups[p]; id < nGroups[p+1]; id++) {
+				split[id] = points[p];
+				normals[id] = vec3(0, 0, 0);
+				if (splitUvs)
+					splitUv[id] = (*uvs)[p];
+			}
+			for (int i = adj.start[p]; i < adj.start[p+1]; i++) {
+				int c = adj.corners[i], id = nGroups[p]+group[c];
+				normals[id] = normalize(cornerN[c]);
+				vids[c] = id;
+			}
+		}
+	}, 50000);
+	points.swap(split);
+	if (splitUvs)
+		uvs->swap(splitUv);
+}
+
+// vertex cache optimization
+
+namespace {
+
+vector<int> Segments(int nTriangles, vector<Group> *groups, vector<Mtl> *mtls) {
+	// boundaries of triangle ranges that no group or material range straddles
+	vector<int> b = {0, nTriangles};
+	for (int i = 0; groups && i < (int) groups->size(); i++) {
+		Group &g = (*groups)[i];
+		b.push_back(g.startTriangle);
+		b.push_back(g.startTriangle+g.nTriangles);
+	}
+	for (int i = 0; mtls && i < (int) mtls->size(); i++) {
+		Mtl &m = (*mtls)[i];
+		if (m.startTriangle >= 0) {
+			b.push_back(m.startTriangle);
+			b.push_back(m.startTriangle+m.nTriangles);
+		}
+	}
+	for (int &i : b)
+		i = i < 0? 0 : i > nTriangles? nTriangles : i;
+	std::sort(b.begin(), b.end());
+	b.erase(std::unique(b.begin(), b.end()), b.end());
+	return b;
+}
+
+struct FifoCache {
+	// simulated post-transform cache: a vertex is cached if among the last size vertices transformed
+	vector<int> stamp;
+	int size, count = 0;
+	FifoCache(int nPoints, int size) : stamp(nPoints, INT_MIN/2), size(size) { }
+	bool Miss(int v) {
+		if (count-stamp[v] < size)
+			return false;
+		stamp[v] = count++;
+		return true;
+	}
+	int Misses(const int3 &t) { return Miss(t.i1)+Miss(t.i2)+Miss(t.i3); }
+	void Flush() { count += size; }
+};
+
+void Tipsify(int3 *tris, int nTris, vector<int> &localId, int cacheSize) {
+	// Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+	// (2007): fan out from a vertex f, then continue from the vertex of the fan that will remain
+	// cached longest, else from a recently used vertex with triangles left (dead-end stack)
+	vector<int> verts;
+	vector<int3> local(nTris);
+	for (int t = 0; t < nTris; t++)
+		for (int k = 0; k < 3; k++) {
+			int &id = localId[tris[t][k]];
+			if (id < 0) {
+				id = (int) verts.size();
+				verts.push_back(tris[t][k]);
+			}
+			local[t][k] = id;
+		}
+	int nVerts = (int) verts.size();
+	vector<int> start(nVerts+1, 0), adj(3*nTris), live(nVerts, 0), cacheTime(nVerts, 0), deadEnd, fan, order;
+	vector<char> emitted(nTris, 0);
+	for (int t = 0; t < nTris; t++)
+		for (int k = 0; k < 3; k++)
+			start[local[t][k]+1]++;
+	for (int v = 0; v < nVerts; v++) {
+		live[v] = start[v+1];
+		start[v+1] += start[v];
+	}
+	vector<int> fill(start.begin(), start.end()-1);
+	for (int t = 0; t < nTris; t++)
+		for (int k = 0; k < 3; k++)
+			adj[fill[local[t][k]]++] = t;
+	order.reserve(nTris);
+	int f = 0, cursor = 1, stamp = cacheSize+1;
+	while (f >= 0) {
+		fan.resize(0);
+		for (int i = start[f]; i < start[f+1]; i++) {
+			int t = adj[i];
+			if (emitted[t])
+				continue;
+			emitted[t] = 1;
+			order.push_back(t);
+			for (int k = 0; k < 3; k++) {
+				int v = local[t][k];
+				fan.push_back(v);
+				deadEnd.push_back(v);
+				live[v]--;
+				if (stamp-cacheTime[v] > cacheSize)
+					cacheTime[v] = stamp++;
+			}
+		}
+		// next fanning vertex: of those with triangles left, prefer the one cached longest,
+		// provided its remaining triangles won't push it from the cache
+		int next = -1, best = -1;
+		for (int v : fan)
+			if (live[v] > 0) {
+				int age = stamp-cacheTime[v], priority = age+2*live[v] <= cacheSize? age : 0;
+				if (priority > best) {
+					best = priority;
+					next = v;
+				}
+			}
+		while (next < 0 && !deadEnd.empty()) {
+			int v = deadEnd.back();
+			deadEnd.pop_back();
+			if (live[v] > 0)
+				next = v;
+		}
+		for (; next < 0 && cursor < nVerts; cursor++)
+			if (live[cursor] > 0)
+				next = cursor;
+		f = next;
+	}
+	for (int t = 0; t < nTris; t++)
+		local[t] = tris[order[t]];
+	std::copy(local.begin(), local.end(), tris);
+	for (int v : verts)
+		localId[v] = -1;
+}
+
+void SortClusters(int3 *tris, int nTris, vector<vec3> &points, int cacheSize, float threshold) {
+	// split triangles into clusters where the cache is flushed (a triangle with three misses), and
+	// again where the cluster's miss ratio so far is within threshold of the entire cluster's;
+	// then order clusters outward facing first (approximate view-independent overdraw reduction)
+	FifoCache cache((int) points.size(), cacheSize);
+	vector<int> hard, clusters;
+	for (int t = 0; t < nTris; t++)
+		if (cache.Misses(tris[t]) == 3 || t == 0)
+			hard.push_back(t);
+	hard.push_back(nTris);
+	for (size_t h = 0; h+1 < hard.size(); h++) {
+		// each cluster is measured from a cold cache, as it may be drawn after any other
+		int a = hard[h], b = hard[h+1], total = 0;
+		cache.Flush();
+		for (int t = a; t < b; t++)
+			total += cache.Misses(tris[t]);
+		float acmr = (float) total/(b-a);
+		clusters.push_back(a);
+		cache.Flush();
+		for (int t = a, start = a, sum = 0; t < b-1; t++) {
+			sum += cache.Misses(tris[t]);
+			if ((float) sum/(t+1-start) <= threshold*acmr) {
+				clusters.push_back(t+1);
+				start = t+1;
+				sum = 0;
+				cache.Flush();
+			}
+		}
+	}
+	clusters.push_back(nTris);
+	int nClusters = (int) clusters.size()-1;
+	vector<vec3> centers(nClusters, vec3(0, 0, 0)), normals(nClusters, vec3(0, 0, 0));
+	vec3 center(0, 0, 0);
+	float totalArea = 0;
+	for (int c = 0; c < nClusters; c++) {
+		float area = 0;
+		for (int t = clusters[c]; t < clusters[c+1]; t++) {
+			vec3 &p1 = points[tris[t].i1], &p2 = points[tris[t].i2], &p3 = points[tris[t].i3], n = cross(p2-p1, p3-p1);
+			float a = length(n);
+			centers[c] += (a/3)*(p1+p2+p3);
+			normals[c] += n;
+			area += a;
+		}
+		center += centers[c];
+		totalArea += area;
+		centers[c] = area > 0? centers[c]/area : vec3(0, 0, 0);
+	}
+	center = totalArea > 0? center/totalArea : vec3(0, 0, 0);
+	vector<float> key(nClusters);
+	vector<int> sorted(nClusters);
+	for (int c = 0; c < nClusters; c++) {
+		float len = length(normals[c]);
+		key[c] = len > 0? dot(centers[c]-center, normals[c]/len) : 0;
+		sorted[c] = c;
+	}
+	std::stable_sort(sorted.begin(), sorted.end(), [&](int a, int b) { return key[a] > key[b]; });
+	vector<int3> result;
+	result.reserve(nTris);
+	for (int c : sorted)
+		result.insert(result.end(), tris+clusters[c], tris+clusters[c+1]);
+	std::copy(result.begin(), result.end(), tris);
+}
+
+void KeepFewerMisses(int3 *tris, const int3 *prior, int nTris, FifoCache &cache) {
+	// restore the prior order of tris if it has no more cache misses (each measured from a cold cache)
+	int before = 0, after = 0;
+	cache.Flush();
+	for (int t = 0; t < nTris; t++)
+		before += cache.Misses(prior[t]);
+	cache.Flush();
+	for (int t = 0; t < nTris; t++)
+		after += cache.Misses(tris[t]);
+	if (before <= after)
+		std::copy(prior, prior+nTris, tris);
+}
+
+} // end namespace
+
+float ACMR(vector<int3> &triangles, int nPoints, int cacheSize) {
+	FifoCache cache(nPoints, cacheSize);
+	int misses = 0;
+	for (int3 &t : triangles)
+		misses += cache.Misses(t);
+	return triangles.size()? (float) misses/triangles.size() : 0;
+}
+
+float ATVR(vector<int3> &triangles, int nPoints, int cacheSize) {
+	vector<char> used(nPoints, 0);
+	int nUsed = 0;
+	for (int3 &t : triangles)
+		for (int k = 0; k < 3; k++)
+			if (!used[t[k]]) {
+				used[t[k]] = 1;
+				nUsed++;
+			}
+	return nUsed? ACMR(triangles, nPoints, cacheSize)*triangles.size()/nUsed : 0;
+}
+
+void OptimizeVertexCache(vector<int3> &triangles, int nPoints, vector<Group> *groups, vector<Mtl> *mtls, int cacheSize) {
+	// a segment keeps its prior order if that has no more cache misses
+	vector<int> segments = Segments((int) triangles.size(), groups, mtls), localId(nPoints, -1);
+	FifoCache cache(nPoints, cacheSize);
+	for (size_t i = 0; i+1 < segments.size(); i++) {
+		int3 *tris = triangles.data()+segments[i];
+		int nTris = segments[i+1]-segments[i];
+		vector<int3> prior(tris, tris+nTris);
+		Tipsify(tris, nTris, localId, cacheSize);
+		KeepFewerMisses(tris, prior.data(), nTris, cache);
+	}
+}
+
+void OptimizeOverdraw(vector<int3> &triangles, vector<vec3> &points, vector<Group> *groups, vector<Mtl> *mtls, int cacheSize, float threshold) {
+	vector<int> segments = Segments((int) triangles.size(), groups, mtls);
+	for (size_t i = 0; i+1 < segments.size(); i++)
+		SortClusters(triangles.data()+segments[i], segments[i+1]-segments[i], points, cacheSize, threshold);
+}
+
+void OptimizeVertexFetch(vector<vec3> &points, vector<int3> &triangles, vector<vec3> *normals, vector<vec2> *uvs, vector<int4> *quads) {
+	// number vertices by first use in triangles, then quads; unused vertices follow, in prior order
+	int nPoints = (int) points.size(), nNew = 0;
+	vector<int> remap(nPoints, -1);
+	for (int3 &t : triangles)
+		for (int k = 0; k < 3; k++)
+			if (remap[t[k]] < 0)
+				remap[t[k]] = nNew++;
+	for (int i = 0; quads && i < (int) quads->size(); i++)
+		for (int k = 0; k < 4; k++) {
+			int &v = (*quads)[i][k];
+			if (remap[v] < 0)
+				remap[v] = nNew++;
+		}
+	for (int v = 0; v < nPoints; v++)
+		if (remap[v] < 0)
+			remap[v] = nNew++;
+	for (int3 &t : triangles)
+		t = int3(remap[t.i1], remap[t.i2], remap[t.i3]);
+	for (int i = 0; quads && i < (int) quads->size(); i++)
+		for (int k = 0; k < 4; k++)
+			(*quads)[i][k] = remap[(*quads)[i][k]];
+	vector<vec3> v3(nPoints);
+	for (int v = 0; v < nPoints; v++)
+		v3[remap[v]] = points[v];
+	points.swap(v3);
+	if (normals && (int) normals->size() == nPoints) {
+		for (int v = 0; v < nPoints; v++)
+			v3[remap[v]] = (*normals)[v];
+		normals->swap(v3);
+	}
+	if (uvs && (int) uvs->size() == nPoints) {
+		vector<vec2> v2(nPoints);
+		for (int v = 0; v < nPoints; v++)
+			v2[remap[v]] = (*uvs)[v];
+		uvs->swap(v2);
+	}
+}
+
+void OptimizeMesh(vector<vec3> &points, vector<int3> &triangles, vector<vec3> *normals, vector<vec2> *uvs, vector<int4> *quads,
+				  vector<Group> *groups, vector<Mtl> *mtls, bool overdraw, int cacheSize) {
+	// a segment keeps its input order unless reordering lowers its cache misses
+	int nPoints = (int) points.size();
+	vector<int3> input(triangles);
+	OptimizeVertexCache(triangles, nPoints, groups, mtls, cacheSize);
+	if (overdraw) {
+		OptimizeOverdraw(triangles, points, groups, mtls, cacheSize);
+		vector<int> segments = Segments((int) triangles.size(), groups, mtls);
+		FifoCache cache(nPoints, cacheSize);
+		for (size_t i = 0; i+1 < segments.size(); i++)
+			KeepFewerMisses(triangles.data()+segments[i], input.data()+segments[i], segments[i+1]-segments[i], cache);
+	}
+	OptimizeVertexFetch(points, triangles, normals, uvs, quads);
+}
+
+// simplification
+
+namespace {
+
+struct Quadric {
+	// sum of squared distances to planes, weighted by triangle area
+	double a[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};	// xx xy xz xw yy yz yw zz zw ww
+	double weight = 0;								// sum of areas
+	void AddPlane(const vec3 &n, double d, double area) {
+		double p[] = {n.x, n.y, n.z, d};
+		for (int i = 0, k = 0; i < 4; i++)
+			for (int j = i; j < 4; j++)
+				a[k++] += area*p[i]*p[j];
+		weight += area;
+	}
+	void operator += (const Quadric &q) {
+		for (int k = 0; k < 10; k++)
+			a[k] += q.a[k];
+		weight += q.weight;
+	}
+	double Error(const vec3 &p) const {
+		double x = p.x, y = p.y, z = p.z;
+		return a[0]*x*x+2*a[1]*x*y+2*a[2]*x*z+2*a[3]*x+a[4]*y*y+2*a[5]*y*z+2*a[6]*y+a[7]*z*z+2*a[8]*z+a[9];
+	}
+};
+
+struct Collapse {
+	int from, to;
+	float cost;
+};
+
+void Ring(VertexAdjacency &adj, vector<int3> &triangles, int v, vector<int> &ring) {
+	// sorted neighbors of v
+	ring.resize(0);
+	for (int i = adj.start[v]; i < adj.start[v+1]; i++) {
+		int c = adj.corners[i];
+		int3 &t = triangles[c/3];
+		ring.push_back(t[(c+1)%3]);
+		ring.push_back(t[(c+2)%3]);
+	}
+	std::sort(ring.begin(), ring.end());
+	ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+}
+
+bool CollapseValid(vector<vec3> &points, vector<int3> &triangles, VertexAdjacency &adj, int from, int to, vector<int> &r1, vector<int> &r2) {
+	// link condition: from and to share only the neighbors opposite their common edge; and no
+	// triangle about from may flip when from moves to to
+	int nShared = 0, nCommon = 0;
+	Ring(adj, triangles, from, r1);
+	Ring(adj, triangles, to, r2);
+	for (size_t i = 0, j = 0; i < r1.size() && j < r2.size(); ) {
+		if (r1[i] == r2[j]) {
+			nCommon++;
+			i++;
+			j++;
+		}
+		else if (r1[i] < r2[j]) i++; else j++;
+	}
+	vec3 &p = points[to];
+	for (int i = adj.start[from]; i < adj.start[from+1]; i++) {
+		int c = adj.corners[i];
+		int3 &t = triangles[c/3];
+		int a = t[(c+1)%3], b = t[(c+2)%3];
+		if (a == to || b == to) {
+			nShared++;
+			continue;
+		}
+		vec3 &pa = points[a], &pb = points[b], n1 = cross(pa-points[from], pb-points[from]), n2 = cross(pa-p, pb-p);
+		if (dot(n1, n2) <= 0)
+			return false;
+	}
+	return nCommon == nShared;
+}
+
+} // end namespace
+
+int SimplifyMesh(vector<vec3> &points, vector<int3> &triangles, int targetTriangles, vector<Group> *groups, vector<Mtl> *mtls, float *error) {
+	// Garland and Heckbert quadric error edge collapse; each pass costs every edge in parallel, then
+	// collapses the cheapest, skipping any that touch the neighborhood of a prior collapse in the pass
+	int nPoints = (int) points.size(), nTriangles = (int) triangles.size();
+	vector<int> segments = Segments(nTriangles, groups, mtls), segment(nTriangles), original(nTriangles);
+	for (size_t i = 0; i+1 < segments.size(); i++)
+		for (int t = segments[i]; t < segments[i+1]; t++)
+			segment[t] = (int) i;
+	for (int t = 0; t < nTriangles; t++)
+		original[t] = t;
+	VertexAdjacency adj;
+	adj.Build(nPoints, triangles);
+	// lock vertices on a border (incl. uv or normal seams), non-manifold edge, or group/material boundary
+	vector<char> locked(nPoints, 0);
+	vector<Quadric> quadrics(nPoints);
+	ParallelFor(nPoints, [&](int p1, int p2) {
+		vector<int> ends;
+		for (int v = p1; v < p2; v++) {
+			ends.resize(0);
+			int seg = -1;
+			for (int i = adj.start[v]; i < adj.start[v+1]; i++) {
+				int c = adj.corners[i], t = c/3;
+				int3 &tri = triangles[t];
+				vec3 &a = points[tri.i1], &b = points[tri.i2], &d = points[tri.i3], n = cross(b-a, d-a);
+				float len = length(n);
+				if (len > 0)
+					quadrics[v].AddPlane(n/len, -dot(n/len, a), .5*len);
+				ends.push_back(tri[(c+1)%3]);
+				ends.push_back(tri[(c+2)%3]);
+				if (seg >= 0 && seg != segment[t])
+					locked[v] = 1;
+				seg = segment[t];
+			}
+			// in a closed manifold fan each neighbor ends exactly two triangle edges
+			std::sort(ends.begin(), ends.end());
+			for (size_t i = 0; i < ends.size() && !locked[v]; ) {
+				size_t j = i;
+				while (j < ends.size() && ends[j] == ends[i])
+					j++;
+				if (j-i != 2)
+					locked[v] = 1;
+				i = j;
+			}
+		}
+	}, 10000);
+	float maxError = 0;
+	vector<int> remap(nPoints), r1, r2;
+	vector<char> touched(nPoints);
+	vector<Collapse> candidates;
+	for (int v = 0; v < nPoints; v++)
+		remap[v] = v;
+	while (nTriangles > targetTriangles) {
+		// cost each edge once (from the triangle in which it runs low to high vertex index)
+		candidates.assign(3*nTriangles, {-1, -1, 0});
+		ParallelFor(nTriangles, [&](int t1, int t2) {
+			for (int t = t1; t < t2; t++)
+				for (int k = 0; k < 3; k++) {
+					int a = triangles[t][k], b = triangles[t][(k+1)%3];
+					if (a > b || (locked[a] && locked[b]))
+						continue;
+					Quadric q = quadrics[a];
+					q += quadrics[b];
+					double ea = locked[b]? DBL_MAX : q.Error(points[a]), eb = locked[a]? DBL_MAX : q.Error(points[b]);
+					candidates[3*t+k] = eb <= ea? Collapse{a, b, (float) eb} : Collapse{b, a, (float) ea};
+				}
+		}, 10000);
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const Collapse &c) { return c.from < 0; }), candidates.end());
+		std::sort(candidates.begin(), candidates.end(), [](const Collapse &a, const Collapse &b) {
+			return a.cost != b.cost? a.cost < b.cost : a.from != b.from? a.from < b.from : a.to < b.to;
+		});
+		// each interior collapse removes two triangles
+		int goal = (nTriangles-targetTriangles+1)/2, nCollapses = 0;
+		std::fill(touched.begin(), touched.end(), 0);
+		for (size_t i = 0; i < candidates.size() && nCollapses < goal; i++) {
+			Collapse &c = candidates[i];
+			if (touched[c.from] || touched[c.to] || !CollapseValid(points, triangles, adj, c.from, c.to, r1, r2))
+				continue;
+			for (int v : r1)
+				touched[v] = 1;
+			for (int v : r2)
+				touched[v] = 1;
+			touched[c.from] = touched[c.to] = 1;
+			remap[c.from] = c.to;
+			quadrics[c.to] += quadrics[c.from];
+			float e = quadrics[c.to].weight > 0? (float) sqrt(fmax(0., c.cost)/quadrics[c.to].weight) : 0;
+			maxError = e > maxError? e : maxError;
+			nCollapses++;
+		}
+		if (!nCollapses)
+			break;
+		// re-index, remove degenerate triangles (preserving order), and rebuild adjacency
+		int n = 0;
+		for (int t = 0; t < nTriangles; t++) {
+			int3 tri(remap[triangles[t].i1], remap[triangles[t].i2], remap[triangles[t].i3]);
+			if (tri.i1 != tri.i2 && tri.i2 != tri.i3 && tri.i3 != tri.i1) {
+				triangles[n] = tri;
+				original[n++] = original[t];
+			}
+		}
+		nTriangles = n;
+		triangles.resize(n);
+		adj.Build(nPoints, triangles);
+	}
+	// update group and material ranges
+	vector<int> kept(original.size()+1, 0);
+	original.resize(nTriangles);
+	for (int t : original)
+		kept[t+1] = 1;
+	for (size_t t = 1; t < kept.size(); t++)
+		kept[t] += kept[t-1];
+	for (int i = 0; groups && i < (int) groups->size(); i++) {
+		Group &g = (*groups)[i];
+		int start = kept[g.startTriangle];
+		g.nTriangles = kept[g.startTriangle+g.nTriangles]-start;
+		g.startTriangle = start;
+	}
+	for (int i = 0; mtls && i < (int) mtls->size(); i++) {
+		Mtl &m = (*mtls)[i];
+		if (m.startTriangle >= 0) {
+			int start = kept[m.startTriangle];
+			m.nTriangles = kept[m.startTriangle+m.nTriangles]-start;
+			m.startTriangle = start;
+		}
+	}
+	if (error)
+		*error = maxError;
+	return nTriangles;
+}
+
+// meshlets
+
+namespace {
+
+void SetMeshletBounds(vector<vec3> &points, int3 *tris, Meshlet &m) {
+	// sphere about bounding box center; cone about average normal, degenerate if wider than a hemisphere
+	vec3 min(FLT_MAX, FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX, -FLT_MAX), sum;
+	vector<vec3> normals(m.nTriangles);
+	for (int t = 0; t < m.nTriangles; t++) {
+		vec3 &a = points[tris[t].i1], &b = points[tris[t].i2], &c = points[tris[t].i3];
+		for (int k = 0; k < 3; k++) {
+			vec3 &p = points[tris[t][k]];
+			min = vec3(fmin(min.x, p.x), fmin(min.y, p.y), fmin(min.z, p.z));
+			max = vec3(fmax(max.x, p.x), fmax(max.y, p.y), fmax(max.z, p.z));
+		}
+		vec3 n = cross(b-a, c-a);
+		float len = length(n);
+		normals[t] = len > 0? n/len : vec3(0, 0, 0);
+		sum += n;
+	}
+	m.center = .5f*(min+max);
+	m.radius = 0;
+	for (int t = 0; t < m.nTriangles; t++)
+		for (int k = 0; k < 3; k++)
+			m.radius = fmax(m.radius, length(points[tris[t][k]]-m.center));
+	float len = length(sum), minDot = 1;
+	m.coneAxis = len > 0? sum/len : vec3(0, 0, 1);
+	for (int t = 0; t < m.nTriangles; t++)
+		minDot = fmin(minDot, dot(normals[t], m.coneAxis));
+	// cutoff is sine of the cone half-angle; 1 disables backface culling
+	m.coneCutoff = len > 0 && minDot > 0? sqrt(1-minDot*minDot) : 1;
+}
+
+} // end namespace
+
+int BuildMeshlets(vector<vec3> &points, vector<int3> &triangles, vector<Meshlet> &meshlets,
+				  vector<Group> *groups, vector<Mtl> *mtls, int maxVertices, int maxTriangles) {
+	// grow each meshlet from a seed, adding the adjacent triangle needing fewest new vertices (ties
+	// to the nearer triangle); if none adjacent, continue with the next unused triangle in order
+	int nPoints = (int) points.size(), nTriangles = (int) triangles.size();
+	vector<int> segments = Segments(nTriangles, groups, mtls), inMeshlet(nPoints, -1), frontier;
+	vector<char> used(nTriangles, 0);
+	vector<int3> order;
+	VertexAdjacency adj;
+	adj.Build(nPoints, triangles);
+	order.reserve(nTriangles);
+	meshlets.resize(0);
+	for (size_t s = 0; s+1 < segments.size(); s++) {
+		int segStart = segments[s], segEnd = segments[s+1], next = segStart;
+		while (true) {
+			while (next < segEnd && used[next])
+				next++;
+			if (next == segEnd)
+				break;
+			Meshlet m;
+			m.startTriangle = (int) order.size();
+			int id = (int) meshlets.size(), t = next;
+			vec3 centroid, sum;
+			frontier.resize(0);
+			while (t >= 0) {
+				// add t, its new vertices, and its unused neighbors to the frontier
+				used[t] = 1;
+				order.push_back(triangles[t]);
+				m.nTriangles++;
+				for (int k = 0; k < 3; k++) {
+					int v = triangles[t][k];
+					sum += points[v];
+					if (inMeshlet[v] == id)
+						continue;
+					inMeshlet[v] = id;
+					m.nVertices++;
+					for (int i = adj.start[v]; i < adj.start[v+1]; i++) {
+						int n = adj.corners[i]/3;
+						if (!used[n] && n >= segStart && n < segEnd)
+							frontier.push_back(n);
+					}
+				}
+				centroid = sum/(3.f*m.nTriangles);
+				if (m.nTriangles == maxTriangles)
+					break;
+				// choose next triangle
+				int best = -1, bestNew = 4;
+				float bestDist = FLT_MAX;
+				for (size_t i = 0; i < frontier.size(); ) {
+					int f = frontier[i];
+					if (used[f]) {
+						frontier[i] = frontier.back();
+						frontier.pop_back();
+						continue;
+					}
+					int3 &tri = triangles[f];
+					int nNew = (inMeshlet[tri.i1] != id)+(inMeshlet[tri.i2] != id)+(inMeshlet[tri.i3] != id);
+					float d = length((points[tri.i1]+points[tri.i2]+points[tri.i3])/3.f-centroid);
+					if (m.nVertices+nNew <= maxVertices && (nNew < bestNew || (nNew == bestNew && (d < bestDist || (d == bestDist && f < best))))) {
+						best = f;
+						bestNew = nNew;
+						bestDist = d;
+					}
+					i++;
+				}
+				if (best < 0 && frontier.empty()) {
+					while (next < segEnd && used[next])
+						next++;
+					if (next < segEnd && m.nVertices+3 <= maxVertices)
+						best = next;
+				}
+				t = best;
+			}
+			SetMeshletBounds(points, &order[m.startTriangle], m);
+			meshlets.push_back(m);
+		}
+	}
+	// meshlets permute triangles within segments, so group and material ranges are unchanged;
+	// anything indexed by triangle (picking, VertexAdjacency) must be rebuilt
+	triangles = order;
+	return (int) meshlets.size();
+}
+
+int CullMeshlets(vector<Meshlet> &meshlets, mat4 modelview, mat4 persp, vector<GLsizei> &counts, vector<size_t> &offsets,
+				 bool backface, int eOffset) {
+	// frustum planes in eye space (camera at origin)
+	Frustum frustum(persp);
+	float scale = length(vec3(modelview[0][0], modelview[1][0], modelview[2][0]));
+	int nVisible = 0;
+	counts.resize(0);
+	offsets.resize(0);
+	for (Meshlet &m : meshlets) {
+		vec4 c = modelview*vec4(m.center, 1);
+		float r = scale*m.radius;
+		bool culled = false;
+		for (int i = 0; i < 6 && !culled; i++)
+			culled = dot(frustum.planes[i], c) < -r;
+		if (!culled && backface && m.coneCutoff < 1) {
+			// all triangles face away if the view direction is within the cone's complement
+			vec3 center(c.x, c.y, c.z), axis = normalize(vec3(modelview*vec4(m.coneAxis, 0)));
+			culled = dot(center, axis) >= m.coneCutoff*length(center)+r;
+		}
+		if (culled)
+			continue;
+		nVisible++;
+		size_t offset = (eOffset+m.startTriangle)*sizeof(int3);
+		if (counts.size() && offsets.back()+counts.back()*sizeof(int) == offset)
+			counts.back() += 3*m.nTriangles;
+		else {
+			counts.push_back(3*m.nTriangles);
+			offsets.push_back(offset);
+		}
+	}
+	return nVisible;
+}
+
+// ASCII support
+
+bool ReadWord(char* &ptr, char *word, int charLimit) {
+	ptr += strspn(ptr, " \t");                  // skip white space
+	int nChars = strcspn(ptr, " \t");           // get # non-white-space characters
+	if (!nChars)
+		return false;                           // no non-space characters
+	int nRead = charLimit-1 < nChars? charLimit-1 : nChars;
+	strncpy(word, ptr, nRead);
+	word[nRead] = 0;                            // strncpy does not null terminate
+	ptr += nChars;
+	return true;
+}
+
+namespace {
+
+inline bool IsBlank(char c) { return c == ' ' || c == '\t'; }
+
+inline bool IsWhite(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; }
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+const char *SkipBlanks(const char *p, const char *end) {
+	while (p < end && IsBlank(*p))
+		p++;
+	return p;
+}
+
+const char *WordEnd(const char *p, const char *end) {
+	while (p < end && !IsBlank(*p))
+		p++;
+	return p;
+}
+
+bool SameWord(const char *p, const char *end, const char *word) {
+	// case-insensitive compare of [p, end) with lower-case word
+	for (; p < end && *word; p++, word++)
+		if (tolower(*p) != *word)
+			return false;
+	return p == end && !*word;
+}
+
+int AtoI(const char *p, const char *end) {
+	// as atoi, but bounded by end
+	bool neg = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		neg = *p++ == '-';
+	int i = 0;
+	for (; p < end && IsDigit(*p); p++)
+		i = 10*i+(*p-'0');
+	return neg? -i : i;
+}
+
+bool ParseFloat(const char *&p, const char *end, float &f) {
+	// as sscanf %g: skip white space, read float, advance p; return false if no float
+	// decimal input with <= 24 bits of mantissa and |exponent| <= 10 is computed exactly,
+	// otherwise fall back to strtof, so results match sscanf bit for bit
+	static const float pow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+	while (p < end && IsWhite(*p))
+		p++;
+	const char *start = p, *q = p;
+	bool neg = false;
+	if (q < end && (*q == '-' || *q == '+'))
+		neg = *q++ == '-';
+	unsigned long long mantissa = 0;
+	int nDigits = 0, nSignificant = 0, exponent = 0;
+	for (; q < end && IsDigit(*q); q++, nDigits++)
+		if (nSignificant < 19) {
+			mantissa = 10*mantissa+(*q-'0');
+			if (mantissa) nSignificant++;
+		}
+		else
+			exponent++;
+	if (q < end && *q == '.')
+		for (q++; q < end && IsDigit(*q); q++, nDigits++)
+			if (nSignificant < 19) {
+				mantissa = 10*mantissa+(*q-'0');
+				if (mantissa) nSignificant++;
+				exponent--;
+			}
+	bool fallback = nDigits == 0 || (q < end && (*q == 'x' || *q == 'X'));
+		// no digits (perhaps inf or nan) or hexadecimal
+	if (!fallback && q < end && (*q == 'e' || *q == 'E')) {
+		const char *e = q+1;
+		bool eNeg = false;
+		if (e < end && (*e == '-' || *e == '+'))
+			eNeg = *e++ == '-';
+		if (e < end && IsDigit(*e)) {
+			int x = 0;
+			for (; e < end && IsDigit(*e); e++)
+				if (x < 100000) x = 10*x+(*e-'0');
+			exponent += eNeg? -x : x;
+			q = e;
+		}
+	}
+	if (!fallback && mantissa <= (1ull << 24) && exponent >= -10 && exponent <= 10) {
+		float m = (float) mantissa;
+		f = exponent < 0? m/pow10[-exponent] : m*pow10[exponent];
+		if (neg) f = -f;
+		p = q;
+		return true;
+	}
+	// slow path: copy token, terminate, and convert
+	char buf[100], *bufEnd = NULL;
+	int n = 0;
+	for (const char *c = start; c < end && !IsWhite(*c) && n < 99; c++)
+		buf[n++] = *c;
+	buf[n] = 0;
+	f = strtof(buf, &bufEnd);
+	if (bufEnd == buf)
+		return false;
+	p = start+(bufEnd-buf);
+	return true;
+}
+
+} // end namespace
+
+// STL
+
+char *Lower(char *word) {
+	for (char *c = word; *c; c++)
+		*c = tolower(*c);
+	return word;
+}
+
+namespace {
+
+bool IsBinarySTL(const char *data, size_t size) {
+	// binary: 80 byte header, 4 byte triangle count, 50 bytes per triangle
+	// ASCII files begin with "solid", but so do some binary headers, so first test size
+	if (size < 84)
+		return false;
+	unsigned int nTriangles;
+	memcpy(&nTriangles, data+80, sizeof(int));
+	if (size == 84+50*(size_t) nTriangles)
+		return true;
+	const char *p = data;
+	while (p < data+size && IsWhite(*p))
+		p++;
+	return !(p+5 <= data+size && SameWord(p, p+5, "solid"));
+}
+
+int ReadBinarySTL(const char *data, size_t size, vector<VertexSTL> &vertices) {
+		// # bytes      use                  significance
+		// -------      ---                  ------------
+		//      80      header               none
+		//       4      unsigned long int    number of triangles
+		//      12      3 floats             triangle normal
+		//      12      3 floats             x,y,z for vertex 1
+		//      12      3 floats             vertex 2
+		//      12      3 floats             vertex 3
+		//       2      unsigned short int   attribute (0)
+		// endianness is assumed to be little endian
+	unsigned int nTriangles;
+	memcpy(&nTriangles, data+80, sizeof(int));
+	size_t nInFile = (size-84)/50;
+	if (nInFile < nTriangles) {
+		printf("STL file has %i of %u triangles\n", (int) nInFile, nTriangles);
+		nTriangles = (unsigned int) nInFile;
+	}
+	const char *body = data+84;
+	vertices.resize(3*(size_t) nTriangles);
+	VertexSTL *v = vertices.data();
+	ParallelFor((int) nTriangles, [body, v](int t1, int t2) {
+		for (int t = t1; t < t2; t++) {
+			float f[12];								// normal, vertex 1, vertex 2, vertex 3
+			memcpy(f, body+50*(size_t) t, sizeof(f));	// records are not 4-byte aligned
+			for (int k = 0; k < 3; k++)
+				v[3*t+k] = VertexSTL(f+3*(k+1), f);
+		}
+	}, 100000);
+	return (int) nTriangles;
+}
+
+int ReadAsciiSTL(const char *data, size_t size, vector<VertexSTL> &vertices) {
+	//  solid name
+	//    facet normal nx ny nz
+	//      outer loop
+	//        vertex x y z
+	//        vertex x y z
+	//        vertex x y z
+	//      endloop
+	//    endfacet
+	//  endsolid name
+	const char *p = data, *end = data+size;
+	vec3 n, v[3];
+	int nVertices = 0, nTriangles = 0;
+	vertices.reserve(3*(size/250+1));					// about 250 bytes per facet
+	while (p < end) {
+		while (p < end && IsWhite(*p))
+			p++;
+		const char *w = p;
+		while (w < end && !IsWhite(*w))
+			w++;
+		if (p == w)
+			break;
+		bool ok = true;
+		if (SameWord(p, w, "solid") || SameWord(p, w, "endsolid")) {
+			// skip name
+			while (w < end && *w != '\n')
+				w++;
+		}
+		else if (SameWord(p, w, "facet")) {
+			const char *n1 = w;
+			while (n1 < end && IsWhite(*n1))
+				n1++;
+			for (w = n1; w < end && !IsWhite(*w); )
+				w++;
+			ok = SameWord(n1, w, "normal") && ParseFloat(w, end, n.x) && ParseFloat(w, end, n.y) && ParseFloat(w, end, n.z);
+			nVertices = 0;
+		}
+		else if (SameWord(p, w, "vertex")) {
+			vec3 &a = v[nVertices < 3? nVertices : 2];
+			ok = ParseFloat(w, end, a.x) && ParseFloat(w, end, a.y) && ParseFloat(w, end, a.z);
+			nVertices++;
+		}
+		else if (SameWord(p, w, "endfacet")) {
+			if (nVertices == 3) {
+				for (int k = 0; k < 3; k++)
+					vertices.push_back(VertexSTL(&v[k].x, &n.x));
+				nTriangles++;
+			}
+			else
+				printf("facet with %i vertices ignored\n", nVertices);
+		}
+		if (!ok) {
+			printf("bad ASCII STL near byte %i\n", (int) (p-data));
+			return -1;
+		}
+		p = w;
+	}
+	return nTriangles;
+}
+
+void OrientSTL(vector<VertexSTL> &vertices) {
+	// the facet normal should point outwards from the solid object; reverse any triangle whose
+	// vertex order (right-hand rule) disagrees; a scalar pass, split across threads: the swap is a
+	// select rather than a branch, but points and normals are interleaved, so it is not vectorized
+	VertexSTL *v = vertices.data();
+	ParallelFor((int) (vertices.size()/3), [v](int t1, int t2) {
+		for (int t = t1; t < t2; t++) {
+			VertexSTL *tv = v+3*t;
+			vec3 p0 = tv[0].point, p2 = tv[2].point;
+			vec3 n = cross(tv[1].point-p0, p2-tv[1].point);
+			bool flip = dot(n, tv[0].normal) < 0;
+			tv[0].point = flip? p2 : p0;
+			tv[2].point = flip? p0 : p2;
+		}
+	}, 100000);
+}
+
+int GridCell(float f) {
+	// floor, clamped in float so that a cell and its neighbors are representable as int
+	const float limit = (float) (1 << 30);
+	return (int) floor(f < -limit? -limit : f > limit? limit : f);
+}
+
+int FloatBits(float f) {
+	int i;
+	f += 0.f;											// -0 becomes +0
+	memcpy(&i, &f, sizeof(int));
+	return i;
+}
+
+} // end namespace
+
+int ReadSTL(const char *filename, vector<VertexSTL> &vertices) {
+	// the file is memory-mapped and decoded in place; binary or ASCII format
+	vertices.resize(0);
+	size_t size = 0;
+	char *data = MapFile(filename, size);
+	if (!data)
+		return 0;
+	int nTriangles = IsBinarySTL(data, size)? ReadBinarySTL(data, size, vertices) : ReadAsciiSTL(data, size, vertices);
+	UnmapFile(data, size);
+	if (nTriangles < 0) {
+		vertices.resize(0);
+		return 0;
+	}
+	OrientSTL(vertices);
+	return nTriangles;
+} // end ReadSTL
+
+int ReadSTL(const char *filename, vector<vec3> &points, vector<int3> &triangles, vector<vec3> *normals) {
+	// weld corners with identical positions
+	vector<VertexSTL> vertices;
+	ReadSTL(filename, vertices);
+	WeldSTL(vertices, points, triangles, 0, normals);
+	return (int) triangles.size();
+}
+
+void WeldSTL(vector<VertexSTL> &vertices, vector<vec3> &points, vector<int3> &triangles, float epsilon, vector<vec3> *normals, float creaseAngle) {
+	// corners are bucketed in a hash of grid cells 2*epsilon wide (or of exact position if epsilon
+	// is zero); each corner then searches the 2x2x2 cells nearest it for the earliest corner
+	// within epsilon; cell tables are built and searched in parallel, one table per hash partition
+	// (cells beyond 2^30 from the origin are clamped: distant corners share cells, but still weld
+	// only if within epsilon)
+	int nCorners = 3*(int) (vertices.size()/3), nParts = NumThreads();
+	const VertexSTL *v = vertices.data();
+	float scale = epsilon > 0? .5f/epsilon : 0, eps2 = epsilon*epsilon;
+	vector<int3> cells(nCorners);
+	vector<int> parts(nCorners);
+	ParallelFor(nCorners, [&](int c1, int c2) {
+		for (int c = c1; c < c2; c++) {
+			const vec3 &p = v[c].point;
+			cells[c] = epsilon > 0?
+				int3(GridCell(scale*p.x), GridCell(scale*p.y), GridCell(scale*p.z)) :
+				int3(FloatBits(p.x), FloatBits(p.y), FloatBits(p.z));
+			parts[c] = (int) (VidMap::Hash(cells[c])%nParts);
+		}
+	}, 100000);
+	// bucket corners by partition, in increasing corner order
+	vector<int> partStart(nParts+1, 0), partCorners(nCorners);
+	for (int c = 0; c < nCorners; c++)
+		partStart[parts[c]+1]++;
+	for (int part = 0; part < nParts; part++)
+		partStart[part+1] += partStart[part];
+	vector<int> partFill(partStart.begin(), partStart.end()-1);
+	for (int c = 0; c < nCorners; c++)
+		partCorners[partFill[parts[c]]++] = c;
+	// each partition (thread) adds the cells of its corners; local cell ids later offset
+	vector<VidMap> maps(nParts);
+	vector<int> cellIds(nCorners), partCells(nParts+1, 0);
+	ParallelFor(nParts, [&](int part1, int part2) {
+		for (int part = part1; part < part2; part++) {
+			VidMap &map = maps[part];
+			map.Reserve((partStart[part+1]-partStart[part])/6);
+			for (int i = partStart[part]; i < partStart[part+1]; i++) {
+				int c = partCorners[i], id = map.Size(), found = map.FindOrAdd(cells[c], id);
+				cellIds[c] = found < 0? id : found;
+			}
+			partCells[part+1] = map.Size();
+		}
+	});
+	for (int part = 0; part < nParts; part++)
+		partCells[part+1] += partCells[part];
+	// compressed cell lists, each in increasing corner order
+	int nCells = partCells[nParts];
+	vector<int> cellStart(nCells+1, 0), cellCorners(nCorners);
+	for (int c = 0; c < nCorners; c++) {
+		cellIds[c] += partCells[parts[c]];
+		cellStart[cellIds[c]+1]++;
+	}
+	for (int i = 0; i < nCells; i++)
+		cellStart[i+1] += cellStart[i];
+	vector<int> fill(cellStart.begin(), cellStart.end()-1);
+	for (int c = 0; c < nCorners; c++)
+		cellCorners[fill[cellIds[c]]++] = c;
+	// representative: least-index corner within epsilon (the cell's first corner if exact)
+	vector<int> rep(nCorners);
+	ParallelFor(nCorners, [&](int c1, int c2) {
+		for (int c = c1; c < c2; c++) {
+			int r = c;
+			if (epsilon <= 0)
+				r = cellCorners[cellStart[cellIds[c]]];
+			else
+				for (int i = 0; i < 8; i++) {
+					// step toward nearer cell face: a corner within epsilon is no further
+					const vec3 &p = v[c].point;
+					int3 k = cells[c];
+					int id = cellIds[c];
+					if (i&1) k.i1 += scale*p.x-k.i1 < .5f? -1 : 1;
+					if (i&2) k.i2 += scale*p.y-k.i2 < .5f? -1 : 1;
+					if (i&4) k.i3 += scale*p.z-k.i3 < .5f? -1 : 1;
+					if (i) {
+						int part = (int) (VidMap::Hash(k)%nParts);
+						if ((id = maps[part].Find(k)) < 0)
+							continue;
+						id += partCells[part];
+					}
+					for (int j = cellStart[id]; j < cellStart[id+1] && cellCorners[j] < r; j++) {
+						vec3 d = v[cellCorners[j]].point-v[c].point;
+						if (dot(d, d) <= eps2) {
+							r = cellCorners[j];
+							break;
+						}
+					}
+				}
+			rep[c] = r;
+		}
+	}, 100000);
+	// resolve chains (rep[c] <= c) and number unique points in order of first use
+	points.resize(0);
+	points.reserve(nCells);
+	for (int c = 0; c < nCorners; c++) {
+		int r = rep[c];
+		if (r == c) {
+			rep[c] = (int) points.size();
+			points.push_back(v[c].point);
+		}
+		else
+			rep[c] = rep[r];
+	}
+	// triangles, dropping any whose corners welded together
+	triangles.resize(0);
+	triangles.reserve(nCorners/3);
+	for (int c = 0; c < nCorners; c += 3) {
+		int i1 = rep[c], i2 = rep[c+1], i3 = rep[c+2];
+		if (i1 != i2 && i2 != i3 && i3 != i1)
+			triangles.push_back(int3(i1, i2, i3));
+	}
+	if (normals)
+		SetCreaseNormals(points, triangles, *normals, creaseAngle);
+}
+
+// ASCII OBJ
+
+#include <map>
+
+static const int LineLim = 10000, WordLim = 1000;
+
+struct CompareS {
+	bool operator() (const string &a, const string &b) const { return (a < b); }
+};
+
+typedef std::map<string, Mtl, CompareS> MtlMap;
+	// string is key, Mtl is value
+
+MtlMap ReadMaterial(const char *filename) {
+	MtlMap mtlMap;
+	char line[LineLim], word[WordLim];
+	Mtl m;
+	FILE *in = fopen(filename, "r");
+	string key;
+	Mtl value;
+	if (in)
+		for (int lineNum = 0;; lineNum++) {
+			line[0] = 0;
+			fgets(line, LineLim, in);                   // \ line continuation not supported
+			if (feof(in))                               // hit end of file
+				break;
+			if (strlen(line) >= LineLim-1) {            // getline reads LineLim-1 max
+				printf("line %d too long\n", lineNum);
+				continue;
+			}
+			line[strlen(line)-1] = 0;							// remove carriage-return
+			char *ptr = line;
+			if (!ReadWord(ptr, word, WordLim) || *word == '#')
+				continue;
+			Lower(word);
+			if (!strcmp(word, "newmtl") && ReadWord(ptr, word, WordLim)) {
+				key = string(word);
+				value.name = string(word);
+			}
+			if (!strcmp(word, "kd")) {
+				if (sscanf(ptr, "%g%g%g", &value.kd.x, &value.kd.y, &value.kd.z) != 3)
+					printf("bad line %d in material file", lineNum);
+				else
+					mtlMap[key] = value;
+			}
+		}
+//	else printf("can't open %s\n", filename);
+	return mtlMap;
+}
+
+bool ReadAsciiObj(const char      *filename,
+				  vector<vec3>    &points,
+				  vector<int3>    &triangles,
+				  vector<vec3>    *normals,
+				  vector<vec2>    *textures,
+				  vector<Group>   *triangleGroups,
+				  vector<Mtl>     *triangleMtls,
+				  vector<int4>    *quads,
+				  vector<int2>	  *segs) {
+	// read 'object' file (Alias/Wavefront .obj format); return true if successful;
+	// polygons are assumed simple (ie, no holes and not self-intersecting);
+	// some file attributes are not supported by this implementation;
+	// obj format indexes vertices from 1
+	FILE *in = fopen(filename, "r");
+	if (!in)
+		return false;
+	vec2 t;
+	vec3 v;
+	int group = 0;
+	char line[LineLim], word[WordLim];
+	bool hashedTriangles = false;	// true if any triangle vertex specified with different point/normal/texture id
+	bool hashedVertices = false;	// true if point/normal/texture arrays different (non-zero) size
+	vector<vec3> tmpVertices, tmpNormals;
+	vector<vec2> tmpTextures;
+	VidMap vidMap;
+	MtlMap mtlMap;
+	for (int lineNum = 0;; lineNum++) {
+		line[0] = 0;
+		fgets(line, LineLim, in);                           // \ line continuation not supported
+		if (feof(in))                                       // hit end of file
+			break;
+		if (strlen(line) >= LineLim-1) {                    // getline reads LineLim-1 max
+			printf("line %d too long\n", lineNum);
+			return false;
+		}
+		line[strlen(line)-1] = 0;							// remove carriage-return
+		char *ptr = line;
+		if (!ReadWord(ptr, word, WordLim))
+			continue;
+		Lower(word);
+		if (*word == '#') {
+			continue;
+		}
+		else if (!strcmp(word, "mtllib")) {
+			if (ReadWord(ptr, word, WordLim)) {
+				char name[100];
+				const char *p = strrchr(filename, '/'); //-filename, count = 0;
+				if (p) {
+					int nchars = p-filename;
+					strncpy(name, filename, nchars+1);
+					name[nchars+1] = 0;
+					strcat(name, word);
+				}
+				else
+					strcpy(name, word);
+				mtlMap = ReadMaterial(name);
+				if (false) {
+					int count = 0;
+					for (MtlMap::iterator iter = mtlMap.begin(); iter != mtlMap.end(); iter++) {
+						string s = (string) iter->first;
+						Mtl m = (Mtl) iter->second;
+						printf("m[%i].name=%s,.kd=(%3.2f,%3.2f,%3.2f),s=%s\n", count++, m.name.c_str(), m.kd.x, m.kd.y, m.kd.z, s.c_str());
+					}
+				}					
+			}
+		}
+		else if (!strcmp(word, "usemtl")) {
+			if (ReadWord(ptr, word, WordLim)) {
+				MtlMap::iterator it = mtlMap.find(string(word));
+				if (it == mtlMap.end())
+					printf(""); // "no such material: %s\n", word);
+				else {
+					Mtl m = it->second;
+					m.startTriangle = triangles.size();
+					if (triangleMtls)
+						triangleMtls->push_back(m);
+				}
+			}
+		}
+		else if (!strcmp(word, "g")) {
+			char *s = strchr(ptr, '(');
+			if (s) *s = 0;
+			if (triangleGroups) {
+			//	printf("adding to triangleGroups: name = %s\n", ptr);
+				triangleGroups->push_back(Group(triangles.size(), string(ptr)));
+			}
+		}
+		else if (!strcmp(word, "v")) {                      // read vertex coordinates
+			if (sscanf(ptr, "%g%g%g", &v.x, &v.y, &v.z) != 3) {
+				printf("bad line %d in object file", lineNum);
+				return false;
+			}
+			tmpVertices.push_back(vec3(v.x, v.y, v.z));
+		}
+		else if (!strcmp(word, "vn")) {                     // read vertex normal
+			if (sscanf(ptr, "%g%g%g", &v.x, &v.y, &v.z) != 3) {
+				printf("bad line %d in object file", lineNum);
+				return false;
+			}
+			tmpNormals.push_back(vec3(v.x, v.y, v.z));
+		}
+		else if (!strcmp(word, "vt")) {                     // read vertex texture
+			if (sscanf(ptr, "%g%g", &t.x, &t.y) != 2) {
+				printf("bad line in object file");
+				return false;
+			}
+			tmpTextures.push_back(vec2(t.x, t.y));
+		}
+		else if (!strcmp(word, "f")) {                      // read triangle or polygon
+			int nvids = tmpVertices.size(), ntids = tmpTextures.size(), nnids = tmpNormals.size();
+			if ((ntids && ntids != nvids) || (nnids && nnids != nvids))
+				hashedVertices = true;
+			static vector<int> vids;
+			vids.resize(0);
+			while (ReadWord(ptr, word, WordLim)) {          // read arbitrary # face vid/tid/nid
+				// set texture and normal pointers to preceding /
+				char *tPtr = strchr(word+1, '/');           // pointer to /, or null if not found
+				char *nPtr = tPtr? strchr(tPtr+1, '/') : NULL;
+				// use of / is optional (ie, '3' is same as '3/3/3')
+				// convert to vid, tid, nid indices (vertex, texture, normal)
+				int vid = atoi(word);
+				if (!vid)                                   // atoi returns 0 if failure to convert
+					break;
+				int tid = tPtr && *++tPtr != '/'? atoi(tPtr) : vid;
+				int nid = nPtr && *++nPtr != 0? atoi(nPtr) : vid;
+				// standard .obj is indexed from 1, mesh indexes from 0
+				vid--;
+				tid--;
+				nid--;
+				if (vid < 0 || tid < 0 || nid < 0) {        // atoi conversion failure
+					printf("bad format on line %d\n", lineNum);
+					break;
+				}
+				if ((tid >= 0 && tid != vid) || (nid >= 0 && nid != vid))
+					hashedTriangles = true;
+				bool hashed = hashedVertices || hashedTriangles;
+				if (!hashedVertices && !hashedTriangles) {
+					vids.push_back(vid);
+				}
+				if (hashedVertices || hashedTriangles) {
+					int3 key(vid, tid, nid);
+					int nvrts = points.size(), found = vidMap.FindOrAdd(key, nvrts);
+					// following can fail on early vertices
+					// to support OBJ must support triangle vid1/tid1/nid1, vid2/tid2/nid2, vid3/tid3/nid3
+					// which would mean changing current implementation
+					// instead, test for hashed vertices (ie, has vid ever not equaled tid or nid?)
+					// but we add specific test for simple impl
+					// need a straightforward implementation for when
+					// vid=tid=nid and/or there is no tid, no nid
+				//	printf("incoming vid = %i, ", vid);
+					if (found < 0) {
+						points.push_back(tmpVertices[vid]); // *** suspect
+						if (normals && (int) tmpNormals.size() > nid)
+							normals->push_back(tmpNormals[nid]);
+						if (textures && (int) tmpTextures.size() > tid)
+							textures->push_back(tmpTextures[tid]);
+						vids.push_back(nvrts);
+				//		printf("pushed %i\n", nvrts);
+					}
+					else {
+						vids.push_back(found);
+				//		printf("pushed second = %i\n", found);
+					}
+				}
+			}
+			int nids = vids.size();
+			if (nids == 3) {
+				int id1 = vids[0], id2 = vids[1], id3 = vids[2];
+				if (normals && (int) normals->size() > id1) {
+					vec3 p1, p2, p3;
+					if (hashedVertices || hashedTriangles) { p1 = points[id1]; p2 = points[id2]; p3 = points[id3]; }
+					else { p1 = tmpVertices[id1]; p2 = tmpVertices[id2]; p3 = tmpVertices[id3]; }
+				//	vec3 &p1 = points[id1], &p2 = points[id2], &p3 = points[id3];
+					vec3 a(p2-p1), b(p3-p2), n(cross(a, b));
+					if (dot(n, (*normals)[id1]) < 0) {
+						// reverse triangle order to correspond with vertex normal
+						int tmp = id1;
+						id1 = id3;
+						id3 = tmp;
+					}
+				}
+				// create triangle
+				triangles.push_back(int3(id1, id2, id3));
+			//	printf("triangle[%i] = (%i, %i, %i)\n", triangles.size()-1, id1+1, id2+1, id3+1);
+			}
+			else if (nids == 4 && quads)
+				quads->push_back(int4(vids[0], vids[1], vids[2], vids[3]));
+			else if (nids == 2 && segs)
+				segs->push_back(int2(vids[0], vids[1]));
+			else
+				// create polygon as nvids-2 triangles
+				for (int i = 1; i < nids-1; i++) {
+					triangles.push_back(int3(vids[0], vids[i], vids[(i+1)%nids]));
+				}
+		} // end "f"
+		else if (*word == 0 || *word == '\n')               // skip blank line
+			continue;
+		else {                                              // unrecognized attribute
+			// printf("unsupported attribute in object file: %s", word);
+			continue; // return false;
+		}
+	} // end read til end of file
+//	printf("hashedVertices = %s, hashedTriangles = %s\n", hashedVertices? "true" : "false", hashedTriangles? "true" : "false");
+	if (!hashedVertices && !hashedTriangles) {
+		int nPoints = tmpVertices.size();
+		points.resize(nPoints);
+		for (int i = 0; i < nPoints; i++)
+			points[i] = tmpVertices[i];
+		if (normals) {
+			int nNormals = tmpNormals.size();
+			normals->resize(nNormals);
+			for (int i = 0; i < nNormals; i++)
+				(*normals)[i] = tmpNormals[i];
+		}
+		if (textures) {
+			int nTextures = tmpTextures.size();
+			textures->resize(nTextures);
+			for (int i = 0; i < nTextures; i++)
+				(*textures)[i] = tmpTextures[i];
+		}
+	}
+	if (triangleGroups) {
+		int nGroups = triangleGroups->size();
+		for (int i = 0; i < nGroups; i++) {
+			int next = i < nGroups-1? (*triangleGroups)[i+1].startTriangle : triangles.size();
+			(*triangleGroups)[i].nTriangles = next-(*triangleGroups)[i].startTriangle;
+		}
+	}
+	if (triangleMtls) {
+		int nMtls = triangleMtls->size();
+		for (int i = 0; i < nMtls; i++) {
+			int next = i < nMtls-1? (*triangleMtls)[i+1].startTriangle : triangles.size();
+			(*triangleMtls)[i].nTriangles = next-(*triangleMtls)[i].startTriangle;
+		}
+	}
+	return true;
+} // end ReadAsciiObj
+
+// Parallel ASCII OBJ
+
+namespace {
+
+struct ObjFace {
+	int firstCorner = 0, nCorners = 0;			// into ObjChunk::corners
+	int nVertices = 0, nTextures = 0, nNormals = 0;	// # v, vt, vn preceding face within chunk
+	int lineNum = 0;							// within chunk
+};
+
+struct ObjStatement {
+	enum Type { Face, Group, UseMtl, MtlLib } type;
+	int id;										// index into ObjChunk::faces or ObjChunk::names
+	ObjStatement(Type t, int i) : type(t), id(i) { }
+};
+
+struct ObjChunk {
+	const char *begin = NULL, *end = NULL;
+	int nLines = 0, badLine = -1;				// line numbers are within chunk
+	vector<vec3> vertices, normals;
+	vector<vec2> textures;
+	vector<int3> corners;						// vid, tid, nid (indexed from 0)
+	vector<ObjFace> faces;
+	vector<string> names;						// group, material, and material library names
+	vector<ObjStatement> statements;			// in file order
+	vector<int> badFaceLines;
+};
+
+void ParseObjLine(ObjChunk &c, const char *line, const char *eol) {
+	const char *p = SkipBlanks(line, eol), *w = WordEnd(p, eol);
+	if (p == w || *p == '#')
+		return;
+	if (SameWord(p, w, "v") || SameWord(p, w, "vn")) {
+		vector<vec3> &v = w-p == 1? c.vertices : c.normals;
+		vec3 a;
+		if (!ParseFloat(w, eol, a.x) || !ParseFloat(w, eol, a.y) || !ParseFloat(w, eol, a.z))
+			c.badLine = c.nLines;
+		else
+			v.push_back(a);
+	}
+	else if (SameWord(p, w, "vt")) {
+		vec2 t;
+		if (!ParseFloat(w, eol, t.x) || !ParseFloat(w, eol, t.y))
+			c.badLine = c.nLines;
+		else
+			c.textures.push_back(t);
+	}
+	else if (SameWord(p, w, "f")) {
+		ObjFace f;
+		f.firstCorner = c.corners.size();
+		f.nVertices = c.vertices.size();
+		f.nTextures = c.textures.size();
+		f.nNormals = c.normals.size();
+		f.lineNum = c.nLines;
+		for (const char *a = SkipBlanks(w, eol); a < eol; a = SkipBlanks(w, eol)) {
+			w = WordEnd(a, eol);
+			// same conventions as ReadAsciiObj: '3' is same as '3/3/3'
+			int vid = AtoI(a, w);
+			if (!vid)
+				break;
+			const char *tPtr = a+1, *nPtr = NULL;
+			while (tPtr < w && *tPtr != '/')
+				tPtr++;
+			if (tPtr < w)
+				for (nPtr = tPtr+1; nPtr < w && *nPtr != '/'; )
+					nPtr++;
+			else
+				tPtr = NULL;
+			if (nPtr == w)
+				nPtr = NULL;
+			int tid = tPtr && (tPtr+1 == w || tPtr[1] != '/')? AtoI(tPtr+1, w) : vid;
+			int nid = nPtr && nPtr+1 < w? AtoI(nPtr+1, w) : vid;
+			if (--vid < 0 || --tid < 0 || --nid < 0) {
+				c.badFaceLines.push_back(c.nLines);
+				break;
+			}
+			c.corners.push_back(int3(vid, tid, nid));
+			f.nCorners++;
+		}
+		c.statements.push_back(ObjStatement(ObjStatement::Face, c.faces.size()));
+		c.faces.push_back(f);
+	}
+	else if (SameWord(p, w, "g")) {
+		const char *paren = (const char *) memchr(w, '(', eol-w);
+		c.statements.push_back(ObjStatement(ObjStatement::Group, c.names.size()));
+		c.names.push_back(string(w, paren? paren : eol));
+	}
+	else if (SameWord(p, w, "usemtl") || SameWord(p, w, "mtllib")) {
+		bool use = w-p == 6 && tolower(*p) == 'u';
+		const char *n = SkipBlanks(w, eol), *nEnd = WordEnd(n, eol);
+		if (n < nEnd) {
+			c.statements.push_back(ObjStatement(use? ObjStatement::UseMtl : ObjStatement::MtlLib, c.names.size()));
+			c.names.push_back(string(n, nEnd));
+		}
+	}
+}
+
+void ParseObjChunk(ObjChunk &c) {
+	for (const char *line = c.begin; line < c.end && c.badLine < 0; c.nLines++) {
+		const char *eol = (const char *) memchr(line, '\n', c.end-line);
+		if (!eol)
+			eol = c.end;
+		ParseObjLine(c, line, eol);
+		line = eol+1;
+	}
+}
+
+string MtlLibName(const char *objFilename, string mtlFilename) {
+	// material library is presumed in same directory as object file
+	const char *p = strrchr(objFilename, '/');
+	return p? string(objFilename, p+1)+mtlFilename : mtlFilename;
+}
+
+} // end namespace
+
+bool ReadAsciiObjParallel(const char      *filename,
+						  vector<vec3>    &points,
+						  vector<int3>    &triangles,
+						  vector<vec3>    *normals,
+						  vector<vec2>    *textures,
+						  vector<Group>   *triangleGroups,
+						  vector<Mtl>     *triangleMtls,
+						  vector<int4>    *quads,
+						  vector<int2>    *segs,
+						  string          *mtlLib) {
+	// as ReadAsciiObj, but file is memory-mapped, split into line-aligned chunks and parsed
+	// by multiple threads; chunks are then merged in order, with faces, groups and materials
+	// replayed serially to give the same result as ReadAsciiObj
+	if (mtlLib)
+		mtlLib->clear();
+	size_t size = 0;
+	char *data = MapFile(filename, size);
+	if (!data)
+		return false;
+	// split into chunks on line boundaries, about 1MB minimum per chunk
+	const size_t minChunk = 1 << 20;
+	int nChunks = NumThreads();
+	if ((size_t) nChunks > size/minChunk)
+		nChunks = size/minChunk > 0? (int) (size/minChunk) : 1;
+	vector<ObjChunk> chunks(nChunks);
+	const char *start = data, *end = data+size;
+	for (int i = 0; i < nChunks; i++) {
+		const char *stop = data+size*(i+1)/nChunks;
+		if (stop < start)
+			stop = start;
+		const char *eol = i < nChunks-1? (const char *) memchr(stop, '\n', end-stop) : NULL;
+		chunks[i].begin = start;
+		chunks[i].end = start = eol? eol+1 : end;
+	}
+	ParallelFor(nChunks, [&chunks](int i1, int i2) {
+		for (int i = i1; i < i2; i++)
+			ParseObjChunk(chunks[i]);
+	});
+	UnmapFile(data, size);
+	// report errors with file line numbers
+	for (int i = 0, lineOffset = 0; i < nChunks; lineOffset += chunks[i++].nLines) {
+		ObjChunk &c = chunks[i];
+		for (size_t k = 0; k < c.badFaceLines.size(); k++)
+			printf("bad format on line %d\n", lineOffset+c.badFaceLines[k]);
+		if (c.badLine >= 0) {
+			printf("bad line %d in object file", lineOffset+c.badLine);
+			return false;
+		}
+	}
+	// concatenate vertex attributes
+	vector<vec3> tmpVertices, tmpNormals;
+	vector<vec2> tmpTextures;
+	vector<int3> offsets(nChunks);					// # vertices, textures, normals preceding chunk
+	for (int i = 0; i < nChunks; i++) {
+		ObjChunk &c = chunks[i];
+		offsets[i] = int3(tmpVertices.size(), tmpTextures.size(), tmpNormals.size());
+		tmpVertices.insert(tmpVertices.end(), c.vertices.begin(), c.vertices.end());
+		tmpTextures.insert(tmpTextures.end(), c.textures.begin(), c.textures.end());
+		tmpNormals.insert(tmpNormals.end(), c.normals.begin(), c.normals.end());
+		vector<vec3>().swap(c.vertices);
+		vector<vec2>().swap(c.textures);
+		vector<vec3>().swap(c.normals);
+	}
+	// replay statements in file order
+	bool hashedTriangles = false;	// true if any triangle vertex specified with different point/normal/texture id
+	bool hashedVertices = false;	// true if point/normal/texture arrays different (non-zero) size
+	size_t nCorners = 0;
+	for (int i = 0; i < nChunks; i++)
+		nCorners += chunks[i].corners.size();
+	VidMap vidMap((int) (nCorners/4));
+		// typically each unique vertex shared by four or more corners; table grows if needed
+	MtlMap mtlMap;
+	vector<int> vids;
+	int nBadIds = 0;
+	for (int i = 0; i < nChunks; i++) {
+		ObjChunk &c = chunks[i];
+		for (size_t s = 0; s < c.statements.size(); s++) {
+			ObjStatement st = c.statements[s];
+			if (st.type == ObjStatement::MtlLib) {
+				string lib = MtlLibName(filename, c.names[st.id]);
+				mtlMap = ReadMaterial(lib.c_str());
+				if (mtlLib)
+					*mtlLib = lib;
+			}
+			if (st.type == ObjStatement::UseMtl) {
+				MtlMap::iterator it = mtlMap.find(c.names[st.id]);
+				if (it != mtlMap.end() && triangleMtls) {
+					Mtl m = it->second;
+					m.startTriangle = triangles.size();
+					triangleMtls->push_back(m);
+				}
+			}
+			if (st.type == ObjStatement::Group && triangleGroups)
+				triangleGroups->push_back(Group(triangles.size(), c.names[st.id]));
+			if (st.type != ObjStatement::Face)
+				continue;
+			ObjFace &f = c.faces[st.id];
+			int nvids = offsets[i].i1+f.nVertices, ntids = offsets[i].i2+f.nTextures, nnids = offsets[i].i3+f.nNormals;
+			if ((ntids && ntids != nvids) || (nnids && nnids != nvids))
+				hashedVertices = true;
+			vids.resize(0);
+			for (int k = 0; k < f.nCorners; k++) {
+				int3 &corner = c.corners[f.firstCorner+k];
+				int vid = corner.i1, tid = corner.i2, nid = corner.i3;
+				if (tid != vid || nid != vid)
+					hashedTriangles = true;
+				if (!hashedVertices && !hashedTriangles) {
+					vids.push_back(vid);
+					continue;
+				}
+				if (vid >= (int) tmpVertices.size()) {
+					nBadIds++;
+					break;
+				}
+				int nvrts = points.size(), found = vidMap.FindOrAdd(corner, nvrts);
+				if (found >= 0) {
+					vids.push_back(found);
+					continue;
+				}
+				points.push_back(tmpVertices[vid]);
+				if (normals && (int) tmpNormals.size() > nid)
+					normals->push_back(tmpNormals[nid]);
+				if (textures && (int) tmpTextures.size() > tid)
+					textures->push_back(tmpTextures[tid]);
+				vids.push_back(nvrts);
+			}
+			int nids = vids.size();
+			if (nids == 3) {
+				int id1 = vids[0], id2 = vids[1], id3 = vids[2];
+				if (normals && (int) normals->size() > id1) {
+					bool hashed = hashedVertices || hashedTriangles;
+					vec3 &p1 = hashed? points[id1] : tmpVertices[id1];
+					vec3 &p2 = hashed? points[id2] : tmpVertices[id2];
+					vec3 &p3 = hashed? points[id3] : tmpVertices[id3];
+					if (dot(cross(p2-p1, p3-p2), (*normals)[id1]) < 0) {
+						// reverse triangle order to correspond with vertex normal
+						int tmp = id1;
+						id1 = id3;
+						id3 = tmp;
+					}
+				}
+				triangles.push_back(int3(id1, id2, id3));
+			}
+			else if (nids == 4 && quads)
+				quads->push_back(int4(vids[0], vids[1], vids[2], vids[3]));
+			else if (nids == 2 && segs)
+				segs->push_back(int2(vids[0], vids[1]));
+			else
+				// create polygon as nvids-2 triangles
+				for (int k = 1; k < nids-1; k++)
+					triangles.push_back(int3(vids[0], vids[k], vids[k+1]));
+		}
+	}
+	if (nBadIds)
+		printf("%i faces with vertex id out of range\n", nBadIds);
+	if (!hashedVertices && !hashedTriangles) {
+		points.swap(tmpVertices);
+		if (normals)
+			normals->swap(tmpNormals);
+		if (textures)
+			textures->swap(tmpTextures);
+	}
+	if (triangleGroups) {
+		int nGroups = triangleGroups->size();
+		for (int i = 0; i < nGroups; i++) {
+			int next = i < nGroups-1? (*triangleGroups)[i+1].startTriangle : triangles.size();
+			(*triangleGroups)[i].nTriangles = next-(*triangleGroups)[i].startTriangle;
+		}
+	}
+	if (triangleMtls) {
+		int nMtls = triangleMtls->size();
+		for (int i = 0; i < nMtls; i++) {
+			int next = i < nMtls-1? (*triangleMtls)[i+1].startTriangle : triangles.size();
+			(*triangleMtls)[i].nTriangles = next-(*triangleMtls)[i].startTriangle;
+		}
+	}
+	return true;
+} // end ReadAsciiObjParallel
+
+bool WriteAsciiObj(const char    *filename,
+				   vector<vec3>  &points,
+				   vector<vec3>  &normals,
+				   vector<vec2>  &uvs,
+				   vector<int3>  *triangles,
+				   vector<int4>  *quads,
+				   vector<int2>  *segs,
+				   vector<Group> *triangleGroups) {
+	FILE *file = fopen(filename, "w");
+	if (!file) {
+		printf("can't write %s\n", filename);
+		return false;
+	}
+	int nPoints = points.size(), nNormals = normals.size(), nUvs = uvs.size(), nTriangles = triangles? triangles->size() : 0;
+	if (nPoints) {
+		fprintf(file, "# %i vertices\n", nPoints);
+		for (int i = 0; i < nPoints; i++)
+			fprintf(file, "v %f %f %f \n", points[i].x, points[i].y, points[i].z);
+		fprintf(file, "\n");
+	}
+	if (nNormals) {
+		fprintf(file, "# %i normals\n", nNormals);
+		for (int i = 0; i < nNormals; i++)
+			fprintf(file, "vn %f %f %f \n", normals[i].x, normals[i].y, normals[i].z);
+		fprintf(file, "\n");
+	}
+	if (nUvs) {
+		fprintf(file, "# %i textures\n", nUvs);
+		for (int i = 0; i < nUvs; i++)
+			fprintf(file, "vt %f %f \n", uvs[i].x, uvs[i].y);
+		fprintf(file, "\n");
+	}
+	// write triangles, quads (adding 1 to all vertex indices per OBJ format)
+	if (triangles) {
+		// non-grouped triangles
+		size_t nNonGrouped = triangleGroups && triangleGroups->size()? (*triangleGroups)[0].startTriangle : nTriangles; 
+		if (nTriangles) fprintf(file, "# %i triangles\n", nTriangles);
+		for (size_t i = 0; i < nNonGrouped; i++)
+			fprintf(file, "f %d %d %d \n", 1+(*triangles)[i].i1, 1+(*triangles)[i].i2, 1+(*triangles)[i].i3);
+		if (triangleGroups)
+			for (size_t i = 0; i < triangleGroups->size(); i++) {
+				Group g = (*triangleGroups)[i];
+				if (g.nTriangles) {
+					fprintf(file, "g %s (%i triangles)\n", g.name.c_str(), g.nTriangles);
+					for (int t = g.startTriangle; t < g.startTriangle+g.nTriangles; t++)
+						fprintf(file, "f %d %d %d \n", 1+(*triangles)[t].i1, 1+(*triangles)[t].i2, 1+(*triangles)[t].i3);
+				}
+			}
+	//	else
+	//		for (size_t i = 0; i < triangles->size(); i++)
+	//			fprintf(file, "f %d %d %d \n", 1+(*triangles)[i].i1, 1+(*triangles)[i].i2, 1+(*triangles)[i].i3);
+		fprintf(file, "\n");
+	}
+	if (quads)
+		for (size_t i = 0; i < quads->size(); i++)
+			fprintf(file, "f %d %d %d %d \n", 1+(*quads)[i].i1, 1+(*quads)[i].i2, 1+(*quads)[i].i3, 1+(*quads)[i].i4);
+	if (segs)
+		for (size_t i = 0; i < segs->size(); i++)
+			fprintf(file, "f %d %d \n", 1+(*segs)[i].i1, 1+(*segs)[i].i2);
+	fclose(file);
+	return true;
+}
+
+// Binary Mesh Cache
+
+namespace {
+
+const char MeshCacheMagic[8] = {'M', 'E', 'S', 'H', 'B', 'I', 'N', '2'};
+
+struct MeshCacheHeader {
+	char magic[8];
+	long long sourceModified = 0;				// time_t of source file
+	long long mtlModified = 0;					// time_t of material library, if any
+	int normalized = 0;
+	int nPoints = 0, nNormals = 0, nUvs = 0, nTriangles = 0, nQuads = 0, nGroups = 0, nMtls = 0, mtlLibLength = 0;
+	long long offsets[9] = {0};					// points, normals, uvs, triangles, quads, groups, mtls, mtlLib, end
+};
+
+const size_t MeshCacheAlign = 16;
+
+size_t AlignCache(size_t n) { return (n+MeshCacheAlign-1) & ~(MeshCacheAlign-1); }
+
+struct GroupRecord { int startTriangle, nTriangles, nameLength; float color[3]; };
+
+struct MtlRecord { int startTriangle, nTriangles, nameLength; float ka[3], kd[3], ks[3]; };
+
+bool ValidCache(MeshCacheHeader &h, size_t size) {
+	// arrays must be aligned, in order, sized by their counts, and end at end of file
+	// (group and material records have names of varying length, so only their minimum size is known)
+	int counts[] = {h.nPoints, h.nNormals, h.nUvs, h.nTriangles, h.nQuads, h.nGroups, h.nMtls, h.mtlLibLength};
+	long long elementSizes[] = {sizeof(vec3), sizeof(vec3), sizeof(vec2), sizeof(int3), sizeof(int4),
+								sizeof(GroupRecord), sizeof(MtlRecord), 1};
+	if (h.offsets[0] != (long long) AlignCache(sizeof(h)) || h.offsets[8] != (long long) size)
+		return false;
+	for (int i = 0; i < 8; i++) {
+		long long end = h.offsets[i]+counts[i]*elementSizes[i];
+		if (counts[i] < 0 || h.offsets[i]%MeshCacheAlign || end > h.offsets[i+1])
+			return false;
+		if (i != 5 && i != 6 && h.offsets[i+1] != (long long) AlignCache((size_t) end))
+			return false;
+	}
+	return true;
+}
+
+template <class Record> const char *NextRecord(const char *r, const char *end, Record &record) {
+	// copy record at r, return start of next record, or NULL if the record or its name overrun end
+	if (end-r < (long long) sizeof(Record))
+		return NULL;
+	memcpy(&record, r, sizeof(Record));
+	r += sizeof(Record);
+	return record.nameLength < 0 || end-r < record.nameLength? NULL : r+record.nameLength;
+}
+
+bool ValidIds(const int *ids, int count, int nPoints) {
+	for (int i = 0; i < count; i++)
+		if ((unsigned) ids[i] >= (unsigned) nPoints)
+			return false;
+	return true;
+}
+
+} // end namespace
+
+string MeshCacheName(string objFile) { return objFile+".cache"; }
+
+bool WriteMeshCache(const char    *filename,
+					time_t         sourceModified,
+					bool           normalized,
+					vector<vec3>  &points,
+					vector<int3>  &triangles,
+					vector<vec3>  *normals,
+					vector<vec2>  *uvs,
+					vector<Group> *triangleGroups,
+					vector<Mtl>   *triangleMtls,
+					vector<int4>  *quads,
+					const char    *mtlLib) {
+	MeshCacheHeader h;
+	memcpy(h.magic, MeshCacheMagic, sizeof(h.magic));
+	h.sourceModified = (long long) sourceModified;
+	h.mtlModified = mtlLib? (long long) FileModified(mtlLib) : 0;
+	h.normalized = normalized? 1 : 0;
+	h.nPoints = points.size();
+	h.nNormals = normals? normals->size() : 0;
+	h.nUvs = uvs? uvs->size() : 0;
+	h.nTriangles = triangles.size();
+	h.nQuads = quads? quads->size() : 0;
+	h.nGroups = triangleGroups? triangleGroups->size() : 0;
+	h.nMtls = triangleMtls? triangleMtls->size() : 0;
+	h.mtlLibLength = mtlLib? strlen(mtlLib) : 0;
+	// serialize groups and materials (names follow each record)
+	vector<char> groupData, mtlData;
+	for (int i = 0; i < h.nGroups; i++) {
+		Group &g = (*triangleGroups)[i];
+		GroupRecord r = {g.startTriangle, g.nTriangles, (int) g.name.size(), {g.color.x, g.color.y, g.color.z}};
+		groupData.insert(groupData.end(), (char *) &r, (char *) &r+sizeof(r));
+		groupData.insert(groupData.end(), g.name.begin(), g.name.end());
+	}
+	for (int i = 0; i < h.nMtls; i++) {
+		Mtl &m = (*triangleMtls)[i];
+		MtlRecord r = {m.startTriangle, m.nTriangles, (int) m.name.size(),
+					   {m.ka.x, m.ka.y, m.ka.z}, {m.kd.x, m.kd.y, m.kd.z}, {m.ks.x, m.ks.y, m.ks.z}};
+		mtlData.insert(mtlData.end(), (char *) &r, (char *) &r+sizeof(r));
+		mtlData.insert(mtlData.end(), m.name.begin(), m.name.end());
+	}
+	// arrays follow header, each aligned
+	const void *arrays[] = {points.data(), h.nNormals? normals->data() : NULL, h.nUvs? uvs->data() : NULL,
+							triangles.data(), h.nQuads? quads->data() : NULL, groupData.data(), mtlData.data(), mtlLib};
+	size_t sizes[] = {h.nPoints*sizeof(vec3), h.nNormals*sizeof(vec3), h.nUvs*sizeof(vec2),
+					  h.nTriangles*sizeof(int3), h.nQuads*sizeof(int4), groupData.size(), mtlData.size(),
+					  (size_t) h.mtlLibLength};
+	size_t offset = AlignCache(sizeof(h));
+	for (int i = 0; i < 8; i++) {
+		h.offsets[i] = offset;
+		offset = AlignCache(offset+sizes[i]);
+	}
+	h.offsets[8] = offset;
+	// write via temporary file so a concurrent reader never sees a partial cache
+	string temp = string(filename)+".tmp";
+	FILE *out = fopen(temp.c_str(), "wb");
+	if (!out)
+		return false;
+	static const char zeros[MeshCacheAlign] = {0};
+	bool ok = fwrite(&h, sizeof(h), 1, out) == 1;
+	size_t written = sizeof(h);
+	for (int i = 0; ok && i < 8; i++) {
+		ok = fwrite(zeros, 1, (size_t) h.offsets[i]-written, out) == (size_t) h.offsets[i]-written;
+		if (ok && sizes[i])
+			ok = fwrite(arrays[i], 1, sizes[i], out) == sizes[i];
+		written = (size_t) h.offsets[i]+sizes[i];
+	}
+	if (ok)
+		ok = fwrite(zeros, 1, (size_t) h.offsets[8]-written, out) == (size_t) h.offsets[8]-written;
+	ok = fclose(out) == 0 && ok;
+	if (ok && rename(temp.c_str(), filename) != 0) {
+		remove(filename);						// Windows rename does not replace
+		ok = rename(temp.c_str(), filename) == 0;
+	}
+	if (!ok)
+		remove(temp.c_str());
+	return ok;
+}
+
+bool ReadMeshCache(const char    *filename,
+				   time_t         sourceModified,
+				   bool           normalized,
+				   vector<vec3>  &points,
+				   vector<int3>  &triangles,
+				   vector<vec3>  *normals,
+				   vector<vec2>  *uvs,
+				   vector<Group> *triangleGroups,
+				   vector<Mtl>   *triangleMtls,
+				   vector<int4>  *quads) {
+	size_t size = 0;
+	char *data = MapFile(filename, size);
+	if (!data)
+		return false;
+	MeshCacheHeader h;
+	bool ok = size >= sizeof(h);
+	if (ok)
+		memcpy(&h, data, sizeof(h));
+	ok = ok && !memcmp(h.magic, MeshCacheMagic, sizeof(h.magic)) &&
+		 h.sourceModified == (long long) sourceModified &&
+		 h.normalized == (normalized? 1 : 0) &&
+		 ValidCache(h, size);
+	if (ok && h.mtlLibLength)
+		ok = (long long) FileModified(string(data+h.offsets[7], h.mtlLibLength).c_str()) == h.mtlModified;
+	const int3 *t = (const int3 *) (data+h.offsets[3]);
+	const int4 *q = (const int4 *) (data+h.offsets[4]);
+	ok = ok && ValidIds((const int *) t, 3*h.nTriangles, h.nPoints) && ValidIds((const int *) q, 4*h.nQuads, h.nPoints);
+	// parse groups and materials first, so a malformed cache leaves the arguments unchanged
+	vector<Group> groups;
+	vector<Mtl> mtls;
+	for (const char *g = data+h.offsets[5], *next; ok && (int) groups.size() < h.nGroups; g = next) {
+		GroupRecord r;
+		if (!(ok = (next = NextRecord(g, data+h.offsets[6], r)) != NULL))
+			break;
+		Group group(r.startTriangle, string(g+sizeof(r), r.nameLength), vec3(r.color));
+		group.nTriangles = r.nTriangles;
+		groups.push_back(group);
+	}
+	for (const char *m = data+h.offsets[6], *next; ok && (int) mtls.size() < h.nMtls; m = next) {
+		MtlRecord r;
+		if (!(ok = (next = NextRecord(m, data+h.offsets[7], r)) != NULL))
+			break;
+		Mtl mtl(r.startTriangle, string(m+sizeof(r), r.nameLength), vec3(r.ka), vec3(r.kd), vec3(r.ks));
+		mtl.nTriangles = r.nTriangles;
+		mtls.push_back(mtl);
+	}
+	if (ok) {
+		const vec3 *p = (const vec3 *) (data+h.offsets[0]), *n = (const vec3 *) (data+h.offsets[1]);
+		const vec2 *u = (const vec2 *) (data+h.offsets[2]);
+		points.assign(p, p+h.nPoints);
+		triangles.assign(t, t+h.nTriangles);
+		if (normals) normals->assign(n, n+h.nNormals);
+		if (uvs) uvs->assign(u, u+h.nUvs);
+		if (quads) quads->assign(q, q+h.nQuads);
+		if (triangleGroups) triangleGroups->swap(groups);
+		if (triangleMtls) triangleMtls->swap(mtls);
+	}
+	UnmapFile(data, size);
+	return ok;
+}
+
+// OLD shaders
+
+const char *OLDmeshVertexShader = R"(
+	#version 330
+	layout (location = 0) in vec3 point;
+	layout (location = 1) in vec3 normal;
+	layout (location = 2) in vec2 uv;
+	layout (location = 3) in mat4 instance; // for use with glDrawArrays/ElementsInstanced
+											// uses locations 3,4,5,6 for 4 vec4s = mat4
+	layout (location = 7) in vec3 color;	// for instanced color (vec4?)
+	out vec3 vPoint;
+	out vec3 vNormal;
+	out vec2 vUv;
+	out vec3 vColor;
+	uniform bool useInstance = false;
+	uniform mat4 modelview;
+	uniform mat4 persp;
+	void main() {
+		mat4 m = useInstance? modelview*instance : modelview;
+		vPoint = (m*vec4(point, 1)).xyz;
+		vNormal = (m*vec4(normal, 0)).xyz;
+		gl_Position = persp*vec4(vPoint, 1);
+		vUv = uv;
+		vColor = color;
+	}
+)";
+
+const char *OLDmeshPixelShader = R"(
+	#version 330
+	in vec3 vPoint;
+	in vec3 vNormal;
+	in vec2 vUv;
+	in vec3 vColor;
+	out vec4 pColor;
+	uniform int nLights = 1;
+	uniform vec3 lights[20] = vec3[20](vec3(1, 1, 1));
+	uniform bool useLight = true;
+	uniform sampler2D textureUnit;
+	uniform vec3 defaultColor = vec3(1);
+	uniform bool useDefaultColor = true;
+	uniform float opacity = 1;
+	uniform bool useTexture = false;
+	uniform bool useTint = false;
+	uniform bool fwdFacing = false;
+	uniform bool facetedShading = false;
+	float Intensity(vec3 normalV, vec3 eyeV, vec3 point, vec3 light) {
+		vec3 lightV = normalize(light-point);		// light vector
+		vec3 reflectV = reflect(lightV, normalV);   // highlight vector
+		float d = max(0, dot(normalV, lightV));     // one-sided diffuse
+		float s = max(0, dot(reflectV, eyeV));      // one-sided specular
+		return clamp(d+pow(s, 50), 0, 1);
+	}
+	void main() {
+		vec3 N = normalize(facetedShading? cross(dFdx(vPoint), dFdy(vPoint)) : vNormal);
+		if (fwdFacing && N.z < 0) discard;
+		vec3 E = normalize(vPoint);					// eye vector
+		float intensity = useLight? 0 : 1;
+		if (useLight) {
+			for (int i = 0; i < nLights; i++)
+				intensity += Intensity(N, E, vPoint, lights[i]);
+			intensity = clamp(intensity, 0, 1);
+		}
+		vec3 color = useTexture? texture(textureUnit, vUv).rgb : useDefaultColor? defaultColor : vColor;
+		if (useTexture && useTint) {
+			color.r *= defaultColor.r;
+			color.g *= defaultColor.g;
+			color.b *= defaultColor.b;
+		}
+		pColor = vec4(intensity*color, opacity);
+	}
+)";
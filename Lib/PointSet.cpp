@@ -0,0 +1,225 @@
+// PointSet.cpp - structure-of-arrays point cloud: bounds, normalize, transform (c) 2019-2022 Jules Bloomenthal
+
+#include "PointSet.h"
+#include "Mesh.h"
+#include "Misc.h"
+#include <float.h>
+
+namespace {
+
+const int minPerThread = 1 << 18;	// fewer points aren't worth a thread
+
+// Bounds
+
+void Update(float v, float &min, float &max) {
+	if (v < min) min = v;
+	if (v > max) max = v;
+}
+
+void Merge(vec3 &min, vec3 &max, const float *lo, const float *hi, int n) {
+	// lo[j], hi[j] are partial bounds of coordinate j%3
+	for (int j = 0; j < n; j++) {
+		if (lo[j] < min[j%3]) min[j%3] = lo[j];
+		if (hi[j] > max[j%3]) max[j%3] = hi[j];
+	}
+}
+
+void MinMaxArrays(const float *x, const float *y, const float *z, int begin, int end, vec3 &min, vec3 &max) {
+	// separate coordinate arrays
+	min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	int i = begin;
+#ifdef VECMAT_SIMD
+	const int nb = FloatBatch::n;
+	FloatBatch loX = FloatBatch::Splat(FLT_MAX), loY = loX, loZ = loX;
+	FloatBatch hiX = FloatBatch::Splat(-FLT_MAX), hiY = hiX, hiZ = hiX;
+	for (; i+nb <= end; i += nb) {
+		FloatBatch px = FloatBatch::Load(x+i), py = FloatBatch::Load(y+i), pz = FloatBatch::Load(z+i);
+		loX = px.Min(loX); loY = py.Min(loY); loZ = pz.Min(loZ);
+		hiX = px.Max(hiX); hiY = py.Max(hiY); hiZ = pz.Max(hiZ);
+	}
+	float l[3][nb], h[3][nb], lo[3*nb], hi[3*nb];
+	loX.Store(l[0]); loY.Store(l[1]); loZ.Store(l[2]);
+	hiX.Store(h[0]); hiY.Store(h[1]); hiZ.Store(h[2]);
+	for (int j = 0; j < 3*nb; j++) {
+		// interleave lanes as x, y, z for Merge
+		lo[j] = l[j%3][j/3];
+		hi[j] = h[j%3][j/3];
+	}
+	Merge(min, max, lo, hi, 3*nb);
+#endif
+	for (; i < end; i++) {
+		Update(x[i], min.x, max.x);
+		Update(y[i], min.y, max.y);
+		Update(z[i], min.z, max.z);
+	}
+}
+
+void MinMaxInterleaved(const float *p, int begin, int end, vec3 &min, vec3 &max) {
+	// x, y, z, x, y, z...: three consecutive batches hold nb points, and lane j of batch r
+	// always holds coordinate (nb*r+j)%3, so bounds accumulate without shuffles
+	min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	int i = begin;
+#ifdef VECMAT_SIMD
+	const int nb = FloatBatch::n;
+	FloatBatch lo0 = FloatBatch::Splat(FLT_MAX), lo1 = lo0, lo2 = lo0;
+	FloatBatch hi0 = FloatBatch::Splat(-FLT_MAX), hi1 = hi0, hi2 = hi0;
+	for (; i+nb <= end; i += nb) {
+		const float *f = p+3*i;
+		FloatBatch a = FloatBatch::Load(f), b = FloatBatch::Load(f+nb), c = FloatBatch::Load(f+2*nb);
+		lo0 = a.Min(lo0); lo1 = b.Min(lo1); lo2 = c.Min(lo2);
+		hi0 = a.Max(hi0); hi1 = b.Max(hi1); hi2 = c.Max(hi2);
+	}
+	float lo[3*nb], hi[3*nb];
+	lo0.Store(lo); lo1.Store(lo+nb); lo2.Store(lo+2*nb);
+	hi0.Store(hi); hi1.Store(hi+nb); hi2.Store(hi+2*nb);
+	Merge(min, max, lo, hi, 3*nb);
+#endif
+	for (; i < end; i++)
+		for (int k = 0; k < 3; k++)
+			Update(p[3*i+k], min[k], max[k]);
+}
+
+// Scale and offset
+
+void ScaleOffsetArray(float *v, int begin, int end, float s, float o) {
+	int i = begin;
+#ifdef VECMAT_SIMD
+	FloatBatch ss = FloatBatch::Splat(s), oo = FloatBatch::Splat(o);
+	for (; i+FloatBatch::n <= end; i += FloatBatch::n)
+		(FloatBatch::Load(v+i)*ss+oo).Store(v+i);
+#endif
+	for (; i < end; i++)
+		v[i] = v[i]*s+o;
+}
+
+void ScaleOffsetInterleaved(float *p, int begin, int end, vec3 s, vec3 o) {
+	// per-lane scale and offset follow the same x, y, z pattern as MinMaxInterleaved
+	int i = begin;
+#ifdef VECMAT_SIMD
+	const int nb = FloatBatch::n;
+	float sp[3*nb], op[3*nb];
+	for (int j = 0; j < 3*nb; j++) {
+		sp[j] = s[j%3];
+		op[j] = o[j%3];
+	}
+	FloatBatch s0 = FloatBatch::Load(sp), s1 = FloatBatch::Load(sp+nb), s2 = FloatBatch::Load(sp+2*nb);
+	FloatBatch o0 = FloatBatch::Load(op), o1 = FloatBatch::Load(op+nb), o2 = FloatBatch::Load(op+2*nb);
+	for (; i+nb <= end; i += nb) {
+		float *f = p+3*i;
+		(FloatBatch::Load(f)*s0+o0).Store(f);
+		(FloatBatch::Load(f+nb)*s1+o1).Store(f+nb);
+		(FloatBatch::Load(f+2*nb)*s2+o2).Store(f+2*nb);
+	}
+#endif
+	for (; i < end; i++)
+		for (int k = 0; k < 3; k++)
+			p[3*i+k] = p[3*i+k]*s[k]+o[k];
+}
+
+} // end namespace
+
+// Storage
+
+void PointSet::Resize(int n) {
+	int padded;
+	x = AlignedArrays(storage, 3, n, padded);
+	y = x+padded;
+	z = y+padded;
+	count = n;
+	stride = 1;
+}
+
+void PointSet::Set(const vec3 *points, int n) {
+	Resize(n);
+	for (int i = 0; i < n; i++) {
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+		z[i] = points[i].z;
+	}
+}
+
+void PointSet::Set(vector<vec3> &points) {
+	Set(points.data(), (int) points.size());
+}
+
+void PointSet::Get(vec3 *points) {
+	for (int i = 0; i < count; i++)
+		points[i] = Point(i);
+}
+
+void PointSet::Get(vector<vec3> &points) {
+	points.resize(count);
+	Get(points.data());
+}
+
+void PointSet::View(vec3 *points, int n) {
+	// an empty view (points may be NULL, as from an empty vector's data()) has NULL arrays
+	storage = vector<float>();
+	x = y = z = NULL;
+	count = 0;
+	stride = 3;
+	if (points && n > 0) {
+		x = &points->x;
+		y = x+1;
+		z = x+2;
+		count = n;
+	}
+}
+
+void PointSet::View(vector<vec3> &points) {
+	View(points.data(), (int) points.size());
+}
+
+// Operations
+
+void PointSet::MinMax(vec3 &min, vec3 &max) {
+	// fixed ranges, merged in order, so the result doesn't depend on thread timing
+	int nRanges = count/minPerThread, nThreads = NumThreads();
+	nRanges = nRanges < 1? 1 : nRanges > nThreads? nThreads : nRanges;
+	vector<vec3> mins(nRanges), maxs(nRanges);
+	ParallelFor(nRanges, [&](int r1, int r2) {
+		for (int r = r1; r < r2; r++) {
+			int begin = (int) ((long long) count*r/nRanges), end = (int) ((long long) count*(r+1)/nRanges);
+			if (IsView())
+				MinMaxInterleaved(x, begin, end, mins[r], maxs[r]);
+			else
+				MinMaxArrays(x, y, z, begin, end, mins[r], maxs[r]);
+		}
+	});
+	min = mins[0];
+	max = maxs[0];
+	for (int r = 1; r < nRanges; r++)
+		Merge(min, max, &mins[r].x, &maxs[r].x, 3);
+}
+
+mat4 PointSet::NormalizeMat(float scale) {
+	vec3 min, max;
+	MinMax(min, max);
+	return NDCfromMinMax(min, max, scale);
+}
+
+void PointSet::Normalize(float scale) {
+	// NormalizeMat is diagonal scale plus translation, so each coordinate is independent
+	mat4 m = NormalizeMat(scale);
+	vec3 s(m[0][0], m[1][1], m[2][2]), o(m[0][3], m[1][3], m[2][3]);
+	ParallelFor(count, [&](int begin, int end) {
+		if (IsView())
+			ScaleOffsetInterleaved(x, begin, end, s, o);
+		else
+			for (int k = 0; k < 3; k++)
+				ScaleOffsetArray(k == 0? x : k == 1? y : z, begin, end, s[k], o[k]);
+	}, minPerThread);
+}
+
+void PointSet::Transform(const mat4 &m) {
+	ParallelFor(count, [&](int begin, int end) {
+		if (IsView()) {
+			vec3 *p = (vec3 *) x+begin;
+			TransformPoints(m, p, p, end-begin);
+		}
+		else
+			TransformPoints(m, x+begin, y+begin, z+begin, x+begin, y+begin, z+begin, NULL, end-begin);
+	}, minPerThread);
+}
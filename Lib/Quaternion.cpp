@@ -1,114 +1,356 @@
-// Quaternion.cpp - quaternion rep & op
-// (c) 2019-2022 Ken Shoemake and Jules Bloomenthal
-
-#include <float.h>
-#include "Quaternion.h"
-
-const int X = 0, Y = 1, Z = 2;
-#define _PI 3.141592f
-
-Quaternion::Quaternion(vec3 axis, float radAng) {
-	float c = cos(radAng/2), s = sin(radAng/2);
-	vec3 a = normalize(axis);
-	x = s*a.x; y = s*a.y; z = s*a.z; w = c;
-}
-
-Quaternion::Quaternion(mat4 m) {
-	mat3 t = mat3(vec3(m[0][0], m[1][0], m[2][0]), vec3(m[0][1], m[1][1], m[2][1]), vec3(m[0][2], m[1][2], m[2][2]));
-	// the following transpose for left-handed coord sys
-	// mat3 t = mat3(vec3(m[0][0], m[0][1], m[0][2]), vec3(m[1][0], m[1][1], m[1][2]), vec3(m[2][0], m[2][1], m[2][2]));
-	// remove scaling if any *** only if uniform scale! (differential scale must be treated differently)
-	float xlen = length(vec3(m[0][0], m[1][0], m[2][0])); // x column scale
-	float ylen = length(vec3(m[0][1], m[1][1], m[2][1]));
-	float zlen = length(vec3(m[0][2], m[1][2], m[2][2]));
-	// *** should test here that xlen, ylen, zlen are same
-	for (int i = 0; i < 3; i++) t[i][0] /= xlen;
-	for (int i = 0; i < 3; i++) t[i][1] /= ylen;
-	for (int i = 0; i < 3; i++) t[i][2] /= zlen;
-	*this = Quaternion(t);
-}
-
-Quaternion::Quaternion(mat3 &mat) {
-  float s, tr = mat[X][X]+mat[Y][Y]+mat[Z][Z];
-  if (tr >= 0) {
-	w = (float) sqrt(.25f*(tr+1));
-	s = .25f/w;
-	x = (mat[Z][Y] - mat[Y][Z]) * s;
-	y = (mat[X][Z] - mat[Z][X]) * s;
-	z = (mat[Y][X] - mat[X][Y]) * s;
-  }
-  else {
-#define caseMacro(i, j, k, I, J, K)                                       \
-	case I:                                                               \
-	  i = sqrt(.25f*(mat[I][I] - mat[J][J] - mat[K][K] + 1));             \
-	  s = .25f/i;                                                         \
-	  j = (mat[I][J] + mat[J][I]) * s;                                    \
-	  k = (mat[K][I] + mat[I][K]) * s;                                    \
-	  w = (mat[K][J] - mat[J][K]) * s;                                    \
-	  break
-	switch ((mat[X][X] >= mat[Y][Y])?
-		   ((mat[X][X] >= mat[Z][Z])? X : Z) :
-		   ((mat[Y][Y] >= mat[Z][Z])? Y : Z)) {
-				caseMacro(x, y, z, X, Y, Z);
-				caseMacro(y, z, x, Y, Z, X);
-				caseMacro(z, x, y, Z, X, Y);
-	}
-  }
-}
-
-mat3 Quaternion::Get3x3() {
-	float norm = Norm();
-	if (fabs(norm) < FLT_EPSILON)
-		return mat3(vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1));
-	float s = 2/norm;
-	float xs = x*s,  ys = y*s,  zs = z*s;
-	float wx = w*xs, wy = w*ys, wz = w*zs;
-	float xx = x*xs, xy = x*ys, xz = x*zs;
-	float yy = y*ys, yz = y*zs, zz = z*zs;
-	return mat3(
-		vec3(1 - (yy + zz), xy + wz,       xz - wy),
-		vec3(xy - wz,       1 - (xx + zz), yz + wx),
-		vec3(xz + wy,       yz - wx,       1 - (xx + yy)));
-}
-
-mat4 Quaternion::GetMatrix() {
-	mat3 m3 = Get3x3();
-	return mat4(m3);
-}
-
-void Quaternion::SetMatrix(mat4 &m, float scale) {
-	mat3 m3 = this->Get3x3();
-	for (int i = 0; i < 3; i++)
-		for (int j = 0; j < 3; j++)
-			m[i][j] = scale*m3[i][j];
-}
-
-float Dot(Quaternion &qL, Quaternion &qR) {
-	return qL.x*qR.x+qL.y*qR.y+qL.z*qR.z+qL.w*qR.w;
-}
-
-void Quaternion::Slerp(Quaternion& qu0, Quaternion& qu1, float t) {
-  float qu0Part, qu1Part, epsilon = .00001f;
-  float cosOmega = Dot(qu0, qu1);
-  if ((1 + cosOmega) > epsilon) { // usual case
-	if ((1 - cosOmega) > epsilon) { // usual case
-	  float omega = acos(cosOmega);
-	  float sinOmega = sin(omega);
-	  qu0Part = sin((1 - t)*omega)/sinOmega;
-	  qu1Part = sin(t*omega)/sinOmega;
-	}
-	else { // ends very close
-	  qu0Part = 1.0f - t;
-	  qu1Part = t;
-	}
-	Quaternion s1 = qu0*qu0Part, s2 = qu1*qu1Part; // s1 = Scale(qu0, qu0Part), s2 = Scale(qu1, qu1Part);
-	*this = s1+s2; // Add(s1, s2);
-  }
-  else { // ends nearly opposite
-	Quaternion qup(-qu0.y, qu0.x, -qu0.w, qu0.z);
-	qu0Part = sin((0.5f - t)*_PI);
-	qu1Part = sin(t*_PI);
-	Quaternion s1 = qu0*qu0Part, s2 = qup*qu1Part;
-	*this = s1+s2;
-  }
-}
+// Quaternion.cpp - quaternion rep & op
+// (c) 2019-2022 Ken Shoemake and Jules Bloomenthal
+
+#include <assert.h>
+#include <float.h>
+#include <algorithm>
+#include "Quaternion.h"
+
+const int X = 0, Y = 1, Z = 2;
+#define _PI 3.141592f
+
+Quaternion::Quaternion(vec3 axis, float radAng) {
+	float c = cos(radAng/2), s = sin(radAng/2);
+	vec3 a = normalize(axis);
+	x = s*a.x; y = s*a.y; z = s*a.z; w = c;
+}
+
+Quaternion::Quaternion(mat4 m) {
+	mat3 t = mat3(vec3(m[0][0], m[1][0], m[2][0]), vec3(m[0][1], m[1][1], m[2][1]), vec3(m[0][2], m[1][2], m[2][2]));
+	// the following transpose for left-handed coord sys
+	// mat3 t = mat3(vec3(m[0][0], m[0][1], m[0][2]), vec3(m[1][0], m[1][1], m[1][2]), vec3(m[2][0], m[2][1], m[2][2]));
+	// remove scaling if any *** only if uniform scale! (differential scale must be treated differently)
+	float xlen = length(vec3(m[0][0], m[1][0], m[2][0])); // x column scale
+	float ylen = length(vec3(m[0][1], m[1][1], m[2][1]));
+	float zlen = length(vec3(m[0][2], m[1][2], m[2][2]));
+	// *** should test here that xlen, ylen, zlen are same
+	for (int i = 0; i < 3; i++) t[i][0] /= xlen;
+	for (int i = 0; i < 3; i++) t[i][1] /= ylen;
+	for (int i = 0; i < 3; i++) t[i][2] /= zlen;
+	*this = Quaternion(t);
+}
+
+Quaternion::Quaternion(mat3 &mat) {
+  float s, tr = mat[X][X]+mat[Y][Y]+mat[Z][Z];
+  if (tr >= 0) {
+	w = (float) sqrt(.25f*(tr+1));
+	s = .25f/w;
+	x = (mat[Z][Y] - mat[Y][Z]) * s;
+	y = (mat[X][Z] - mat[Z][X]) * s;
+	z = (mat[Y][X] - mat[X][Y]) * s;
+  }
+  else {
+#define caseMacro(i, j, k, I, J, K)                                       \
+	case I:                                                               \
+	  i = sqrt(.25f*(mat[I][I] - mat[J][J] - mat[K][K] + 1));             \
+	  s = .25f/i;                                                         \
+	  j = (mat[I][J] + mat[J][I]) * s;                                    \
+	  k = (mat[K][I] + mat[I][K]) * s;                                    \
+	  w = (mat[K][J] - mat[J][K]) * s;                                    \
+	  break
+	switch ((mat[X][X] >= mat[Y][Y])?
+		   ((mat[X][X] >= mat[Z][Z])? X : Z) :
+		   ((mat[Y][Y] >= mat[Z][Z])? Y : Z)) {
+				caseMacro(x, y, z, X, Y, Z);
+				caseMacro(y, z, x, Y, Z, X);
+				caseMacro(z, x, y, Z, X, Y);
+	}
+  }
+}
+
+mat3 Quaternion::Get3x3() {
+	float norm = Norm();
+	if (fabs(norm) < FLT_EPSILON)
+		return mat3(vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1));
+	float s = 2/norm;
+	float xs = x*s,  ys = y*s,  zs = z*s;
+	float wx = w*xs, wy = w*ys, wz = w*zs;
+	float xx = x*xs, xy = x*ys, xz = x*zs;
+	float yy = y*ys, yz = y*zs, zz = z*zs;
+	return mat3(
+		vec3(1 - (yy + zz), xy + wz,       xz - wy),
+		vec3(xy - wz,       1 - (xx + zz), yz + wx),
+		vec3(xz + wy,       yz - wx,       1 - (xx + yy)));
+}
+
+mat4 Quaternion::GetMatrix() {
+	mat3 m3 = Get3x3();
+	return mat4(m3);
+}
+
+void Quaternion::SetMatrix(mat4 &m, float scale) {
+	mat3 m3 = this->Get3x3();
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			m[i][j] = scale*m3[i][j];
+}
+
+float Dot(Quaternion &qL, Quaternion &qR) {
+	return qL.x*qR.x+qL.y*qR.y+qL.z*qR.z+qL.w*qR.w;
+}
+
+void Quaternion::Slerp(Quaternion& qu0, Quaternion& qu1, float t) {
+  float qu0Part, qu1Part, epsilon = .00001f;
+  float cosOmega = Dot(qu0, qu1);
+  if ((1 + cosOmega) > epsilon) { // usual case
+	if ((1 - cosOmega) > epsilon) { // usual case
+	  float omega = acos(cosOmega);
+	  float sinOmega = sin(omega);
+	  qu0Part = sin((1 - t)*omega)/sinOmega;
+	  qu1Part = sin(t*omega)/sinOmega;
+	}
+	else { // ends very close
+	  qu0Part = 1.0f - t;
+	  qu1Part = t;
+	}
+	Quaternion s1 = qu0*qu0Part, s2 = qu1*qu1Part; // s1 = Scale(qu0, qu0Part), s2 = Scale(qu1, qu1Part);
+	*this = s1+s2; // Add(s1, s2);
+  }
+  else { // ends nearly opposite
+	Quaternion qup(-qu0.y, qu0.x, -qu0.w, qu0.z);
+	qu0Part = sin((0.5f - t)*_PI);
+	qu1Part = sin(t*_PI);
+	Quaternion s1 = qu0*qu0Part, s2 = qup*qu1Part;
+	*this = s1+s2;
+  }
+}
+
+// Quaternion Arrays
+
+void QuaternionArray::Resize(int n) {
+	int padded;
+	x = AlignedArrays(storage, 4, n, padded);
+	y = x+padded;
+	z = y+padded;
+	w = z+padded;
+	count = n;
+}
+
+void QuaternionArray::Set(const Quaternion *q, int n) {
+	Resize(n);
+	for (int i = 0; i < n; i++)
+		Set(i, q[i]);
+}
+
+void QuaternionArray::Set(vector<Quaternion> &q) {
+	Set(q.data(), (int) q.size());
+}
+
+void QuaternionArray::GetAll(Quaternion *q) {
+	for (int i = 0; i < count; i++)
+		q[i] = Get(i);
+}
+
+void QuaternionArray::Normalize() {
+	int i = 0;
+#ifdef VECMAT_SIMD
+	FloatBatch one = FloatBatch::Splat(1);
+	for (; i+FloatBatch::n <= count; i += FloatBatch::n) {
+		FloatBatch qx = FloatBatch::Load(x+i), qy = FloatBatch::Load(y+i), qz = FloatBatch::Load(z+i), qw = FloatBatch::Load(w+i);
+		FloatBatch s = one/(((qx*qx+qy*qy)+qz*qz)+qw*qw).Sqrt();
+		(qx*s).Store(x+i); (qy*s).Store(y+i); (qz*s).Store(z+i); (qw*s).Store(w+i);
+	}
+#endif
+	for (; i < count; i++) {
+		float s = 1/sqrt(((x[i]*x[i]+y[i]*y[i])+z[i]*z[i])+w[i]*w[i]);
+		x[i] *= s; y[i] *= s; z[i] *= s; w[i] *= s;
+	}
+}
+
+void QuaternionArray::GetMatrices(mat4 *m) {
+	// as Get3x3, in batches; rows are written per quaternion
+	int i = 0;
+#ifdef VECMAT_SIMD
+	const int nb = FloatBatch::n;
+	FloatBatch one = FloatBatch::Splat(1), two = FloatBatch::Splat(2);
+	float r[10][nb];
+	for (; i+nb <= count; i += nb) {
+		FloatBatch qx = FloatBatch::Load(x+i), qy = FloatBatch::Load(y+i), qz = FloatBatch::Load(z+i), qw = FloatBatch::Load(w+i);
+		FloatBatch norm = ((qx*qx+qy*qy)+qz*qz)+qw*qw, s = two/norm;
+		FloatBatch xs = qx*s,  ys = qy*s,  zs = qz*s;
+		FloatBatch wx = qw*xs, wy = qw*ys, wz = qw*zs;
+		FloatBatch xx = qx*xs, xy = qx*ys, xz = qx*zs;
+		FloatBatch yy = qy*ys, yz = qy*zs, zz = qz*zs;
+		(one-(yy+zz)).Store(r[0]); (xy+wz).Store(r[1]);       (xz-wy).Store(r[2]);
+		(xy-wz).Store(r[3]);       (one-(xx+zz)).Store(r[4]); (yz+wx).Store(r[5]);
+		(xz+wy).Store(r[6]);       (yz-wx).Store(r[7]);       (one-(xx+yy)).Store(r[8]);
+		norm.Store(r[9]);
+		for (int j = 0; j < nb; j++)
+			m[i+j] = fabs(r[9][j]) < FLT_EPSILON? mat4() : mat4(
+				vec4(r[0][j], r[1][j], r[2][j], 0),
+				vec4(r[3][j], r[4][j], r[5][j], 0),
+				vec4(r[6][j], r[7][j], r[8][j], 0),
+				vec4(0, 0, 0, 1));
+	}
+#endif
+	for (; i < count; i++)
+		m[i] = Get(i).GetMatrix();
+}
+
+// Batch Interpolation
+
+namespace {
+
+// Slerp weights
+//     sin((1-t)w)/sin(w) and sin(tw)/sin(w) as polynomials in cos(w), after Eberly, "A Fast and Accurate
+//     Algorithm for Computing SLERP" (2011): 16 terms, the last scaled by slerpMu to absorb the rest of
+//     the series (max weight error 3e-8 for cos(w) in 0..1, versus 2e-5 with Eberly's 8 terms)
+
+const int nSlerpTerms = 16;
+const float slerpMu = 1.9166668f;
+
+struct SlerpCoefficients {
+	float u[nSlerpTerms], v[nSlerpTerms];
+	SlerpCoefficients() {
+		for (int i = 0; i < nSlerpTerms; i++) {
+			float mu = i == nSlerpTerms-1? slerpMu : 1;
+			u[i] = mu/((i+1)*(2*i+3));
+			v[i] = mu*(i+1)/(2*i+3);
+		}
+	}
+} slerp;
+
+void SlerpWeights(float c, float t, float &wa, float &wb) {
+	// c = cos(w) >= 0
+	float cm1 = c-1, d = 1-t, tt = t*t, dd = d*d, ca = 1, cb = 1;
+	for (int i = nSlerpTerms-1; i >= 0; i--) {
+		ca = 1+(slerp.u[i]*dd-slerp.v[i])*cm1*ca;
+		cb = 1+(slerp.u[i]*tt-slerp.v[i])*cm1*cb;
+	}
+	wa = d*ca;
+	wb = t*cb;
+}
+
+void Interpolate(QuaternionArray &a, QuaternionArray &b, float t, const float *ts, QuaternionArray &r, bool nlerp) {
+	// per-quaternion t if ts non-null; scalar tail matches the SIMD lanes
+	// a and b must be the same size; if not (release builds), the shorter is used and r is not
+	// resized if it is a or b, as that would move their arrays
+	assert(a.count == b.count);
+	int n = a.count < b.count? a.count : b.count, i = 0;
+	if (r.count != n && &r != &a && &r != &b)
+		r.Resize(n);
+#ifdef VECMAT_SIMD
+	const int nb = FloatBatch::n;
+	FloatBatch one = FloatBatch::Splat(1), tBatch = FloatBatch::Splat(t);
+	for (; i+nb <= n; i += nb) {
+		FloatBatch ax = FloatBatch::Load(a.x+i), ay = FloatBatch::Load(a.y+i), az = FloatBatch::Load(a.z+i), aw = FloatBatch::Load(a.w+i);
+		FloatBatch bx = FloatBatch::Load(b.x+i), by = FloatBatch::Load(b.y+i), bz = FloatBatch::Load(b.z+i), bw = FloatBatch::Load(b.w+i);
+		FloatBatch c = ((ax*bx+ay*by)+az*bz)+aw*bw;
+		bx = bx.FlipSign(c); by = by.FlipSign(c); bz = bz.FlipSign(c); bw = bw.FlipSign(c);
+		c = c.FlipSign(c);
+		FloatBatch tt = ts? FloatBatch::Load(ts+i) : tBatch, d = one-tt, wa = d, wb = tt;
+		if (!nlerp) {
+			FloatBatch cm1 = c-one, t2 = tt*tt, d2 = d*d, ca = one, cb = one;
+			for (int k = nSlerpTerms-1; k >= 0; k--) {
+				FloatBatch u = FloatBatch::Splat(slerp.u[k]), v = FloatBatch::Splat(slerp.v[k]);
+				ca = one+(u*d2-v)*cm1*ca;
+				cb = one+(u*t2-v)*cm1*cb;
+			}
+			wa = d*ca;
+			wb = tt*cb;
+		}
+		FloatBatch rx = wa*ax+wb*bx, ry = wa*ay+wb*by, rz = wa*az+wb*bz, rw = wa*aw+wb*bw;
+		if (nlerp) {
+			FloatBatch s = one/(((rx*rx+ry*ry)+rz*rz)+rw*rw).Sqrt();
+			rx = rx*s; ry = ry*s; rz = rz*s; rw = rw*s;
+		}
+		rx.Store(r.x+i); ry.Store(r.y+i); rz.Store(r.z+i); rw.Store(r.w+i);
+	}
+#endif
+	for (; i < n; i++) {
+		float ax = a.x[i], ay = a.y[i], az = a.z[i], aw = a.w[i];
+		float bx = b.x[i], by = b.y[i], bz = b.z[i], bw = b.w[i];
+		float c = ((ax*bx+ay*by)+az*bz)+aw*bw;
+		if (signbit(c)) {
+			bx = -bx; by = -by; bz = -bz; bw = -bw;
+			c = -c;
+		}
+		float tt = ts? ts[i] : t, wa = 1-tt, wb = tt;
+		if (!nlerp)
+			SlerpWeights(c, tt, wa, wb);
+		float rx = wa*ax+wb*bx, ry = wa*ay+wb*by, rz = wa*az+wb*bz, rw = wa*aw+wb*bw;
+		if (nlerp) {
+			float s = 1/sqrt(((rx*rx+ry*ry)+rz*rz)+rw*rw);
+			rx *= s; ry *= s; rz *= s; rw *= s;
+		}
+		r.x[i] = rx; r.y[i] = ry; r.z[i] = rz; r.w[i] = rw;
+	}
+}
+
+} // end namespace
+
+void Slerp(QuaternionArray &a, QuaternionArray &b, float t, QuaternionArray &result) {
+	Interpolate(a, b, t, NULL, result, false);
+}
+
+void Slerp(QuaternionArray &a, QuaternionArray &b, const float *t, QuaternionArray &result) {
+	Interpolate(a, b, 0, t, result, false);
+}
+
+void NLerp(QuaternionArray &a, QuaternionArray &b, float t, QuaternionArray &result) {
+	Interpolate(a, b, t, NULL, result, true);
+}
+
+void NLerp(QuaternionArray &a, QuaternionArray &b, const float *t, QuaternionArray &result) {
+	Interpolate(a, b, 0, t, result, true);
+}
+
+// Keyframe Sampling
+
+int QuaternionSampler::Add(const vector<float> &times, const vector<Quaternion> &keys) {
+	// equal times would give 0/0 when sampled
+	if (keys.empty() || times.size() != keys.size())
+		return -1;
+	for (size_t k = 1; k < times.size(); k++)
+		if (!(times[k] > times[k-1]))
+			return -1;
+	Track track;
+	track.times = times;
+	track.keys = keys;
+	tracks.push_back(track);
+	return (int) tracks.size()-1;
+}
+
+void QuaternionSampler::Sample(float t, QuaternionArray &r, bool fast) {
+	int n = (int) tracks.size();
+	if (a.count != n) {
+		a.Resize(n);
+		b.Resize(n);
+		u.resize(n);
+	}
+	for (int i = 0; i < n; i++) {
+		Track &track = tracks[i];
+		vector<float> &times = track.times;
+		int last = (int) times.size()-1, k = track.key;
+		if (last < 1) {
+			// one key
+			a.Set(i, track.keys[0]);
+			b.Set(i, track.keys[0]);
+			u[i] = 0;
+			continue;
+		}
+		// find k such that times[k] <= t < times[k+1] (k = 0 before the first key, last-1 after the last)
+		if (!(k < last && (k == 0 || t >= times[k]) && (k == last-1 || t < times[k+1]))) {
+			if (k+1 < last && t >= times[k+1] && (k+1 == last-1 || t < times[k+2]))
+				k++;
+			else {
+				k = (int) (std::upper_bound(times.begin(), times.end(), t)-times.begin())-1;
+				k = k < 0? 0 : k > last-1? last-1 : k;
+			}
+			track.key = k;
+		}
+		float s = (t-times[k])/(times[k+1]-times[k]);
+		a.Set(i, track.keys[k]);
+		b.Set(i, track.keys[k+1]);
+		u[i] = s < 0? 0 : s > 1? 1 : s;
+	}
+	if (fast)
+		NLerp(a, b, u.data(), r);
+	else
+		Slerp(a, b, u.data(), r);
+}
+
+void QuaternionSampler::Sample(float t, mat4 *matrices, bool fast) {
+	Sample(t, result, fast);
+	result.GetMatrices(matrices);
+}
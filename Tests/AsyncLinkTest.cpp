@@ -0,0 +1,136 @@
+// AsyncLinkTest.cpp - LinkProgramAsync, ProgramFuture, LazyProgram, PrepareLibraryPrograms; submit and link times (c) 2019-2022 Jules Bloomenthal
+// usage: AsyncLinkTest [# programs]  (default 8)
+
+#include <vector>
+#include "GLXtras.h"
+#include "Test.h"
+
+using std::string;
+using std::vector;
+
+// GL shim: glad's pointers for compiling, linking and uniform lookup are replaced by counting thunks
+
+template <auto &slot, class F = std::remove_reference_t<decltype(slot)>> struct Count;
+
+template <auto &slot, class R, class... A> struct Count<slot, R (APIENTRYP)(A...)> {
+	static inline R (APIENTRYP real)(A...) = NULL;
+	static inline int n = 0;
+	static R APIENTRY Thunk(A... a) { n++; return real(a...); }
+	static void Install() { real = slot; slot = Thunk; }
+};
+
+typedef Count<glad_glCompileShader> Compiles;
+typedef Count<glad_glLinkProgram> Links;
+typedef Count<glad_glDeleteProgram> Deletes;
+typedef Count<glad_glGetUniformLocation> Locations;
+
+// shaders
+
+const char *vertexCode = R"(
+	#version 410 core
+	in vec3 position;
+	uniform mat4 view;
+	void main() { gl_Position = view*vec4(position, 1); }
+)";
+
+const char *pixelCode = R"(
+	#version 410 core
+	out vec4 pColor;
+	uniform vec4 color;
+	void main() { pColor = color; }
+)";
+
+const char *brokenCode = R"(
+	#version 410 core
+	out vec4 pColor;
+	void main() { pColor = undeclared; }
+)";
+
+string Variant(int i) {
+	// pixel shader that differs per program, so a driver can't reuse an earlier compile
+	string code = pixelCode;
+	return code.replace(code.find("color;"), 6, "color;\n\tconst float unused"+std::to_string(i)+" = 0.;");
+}
+
+LazyProgram prepared("prepared", &vertexCode, NULL, NULL, NULL, &pixelCode);
+LazyProgram unprepared("unprepared", &vertexCode, NULL, NULL, NULL, &pixelCode, false);
+LazyProgram broken("broken", &vertexCode, NULL, NULL, NULL, &brokenCode);
+
+bool Linked(GLuint program) {
+	GLint status = GL_FALSE;
+	if (program)
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+	return status == GL_TRUE;
+}
+
+bool Uniforms(GLuint program) {
+	// the uniform table was built at Get: lookups need no glGetUniformLocation
+	int n = Locations::n;
+	bool found = UniformLocation(program, "view") >= 0 && UniformLocation(program, "color") >= 0;
+	return found && Locations::n == n;
+}
+
+int main(int argc, char **argv) {
+	int nPrograms = argc > 1? atoi(argv[1]) : 8;
+	if (!TestContext()) {
+		printf("AsyncLinkTest: no GL context, skipped\n");
+		return testSkipped;
+	}
+	SetShaderCache(NULL);
+	Compiles::Install();
+	Links::Install();
+	Deletes::Install();
+	Locations::Install();
+	// several programs submitted at once, polled until ready, then each linked with its uniform table
+	vector<string> variants(nPrograms);
+	vector<const char *> codes(nPrograms);
+	vector<ProgramFuture> futures(nPrograms);
+	double start = Seconds();
+	for (int i = 0; i < nPrograms; i++) {
+		variants[i] = Variant(i);
+		codes[i] = variants[i].c_str();
+		futures[i] = LinkProgramAsync(&vertexCode, &codes[i]);
+	}
+	double submitted = Seconds();
+	int nPolls = 0, nReady = 0;
+	while (nReady < nPrograms && Seconds()-submitted < 30) {
+		nReady = 0;
+		for (ProgramFuture &f : futures)
+			nReady += f.Ready();
+		nPolls++;
+	}
+	double ready = Seconds();
+	Check(nReady == nPrograms, "every program ready");
+	bool linked = true, uniforms = true;
+	for (ProgramFuture &f : futures) {
+		GLuint p = f.Get();
+		linked = linked && Linked(p);
+		uniforms = uniforms && Uniforms(p);
+	}
+	double got = Seconds();
+	Check(Compiles::n == 2*nPrograms && Links::n == nPrograms, "one compile per shader, one link per program");
+	Check(linked, "Get returns linked program");
+	Check(uniforms, "Get builds uniform table");
+	printf("%d programs (%s): submit %.1f ms, ready after %d polls %.1f ms, all linked %.1f ms\n", nPrograms,
+		ParallelShaderCompile()? "parallel compile" : "no parallel compile", 1000*(submitted-start), nPolls,
+		1000*(ready-start), 1000*(got-start));
+	// a failed program: 0, deleted, and not compiled or linked again
+	ProgramFuture f = LinkProgramAsync(&vertexCode, &brokenCode);
+	GLuint failed = f.program;
+	int deletes = Deletes::n;
+	printf("expected errors follow:\n");
+	Check(f.Get() == 0 && Deletes::n == deletes+1 && !glIsProgram(failed), "broken program 0 and deleted");
+	int compiles = Compiles::n, links = Links::n;
+	Check(f.Get() == 0 && Compiles::n == compiles && Links::n == links && Deletes::n == deletes+1, "broken program not relinked");
+	// library programs: PrepareLibraryPrograms submits all but those not to prepare
+	PrepareLibraryPrograms();
+	Check(prepared.submitted && broken.submitted && !unprepared.submitted, "PrepareLibraryPrograms skips prepare=false");
+	Check(Linked(prepared.Get()) && Uniforms(prepared.Get()), "prepared program linked");
+	Check(Linked(unprepared.Get()) && unprepared.submitted, "unprepared program linked on Get");
+	compiles = Compiles::n;
+	links = Links::n;
+	deletes = Deletes::n;
+	Check(broken.Get() == 0 && Deletes::n == deletes+1, "broken library program 0 and deleted");
+	Check(broken.Get() == 0 && Compiles::n == compiles && Links::n == links && Deletes::n == deletes+1, "broken library program not relinked");
+	return TestResult("AsyncLinkTest");
+}
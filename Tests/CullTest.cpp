@@ -0,0 +1,184 @@
+// CullTest.cpp - frustum and occlusion culling along canned camera paths: culled counts, nothing visible culled (c) 2019-2022 Jules Bloomenthal
+// usage: CullTest [# boxes]  (default 4000)
+
+#include <float.h>
+#include "Cull.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+// occluder: a 30x12 wall in the z = 0 plane
+vector<vec3> wallPoints = {vec3(-15, 0, 0), vec3(15, 0, 0), vec3(15, 12, 0), vec3(-15, 12, 0)};
+vector<int3> wallTriangles = {int3(0, 1, 2), int3(0, 2, 3)};
+
+bool Hidden(vec3 eye, vec3 p, mat4 &fullview) {
+	// p is outside the frustum, or the wall is between eye and p
+	vec4 c = fullview*vec4(p, 1);
+	float w = 1.0001f*c.w;
+	if (c.w <= 0 || c.x < -w || c.x > w || c.y < -w || c.y > w || c.z < -w || c.z > w)
+		return true;
+	if ((eye.z > 0) == (p.z > 0) || p.z == 0)
+		return false;
+	vec3 q = eye+(eye.z/(eye.z-p.z))*(p-eye);
+	return q.x > -15 && q.x < 15 && q.y > 0 && q.y < 12;
+}
+
+bool Hidden(vec3 eye, vec3 min, vec3 max, mat4 &fullview) {
+	// corners and a 4x4 grid on each face are hidden
+	for (int axis = 0; axis < 3; axis++)
+		for (int side = 0; side < 2; side++)
+			for (int i = 0; i < 4; i++)
+				for (int j = 0; j < 4; j++) {
+					vec3 p;
+					int u = (axis+1)%3, v = (axis+2)%3;
+					p[axis] = side? max[axis] : min[axis];
+					p[u] = min[u]+(max[u]-min[u])*i/3.f;
+					p[v] = min[v]+(max[v]-min[v])*j/3.f;
+					if (!Hidden(eye, p, fullview))
+						return false;
+				}
+	return true;
+}
+
+CameraAB Camera(vec3 eye, vec3 lookAt) {
+	// 512x256 view from eye toward lookAt
+	CameraAB camera(0, 0, 512, 256, vec3(0, 0, 0), vec3(0, 0, 0), 40, .1f, 200);
+	camera.SetModelview(LookAt(eye, lookAt, vec3(0, 1, 0)));
+	return camera;
+}
+
+struct Path {
+	const char *name;
+	vec3 (*eye)(float t), (*lookAt)(float t);
+};
+
+int main(int argc, char **argv) {
+	int nBoxes = argc > 1? atoi(argv[1]) : 4000;
+	srand(1);
+	Boxes boxes;
+	for (int i = 0; i < nBoxes; i++) {
+		vec3 min(Random(-40, 40), Random(0, 10), Random(-60, 20)), size(Random(.2f, 1.5f), Random(.2f, 1.5f), Random(.2f, 1.5f));
+		boxes.Add(min, min+size);
+	}
+	Path paths[] = {
+		{"dolly toward wall", [](float t) { return vec3(0, 5, 60-55*t); }, [](float) { return vec3(0, 5, -30); }},
+		{"orbit", [](float t) { return vec3(50*sin(6.2832f*t), 6, 50*cos(6.2832f*t)); }, [](float) { return vec3(0, 4, 0); }},
+		{"strafe past wall", [](float t) { return vec3(-50+100*t, 3, 25); }, [](float t) { return vec3(-50+100*t, 3, -10); }}
+	};
+	HiZBuffer hiz;
+	vector<int> visible, occluded;
+	int nFrames = 60;
+	for (Path &path : paths) {
+		int nFrustumCulled = 0, nOccluded = 0, nDisagree = 0, nWrong = 0;
+		for (int f = 0; f < nFrames; f++) {
+			float t = (float) f/(nFrames-1);
+			vec3 eye = path.eye(t);
+			CameraAB camera = Camera(eye, path.lookAt(t));
+			mat4 fullview = camera.persp*camera.modelview;
+			// SIMD frustum test agrees with Frustum::Outside
+			Frustum frustum(fullview);
+			CullMeshes(camera, boxes, visible);
+			vector<int> expected;
+			for (int i = 0; i < nBoxes; i++) {
+				vec3 min, max;
+				boxes.Get(i, min, max);
+				if (!frustum.Outside(min, max))
+					expected.push_back(i);
+			}
+			nDisagree += visible != expected;
+			nFrustumCulled += nBoxes-(int) visible.size();
+			// boxes culled by occlusion are hidden by the wall
+			hiz.Clear();
+			hiz.Rasterize(wallPoints, wallTriangles, fullview);
+			hiz.BuildPyramid();
+			CullMeshes(camera, boxes, occluded, &hiz);
+			nOccluded += (int) (visible.size()-occluded.size());
+			for (size_t i = 0, j = 0; i < visible.size(); i++)
+				if (j < occluded.size() && occluded[j] == visible[i])
+					j++;
+				else {
+					vec3 min, max;
+					boxes.Get(visible[i], min, max);
+					nWrong += !Hidden(eye, min, max, fullview);
+				}
+		}
+		printf("%s, %d frames: %.0f of %d boxes culled by frustum, %.0f more by occlusion (per frame)\n",
+			path.name, nFrames, (float) nFrustumCulled/nFrames, nBoxes, (float) nOccluded/nFrames);
+		Check(nDisagree == 0, "SIMD frustum test matches Frustum::Outside");
+		Check(nWrong == 0, "occlusion culls only hidden boxes");
+		Check(nOccluded > 0 || path.eye(0).z < 0, "occlusion culls");
+	}
+	// boxes projecting beyond the int range, or to NaN, are kept
+	CameraAB camera = Camera(vec3(0, 5, 30), vec3(0, 5, 0));
+	mat4 fullview = camera.persp*camera.modelview;
+	hiz.Clear();
+	hiz.Rasterize(wallPoints, wallTriangles, fullview);
+	hiz.BuildPyramid();
+	Check(hiz.Visible(vec3(-1e12f, 4, 29.85f), vec3(1e12f, 5, 29.88f), fullview), "huge box kept");
+	Check(hiz.Visible(vec3(2e9f, 4, 29.89f), vec3(3e9f, 5, 29.895f), fullview), "box far off screen left to frustum test");
+	Check(hiz.Visible(vec3(NAN, NAN, NAN), vec3(NAN, NAN, NAN), fullview), "NaN box kept");
+	// Mesh::Display draws visibleGroups of the full mesh, of its meshlets, and of the selected LOD
+	// (Display needs a context; primitives are counted with a query)
+	if (TestContext()) {
+		Mesh mesh;
+		int res = 64;
+		for (int j = 0; j < res; j++)
+			for (int i = 0; i < res; i++)
+				mesh.points.push_back(vec3((float) i/(res-1), (float) j/(res-1), 0));
+		mesh.normals.assign(mesh.points.size(), vec3(0, 0, 1));
+		for (int j = 0; j < res-1; j++) {
+			if (j%16 == 0)
+				mesh.triangleGroups.push_back(Group((int) mesh.triangles.size()));
+			for (int i = 0; i < res-1; i++) {
+				int a = j*res+i, b = a+1, c = a+res, d = c+1;
+				mesh.triangles.push_back(int3(a, b, d));
+				mesh.triangles.push_back(int3(a, d, c));
+			}
+			mesh.triangleGroups.back().nTriangles = (int) mesh.triangles.size()-mesh.triangleGroups.back().startTriangle;
+		}
+		mesh.Buffer();
+		CameraAB camera = Camera(vec3(.2f, .3f, .6f), vec3(.2f, .3f, 0));
+		GLuint query;
+		glGenQueries(1, &query);
+		auto Drawn = [&]() {
+			GLuint n = 0;
+			glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+			mesh.Display(camera);
+			glEndQuery(GL_PRIMITIVES_GENERATED);
+			glGetQueryObjectuiv(query, GL_QUERY_RESULT, &n);
+			return (int) n;
+		};
+		vector<int> groups = {1, 3};
+		mesh.visibleGroups = &groups;
+		Check(Drawn() == mesh.triangleGroups[1].nTriangles+mesh.triangleGroups[3].nTriangles, "Display visible groups");
+		mesh.BuildMeshlets();
+		vector<GLsizei> counts;
+		vector<size_t> offsets;
+		CullMeshlets(mesh.meshlets, camera.modelview*mesh.transform, camera.persp, counts, offsets, false);
+		vector<char> drawn(mesh.triangles.size(), 0);
+		for (size_t i = 0; i < counts.size(); i++)
+			for (int t = 0; t < counts[i]/3; t++)
+				drawn[offsets[i]/sizeof(int3)+t] = 1;
+		int nExpected = 0, nMeshlets = 0;
+		for (int g : groups)
+			for (int t = mesh.triangleGroups[g].startTriangle; t < mesh.triangleGroups[g].startTriangle+mesh.triangleGroups[g].nTriangles; t++)
+				nExpected += drawn[t];
+		for (char d : drawn)
+			nMeshlets += d;
+		Check(Drawn() == nExpected && nExpected < nMeshlets, "Display visible groups of visible meshlets");
+		mesh.BuildLODs({.25f});
+		mesh.lodPixelError = 1e6f;
+		camera = Camera(vec3(.5f, .5f, 3), vec3(.5f, .5f, 0));
+		Check(Drawn() == mesh.lods[0].triangleGroups[1].nTriangles+mesh.lods[0].triangleGroups[3].nTriangles, "Display visible groups of LOD");
+		glDeleteQueries(1, &query);
+	}
+	// times
+	CameraAB c = Camera(vec3(0, 5, 40), vec3(0, 5, -30));
+	fullview = c.persp*c.modelview;
+	double tFrustum = BestTime([&]() { CullMeshes(c, boxes, visible); });
+	double tRasterize = BestTime([&]() { hiz.Clear(); hiz.Rasterize(wallPoints, wallTriangles, fullview); hiz.BuildPyramid(); });
+	double tOcclusion = BestTime([&]() { CullMeshes(c, boxes, visible, &hiz); });
+	printf("%d boxes: frustum %.0f us, hiz rasterize and pyramid %.0f us, frustum and occlusion %.0f us\n",
+		nBoxes, 1e6*tFrustum, 1e6*tRasterize, 1e6*tOcclusion);
+	return TestResult("CullTest");
+}
@@ -0,0 +1,140 @@
+// DrawBatchTest.cpp - batched drawing: same pixels as immediate, one draw per bucket; GL calls and times (c) 2019-2022 Jules Bloomenthal
+// usage: DrawBatchTest [# disks and lines]  (default 10000 of each)
+
+#include <string.h>
+#include <vector>
+#include "Draw.h"
+#include "GLXtras.h"
+#include "Test.h"
+
+using std::vector;
+
+// GL shim: glad's pointers for the calls Draw makes are replaced by counting thunks
+
+int nCalls = 0;
+
+template <auto &slot, class F = std::remove_reference_t<decltype(slot)>> struct Count;
+
+template <auto &slot, class R, class... A> struct Count<slot, R (APIENTRYP)(A...)> {
+	static inline R (APIENTRYP real)(A...) = NULL;
+	static inline int n = 0;
+	static R APIENTRY Thunk(A... a) { n++; nCalls++; return real(a...); }
+	static void Install() { real = slot; slot = Thunk; }
+};
+
+typedef Count<glad_glDrawArrays> Draws;
+
+void Shim() {
+	Draws::Install();
+	Count<glad_glUseProgram>::Install();
+	Count<glad_glUniform1i>::Install();
+	Count<glad_glUniform1f>::Install();
+	Count<glad_glUniform4fv>::Install();
+	Count<glad_glUniformMatrix4fv>::Install();
+	Count<glad_glGetAttribLocation>::Install();
+	Count<glad_glEnableVertexAttribArray>::Install();
+	Count<glad_glVertexAttribPointer>::Install();
+	Count<glad_glBindBuffer>::Install();
+	Count<glad_glMapBufferRange>::Install();
+	Count<glad_glUnmapBuffer>::Install();
+	Count<glad_glBufferSubData>::Install();
+	Count<glad_glPointSize>::Install();
+	Count<glad_glLineWidth>::Install();
+	Count<glad_glEnable>::Install();
+	Count<glad_glBlendFunc>::Install();
+	Count<glad_glGetFloatv>::Install();
+	Count<glad_glGetIntegerv>::Install();
+	Count<glad_glFenceSync>::Install();
+	Count<glad_glClientWaitSync>::Install();
+}
+
+// drawing
+
+const int size = 256;
+
+void Grid(int n) {
+	// n by n cells, each with a disk, a line and a triangle apart from one another and from other cells
+	float cell = (float) size/n;
+	for (int j = 0; j < n; j++)
+		for (int i = 0; i < n; i++) {
+			float x = i*cell, y = j*cell;
+			vec3 c((float) i/n, (float) j/n, .5f);
+			Disk(vec2(x+.25f*cell, y+.25f*cell), (i+j)%2? 4.f : 6.f, c);
+			Line(vec2(x+.5f*cell, y+.1f*cell), vec2(x+.9f*cell, y+.4f*cell), 1+(float) (i%2), vec3(1, 1, 1)-c);
+			Triangle(vec3(x+.1f*cell, y+.6f*cell, 0), vec3(x+.4f*cell, y+.6f*cell, 0), vec3(x+.25f*cell, y+.9f*cell, 0), c, c, c, j%2? 1.f : .5f);
+		}
+}
+
+vector<unsigned char> Pixels(void (*draw)()) {
+	// draw into a cleared framebuffer, read it back
+	vector<unsigned char> pixels(4*size*size);
+	glClearColor(0, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT);
+	mat4 screen = ScreenMode();
+	UseTriangleShader(screen);
+	UseDrawShader(screen);
+	draw();
+	glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 10000;
+	if (!TestContext(size, size)) {
+		printf("DrawBatchTest: no GL context, skipped\n");
+		return testSkipped;
+	}
+	Shim();
+	GLuint vao;
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glViewport(0, 0, size, size);
+	// a grid of separate primitives looks the same batched as drawn immediately
+	vector<unsigned char> immediate = Pixels([]() { Grid(16); });
+	vector<unsigned char> batched = Pixels([]() { BeginDrawBatch(); Grid(16); EndDrawBatch(); });
+	int nDifferent = 0, nLit = 0;
+	for (int i = 0; i < 4*size*size; i += 4) {
+		nDifferent += memcmp(&immediate[i], &batched[i], 3) != 0;
+		nLit += immediate[i] || immediate[i+1] || immediate[i+2];
+	}
+	Check(nLit > 0 && nDifferent == 0, "batched pixels same as immediate");
+	// a flush draws once per bucket: disks of 2 diameters, lines of 2 widths, triangles of 2 opacities
+	BeginDrawBatch();
+	Grid(16);
+	int draws = Draws::n;
+	FlushDrawBatch();
+	Check(Draws::n-draws == 6, "one draw per bucket");
+	draws = Draws::n;
+	Grid(4);
+	EndDrawBatch();
+	Check(Draws::n-draws == 6, "one draw per bucket, next flush");
+	// times: n disks and n lines per frame, immediate and batched
+	vector<vec2> points(n);
+	for (int i = 0; i < n; i++)
+		points[i] = vec2((float) (i*37%size), (float) (i*53%size));
+	auto Frame = [&](bool batch) {
+		UseDrawShader(ScreenMode());
+		if (batch)
+			BeginDrawBatch();
+		for (int i = 0; i < n; i++) {
+			Disk(points[i], 3, vec3(1, 0, 0));
+			Line(points[i], points[(i+1)%n], 1, vec3(0, 1, 0));
+		}
+		if (batch)
+			EndDrawBatch();
+		glFinish();
+	};
+	int calls[2];
+	double times[2];
+	for (int batch = 0; batch < 2; batch++) {
+		Frame(batch == 1);
+		int c = nCalls;
+		Frame(batch == 1);
+		calls[batch] = nCalls-c;
+		times[batch] = BestTime([&]() { Frame(batch == 1); });
+	}
+	printf("%d disks and %d lines per frame: immediate %d GL calls, %.1f ms; batched %d GL calls, %.1f ms\n",
+		n, n, calls[0], 1000*times[0], calls[1], 1000*times[1]);
+	glDeleteVertexArrays(1, &vao);
+	return TestResult("DrawBatchTest");
+}
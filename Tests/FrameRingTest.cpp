@@ -0,0 +1,114 @@
+// FrameRingTest.cpp - frame ring wraparound: fenced regions never overwrite data the GPU has yet to read; times (c) 2019-2022 Jules Bloomenthal
+// usage: FrameRingTest [# writes]  (default 20000)
+
+#include <vector>
+#include "FrameRing.h"
+#include "Test.h"
+#ifdef FREETYPE_OK
+#include "Text.h"
+#endif
+
+// GL shim: glad's sync pointers are wrapped to record each fence, the region it fenced, and whether it was waited on
+
+struct Fence { GLsync sync; int region; bool waited; };
+std::vector<Fence> fences;
+int writeRegion = 0;
+PFNGLFENCESYNCPROC fenceSync;
+PFNGLCLIENTWAITSYNCPROC clientWaitSync;
+
+void Shim() {
+	fenceSync = glad_glFenceSync;
+	clientWaitSync = glad_glClientWaitSync;
+	glad_glFenceSync = [](GLenum c, GLbitfield f) { GLsync s = fenceSync(c, f); fences.push_back({s, writeRegion, false}); return s; };
+	glad_glClientWaitSync = [](GLsync s, GLbitfield f, GLuint64 t) {
+		for (Fence &fence : fences)
+			if (fence.sync == s)
+				fence.waited = true;
+		return clientWaitSync(s, f, t);
+	};
+}
+
+bool Unwaited(int region) {
+	// a fence set when region was last left, not waited on
+	for (Fence &f : fences)
+		if (f.region == region && !f.waited)
+			return true;
+	return false;
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 20000;
+	if (!TestContext()) {
+		printf("FrameRingTest: no GL context, skipped\n");
+		return testSkipped;
+	}
+	Shim();
+	// each write is copied by the GPU (glCopyBufferSubData, queued behind the write) to its own place
+	// in a check buffer; if a region were reused before the GPU read it, a copy would see later data
+	const size_t regionSize = 4096, chunk = 1000;
+	FrameRingSize(regionSize);
+	GLuint check;
+	glGenBuffers(1, &check);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, check);
+	glBufferData(GL_COPY_WRITE_BUFFER, n*chunk, NULL, GL_STATIC_READ);
+	std::vector<unsigned char> data(chunk);
+	int nMisaligned = 0, nOutside = 0, nUnwaited = 0;
+	FrameRingStats before = GetFrameRingStats();
+	for (int i = 0; i < n; i++) {
+		for (size_t k = 0; k < chunk; k++)
+			data[k] = (unsigned char) (i*7+k);
+		GLintptr offset = FrameRingWrite(data.data(), chunk);
+		nMisaligned += offset%16 != 0;
+		nOutside += offset%regionSize+chunk > regionSize;
+		nUnwaited += Unwaited(writeRegion = (int) (offset/regionSize));
+		if (fences.size() > 100)
+			fences.erase(fences.begin(), fences.end()-10);
+		glBindBuffer(GL_COPY_READ_BUFFER, FrameRingBuffer());
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, (GLintptr) i*chunk, chunk);
+		if (i%10 == 9)
+			FrameRingEndFrame();
+	}
+	FrameRingStats after = GetFrameRingStats();
+	std::vector<unsigned char> copies(n*chunk);
+	glGetBufferSubData(GL_COPY_WRITE_BUFFER, 0, n*chunk, copies.data());
+	int nBad = 0;
+	for (int i = 0; i < n; i++)
+		for (size_t k = 0; k < chunk; k++)
+			nBad += copies[i*chunk+k] != (unsigned char) (i*7+k);
+	int wraps = after.wraps-before.wraps;
+	Check(nMisaligned == 0 && nOutside == 0, "writes aligned, within a region");
+	Check(wraps > n/20, "ring wraps");
+	Check(nUnwaited == 0, "region re-entered only after its fence is waited on");
+	Check(nBad == 0, "GPU reads what was written, across wraps");
+	// a write larger than a region grows the ring
+	std::vector<unsigned char> big(3*regionSize, 42);
+	GLintptr offset = FrameRingWrite(big.data(), big.size());
+	std::vector<unsigned char> back(big.size());
+	glBindBuffer(GL_COPY_READ_BUFFER, FrameRingBuffer());
+	glFinish();
+	glGetBufferSubData(GL_COPY_READ_BUFFER, offset, back.size(), back.data());
+	Check(GetFrameRingStats().grows == after.grows+1 && back == big, "ring grows");
+#ifdef FREETYPE_OK
+	// RenderText unbinds the vertex array object, whether or not there is text
+	GLuint vao;
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	SetFont("no such font");
+	RenderText("", 0, 0, vec3(1, 1, 1), 1, mat4());
+	GLint bound = -1;
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &bound);
+	Check(bound == 0, "RenderText of empty text unbinds vertex array");
+	glDeleteVertexArrays(1, &vao);
+#endif
+	glDeleteBuffers(1, &check);
+	// times: writes of one chunk, with and without a GPU read of each
+	FrameRingSize(1 << 20);
+	int nTimed = 10000;
+	double tWrite = BestTime([&]() { for (int i = 0; i < nTimed; i++) FrameRingWrite(data.data(), chunk); glFinish(); });
+	FrameRingStats s = GetFrameRingStats();
+	printf("%d writes of %d bytes (%s), %d wraps, %d fence waits; write %.2f us (%.0f MB/s)\n",
+		n, (int) chunk, FrameRingPersistent()? "persistent" : "unsynchronized map", wraps, after.fenceWaits-before.fenceWaits,
+		1e6*tWrite/nTimed, chunk*nTimed/tWrite/1e6);
+	printf("total: %d writes, %d region changes, %d wraps, %d fence waits, %d grows\n", s.writes, s.regionChanges, s.wraps, s.fenceWaits, s.grows);
+	return TestResult("FrameRingTest");
+}
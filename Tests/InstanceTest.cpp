@@ -0,0 +1,118 @@
+// InstanceTest.cpp - DisplayInstanced draws the selected LOD, keeps instances across Buffer; submission times (c) 2019-2022 Jules Bloomenthal
+// usage: InstanceTest [# instances]  (default 2000)
+
+#include "GLXtras.h"
+#include "Mesh.h"
+#include "Test.h"
+
+void Grid(Mesh &mesh, int res) {
+	// res*res unit grid in the z = 0 plane, with normals and uvs
+	for (int j = 0; j < res; j++)
+		for (int i = 0; i < res; i++) {
+			mesh.points.push_back(vec3((float) i/(res-1), (float) j/(res-1), 0));
+			mesh.uvs.push_back(vec2((float) i/(res-1), (float) j/(res-1)));
+		}
+	mesh.normals.assign(mesh.points.size(), vec3(0, 0, 1));
+	for (int j = 0; j < res-1; j++)
+		for (int i = 0; i < res-1; i++) {
+			int a = j*res+i, b = a+1, c = a+res, d = c+1;
+			mesh.triangles.push_back(int3(a, b, d));
+			mesh.triangles.push_back(int3(a, d, c));
+		}
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 2000;
+	if (!TestContext(512, 512)) {
+		printf("InstanceTest: no GL context, skipped\n");
+		return testSkipped;
+	}
+	Mesh mesh;
+	Grid(mesh, 8);
+	mesh.Buffer();
+	vector<mat4> transforms(n);
+	for (int i = 0; i < n; i++)
+		transforms[i] = Translate((float) (i%50)-25, (float) (i/50)-20, 0)*Scale(.8f, .8f, 2);
+	mesh.SetInstances(transforms);
+	mesh.transform = Translate(0, 0, -60);
+	CameraAB camera(0, 0, 512, 512, vec3(0, 0, 0), vec3(0, 0, 0), 60, .1f, 200);
+	camera.SetModelview(mat4());
+	GLuint query;
+	glGenQueries(1, &query);
+	auto Drawn = [&](auto draw) {
+		GLuint count = 0;
+		glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+		draw();
+		glEndQuery(GL_PRIMITIVES_GENERATED);
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT, &count);
+		return (int) count;
+	};
+	auto Instanced = [&]() { mesh.DisplayInstanced(camera); };
+	int nTris = (int) mesh.triangles.size();
+	Check(Drawn(Instanced) == n*nTris, "DisplayInstanced draws all instances");
+	// a later Buffer reuses the vertex array object and keeps the instance attributes
+	GLuint vao = mesh.vao;
+	mesh.Buffer();
+	GLint divisor = 0, buffer = 0;
+	glBindVertexArray(mesh.vao);
+	glGetVertexAttribiv(3, GL_VERTEX_ATTRIB_ARRAY_DIVISOR, &divisor);
+	glGetVertexAttribiv(7, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buffer);
+	glBindVertexArray(0);
+	Check(mesh.vao == vao && divisor == 1 && buffer == (GLint) mesh.iBufferId, "instances kept across Buffer");
+	Check(Drawn(Instanced) == n*nTris, "DisplayInstanced after Buffer");
+	// a destroyed mesh frees its buffers and vertex array
+	GLuint ids[4];
+	{
+		Mesh temp;
+		Grid(temp, 2);
+		temp.Buffer();
+		temp.SetInstances(transforms);
+		ids[0] = temp.vBufferId; ids[1] = temp.eBufferId; ids[2] = temp.iBufferId; ids[3] = temp.vao;
+	}
+	Check(!glIsBuffer(ids[0]) && !glIsBuffer(ids[1]) && !glIsBuffer(ids[2]) && !glIsVertexArray(ids[3]), "~Mesh deletes buffers");
+	// the LOD Display selects
+	mesh.BuildLODs({.25f});
+	mesh.lodPixelError = 1e6f;
+	int lod = mesh.SelectLOD(camera, 512);
+	Check(lod == 0 && Drawn(Instanced) == n*(int) mesh.lods[0].triangles.size(), "DisplayInstanced draws selected LOD");
+	mesh.lods.clear();
+	mesh.Buffer();
+	// an app-set useTexture = false is respected, as by Display (if the shader links)
+	GLuint shader = UseMeshShader(), texture;
+	GLint linked = 0;
+	glGetProgramiv(shader, GL_LINK_STATUS, &linked);
+	glGenTextures(1, &texture);
+	mesh.textureName = texture;
+	if (linked) {
+		GLint useTexture = 1;
+		SetUniform(shader, "useTexture", false);
+		mesh.DisplayInstanced(camera);
+		glGetUniformiv(shader, UniformLocation(shader, "useTexture"), &useTexture);
+		Check(useTexture == 0, "DisplayInstanced respects useTexture");
+	}
+	else
+		printf("mesh shader didn't link, useTexture not checked\n");
+	mesh.textureName = 0;
+	glDeleteTextures(1, &texture);
+	glDeleteQueries(1, &query);
+	// times: n Display calls vs one DisplayInstanced, submission alone and through glFinish
+	mat4 transform = mesh.transform;
+	auto Separate = [&]() {
+		for (int i = 0; i < n; i++) {
+			mesh.transform = transform*transforms[i];
+			mesh.Display(camera);
+		}
+		mesh.transform = transform;
+	};
+	glFinish();
+	double tSeparate = BestTime(Separate);
+	glFinish();
+	double tInstanced = BestTime(Instanced);
+	glFinish();
+	double tSeparateFinish = BestTime([&]() { Separate(); glFinish(); });
+	double tInstancedFinish = BestTime([&]() { Instanced(); glFinish(); });
+	printf("%d instances of %d triangles: submit %d Display calls %.2f ms, DisplayInstanced %.3f ms\n",
+		n, nTris, n, 1000*tSeparate, 1000*tInstanced);
+	printf("with glFinish: %.1f ms, %.1f ms\n", 1000*tSeparateFinish, 1000*tInstancedFinish);
+	return TestResult("InstanceTest");
+}
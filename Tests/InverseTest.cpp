@@ -0,0 +1,222 @@
+// InverseTest.cpp - Invert, InvertAffine, InvertRigid and NormalMatrix against InverseMatrix4x4, ScreenLine against double precision; times (c) 2019-2022 Jules Bloomenthal
+// usage: InverseTest [# matrices]  (default 4096)
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "CameraArcball.h"
+#include "Draw.h"
+#include "Test.h"
+
+using std::vector;
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+mat4 RandomRigid() {
+	return Translate(Random(-10, 10), Random(-10, 10), Random(-10, 10))*RotateX(Random(0, 360))*RotateY(Random(0, 360))*RotateZ(Random(0, 360));
+}
+
+mat4 RandomAffine() {
+	// non-uniform scale, possibly a reflection
+	float sx = Random(.1f, 5), sy = Random(.1f, 5), sz = Random(.1f, 5);
+	return RandomRigid()*Scale(rand()%2? sx : -sx, sy, rand()%3? sz : -sz)*RotateY(Random(0, 360));
+}
+
+// reference: the inverse Invert used before, and the inverse transpose of the upper 3x3
+
+mat4 OldInvert(mat4 m) {
+	mat4 inv;
+	InverseMatrix4x4(&m[0][0], &inv[0][0]);
+	return inv;
+}
+
+mat3 InverseTranspose(const mat4 &m) {
+	mat4 t = Transpose(OldInvert(m));
+	return mat3(vec3(t[0].x, t[0].y, t[0].z), vec3(t[1].x, t[1].y, t[1].z), vec3(t[2].x, t[2].y, t[2].z));
+}
+
+double Residual(const mat4 &m, const mat4 &inv) {
+	// largest element of |m*inv-identity|, in double
+	double e = 0;
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++) {
+			double s = 0;
+			for (int k = 0; k < 4; k++)
+				s += (double) m[i][k]*inv[k][j];
+			e = fmax(e, fabs(s-(i == j)));
+		}
+	return e;
+}
+
+struct Accuracy {
+	double residual = 0, oldResidual = 0;
+	void Add(const mat4 &m, const mat4 &inv) {
+		residual = fmax(residual, Residual(m, inv));
+		oldResidual = fmax(oldResidual, Residual(m, OldInvert(m)));
+	}
+};
+
+bool Invert(double m[4][4], double inv[4][4]) {
+	// Gauss-Jordan, partial pivoting
+	double a[4][8];
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++) {
+			a[i][j] = m[i][j];
+			a[i][j+4] = i == j;
+		}
+	for (int c = 0; c < 4; c++) {
+		int p = c;
+		for (int r = c+1; r < 4; r++)
+			if (fabs(a[r][c]) > fabs(a[p][c]))
+				p = r;
+		if (a[p][c] == 0)
+			return false;
+		for (int j = 0; j < 8; j++)
+			std::swap(a[c][j], a[p][j]);
+		for (int r = 0; r < 4; r++)
+			if (r != c) {
+				double f = a[r][c]/a[c][c];
+				for (int j = 0; j < 8; j++)
+					a[r][j] -= f*a[c][j];
+			}
+	}
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			inv[i][j] = a[i][j+4]/a[i][i];
+	return true;
+}
+
+void ReferenceLine(float x, float y, const mat4 &modelview, const mat4 &persp, double p1[3], double p2[3]) {
+	// as ScreenLine before (gluUnProject at depths .25 and .5), in double precision
+	int vp[4];
+	double m[4][4], inv[4][4];
+	glGetIntegerv(GL_VIEWPORT, vp);
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++) {
+			m[i][j] = 0;
+			for (int k = 0; k < 4; k++)
+				m[i][j] += (double) persp[i][k]*modelview[k][j];
+		}
+	Invert(m, inv);
+	double *p[] = {p1, p2}, depth[] = {.25, .5};
+	for (int k = 0; k < 2; k++) {
+		double ndc[] = {2*(x-vp[0])/vp[2]-1, 2*(y-vp[1])/vp[3]-1, 2*depth[k]-1, 1}, w[4];
+		for (int i = 0; i < 4; i++)
+			w[i] = inv[i][0]*ndc[0]+inv[i][1]*ndc[1]+inv[i][2]*ndc[2]+inv[i][3]*ndc[3];
+		for (int i = 0; i < 3; i++)
+			p[k][i] = w[i]/w[3];
+	}
+}
+
+double LineDistance(const double p[3], vec3 p1, vec3 p2) {
+	// distance from p to the line through p1, p2
+	double d[3], a[3] = {p[0]-p1.x, p[1]-p1.y, p[2]-p1.z}, len = 0;
+	for (int i = 0; i < 3; i++) {
+		d[i] = p2[i]-p1[i];
+		len += d[i]*d[i];
+	}
+	double c[3] = {a[1]*d[2]-a[2]*d[1], a[2]*d[0]-a[0]*d[2], a[0]*d[1]-a[1]*d[0]};
+	return sqrt((c[0]*c[0]+c[1]*c[1]+c[2]*c[2])/len);
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 4096;
+	srand(1);
+	// accuracy: general (random, and persp*modelview as for ScreenLine), affine and rigid inverses
+	Accuracy general, view, affine, rigid;
+	float maxNormalError = 0;
+	int nReversed = 0;
+	for (int t = 0; t < 100000; t++) {
+		mat4 g;
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				g[i][j] = Random(-1, 1);
+		if (fabs(OldInvert(g)[0][0]) < 1000)		// skip near-singular
+			general.Add(g, Invert(g));
+		mat4 v = Perspective(Random(20, 60), Random(.5f, 2), .001f, 500)*RandomRigid(), a = RandomAffine(), r = RandomRigid();
+		view.Add(v, Invert(v));
+		affine.Add(a, InvertAffine(a));
+		rigid.Add(r, InvertRigid(r));
+		// normal matrix: same direction as the inverse transpose, including reflections
+		vec3 nrm(Random(-1, 1), Random(-1, 1), Random(-1, 1)), p = NormalMatrix(a)*nrm, q = InverseTranspose(a)*nrm;
+		maxNormalError = fmax(maxNormalError, length(normalize(p)-normalize(q)));
+		nReversed += dot(p, q) < 0;
+	}
+	printf("largest |m*inverse-identity|, new vs InverseMatrix4x4:\n");
+	printf("  general %.1e, %.1e; persp*modelview %.1e, %.1e; affine %.1e, %.1e; rigid %.1e, %.1e\n",
+		general.residual, general.oldResidual, view.residual, view.oldResidual,
+		affine.residual, affine.oldResidual, rigid.residual, rigid.oldResidual);
+	Check(general.residual < 4*general.oldResidual+1e-5, "Invert as accurate as InverseMatrix4x4 (random)");
+	Check(view.residual < 4*view.oldResidual+1e-5, "Invert as accurate as InverseMatrix4x4 (persp*modelview)");
+	Check(affine.residual < 1e-4 && affine.residual < 4*affine.oldResidual+1e-5, "InvertAffine");
+	Check(rigid.residual < 1e-5, "InvertRigid");
+	Check(nReversed == 0 && maxNormalError < 1e-5f, "NormalMatrix proportional to inverse transpose, det > 0 or < 0");
+	vec3 mirrored = NormalMatrix(Scale(-1, 1, 1))*vec3(1, 0, 0);
+	Check(mirrored.x < 0 && mirrored.y == 0 && mirrored.z == 0, "NormalMatrix of reflection maps +x face normal to -x");
+	mat4 id, inv = Invert(mat4(0));
+	Check(!memcmp(&inv, &id, sizeof(mat4)) && !memcmp(&(inv = InvertAffine(mat4(0))), &id, sizeof(mat4)), "singular inverts to identity");
+	// cache: recomputed only if the source changes
+	int nComputed = 0;
+	MatrixCache<mat4> cache;
+	auto counted = [&nComputed](const mat4 &m) { nComputed++; return Invert(m); };
+	mat4 m1 = RandomAffine(), m2 = RandomAffine();
+	cache.Get(m1, counted); cache.Get(m1, counted); cache.Get(m2, counted); cache.Get(m2, counted);
+	Check(nComputed == 2, "MatrixCache recomputes only after a change");
+	// ScreenLine with the inverse, or the camera, against a double precision unproject: distances
+	// from a point on the reference line, at the scene's distance from the eye, to the float lines
+	bool gl = TestContext(640, 480) != NULL;
+	if (!gl)
+		printf("InverseTest: no GL context, ScreenLine not tested\n");
+	double tRefLine = 0, tLine = 0;
+	if (gl) {
+		glViewport(0, 0, 640, 480);
+		CameraAB camera(0, 0, 640, 480, vec3(15, -25, 0), vec3(0, 0, -5));
+		double maxDistance = 0, maxRounded = 0;
+		float maxPixel = 0, maxRoundedPixel = 0;
+		for (int t = 0; t < 1000; t++) {
+			float x = Random(0, 640), y = Random(0, 480);
+			double r1[3], r2[3], d = 0, p[3];
+			ReferenceLine(x, y, camera.modelview, camera.persp, r1, r2);
+			for (int k = 0; k < 3; k++)
+				d += (r2[k]-r1[k])*(r2[k]-r1[k]);
+			for (int k = 0; k < 3; k++)
+				p[k] = r1[k]+5*(r2[k]-r1[k])/sqrt(d);
+			vec3 a1((float) r1[0], (float) r1[1], (float) r1[2]), a2((float) r2[0], (float) r2[1], (float) r2[2]);
+			vec3 b1, b2, c1, c2;
+			ScreenLine(x, y, camera.modelview, camera.persp, b1, b2);
+			ScreenLine(x, y, camera, c1, c2);
+			maxDistance = fmax(maxDistance, fmax(LineDistance(p, b1, b2), LineDistance(p, c1, c2)));
+			maxRounded = fmax(maxRounded, LineDistance(p, a1, a2));
+			vec2 s = ScreenPoint(c2, camera.fullview), r = ScreenPoint(a2, camera.fullview);
+			maxPixel = fmax(maxPixel, fmax(fabs(s.x-x), fabs(s.y-y)));
+			maxRoundedPixel = fmax(maxRoundedPixel, fmax(fabs(r.x-x), fabs(r.y-y)));
+		}
+		printf("ScreenLine: distance from reference line %.1e (reference rounded to float %.1e), reprojection %.2f pixels (%.2f)\n",
+			maxDistance, maxRounded, maxPixel, maxRoundedPixel);
+		Check(maxDistance < 4*maxRounded, "ScreenLine as accurate as gluUnProject rounded to float");
+		Check(maxPixel < 4*maxRoundedPixel, "ScreenLine points project to the pixel, as well as gluUnProject's");
+		vec3 p1, p2;
+		double r1[3], r2[3];
+		tRefLine = BestTime([&]() { for (int i = 0; i < 1000; i++) ReferenceLine((float) i, 100, camera.modelview, camera.persp, r1, r2); })/1000;
+		tLine = BestTime([&]() { for (int i = 0; i < 1000; i++) ScreenLine((float) i, 100, camera, p1, p2); })/1000;
+	}
+	// times, per matrix
+	vector<mat4> views(n), affines(n), out(n);
+	vector<mat3> normals(n);
+	for (int i = 0; i < n; i++) {
+		views[i] = Perspective(40, 1.3f, .1f, 100)*RandomAffine();
+		affines[i] = RandomAffine();
+	}
+	double tOld = BestTime([&]() { for (int i = 0; i < n; i++) out[i] = OldInvert(views[i]); })/n;
+	double tInvert = BestTime([&]() { for (int i = 0; i < n; i++) out[i] = Invert(views[i]); })/n;
+	double tAffine = BestTime([&]() { for (int i = 0; i < n; i++) out[i] = InvertAffine(affines[i]); })/n;
+	double tRigid = BestTime([&]() { for (int i = 0; i < n; i++) out[i] = InvertRigid(affines[i]); })/n;
+	double tOldNormal = BestTime([&]() { for (int i = 0; i < n; i++) normals[i] = InverseTranspose(affines[i]); })/n;
+	double tNormal = BestTime([&]() { for (int i = 0; i < n; i++) normals[i] = NormalMatrix(affines[i]); })/n;
+	printf("%d matrices, ns: InverseMatrix4x4 %.1f, Invert %.1f, InvertAffine %.1f, InvertRigid %.1f\n",
+		n, 1e9*tOld, 1e9*tInvert, 1e9*tAffine, 1e9*tRigid);
+	printf("  normal matrix: transposed inverse %.1f, NormalMatrix %.1f\n", 1e9*tOldNormal, 1e9*tNormal);
+	if (gl)
+		printf("  ScreenLine: double precision unproject %.1f, camera's inverse %.1f\n", 1e9*tRefLine, 1e9*tLine);
+	return TestResult("InverseTest");
+}
@@ -0,0 +1,166 @@
+// MeshCacheTest.cpp - binary mesh cache round trip, staleness and malformed files; load times (c) 2019-2022 Jules Bloomenthal
+// usage: MeshCacheTest [grid resolution]  (default 400)
+
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include "Mesh.h"
+#include "Misc.h"
+#include "Test.h"
+
+struct CacheHeader {
+	// mirrors MeshCacheHeader in Mesh.cpp, to corrupt a cache
+	char magic[8];
+	long long sourceModified, mtlModified;
+	int normalized, nPoints, nNormals, nUvs, nTriangles, nQuads, nGroups, nMtls, mtlLibLength;
+	long long offsets[9];
+};
+
+struct MeshData {
+	vector<vec3> points, normals;
+	vector<int3> triangles;
+	vector<vec2> uvs;
+	vector<Group> groups;
+	vector<Mtl> mtls;
+	vector<int4> quads;
+	bool Read(const char *cache, time_t modified) {
+		return ReadMeshCache(cache, modified, false, points, triangles, &normals, &uvs, &groups, &mtls, &quads);
+	}
+};
+
+template <class T> bool Same(vector<T> &a, vector<T> &b) {
+	return a.size() == b.size() && (a.empty() || !memcmp(a.data(), b.data(), a.size()*sizeof(T)));
+}
+
+bool Same(MeshData &a, MeshData &b) {
+	bool groups = a.groups.size() == b.groups.size(), mtls = a.mtls.size() == b.mtls.size();
+	for (size_t i = 0; groups && i < a.groups.size(); i++)
+		groups = a.groups[i].name == b.groups[i].name && a.groups[i].startTriangle == b.groups[i].startTriangle &&
+				 a.groups[i].nTriangles == b.groups[i].nTriangles;
+	for (size_t i = 0; mtls && i < a.mtls.size(); i++)
+		mtls = a.mtls[i].name == b.mtls[i].name && a.mtls[i].nTriangles == b.mtls[i].nTriangles &&
+			   !memcmp(&a.mtls[i].kd, &b.mtls[i].kd, sizeof(vec3));
+	return groups && mtls && Same(a.points, b.points) && Same(a.normals, b.normals) && Same(a.uvs, b.uvs) &&
+		   Same(a.triangles, b.triangles) && Same(a.quads, b.quads);
+}
+
+vector<char> ReadBytes(const char *filename) {
+	vector<char> bytes;
+	if (FILE *f = fopen(filename, "rb")) {
+		fseek(f, 0, SEEK_END);
+		bytes.resize(ftell(f));
+		fseek(f, 0, SEEK_SET);
+		bytes.resize(fread(bytes.data(), 1, bytes.size(), f));
+		fclose(f);
+	}
+	return bytes;
+}
+
+void WriteBytes(const char *filename, vector<char> &bytes) {
+	FILE *f = fopen(filename, "wb");
+	fwrite(bytes.data(), 1, bytes.size(), f);
+	fclose(f);
+}
+
+void WriteMtl(const char *filename, float red, time_t modified) {
+	FILE *f = fopen(filename, "w");
+	fprintf(f, "newmtl red\nKd %g 0.1 0.1\nnewmtl blue\nKd 0.1 0.1 0.8\n", red);
+	fclose(f);
+	struct utimbuf times = {modified, modified};
+	utime(filename, &times);
+}
+
+void WriteGrid(const char *filename, const char *mtlName, int res) {
+	// res*res grid: v/vt/vn per vertex, two groups and materials, triangles and a row of quads
+	FILE *f = fopen(filename, "w");
+	fprintf(f, "mtllib %s\n", mtlName);
+	for (int j = 0; j < res; j++)
+		for (int i = 0; i < res; i++) {
+			float x = (float) i/(res-1), y = (float) j/(res-1);
+			fprintf(f, "v %g %g %.6f\nvt %g %g\nvn 0 0 1\n", x, y, .1f*sin(20*x)*cos(17*y), x, y);
+		}
+	for (int j = 0; j < res-1; j++) {
+		if (j == 0 || j == res/2)
+			fprintf(f, "g half%d\nusemtl %s\n", j? 2 : 1, j? "blue" : "red");
+		for (int i = 0; i < res-1; i++) {
+			int a = j*res+i+1, b = a+1, c = a+res, d = c+1;
+			if (j == res-2)
+				fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, d, d, d, c, c, c);
+			else
+				fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d\nf %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, d, d, d, a, a, a, d, d, d, c, c, c);
+		}
+	}
+	fclose(f);
+}
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 400;
+	std::string obj = TempFile("MeshCacheTest.obj"), mtl = TempFile("MeshCacheTest.mtl"), cache = MeshCacheName(obj);
+	WriteGrid(obj.c_str(), "MeshCacheTest.mtl", res);
+	WriteMtl(mtl.c_str(), .8f, time(NULL)-100);
+	remove(cache.c_str());
+	// Mesh::Read writes the cache, then reads it; a changed material library makes it stale
+	// (Mesh deletes its GL buffer on destruction, so this needs a context)
+	if (TestContext()) {
+		Mesh parse, cached;
+		parse.Read(obj, NULL, false, false);
+		Check(FileExists(cache.c_str()) && !FileExists((cache+".tmp").c_str()), "cache written, no temporary left");
+		cached.Read(obj, NULL, false, false);
+		Check(Same(cached.points, parse.points) && cached.triangles.size() == parse.triangles.size() &&
+			  cached.triangleMtls.size() == 2 && cached.triangleMtls[0].kd.x == .8f, "Mesh::Read from cache");
+		WriteMtl(mtl.c_str(), .5f, time(NULL)-50);
+		cached.Read(obj, NULL, false, false);
+		Check(cached.triangleMtls.size() == 2 && cached.triangleMtls[0].kd.x == .5f, "Mesh::Read after material change");
+	}
+	// round trip
+	MeshData a, b;
+	time_t modified = FileModified(obj.c_str());
+	Check(ReadAsciiObjParallel(obj.c_str(), a.points, a.triangles, &a.normals, &a.uvs, &a.groups, &a.mtls, &a.quads), "read obj");
+	Check(WriteMeshCache(cache.c_str(), modified, false, a.points, a.triangles, &a.normals, &a.uvs, &a.groups, &a.mtls, &a.quads, mtl.c_str()), "write cache");
+	Check(b.Read(cache.c_str(), modified) && Same(a, b), "round trip");
+	Check(!b.Read(cache.c_str(), modified+1), "stale source");
+	// malformed caches are refused and leave the arguments unchanged
+	vector<char> good = ReadBytes(cache.c_str());
+	CacheHeader h;
+	memcpy(&h, good.data(), sizeof(h));
+	auto Refused = [&](const char *what, std::function<void(vector<char> &bytes, CacheHeader &h)> corrupt) {
+		vector<char> bytes = good;
+		CacheHeader hh = h;
+		corrupt(bytes, hh);
+		memcpy(bytes.data(), &hh, sizeof(hh));
+		WriteBytes(cache.c_str(), bytes);
+		MeshData c = b;
+		Check(!c.Read(cache.c_str(), modified) && Same(c, b), what);
+	};
+	Refused("truncated", [](vector<char> &bytes, CacheHeader &) { bytes.resize(bytes.size()-16); });
+	Refused("point count too large", [](vector<char> &, CacheHeader &h) { h.nPoints += 100; });
+	Refused("negative count", [](vector<char> &, CacheHeader &h) { h.nUvs = -1; });
+	Refused("offsets out of order", [](vector<char> &, CacheHeader &h) { std::swap(h.offsets[1], h.offsets[2]); });
+	Refused("misaligned offset", [](vector<char> &, CacheHeader &h) { h.offsets[3] += 4; });
+	Refused("offset past end", [](vector<char> &, CacheHeader &h) { h.offsets[6] = h.offsets[8]+16; });
+	Refused("triangle id out of range", [](vector<char> &bytes, CacheHeader &h) {
+		int bad = h.nPoints;
+		memcpy(bytes.data()+h.offsets[3]+4, &bad, sizeof(int));
+	});
+	Refused("group name overruns", [](vector<char> &bytes, CacheHeader &h) {
+		int bad = 1 << 20;
+		memcpy(bytes.data()+h.offsets[5]+2*sizeof(int), &bad, sizeof(int));
+	});
+	WriteBytes(cache.c_str(), good);
+	Check(b.Read(cache.c_str(), modified), "restored cache");
+	remove(mtl.c_str());
+	Check(!b.Read(cache.c_str(), modified), "material library removed");
+	// times
+	WriteMtl(mtl.c_str(), .8f, time(NULL)-100);
+	WriteMeshCache(cache.c_str(), modified, false, a.points, a.triangles, &a.normals, &a.uvs, &a.groups, &a.mtls, &a.quads, mtl.c_str());
+	double tParse = BestTime([&]() { MeshData d; ReadAsciiObjParallel(obj.c_str(), d.points, d.triangles, &d.normals, &d.uvs, &d.groups, &d.mtls, &d.quads); }, 3);
+	double tCache = BestTime([&]() { MeshData d; d.Read(cache.c_str(), modified); }, 3);
+	printf("%d points, %d triangles: ReadAsciiObjParallel %.1f ms, ReadMeshCache %.1f ms (%.0fx)\n",
+		(int) a.points.size(), (int) a.triangles.size(), 1000*tParse, 1000*tCache, tParse/tCache);
+	remove(obj.c_str());
+	remove(mtl.c_str());
+	remove(cache.c_str());
+	return TestResult("MeshCacheTest");
+}
@@ -0,0 +1,139 @@
+// MeshletTest.cpp - meshlets partition triangles within groups, bound them, cull conservatively; times (c) 2019-2022 Jules Bloomenthal
+// usage: MeshletTest [sphere resolution]  (default 400: a 640K triangle sphere)
+
+#include <algorithm>
+#include "Mesh.h"
+#include "Test.h"
+
+void Sphere(int res, vector<vec3> &points, vector<int3> &triangles, vector<Group> &groups) {
+	// res by 2*res latitude/longitude sphere, three groups of latitude bands
+	points.resize(0);
+	triangles.resize(0);
+	for (int j = 0; j <= res; j++)
+		for (int i = 0; i < 2*res; i++) {
+			float phi = 3.1415926f*j/res, theta = 3.1415926f*i/res;
+			points.push_back(vec3(sin(phi)*cos(theta), sin(phi)*sin(theta), cos(phi)));
+		}
+	groups.resize(0);
+	for (int j = 0; j < res; j++) {
+		if (j == 0 || j == res/3 || j == 2*res/3)
+			groups.push_back(Group((int) triangles.size(), "band"));
+		for (int i = 0; i < 2*res; i++) {
+			int a = j*2*res+i, b = j*2*res+(i+1)%(2*res), c = a+2*res, d = b+2*res;
+			if (j > 0)
+				triangles.push_back(int3(a, c, b));
+			if (j < res-1)
+				triangles.push_back(int3(b, c, d));
+		}
+		groups.back().nTriangles = (int) triangles.size()-groups.back().startTriangle;
+	}
+}
+
+bool SameSet(vector<int3> a, vector<int3> b) {
+	auto less = [](const int3 &x, const int3 &y) { return memcmp(&x, &y, sizeof(int3)) < 0; };
+	std::sort(a.begin(), a.end(), less);
+	std::sort(b.begin(), b.end(), less);
+	return a.size() == b.size() && (a.empty() || !memcmp(a.data(), b.data(), a.size()*sizeof(int3)));
+}
+
+vec4 Clip(mat4 &m, vec3 p) { return m*vec4(p, 1); }
+
+bool InFrustum(vec4 c) { return fabs(c.x) <= c.w && fabs(c.y) <= c.w && fabs(c.z) <= c.w; }
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 400;
+	vector<vec3> points;
+	vector<int3> triangles;
+	vector<Group> groups;
+	Sphere(res, points, triangles, groups);
+	vector<int3> original(triangles);
+	VertexAdjacency adjacency;
+	adjacency.Build((int) points.size(), triangles);
+	vector<Meshlet> meshlets;
+	int nMeshlets = BuildMeshlets(points, triangles, meshlets, &groups);
+	// triangles are permuted within each group; meshlets are contiguous, in one group, and within limits
+	bool permuted = triangles.size() == original.size();
+	for (Group &g : groups)
+		permuted = permuted && SameSet(vector<int3>(&original[g.startTriangle], &original[g.startTriangle]+g.nTriangles),
+									   vector<int3>(&triangles[g.startTriangle], &triangles[g.startTriangle]+g.nTriangles));
+	Check(permuted, "triangles permuted within groups");
+	Check(!adjacency.Valid((int) points.size(), triangles), "adjacency invalid after BuildMeshlets");
+	int next = 0, nInGroup = 0, nBounded = 0, nCone = 0;
+	for (Meshlet &m : meshlets) {
+		vector<int> verts;
+		for (int t = m.startTriangle; t < m.startTriangle+m.nTriangles; t++)
+			for (int k = 0; k < 3; k++)
+				verts.push_back(triangles[t][k]);
+		std::sort(verts.begin(), verts.end());
+		int nVerts = (int) (std::unique(verts.begin(), verts.end())-verts.begin());
+		next = m.startTriangle == next? next+m.nTriangles : -1;
+		for (Group &g : groups)
+			nInGroup += m.startTriangle >= g.startTriangle && m.startTriangle+m.nTriangles <= g.startTriangle+g.nTriangles;
+		bool bounded = nVerts == m.nVertices && m.nVertices <= 64 && m.nTriangles <= 124, cone = true;
+		for (int t = m.startTriangle; t < m.startTriangle+m.nTriangles; t++) {
+			vec3 &a = points[triangles[t].i1], &b = points[triangles[t].i2], &c = points[triangles[t].i3];
+			for (vec3 p : {a, b, c})
+				bounded = bounded && length(p-m.center) <= m.radius*1.0001f;
+			if (m.coneCutoff < 1)
+				cone = cone && dot(normalize(cross(b-a, c-a)), m.coneAxis) >= sqrt(1-m.coneCutoff*m.coneCutoff)-1e-5f;
+		}
+		nBounded += bounded;
+		nCone += cone;
+	}
+	Check(next == (int) triangles.size(), "meshlets contiguous, cover all triangles");
+	Check(nInGroup == nMeshlets && nBounded == nMeshlets && nCone == nMeshlets, "meshlets within groups, limits, sphere and cone");
+	// CullMeshlets never culls a meshlet with a vertex in the frustum (or, if backface, a front facing triangle)
+	srand(1);
+	mat4 persp = Perspective(40, 1.5f, .1f, 10);
+	int nCulled = 0, nWrong = 0;
+	for (int view = 0; view < 50; view++) {
+		vec3 eye = (1.2f+2.f*rand()/RAND_MAX)*normalize(vec3(rand()-RAND_MAX/2.f, rand()-RAND_MAX/2.f, rand()-RAND_MAX/2.f));
+		mat4 modelview = LookAt(eye, vec3(.5f*rand()/RAND_MAX, 0, 0), vec3(0, 0, 1))*Scale(view%2? 1 : 1.3f), full = persp*modelview;
+		for (bool backface : {false, true}) {
+			vector<GLsizei> counts;
+			vector<size_t> offsets;
+			nCulled += (int) meshlets.size()-CullMeshlets(meshlets, modelview, persp, counts, offsets, backface);
+			vector<char> drawn(triangles.size(), 0);
+			for (size_t i = 0; i < counts.size(); i++)
+				std::fill(drawn.begin()+offsets[i]/sizeof(int3), drawn.begin()+offsets[i]/sizeof(int3)+counts[i]/3, 1);
+			for (int t = 0; t < (int) triangles.size(); t++) {
+				if (drawn[t])
+					continue;
+				vec3 &a = points[triangles[t].i1], &b = points[triangles[t].i2], &c = points[triangles[t].i3];
+				vec4 ea = modelview*vec4(a, 1), eb = modelview*vec4(b, 1), ec = modelview*vec4(c, 1);
+				vec3 pa(ea.x, ea.y, ea.z), pb(eb.x, eb.y, eb.z), pc(ec.x, ec.y, ec.z);
+				bool visible = InFrustum(Clip(full, a)) || InFrustum(Clip(full, b)) || InFrustum(Clip(full, c));
+				bool facing = dot(cross(pb-pa, pc-pa), pa) < 0;
+				nWrong += visible && (!backface || facing);
+			}
+		}
+	}
+	Check(nCulled > 0 && nWrong == 0, "CullMeshlets conservative");
+	// Mesh::BuildMeshlets clears picking; Set with new triangles discards meshlets and LODs
+	// (Mesh deletes its GL buffer on destruction, so this needs a context)
+	if (TestContext()) {
+		Mesh mesh;
+		mesh.points = points;
+		mesh.triangles = original;
+		mesh.triangleGroups = groups;
+		float alpha;
+		mesh.IntersectWithLine(vec3(0, 0, 2), vec3(0, 0, 0), alpha);
+		mesh.BuildLODs({.5f});
+		mesh.BuildMeshlets();
+		Check(mesh.triInfos.empty() && mesh.meshlets.size() && mesh.lods.size() == 1, "Mesh::BuildMeshlets clears picking");
+		vector<int> tris;
+		for (int3 &t : original)
+			tris.insert(tris.end(), {t.i1, t.i2, t.i3});
+		mesh.Set(points, NULL, NULL, &tris);
+		Check(mesh.meshlets.empty() && mesh.lods.empty(), "Mesh::Set discards meshlets and LODs");
+	}
+	// times
+	vector<GLsizei> counts;
+	vector<size_t> offsets;
+	mat4 modelview = LookAt(vec3(0, -3, 1), vec3(0, 0, 0), vec3(0, 0, 1));
+	double tBuild = BestTime([&]() { triangles = original; BuildMeshlets(points, triangles, meshlets, &groups); }, 3);
+	double tCull = BestTime([&]() { CullMeshlets(meshlets, modelview, persp, counts, offsets); });
+	printf("%d triangles, %d meshlets: BuildMeshlets %.0f ms, CullMeshlets %.0f us\n",
+		(int) triangles.size(), nMeshlets, 1000*tBuild, 1e6*tCull);
+	return TestResult("MeshletTest");
+}
@@ -0,0 +1,121 @@
+// NormalsTest.cpp - vertex normals with reused adjacency, incremental update, reordered triangles, crease normals, OptimizeMesh; times (c) 2019-2022 Jules Bloomenthal
+// usage: NormalsTest [grid resolution]  (default 700: a 490K vertex, 976K triangle grid)
+
+#include <string.h>
+#include <algorithm>
+#include "Mesh.h"
+#include "Test.h"
+
+void Grid(int res, vector<vec3> &points, vector<int3> &triangles) {
+	// wavy res*res grid
+	points.resize(res*res);
+	triangles.resize(0);
+	for (int j = 0; j < res; j++)
+		for (int i = 0; i < res; i++) {
+			float x = (float) i/(res-1), y = (float) j/(res-1);
+			points[j*res+i] = vec3(x, y, .1f*sin(20*x)*cos(17*y));
+		}
+	for (int j = 0; j < res-1; j++)
+		for (int i = 0; i < res-1; i++) {
+			int a = j*res+i, b = a+1, c = a+res, d = c+1;
+			triangles.push_back(int3(a, b, d));
+			triangles.push_back(int3(a, d, c));
+		}
+}
+
+float MaxDifference(vector<vec3> &a, vector<vec3> &b) {
+	float d = a.size() == b.size()? 0 : 1e9f;
+	for (size_t i = 0; i < a.size() && i < b.size(); i++)
+		d = std::max(d, length(a[i]-b[i]));
+	return d;
+}
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 700;
+	vector<vec3> points, normals, fresh;
+	vector<int3> triangles;
+	Grid(res, points, triangles);
+	for (NormalWeight w : {AreaWeight, AngleWeight}) {
+		// reused adjacency, after points move, and incremental update
+		VertexAdjacency adjacency;
+		SetVertexNormals(points, triangles, normals, adjacency, w);
+		Check(adjacency.Valid((int) points.size(), triangles), "adjacency valid after build");
+		vector<int> changed;
+		for (int t = 0; t < (int) triangles.size(); t += 97)
+			changed.push_back(t);
+		vector<vec3> moved(points);
+		for (int t : changed)
+			moved[triangles[t].i1].z += .05f;
+		vector<int> touched;
+		for (int t = 0; t < (int) triangles.size(); t++)
+			for (int k = 0; k < 3; k++)
+				if (moved[triangles[t][k]].z != points[triangles[t][k]].z) {
+					touched.push_back(t);
+					break;
+				}
+		UpdateVertexNormals(moved, triangles, normals, adjacency, touched, w);
+		VertexAdjacency adjFresh;
+		SetVertexNormals(moved, triangles, fresh, adjFresh, w);
+		Check(MaxDifference(normals, fresh) < 1e-5f, "UpdateVertexNormals matches SetVertexNormals");
+		// triangles reordered in place (same count): adjacency must be rebuilt
+		vector<int3> reordered(triangles);
+		std::reverse(reordered.begin(), reordered.end());
+		std::swap(reordered[0].i1, reordered[0].i2);
+		Check(!adjacency.Valid((int) points.size(), reordered), "adjacency invalid after reordering");
+		OptimizeMesh(moved, reordered);
+		SetVertexNormals(moved, reordered, normals, adjacency, w);
+		SetVertexNormals(moved, reordered, fresh, adjFresh = VertexAdjacency(), w);
+		Check(MaxDifference(normals, fresh) == 0, "normals after OptimizeMesh with reused adjacency");
+	}
+	// OptimizeMesh never raises ACMR (the teacup once went from .78 to .81), and renumbers quads with points
+	for (const char *name : {"Assets/Teacup.obj", "Assets/HousePlant.obj", "Assets/Cat.obj"}) {
+		vector<vec3> p;
+		vector<int3> t;
+		vector<int4> q;
+		vector<Group> groups;
+		vector<Mtl> mtls;
+		if (!Check(ReadAsciiObj(name, p, t, NULL, NULL, &groups, &mtls, &q), name))
+			continue;
+		vector<vec3> p0(p);
+		vector<int4> q0(q);
+		float acmr = ACMR(t, (int) p.size());
+		OptimizeMesh(p, t, NULL, NULL, &q, &groups, &mtls);
+		bool sameQuads = q.size() == q0.size();
+		for (size_t i = 0; sameQuads && i < q.size(); i++)
+			for (int k = 0; k < 4; k++)
+				sameQuads = sameQuads && !memcmp(&p[q[i][k]], &p0[q0[i][k]], sizeof(vec3));
+		Check(ACMR(t, (int) p.size()) <= acmr && sameQuads, "OptimizeMesh ACMR and quads");
+	}
+	// crease: a grid folded 90 degrees splits its fold column; uvs split with points, an unused point kept
+	vector<vec3> fold, foldNormals;
+	vector<int3> foldTriangles;
+	Grid(5, fold, foldTriangles);
+	vector<vec2> uvs;
+	for (vec3 &p : fold) {
+		uvs.push_back(vec2(p.x, p.y));
+		p = p.x > .5f? vec3(.5f, p.y, p.x-.5f) : vec3(p.x, p.y, 0);
+	}
+	fold.push_back(vec3(9, 9, 9));
+	uvs.push_back(vec2(9, 9));
+	vector<vec3> fold0(fold);
+	vector<vec2> uvs0(uvs);
+	vector<int3> foldTriangles0(foldTriangles);
+	SetCreaseNormals(fold, foldTriangles, foldNormals, 30, AreaWeight, &uvs);
+	bool sameCorners = foldTriangles.size() == foldTriangles0.size() && uvs.size() == fold.size();
+	for (size_t t = 0; sameCorners && t < foldTriangles.size(); t++)
+		for (int k = 0; k < 3; k++) {
+			int i = foldTriangles[t][k], i0 = foldTriangles0[t][k];
+			sameCorners = sameCorners && !memcmp(&fold[i], &fold0[i0], sizeof(vec3)) && uvs[i].x == uvs0[i0].x && uvs[i].y == uvs0[i0].y;
+		}
+	Check(sameCorners && fold.size() == 25+5+1, "SetCreaseNormals splits the fold with its uvs");
+	Check(fold.back().x == 9 && uvs.back().x == 9 && length(foldNormals.back()) == 0, "SetCreaseNormals keeps unused points");
+	// times
+	VertexAdjacency adjacency;
+	SetVertexNormals(points, triangles, normals, adjacency);
+	double tBuild = BestTime([&]() { VertexAdjacency a; SetVertexNormals(points, triangles, normals, a); }, 3);
+	double tReuse = BestTime([&]() { SetVertexNormals(points, triangles, normals, adjacency); }, 3);
+	double tValid = BestTime([&]() { adjacency.Valid((int) points.size(), triangles); }, 3);
+	printf("%d points, %d triangles: SetVertexNormals %.1f ms, with adjacency reused %.1f ms (of which Valid %.1f ms)\n",
+		(int) points.size(), (int) triangles.size(), 1000*tBuild, 1000*tReuse, 1000*tValid);
+	return TestResult("NormalsTest");
+}
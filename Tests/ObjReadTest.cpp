@@ -0,0 +1,88 @@
+// ObjReadTest.cpp - ReadAsciiObjParallel matches ReadAsciiObj; read times (c) 2019-2022 Jules Bloomenthal
+// usage: ObjReadTest [grid resolution]  (default 400: a 160K vertex, 318K triangle synthetic file)
+
+#include "Mesh.h"
+#include "Misc.h"
+#include "Test.h"
+
+struct ObjData {
+	vector<vec3> points, normals;
+	vector<int3> triangles;
+	vector<vec2> uvs;
+	vector<Group> groups;
+	vector<Mtl> mtls;
+	vector<int4> quads;
+	bool ok = false;
+	void Read(const char *filename, bool parallel) {
+		ok = parallel?
+			ReadAsciiObjParallel(filename, points, triangles, &normals, &uvs, &groups, &mtls, &quads) :
+			ReadAsciiObj(filename, points, triangles, &normals, &uvs, &groups, &mtls, &quads);
+	}
+};
+
+template <class T> bool Same(vector<T> &a, vector<T> &b) {
+	return a.size() == b.size() && (a.empty() || !memcmp(a.data(), b.data(), a.size()*sizeof(T)));
+}
+
+bool Same(ObjData &a, ObjData &b) {
+	bool groups = a.groups.size() == b.groups.size(), mtls = a.mtls.size() == b.mtls.size();
+	for (size_t i = 0; groups && i < a.groups.size(); i++)
+		groups = a.groups[i].name == b.groups[i].name && a.groups[i].startTriangle == b.groups[i].startTriangle &&
+				 a.groups[i].nTriangles == b.groups[i].nTriangles;
+	for (size_t i = 0; mtls && i < a.mtls.size(); i++)
+		mtls = a.mtls[i].name == b.mtls[i].name && a.mtls[i].startTriangle == b.mtls[i].startTriangle &&
+			   a.mtls[i].nTriangles == b.mtls[i].nTriangles && !memcmp(&a.mtls[i].kd, &b.mtls[i].kd, sizeof(vec3));
+	return a.ok && b.ok && groups && mtls && Same(a.points, b.points) && Same(a.normals, b.normals) &&
+		   Same(a.uvs, b.uvs) && Same(a.triangles, b.triangles) && Same(a.quads, b.quads);
+}
+
+void WriteGrid(const char *filename, const char *mtlName, int res) {
+	// res*res wavy grid: v/vt/vn per vertex, two groups and materials, triangles and a row of quads
+	FILE *mtl = fopen(TempFile(mtlName).c_str(), "w");
+	fprintf(mtl, "newmtl red\nKa 0.1 0 0\nKd 0.8 0.1 0.1\nKs 1 1 1\nnewmtl blue\nKd 0.1 0.1 0.8\n");
+	fclose(mtl);
+	FILE *f = fopen(filename, "w");
+	fprintf(f, "# synthetic grid\nmtllib %s\n", mtlName);
+	for (int j = 0; j < res; j++)
+		for (int i = 0; i < res; i++) {
+			float x = (float) i/(res-1), y = (float) j/(res-1), z = .1f*sin(20*x)*cos(17*y);
+			fprintf(f, "v %g %g %.6f\nvt %g %g\nvn %.5f %.5f 1\n", x, y, z, x, y, -2*cos(20*x)*cos(17*y), 1.7f*sin(20*x)*sin(17*y));
+		}
+	for (int j = 0; j < res-1; j++) {
+		if (j == 0 || j == res/2)
+			fprintf(f, "g half%d\nusemtl %s\n", j? 2 : 1, j? "blue" : "red");
+		for (int i = 0; i < res-1; i++) {
+			int a = j*res+i+1, b = a+1, c = a+res, d = c+1;
+			if (j == res-2)
+				fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, d, d, d, c, c, c);
+			else
+				fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d\nf %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, d, d, d, a, a, a, d, d, d, c, c, c);
+		}
+	}
+	fclose(f);
+}
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 400;
+	// same results on the repo's models
+	const char *models[] = {"Face.obj", "Assets/Cat.obj", "Assets/Head.obj", "Assets/HousePlant.obj", "Assets/Rose.obj", "Assets/Teacup.obj"};
+	for (const char *m : models) {
+		ObjData serial, parallel;
+		serial.Read(m, false);
+		parallel.Read(m, true);
+		Check(Same(serial, parallel), m);
+	}
+	// synthetic file: results and times
+	std::string grid = TempFile("ObjReadTest.obj");
+	WriteGrid(grid.c_str(), "ObjReadTest.mtl", res);
+	ObjData serial, parallel;
+	double tSerial = BestTime([&]() { serial = ObjData(); serial.Read(grid.c_str(), false); }, 3);
+	double tParallel = BestTime([&]() { parallel = ObjData(); parallel.Read(grid.c_str(), true); }, 3);
+	Check(Same(serial, parallel), "synthetic grid");
+	Check((int) serial.points.size() == res*res && serial.quads.size() == (size_t) res-1, "synthetic grid size");
+	printf("%d points, %d triangles, %d threads: ReadAsciiObj %.0f ms, ReadAsciiObjParallel %.0f ms (%.1fx)\n",
+		(int) serial.points.size(), (int) serial.triangles.size(), NumThreads(), 1000*tSerial, 1000*tParallel, tSerial/tParallel);
+	remove(grid.c_str());
+	remove(TempFile("ObjReadTest.mtl").c_str());
+	return TestResult("ObjReadTest");
+}
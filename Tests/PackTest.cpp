@@ -0,0 +1,99 @@
+// PackTest.cpp - packed vertex formats round trip on the CPU: octahedral normals, half floats, PackVertices (c) 2019-2022 Jules Bloomenthal
+// usage: PackTest [# vertices]  (default 1000000)
+
+#include <algorithm>
+#include "Mesh.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+bool IsNaN(float f) { return f != f; }
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 1000000;
+	srand(1);
+	// octahedral normals: within .0001 radian, both hemispheres and the axes
+	vector<vec3> normals(n);
+	for (int i = 0; i < n; i++)
+		normals[i] = normalize(vec3(Random(-1, 1), Random(-1, 1), Random(-1, 1)));
+	for (vec3 a : {vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1)})
+		normals[rand()%n] = a;
+	float maxAngle = 0;
+	for (vec3 &nrm : normals)
+		maxAngle = std::max(maxAngle, length(OctDecode(OctEncode(nrm))-nrm)); // chord ~ angle, acos(dot) loses precision
+	Check(maxAngle < 1e-4f, "octahedral normal error");
+	// half floats: every half converts back to itself, and floats round to the nearest half (ties even)
+	int nBadHalves = 0;
+	for (int h = 0; h < 65536; h++) {
+		float f = HalfToFloat((unsigned short) h);
+		nBadHalves += IsNaN(f)? !IsNaN(HalfToFloat(FloatToHalf(f))) : FloatToHalf(f) != h;
+	}
+	Check(nBadHalves == 0, "half round trip");
+	int nBadRounding = 0;
+	for (int i = 0; i < n; i++) {
+		float f = Random(-1, 1)*powf(2, Random(-26, 16));
+		unsigned short h = FloatToHalf(f);
+		float d = fabs(HalfToFloat(h)-f);
+		for (int step : {-1, 1}) {
+			// neighbors of h with the same sign, if finite
+			unsigned short g = (unsigned short) (h+step);
+			if ((g & 0x8000) != (h & 0x8000) || (g & 0x7c00) == 0x7c00)
+				continue;
+			float dg = fabs(HalfToFloat(g)-f);
+			nBadRounding += dg < d || (dg == d && (h & 1));
+		}
+	}
+	Check(nBadRounding == 0, "float to half rounding");
+	Check(HalfToFloat(FloatToHalf(70000)) > 65504 && FloatToHalf(1e-9f) == 0 && FloatToHalf(-1e-9f) == 0x8000, "half overflow, underflow");
+	// PackVertices: float and quantized points, normals, unorm and half uvs
+	vector<vec3> points(n);
+	vector<vec2> uvs(n), wideUvs(n);
+	for (int i = 0; i < n; i++) {
+		points[i] = vec3(Random(-3, 5), Random(10, 11), Random(-.01f, .01f));
+		uvs[i] = vec2(Random(0, 1), Random(0, 1));
+		wideUvs[i] = vec2(Random(-4, 4), Random(0, 2));
+	}
+	for (bool quantize : {false, true})
+		for (vector<vec2> *t : {&uvs, &wideUvs}) {
+			PackedVertices pv;
+			PackVertices(points, &normals, t, quantize, pv);
+			Check(pv.stride == (quantize? 16 : 20) && pv.normalOffset == (quantize? 8 : 12) && pv.uvOffset == pv.normalOffset+4, "packed layout");
+			Check(pv.uvHalf == (t == &wideUvs), "uv format");
+			vec3 range(8, 1, .02f);
+			float maxPoint = 0, maxUv = 0, maxNormal = 0;
+			for (int i = 0; i < n; i++) {
+				const char *v = pv.data.data()+(size_t) i*pv.stride;
+				vec3 p;
+				if (quantize) {
+					unsigned short q[3];
+					memcpy(q, v, 6);
+					vec4 d = pv.dequantize*vec4(q[0]/65535.f, q[1]/65535.f, q[2]/65535.f, 1);
+					p = vec3(d.x, d.y, d.z);
+				}
+				else
+					memcpy(&p, v, 12);
+				for (int k = 0; k < 3; k++)
+					maxPoint = std::max(maxPoint, fabs(p[k]-points[i][k])/range[k]);
+				unsigned int e;
+				unsigned short u[2];
+				memcpy(&e, v+pv.normalOffset, 4);
+				memcpy(u, v+pv.uvOffset, 4);
+				maxNormal = std::max(maxNormal, length(OctDecode(e)-normals[i]));
+				for (int k = 0; k < 2; k++) {
+					// unorm within half a step; half within 2^-11 of the value (of 2^-14 if denormal)
+					float c = pv.uvHalf? HalfToFloat(u[k]) : u[k]/65535.f, tc = (*t)[i][k];
+					maxUv = std::max(maxUv, pv.uvHalf? fabs(c-tc)/std::max(fabs(tc), ldexpf(1, -14)) : fabs(c-tc));
+				}
+			}
+			Check(quantize? maxPoint < .51f/65535 : maxPoint == 0, "packed points");
+			Check(maxNormal < 1e-4f, "packed normals");
+			Check(pv.uvHalf? maxUv <= 1/2048.f : maxUv < .51f/65535, "packed uvs");
+		}
+	// times
+	PackedVertices pv;
+	double tFloat = BestTime([&]() { PackVertices(points, &normals, &uvs, false, pv); }, 3);
+	double tQuantized = BestTime([&]() { PackVertices(points, &normals, &uvs, true, pv); }, 3);
+	printf("%d vertices: octahedral error %.2g radian; PackVertices %.1f ms (20 bytes/vertex), quantized %.1f ms (16 bytes/vertex)\n",
+		n, maxAngle, 1000*tFloat, 1000*tQuantized);
+	return TestResult("PackTest");
+}
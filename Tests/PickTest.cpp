@@ -0,0 +1,92 @@
+// PickTest.cpp - BVH and SIMD picking agree with the linear search, for moved meshes too; pick times (c) 2019-2022 Jules Bloomenthal
+// usage: PickTest [# lines]  (default 2000)
+
+#include "Mesh.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+vec3 RandomPoint(float r) { return vec3(Random(-r, r), Random(-r, r), Random(-r, r)); }
+
+vec3 Transform(mat4 m, vec3 p) {
+	vec4 q = m*vec4(p, 1);
+	return vec3(q.x, q.y, q.z);
+}
+
+int main(int argc, char **argv) {
+	int nLines = argc > 1? atoi(argv[1]) : 2000;
+	srand(1);
+	vector<vec3> points;
+	vector<int3> triangles;
+	if (!Check(ReadAsciiObj("Assets/Cat.obj", points, triangles), "read Assets/Cat.obj"))
+		return TestResult("PickTest");
+	Normalize(points, 1);
+	vector<TriInfo> triInfos;
+	BVH bvh;
+	BuildTriInfos(points, triangles, triInfos, bvh);
+	// lines through the mesh, from outside it, in object and in world space
+	mat4 transform = Translate(.3f, -2, 5)*RotateY(35)*RotateX(-20)*Scale(1.5f), inverse = InvertAffine(transform);
+	vector<vec3> p1s(nLines), p2s(nLines);
+	for (int i = 0; i < nLines; i++) {
+		p1s[i] = 3*normalize(RandomPoint(1));
+		p2s[i] = RandomPoint(.6f);
+	}
+	int nHits = 0, nAgree = 0, nWorldAgree = 0;
+	for (int i = 0; i < nLines; i++) {
+		float alpha, bvhAlpha, worldAlpha;
+		int t = IntersectWithLine(p1s[i], p2s[i], triInfos, alpha);
+		int tBVH = IntersectWithLine(p1s[i], p2s[i], triInfos, bvh, bvhAlpha);
+		int tWorld = IntersectWithLine(Transform(transform, p1s[i]), Transform(transform, p2s[i]), triInfos, bvh, worldAlpha, &inverse);
+		nHits += t >= 0;
+		nAgree += t == tBVH && (t < 0 || alpha == bvhAlpha);
+		nWorldAgree += t == tWorld && (t < 0 || fabs(alpha-worldAlpha) < 1e-4f);
+	}
+	Check(nHits > nLines/4, "lines hit mesh");
+	Check(nAgree == nLines, "bvh matches linear search");
+	Check(nWorldAgree == nLines, "bvh with inverse matches object space search");
+	// Moller-Trumbore on FloatBatch lanes: triangles per lane, and lines per lane
+	TriangleSoA soa;
+	BuildTriangleSoA(points, triangles, soa);
+	vector<int> picked(nLines);
+	vector<float> alphas(nLines);
+	IntersectWithLines(nLines, p1s.data(), p2s.data(), soa, picked.data(), alphas.data());
+	int nSoAAgree = 0;
+	for (int i = 0; i < nLines; i++) {
+		float alpha, soaAlpha;
+		int t = IntersectWithLine(p1s[i], p2s[i], triInfos, alpha);
+		int tSoA = IntersectWithLine(p1s[i], p2s[i], soa, soaAlpha);
+		nSoAAgree += t == tSoA && t == picked[i] && (t < 0 || (fabs(alpha-soaAlpha) < 1e-4f && soaAlpha == alphas[i]));
+	}
+	Check(nSoAAgree == nLines, "triangle SoA matches linear search");
+	// Mesh::IntersectWithLine builds the bvh on first use and follows Mesh::transform
+	// (Mesh deletes its GL buffer on destruction, so this needs a context)
+	if (TestContext()) {
+		Mesh mesh;
+		mesh.points = points;
+		mesh.triangles = triangles;
+		mesh.transform = transform;
+		int nMeshAgree = 0;
+		for (int i = 0; i < nLines; i++) {
+			float alpha, meshAlpha;
+			int t = IntersectWithLine(p1s[i], p2s[i], triInfos, alpha);
+			int tMesh = mesh.IntersectWithLine(Transform(transform, p1s[i]), Transform(transform, p2s[i]), meshAlpha);
+			nMeshAgree += t == tMesh && (t < 0 || fabs(alpha-meshAlpha) < 1e-4f);
+		}
+		Check(nMeshAgree == nLines && mesh.triInfos.size() == triangles.size(), "Mesh::IntersectWithLine");
+		mesh.ClearPicking();
+		Check(mesh.triInfos.empty() && mesh.bvh.nodes.empty(), "Mesh::ClearPicking");
+	}
+	// times
+	float alpha;
+	volatile int sink = 0;
+	double tLinear = BestTime([&]() { for (int i = 0; i < nLines; i++) sink += IntersectWithLine(p1s[i], p2s[i], triInfos, alpha); });
+	double tBVH = BestTime([&]() { for (int i = 0; i < nLines; i++) sink += IntersectWithLine(p1s[i], p2s[i], triInfos, bvh, alpha); });
+	double tSoA = BestTime([&]() { for (int i = 0; i < nLines; i++) sink += IntersectWithLine(p1s[i], p2s[i], soa, alpha); });
+	double tPackets = BestTime([&]() { IntersectWithLines(nLines, p1s.data(), p2s.data(), soa, picked.data(), alphas.data()); });
+	double tBuild = BestTime([&]() { BuildTriInfos(points, triangles, triInfos, bvh); }, 3);
+	printf("%d triangles, %d lines: linear %.2f us/line, bvh %.2f us/line (%.0fx); BuildTriInfos with bvh %.1f ms\n",
+		(int) triangles.size(), nLines, 1e6*tLinear/nLines, 1e6*tBVH/nLines, tLinear/tBVH, 1000*tBuild);
+	printf("triangle SoA (%d lanes): %.2f us/line (%.0fx), line packets %.2f us/line (%.0fx)\n",
+		FloatBatch::n, 1e6*tSoA/nLines, tLinear/tSoA, 1e6*tPackets/nLines, tLinear/tPackets);
+	return TestResult("PickTest");
+}
@@ -0,0 +1,112 @@
+// PointSetTest.cpp - PointSet bounds, normalize and transform match scalar loops, views of empty arrays; times (c) 2019-2022 Jules Bloomenthal
+// usage: PointSetTest [# points]  (default 2000000; 50000000 for large-cloud timings)
+
+#include <float.h>
+#include <string.h>
+#include "Mesh.h"
+#include "Misc.h"
+#include "PointSet.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+// scalar reference: the loops Mesh.cpp used before PointSet
+
+void Bounds(const vector<vec3> &points, vec3 &min, vec3 &max) {
+	min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for (const vec3 &p : points)
+		for (int k = 0; k < 3; k++) {
+			if (p[k] < min[k]) min[k] = p[k];
+			if (p[k] > max[k]) max[k] = p[k];
+		}
+}
+
+void Transformed(const mat4 &m, vector<vec3> &points) {
+	for (vec3 &p : points) {
+		vec4 q = m*vec4(p, 1);
+		p = vec3(q.x, q.y, q.z);
+	}
+}
+
+template <class T> bool Same(const T &a, const T &b) { return !memcmp(&a, &b, sizeof(T)); }
+
+bool Same(const vector<vec3> &a, const vector<vec3> &b) {
+	return a.size() == b.size() && (a.empty() || !memcmp(a.data(), b.data(), a.size()*sizeof(vec3)));
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 2000000;
+	srand(1);
+	// counts around the SIMD widths, and two beyond one thread's range; NaN coordinates are ignored by bounds
+	int nBadBounds = 0, nBadNormalize = 0, nBadTransform = 0, nMisaligned = 0;
+	mat4 m = RotateY(30)*Translate(1, 2, 3)*Scale(2, 3, 4);
+	m[3][0] = .1f;
+	for (int count : {0, 1, 3, 7, 8, 9, 15, 16, 17, 33, 1001, 300001, 600007})
+		for (int nan = 0; nan < 2; nan++) {
+			vector<vec3> points(count);
+			for (vec3 &p : points)
+				p = vec3(Random(-50, 120), Random(-25, 60), Random(-100, 240));
+			if (nan && count > 2)
+				points[0].x = points[count/2].y = NAN;
+			vec3 min, max, vMin, vMax, sMin, sMax;
+			Bounds(points, min, max);
+			PointSet soa;
+			soa.Set(points);
+			PointSet(points).MinMax(vMin, vMax);
+			soa.MinMax(sMin, sMax);
+			nBadBounds += !Same(min, vMin) || !Same(max, vMax) || !Same(min, sMin) || !Same(max, sMax);
+			nMisaligned += count && ((uintptr_t) soa.x%32 || (uintptr_t) soa.y%32 || (uintptr_t) soa.z%32);
+			if (nan)
+				continue;
+			vector<vec3> expected = points, view = points, got;
+			Transformed(NDCfromMinMax(min, max, .8f), expected);
+			PointSet(view).Normalize(.8f);
+			soa.Normalize(.8f);
+			soa.Get(got);
+			nBadNormalize += !Same(expected, view) || !Same(expected, got);
+			expected = view = points;
+			Transformed(m, expected);
+			PointSet(view).Transform(m);
+			soa.Set(points);
+			soa.Transform(m);
+			soa.Get(got);
+			nBadTransform += !Same(expected, view) || !Same(expected, got);
+		}
+	Check(nBadBounds == 0, "MinMax matches scalar loop, view and arrays");
+	Check(nBadNormalize == 0, "Normalize matches NDCfromMinMax*point");
+	Check(nBadTransform == 0, "Transform matches m*point");
+	Check(nMisaligned == 0, "arrays 32-byte aligned");
+	// a view of an empty vector (data() may be NULL) is empty, without dereferencing
+	vector<vec3> empty;
+	PointSet view(empty);
+	vec3 min, max;
+	view.MinMax(min, max);
+	view.Normalize();
+	view.Transform(m);
+	Check(view.count == 0 && view.x == NULL && view.IsView(), "view of empty vector");
+	Check(min.x == FLT_MAX && max.x == -FLT_MAX, "bounds of empty view");
+	PointSet((vec3 *) NULL, 5).MinMax(min, max);
+	Check(min.x == FLT_MAX, "view of NULL is empty");
+	// times, for n points: scalar loop, view of the caller's vec3s, and owned arrays
+	vector<vec3> points(n);
+	for (vec3 &p : points)
+		p = vec3(Random(-50, 120), Random(-50, 120), Random(-50, 120));
+	PointSet soa;
+	soa.Set(points);
+	mat4 r = RotateY(1);
+	double tRefBounds = BestTime([&]() { Bounds(points, min, max); });
+	double tViewBounds = BestTime([&]() { PointSet(points).MinMax(min, max); });
+	double tBounds = BestTime([&]() { soa.MinMax(min, max); });
+	double tRefNormalize = BestTime([&]() { vec3 a, b; Bounds(points, a, b); Transformed(NDCfromMinMax(a, b), points); });
+	double tViewNormalize = BestTime([&]() { PointSet(points).Normalize(); });
+	double tNormalize = BestTime([&]() { soa.Normalize(); });
+	double tRefTransform = BestTime([&]() { Transformed(r, points); });
+	double tViewTransform = BestTime([&]() { PointSet(points).Transform(r); });
+	double tTransform = BestTime([&]() { soa.Transform(r); });
+	printf("%d points, %d threads; ms for scalar loop, view, arrays:\n", n, NumThreads());
+	printf("  MinMax %.1f, %.1f, %.1f\n", 1e3*tRefBounds, 1e3*tViewBounds, 1e3*tBounds);
+	printf("  Normalize %.1f, %.1f, %.1f\n", 1e3*tRefNormalize, 1e3*tViewNormalize, 1e3*tNormalize);
+	printf("  Transform %.1f, %.1f, %.1f\n", 1e3*tRefTransform, 1e3*tViewTransform, 1e3*tTransform);
+	return TestResult("PointSetTest");
+}
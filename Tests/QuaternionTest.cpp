@@ -0,0 +1,182 @@
+// QuaternionTest.cpp - batch Slerp and NLerp against Quaternion::Slerp, GetMatrices, keyframe sampling; tracks/sec (c) 2019-2022 Jules Bloomenthal
+// usage: QuaternionTest [# tracks]  (default 5000)
+
+#include <float.h>
+#include <string.h>
+#include <algorithm>
+#include "Quaternion.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+Quaternion RandomQuaternion() {
+	Quaternion q(Random(-1, 1), Random(-1, 1), Random(-1, 1), Random(-1, 1));
+	return q*(1/sqrt(q.Norm()));
+}
+
+float Dot(const Quaternion &a, const Quaternion &b) { return a.x*b.x+a.y*b.y+a.z*b.z+a.w*b.w; }
+
+double Difference(const Quaternion &a, const Quaternion &b) {
+	// largest component difference, q and -q the same rotation
+	float d1 = 0, d2 = 0, pa[] = {a.x, a.y, a.z, a.w}, pb[] = {b.x, b.y, b.z, b.w};
+	for (int k = 0; k < 4; k++) {
+		d1 = std::max(d1, fabsf(pa[k]-pb[k]));
+		d2 = std::max(d2, fabsf(pa[k]+pb[k]));
+	}
+	return std::min(d1, d2);
+}
+
+double Degrees(const Quaternion &a, const Quaternion &b) {
+	// angle of the rotation between unit a and b
+	double c = fabs((double) a.x*b.x+(double) a.y*b.y+(double) a.z*b.z+(double) a.w*b.w);
+	return 2*acos(std::min(1., c))*180/3.141592653589793;
+}
+
+Quaternion ShorterSlerp(Quaternion a, Quaternion b, float t) {
+	// Quaternion::Slerp along the shorter arc, as the batch routines
+	Quaternion q;
+	if (Dot(a, b) < 0)
+		b = b*-1;
+	q.Slerp(a, b, t);
+	return q;
+}
+
+int KeyIndex(const vector<float> &times, float t) {
+	// k such that times[k] <= t < times[k+1], clamped to the first and last intervals
+	int k = (int) (std::upper_bound(times.begin(), times.end(), t)-times.begin())-1;
+	return std::max(0, std::min((int) times.size()-2, k));
+}
+
+bool SameLanes(QuaternionArray &r) {
+	// every quaternion the same as the first
+	for (int i = 1; i < r.count; i++)
+		if (memcmp(&r.x[i], &r.x[0], 4) || memcmp(&r.y[i], &r.y[0], 4) || memcmp(&r.z[i], &r.z[0], 4) || memcmp(&r.w[i], &r.w[0], 4))
+			return false;
+	return true;
+}
+
+int main(int argc, char **argv) {
+	int nTracks = argc > 1? atoi(argv[1]) : 5000;
+	srand(1);
+	// pairs: random, nearby, and in opposite hemispheres; a count not a multiple of the batch size
+	int n = 100003;
+	vector<Quaternion> qa(n), qb(n);
+	vector<float> ts(n);
+	for (int i = 0; i < n; i++) {
+		qa[i] = RandomQuaternion();
+		qb[i] = RandomQuaternion();
+		ts[i] = Random(0, 1);
+		if (i%4 == 1)
+			qb[i] = qa[i]*Quaternion(vec3(Random(-1, 1), Random(-1, 1), Random(-1, 1)), Random(-.01f, .01f));
+		if (i%4 == 2)
+			qb[i] = qb[i]*-1;
+	}
+	QuaternionArray a, b, r;
+	a.Set(qa);
+	b.Set(qb);
+	Slerp(a, b, ts.data(), r);
+	double slerpError = 0;
+	for (int i = 0; i < n; i++)
+		slerpError = std::max(slerpError, Difference(r.Get(i), ShorterSlerp(qa[i], qb[i], ts[i])));
+	NLerp(a, b, ts.data(), r);
+	double nlerpError = 0;
+	for (int i = 0; i < n; i++)
+		nlerpError = std::max(nlerpError, Degrees(r.Get(i), ShorterSlerp(qa[i], qb[i], ts[i])));
+	printf("largest difference from Quaternion::Slerp: Slerp %.1e, NLerp %.2f degrees\n", slerpError, nlerpError);
+	Check(slerpError < 5e-6, "Slerp matches Quaternion::Slerp");
+	Check(nlerpError < 8.5, "NLerp within its documented angle");
+	// SIMD lanes and scalar tail agree; result may be a or b
+	QuaternionArray a13, b13, r13;
+	vector<Quaternion> sameA(13, qa[5]), sameB(13, qb[6]);
+	a13.Set(sameA);
+	b13.Set(sameB);
+	vector<float> t13(13, .3f);
+	Slerp(a13, b13, t13.data(), r13);
+	bool sameSlerp = SameLanes(r13);
+	NLerp(a13, b13, .3f, r13);
+	Check(sameSlerp && SameLanes(r13), "SIMD lanes match scalar tail");
+	Quaternion expected = r13.Get(0);
+	NLerp(a13, b13, .3f, b13);
+	Quaternion got = b13.Get(12);
+	Check(b13.count == 13 && !memcmp(&expected, &got, sizeof(Quaternion)), "result may be b");
+	vector<Quaternion> copied(13);
+	b13.GetAll(copied.data());
+	Check(!memcmp(&copied[12], &got, sizeof(Quaternion)), "GetAll");
+	// matrices: same values as GetMatrix, including near-zero quaternions (identity)
+	vector<mat4> matrices(n);
+	a.GetMatrices(matrices.data());
+	int nDifferent = 0;
+	for (int i = 0; i < n; i++) {
+		mat4 m = qa[i].GetMatrix();
+		nDifferent += memcmp(&m, &matrices[i], sizeof(mat4)) != 0;
+	}
+	QuaternionArray small(9);
+	for (int k = 0; k < 9; k++)
+		small.Set(k, Quaternion(0, 0, 0, k == 4? 1e-5f : 0));
+	small.GetMatrices(matrices.data());
+	mat4 identity;
+	for (int k = 0; k < 9; k++)
+		nDifferent += memcmp(&matrices[k], &identity, sizeof(mat4)) != 0;
+	Check(nDifferent == 0, "GetMatrices same as GetMatrix");
+	// sampler: rejects bad tracks, matches a per-track search and Quaternion::Slerp
+	QuaternionSampler bad, sampler;
+	Quaternion q = RandomQuaternion();
+	Check(bad.Add({}, {}) < 0 && bad.Add({0, 1}, {q}) < 0 && bad.Add({0, 1, 1}, {q, q, q}) < 0 &&
+		  bad.Add({0, 2, 1}, {q, q, q}) < 0 && bad.Add({0, NAN}, {q, q}) < 0 && bad.NTracks() == 0, "Add rejects bad tracks");
+	Check(bad.Add({5}, {q}) == 0, "Add accepts one key");
+	vector<vector<float>> times(nTracks);
+	vector<vector<Quaternion>> keys(nTracks);
+	for (int i = 0; i < nTracks; i++) {
+		float t = Random(-1, 0);
+		for (int k = 0; k < 30+i%5; k++) {
+			times[i].push_back(t);
+			keys[i].push_back(RandomQuaternion());
+			t += Random(.01f, .1f);
+		}
+		sampler.Add(times[i], keys[i]);
+	}
+	double sampleError = 0;
+	for (float t : {-2.f, -.5f, 0.f, .3f, .31f, 1.5f, 5.f, .2f, -.9f}) {
+		sampler.Sample(t, r);
+		for (int i = 0; i < nTracks; i++) {
+			int k = KeyIndex(times[i], t);
+			float u = std::max(0.f, std::min(1.f, (t-times[i][k])/(times[i][k+1]-times[i][k])));
+			sampleError = std::max(sampleError, Difference(r.Get(i), ShorterSlerp(keys[i][k], keys[i][k+1], u)));
+		}
+	}
+	Check(sampleError < 5e-6, "Sample matches per-track search and Quaternion::Slerp");
+	// times: per quaternion, then tracks/sec at advancing times (as in playback)
+	int nb = 4096;
+	QuaternionArray a2, b2, r2;
+	vector<Quaternion> qa2(qa.begin(), qa.begin()+nb), qb2(qb.begin(), qb.begin()+nb), out(nb);
+	a2.Set(qa2);
+	b2.Set(qb2);
+	vector<mat4> m2(nb);
+	int j = 0;
+	double tScalar = BestTime([&]() { float t = .001f*(j++%1000); for (int i = 0; i < nb; i++) out[i].Slerp(qa2[i], qb2[i], t); })/nb;
+	double tSlerp = BestTime([&]() { Slerp(a2, b2, .001f*(j++%1000), r2); })/nb;
+	double tNLerp = BestTime([&]() { NLerp(a2, b2, .001f*(j++%1000), r2); })/nb;
+	double tScalarMatrix = BestTime([&]() { for (int i = 0; i < nb; i++) m2[i] = qa2[i].GetMatrix(); })/nb;
+	double tMatrix = BestTime([&]() { a2.GetMatrices(m2.data()); })/nb;
+	vector<Quaternion> outTracks(nTracks);
+	vector<mat4> trackMatrices(nTracks);
+	int nFrames = 100;
+	double tRef = BestTime([&]() {
+		for (int f = 0; f < nFrames; f++) {
+			float t = -1+.017f*f;
+			for (int i = 0; i < nTracks; i++) {
+				int k = KeyIndex(times[i], t);
+				float u = std::max(0.f, std::min(1.f, (t-times[i][k])/(times[i][k+1]-times[i][k])));
+				outTracks[i].Slerp(keys[i][k], keys[i][k+1], u);
+			}
+		}
+	})/nFrames;
+	double tSample = BestTime([&]() { for (int f = 0; f < nFrames; f++) sampler.Sample(-1+.017f*f, r); })/nFrames;
+	double tFast = BestTime([&]() { for (int f = 0; f < nFrames; f++) sampler.Sample(-1+.017f*f, r, true); })/nFrames;
+	double tSampleMatrix = BestTime([&]() { for (int f = 0; f < nFrames; f++) sampler.Sample(-1+.017f*f, trackMatrices.data()); })/nFrames;
+	printf("ns per quaternion: Quaternion::Slerp %.1f, Slerp %.2f, NLerp %.2f; GetMatrix %.2f, GetMatrices %.2f\n",
+		1e9*tScalar, 1e9*tSlerp, 1e9*tNLerp, 1e9*tScalarMatrix, 1e9*tMatrix);
+	printf("millions of tracks/sec (%d tracks): search and Quaternion::Slerp %.1f, Sample %.1f, fast %.1f, to mat4 %.1f\n",
+		nTracks, 1e-6*nTracks/tRef, 1e-6*nTracks/tSample, 1e-6*nTracks/tFast, 1e-6*nTracks/tSampleMatrix);
+	return TestResult("QuaternionTest");
+}
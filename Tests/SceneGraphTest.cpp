@@ -0,0 +1,133 @@
+// SceneGraphTest.cpp - SceneGraph::Update agrees with a recursive traversal; update and Find times (c) 2019-2022 Jules Bloomenthal
+// usage: SceneGraphTest [# nodes]  (default 200000)
+
+#include <float.h>
+#include "Mesh.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+struct Tree {
+	// the same hierarchy as nested children, updated recursively (as Mesh::children are)
+	vector<vector<int>> children;
+	vector<int> roots;
+	vector<mat4> local, world;
+	vector<vec3> min, max, worldMin, worldMax;
+	void Update(int n, mat4 parentWorld) {
+		world[n] = parentWorld*local[n];
+		if (dot(min[n], min[n]) == 0 && dot(max[n], max[n]) == 0) {
+			worldMin[n] = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+			worldMax[n] = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		}
+		else
+			TransformBox(world[n], min[n], max[n], worldMin[n], worldMax[n]);
+		for (int c : children[n]) {
+			Update(c, world[n]);
+			for (int k = 0; k < 3; k++) {
+				worldMin[n][k] = fmin(worldMin[n][k], worldMin[c][k]);
+				worldMax[n][k] = fmax(worldMax[n][k], worldMax[c][k]);
+			}
+		}
+	}
+	void Update() {
+		for (int r : roots)
+			Update(r, mat4());
+	}
+};
+
+Tree RandomTree(int n) {
+	// each node's parent is a random earlier node (or none); a fifth of the nodes have no geometry
+	Tree t;
+	t.children.resize(n);
+	t.local.resize(n);
+	t.world.resize(n);
+	t.min.resize(n);
+	t.max.resize(n);
+	t.worldMin.resize(n);
+	t.worldMax.resize(n);
+	for (int i = 0; i < n; i++) {
+		int parent = i < 10? -1 : rand()%i;
+		(parent < 0? t.roots : t.children[parent]).push_back(i);
+		t.local[i] = Translate(Random(-1, 1), Random(-1, 1), Random(-1, 1))*RotateY(Random(-30, 30))*RotateX(Random(-30, 30));
+		if (rand()%5) {
+			t.min[i] = vec3(Random(-.2f, 0), Random(-.2f, 0), Random(-.2f, 0));
+			t.max[i] = vec3(Random(0, .2f), Random(0, .2f), Random(0, .2f));
+		}
+	}
+	return t;
+}
+
+void AddPreorder(Tree &t, int n, int parent, SceneGraph &g, vector<int> &nodeOf) {
+	// preorder, so each Add appends
+	nodeOf[n] = g.Add(parent, t.local[n], t.min[n], t.max[n]);
+	for (int c : t.children[n])
+		AddPreorder(t, c, nodeOf[n], g, nodeOf);
+}
+
+bool Same(vec3 a, vec3 b) { return !memcmp(&a, &b, sizeof(vec3)); }
+
+bool Same(Tree &t, SceneGraph &g, vector<int> &nodeOf) {
+	bool same = true;
+	for (int i = 0; i < (int) nodeOf.size() && same; i++) {
+		int k = nodeOf[i];
+		same = !memcmp(&t.world[i], &g.world[k], sizeof(mat4)) && Same(t.worldMin[i], g.worldMin[k]) && Same(t.worldMax[i], g.worldMax[k]);
+	}
+	return same;
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 200000;
+	srand(1);
+	Tree t = RandomTree(n);
+	SceneGraph g;
+	vector<int> nodeOf(n);
+	for (int r : t.roots)
+		AddPreorder(t, r, -1, g, nodeOf);
+	int nUpdated = g.Update();
+	t.Update();
+	Check(nUpdated == n && Same(t, g, nodeOf), "initial update matches recursive");
+	// move nodes, some nested in others' subtrees, and some twice
+	vector<int> moved;
+	for (int i = 0; i < 20; i++)
+		moved.push_back(rand()%n);
+	moved.push_back(moved[3]);
+	for (int i : moved) {
+		t.local[i] = RotateZ(Random(-10, 10))*t.local[i];
+		g.SetLocal(nodeOf[i], t.local[i]);
+	}
+	g.Update();
+	t.Update();
+	Check(Same(t, g, nodeOf), "incremental update matches recursive");
+	// a node without geometry doesn't extend its subtree bounds
+	SceneGraph e;
+	int root = e.Add(-1, Translate(100, 0, 0)), child = e.Add(root, Translate(-100, 0, 0), vec3(-1, -1, -1), vec3(1, 1, 1));
+	e.Update();
+	Check(Same(e.worldMin[root], e.worldMin[child]) && Same(e.worldMax[root], vec3(1, 1, 1)), "no geometry, no bounds");
+	// Find, with meshes (Mesh deletes its GL buffer on destruction, so this needs a context)
+	double tFind = 0, tFindHint = 0;
+	if (TestContext()) {
+		vector<Mesh> meshes(2000);
+		SceneGraph m;
+		for (int i = 0; i < (int) meshes.size(); i++)
+			m.Add(i%3? i-1 : -1, Translate(1, 0, 0), vec3(), vec3(), &meshes[i]);
+		int nFound = 0;
+		for (int i = 0; i < (int) meshes.size(); i += 7)
+			nFound += m.Find(&meshes[i]) == i && m.Find(&meshes[i]) == i;
+		Mesh other;
+		Check(nFound == ((int) meshes.size()+6)/7 && m.Find(&other) == -1, "Find");
+		m.Update();
+		Check(meshes[5].transform[0][3] == 3, "mesh transform follows node");
+		volatile int sink = 0;
+		tFind = BestTime([&]() { for (int i = 0; i < 1000; i++) sink += m.Find(&meshes[(i*997)%meshes.size()]); })/1000;
+		tFindHint = BestTime([&]() { for (int i = 0; i < 1000; i++) sink += m.Find(&meshes[1999]); })/1000;
+	}
+	// times: update everything, and a drag (one subtree moves)
+	double tFull = BestTime([&]() { for (int r : t.roots) g.SetLocal(nodeOf[r], t.local[r]); g.Update(); }, 3);
+	double tRecursive = BestTime([&]() { t.Update(); }, 3);
+	int dragged = nodeOf[t.roots[0]]+1, nDragged = g.nodes[dragged].nDescendants+1;
+	double tDrag = BestTime([&]() { g.SetWorld(dragged, g.world[dragged]*RotateZ(1)); g.Update(); });
+	printf("%d nodes: Update all %.1f ms, recursive %.1f ms; drag (%d node subtree) %.1f us\n",
+		n, 1000*tFull, 1000*tRecursive, nDragged, 1e6*tDrag);
+	printf("Find: %.2f us, repeated %.3f us\n", 1e6*tFind, 1e6*tFindHint);
+	return TestResult("SceneGraphTest");
+}
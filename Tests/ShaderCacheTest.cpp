@@ -0,0 +1,159 @@
+// ShaderCacheTest.cpp - program cache: hit without compiling, corrupt binary recompiled and replaced; cold and warm startup times (c) 2019-2022 Jules Bloomenthal
+// usage: ShaderCacheTest [# programs]  (default 8)
+
+#include <string.h>
+#include <vector>
+#include "GLXtras.h"
+#include "Test.h"
+
+using std::string;
+using std::vector;
+
+// GL shim: glad's glCompileShader is replaced by a counting thunk
+
+PFNGLCOMPILESHADERPROC compileShader = NULL;
+int nCompiles = 0;
+
+void APIENTRY CountedCompileShader(GLuint shader) { nCompiles++; compileShader(shader); }
+
+// shaders
+
+const char *vertexCode = R"(
+	#version 410 core
+	in vec3 position;
+	uniform mat4 view;
+	void main() { gl_Position = view*vec4(position, 1); }
+)";
+
+const char *pixelCode = R"(
+	#version 410 core
+	out vec4 pColor;
+	uniform vec4 color;
+	void main() { pColor = color; }
+)";
+
+string Variant(int i) {
+	// pixel shader that differs per program, so each has its own cache file
+	string code = pixelCode;
+	return code.replace(code.find("color;"), 6, "color;\n\tconst float unused"+std::to_string(i)+" = 0.;");
+}
+
+// cache files
+
+string CacheFile(const string &directory, const char *vertex, const char *pixel) {
+	// mirrors CacheFile in GLXtras.cpp: FNV-1a of driver strings and each stage's type and source
+	unsigned long long h = 14695981039346656037ull;
+	auto Hash = [&h](const void *data, size_t nBytes) {
+		for (size_t i = 0; i < nBytes; i++)
+			h = (h^((const unsigned char *) data)[i])*1099511628211ull;
+	};
+	GLenum driver[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+	for (GLenum d : driver) {
+		const char *s = (const char *) glGetString(d);
+		if (s) Hash(s, strlen(s)+1);
+	}
+	GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	const char *codes[] = { vertex, pixel };
+	for (int i = 0; i < 2; i++) {
+		Hash(&types[i], sizeof(GLenum));
+		Hash(codes[i], strlen(codes[i])+1);
+	}
+	char name[32];
+	snprintf(name, sizeof(name), "/%016llx.bin", h);
+	return directory+name;
+}
+
+vector<char> ReadBytes(const string &filename) {
+	vector<char> bytes;
+	if (FILE *f = fopen(filename.c_str(), "rb")) {
+		fseek(f, 0, SEEK_END);
+		bytes.resize(ftell(f));
+		fseek(f, 0, SEEK_SET);
+		bytes.resize(fread(bytes.data(), 1, bytes.size(), f));
+		fclose(f);
+	}
+	return bytes;
+}
+
+bool WriteBytes(const string &filename, vector<char> &bytes) {
+	FILE *f = fopen(filename.c_str(), "wb");
+	bool ok = f && fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+	return f && fclose(f) == 0 && ok;
+}
+
+bool Exists(const string &filename) {
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (f)
+		fclose(f);
+	return f != NULL;
+}
+
+bool Linked(GLuint program) {
+	GLint status = GL_FALSE;
+	if (program)
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+	return status == GL_TRUE;
+}
+
+int main(int argc, char **argv) {
+	int nPrograms = argc > 1? atoi(argv[1]) : 8;
+	GLint nFormats = 0;
+	if (!TestContext()) {
+		printf("ShaderCacheTest: no GL context, skipped\n");
+		return testSkipped;
+	}
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+	if (nFormats < 1) {
+		printf("ShaderCacheTest: no program binary formats, skipped\n");
+		return testSkipped;
+	}
+	compileShader = glad_glCompileShader;
+	glad_glCompileShader = CountedCompileShader;
+	string directory = TempFile("GLXtrasShaderCacheTest");
+	SetShaderCache(directory.c_str());
+	string file = CacheFile(directory, vertexCode, pixelCode);
+	remove(file.c_str());
+	// the first link compiles and writes a binary, the second is a hit: linked, with no compile
+	GLuint first = LinkProgramViaCode(&vertexCode, &pixelCode);
+	Check(Linked(first) && nCompiles == 2 && Exists(file), "miss compiles and writes binary");
+	int compiles = nCompiles;
+	GLuint second = LinkProgramViaCode(&vertexCode, &pixelCode);
+	Check(Linked(second) && second != first && nCompiles == compiles, "hit without glCompileShader");
+	Check(UniformLocation(second, "view") >= 0 && UniformLocation(second, "color") >= 0, "hit has uniforms");
+	ProgramFuture hit = LinkProgramAsync(&vertexCode, &pixelCode);
+	Check(hit.done && Linked(hit.Get()) && nCompiles == compiles, "LinkProgramAsync hit done on return");
+	// a corrupt binary is rejected and removed, and the program compiled anew and cached again
+	vector<char> good = ReadBytes(file), bad = good;
+	for (size_t i = sizeof(GLenum); i < bad.size(); i++)
+		bad[i] = (char) ~bad[i];
+	Check(bad.size() > sizeof(GLenum) && WriteBytes(file, bad), "corrupt binary");
+	ProgramFuture rejected = LinkProgramAsync(&vertexCode, &pixelCode);
+	Check(!rejected.done && nCompiles == compiles+2 && !Exists(file), "corrupt binary removed, program recompiled");
+	Check(Linked(rejected.Get()) && Exists(file) && ReadBytes(file) != bad, "recompiled program cached");
+	compiles = nCompiles;
+	Check(Linked(LinkProgramViaCode(&vertexCode, &pixelCode)) && nCompiles == compiles, "hit after recompile");
+	// startup: link nPrograms with an empty cache (cold), then again from the cache (warm)
+	vector<string> variants(nPrograms), files(nPrograms);
+	vector<const char *> codes(nPrograms);
+	for (int i = 0; i < nPrograms; i++) {
+		variants[i] = Variant(i);
+		codes[i] = variants[i].c_str();
+		files[i] = CacheFile(directory, vertexCode, codes[i]);
+		remove(files[i].c_str());
+	}
+	auto Startup = [&]() {
+		for (int i = 0; i < nPrograms; i++)
+			DeleteProgram(LinkProgramViaCode(&vertexCode, &codes[i]));
+	};
+	double start = Seconds();
+	Startup();
+	double cold = Seconds()-start;
+	compiles = nCompiles;
+	double warm = BestTime(Startup);
+	Check(nCompiles == compiles, "warm startup without glCompileShader");
+	printf("%d programs: cold startup %.1f ms, warm (cached) %.1f ms\n", nPrograms, 1000*cold, 1000*warm);
+	for (string &f : files)
+		remove(f.c_str());
+	remove(file.c_str());
+	return TestResult("ShaderCacheTest");
+}
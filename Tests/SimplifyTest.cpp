@@ -0,0 +1,190 @@
+// SimplifyTest.cpp - LOD chain: triangle counts, group/material ranges, locked border and seam vertices, accumulated error, SelectLOD; times (c) 2019-2022 Jules Bloomenthal
+// usage: SimplifyTest [sphere resolution]  (default 300: a 359K triangle sphere)
+
+#include <float.h>
+#include <algorithm>
+#include "CameraArcball.h"
+#include "Mesh.h"
+#include "Misc.h"
+#include "Test.h"
+
+void Sphere(int res, Mesh &m) {
+	// res by 2*res latitude/longitude sphere with a uv seam (first and last columns coincide), three
+	// groups of latitude bands, and two materials that split the triangles off a band boundary
+	m.points.resize(0);
+	m.triangles.resize(0);
+	for (int j = 0; j <= res; j++)
+		for (int i = 0; i <= 2*res; i++) {
+			float phi = 3.1415926f*j/res, theta = 3.1415926f*i/res;
+			m.points.push_back(vec3(sin(phi)*cos(theta), sin(phi)*sin(theta), cos(phi)));
+		}
+	m.triangleGroups.resize(0);
+	for (int j = 0; j < res; j++) {
+		if (j == 0 || j == res/3 || j == 2*res/3)
+			m.triangleGroups.push_back(Group((int) m.triangles.size(), "band"));
+		for (int i = 0; i < 2*res; i++) {
+			int a = j*(2*res+1)+i, b = a+1, c = a+2*res+1, d = c+1;
+			if (j > 0)
+				m.triangles.push_back(int3(a, c, b));
+			if (j < res-1)
+				m.triangles.push_back(int3(b, c, d));
+		}
+		m.triangleGroups.back().nTriangles = (int) m.triangles.size()-m.triangleGroups.back().startTriangle;
+	}
+	int n = (int) m.triangles.size(), half = n/2+7;
+	m.triangleMtls = {Mtl(0, "a", vec3(), vec3(), vec3()), Mtl(half, "b", vec3(), vec3(), vec3())};
+	m.triangleMtls[0].nTriangles = half;
+	m.triangleMtls[1].nTriangles = n-half;
+}
+
+vector<int> BorderVertices(vector<int3> &triangles) {
+	// vertices of edges used by one triangle (borders, and seams, which are borders in index space)
+	vector<std::pair<int, int>> edges;
+	for (int3 &t : triangles)
+		for (int k = 0; k < 3; k++)
+			edges.push_back({std::min(t[k], t[(k+1)%3]), std::max(t[k], t[(k+1)%3])});
+	std::sort(edges.begin(), edges.end());
+	vector<int> border;
+	for (size_t i = 0, j; i < edges.size(); i = j) {
+		for (j = i; j < edges.size() && edges[j] == edges[i]; j++)
+			;
+		if (j-i == 1) {
+			border.push_back(edges[i].first);
+			border.push_back(edges[i].second);
+		}
+	}
+	std::sort(border.begin(), border.end());
+	border.erase(std::unique(border.begin(), border.end()), border.end());
+	return border;
+}
+
+bool AllUsed(vector<int> &vertices, vector<int3> &triangles, int nPoints) {
+	vector<char> used(nPoints, 0);
+	for (int3 &t : triangles)
+		used[t.i1] = used[t.i2] = used[t.i3] = 1;
+	for (int v : vertices)
+		if (!used[v])
+			return false;
+	return true;
+}
+
+template <class R> bool Contiguous(vector<R> &ranges, int nTriangles) {
+	// ranges (other than unused materials) follow one another from 0 and together cover nTriangles
+	int next = 0, nUsed = 0;
+	for (R &r : ranges)
+		if (r.startTriangle >= 0) {
+			if (r.startTriangle != next)
+				return false;
+			next += r.nTriangles;
+			nUsed++;
+		}
+	return !nUsed || next == nTriangles;
+}
+
+float Distance(vec3 p, vec3 a, vec3 b, vec3 c) {
+	// distance from p to triangle abc: to its plane if p projects inside, else to the nearest edge
+	vec3 n = cross(b-a, c-a), e[] = {a, b, c};
+	float len = length(n);
+	if (len > 0 && dot(cross(b-a, p-a), n) >= 0 && dot(cross(c-b, p-b), n) >= 0 && dot(cross(a-c, p-c), n) >= 0)
+		return fabs(dot(p-a, n))/len;
+	float d = FLT_MAX;
+	for (int k = 0; k < 3; k++) {
+		vec3 p1 = e[k], v = e[(k+1)%3]-p1;
+		float l2 = dot(v, v), t = l2 > 0? std::max(0.f, std::min(1.f, dot(p-p1, v)/l2)) : 0;
+		d = std::min(d, length(p-(p1+t*v)));
+	}
+	return d;
+}
+
+float MaxDistance(vector<vec3> &points, vector<int3> &full, vector<int3> &lod) {
+	// largest distance from a vertex of the full mesh to the LOD surface
+	vector<char> used(points.size(), 0);
+	for (int3 &t : full)
+		used[t.i1] = used[t.i2] = used[t.i3] = 1;
+	float dMax = 0;
+	for (size_t v = 0; v < points.size(); v++) {
+		float d = FLT_MAX;
+		for (size_t t = 0; used[v] && t < lod.size(); t++)
+			d = std::min(d, Distance(points[v], points[lod[t].i1], points[lod[t].i2], points[lod[t].i3]));
+		if (used[v])
+			dMax = std::max(dMax, d);
+	}
+	return dMax;
+}
+
+float SphereDeviation(vector<vec3> &points, vector<int3> &lod) {
+	// largest distance of a triangle centroid inside the unit sphere
+	float d = 0;
+	for (int3 &t : lod)
+		d = std::max(d, 1-length((points[t.i1]+points[t.i2]+points[t.i3])/3));
+	return d;
+}
+
+void Report(const char *name, Mesh &m, vector<float> &ratios, bool sphere) {
+	// per level: triangles, estimated and measured error (percent of bounding diagonal), triangles in per second
+	float diagonal = 2*m.lodRadius;
+	printf("%s, %d triangles, %d threads:\n", name, (int) m.triangles.size(), NumThreads());
+	for (size_t i = 0; i < m.lods.size(); i++) {
+		vector<int3> &in = i? m.lods[i-1].triangles : m.triangles, out;
+		double t = BestTime([&]() {
+			out = in;
+			SimplifyMesh(m.points, out, (int) (ratios[i]*m.triangles.size()));
+		}, 3);
+		float measured = sphere? SphereDeviation(m.points, m.lods[i].triangles) : MaxDistance(m.points, m.triangles, m.lods[i].triangles);
+		printf("  1/%-3.0f %7d triangles, error %.2f%% of diagonal (measured %.2f%%), %.2fM triangles/sec\n",
+			1/ratios[i], (int) m.lods[i].triangles.size(), 100*m.lods[i].error/diagonal, 100*measured/diagonal,
+			1e-6*in.size()/t);
+	}
+}
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 300;
+	vector<float> ratios = {.5f, .25f, .125f, .0625f};
+	// sphere: each LOD reaches its target, ranges stay contiguous, seams and band boundaries stay put
+	Mesh sphere;
+	Sphere(res, sphere);
+	int nTriangles = (int) sphere.triangles.size();
+	vector<int> border = BorderVertices(sphere.triangles);
+	sphere.BuildLODs(ratios);
+	bool counts = sphere.lods.size() == ratios.size(), ranges = counts, locked = counts, errors = counts;
+	for (size_t i = 0; i < sphere.lods.size(); i++) {
+		MeshLOD &lod = sphere.lods[i];
+		int n = (int) lod.triangles.size(), target = (int) (ratios[i]*nTriangles);
+		counts = counts && n <= target && n >= target-2;
+		ranges = ranges && Contiguous(lod.triangleGroups, n) && Contiguous(lod.triangleMtls, n);
+		locked = locked && AllUsed(border, lod.triangles, (int) sphere.points.size());
+		errors = errors && lod.error > 0 && (!i || lod.error >= sphere.lods[i-1].error);
+	}
+	Check(counts, "LOD triangle counts meet targets");
+	Check(ranges, "group and material ranges contiguous, sum to LOD size");
+	Check(border.size() > 0 && locked, "border and seam vertices kept");
+	Check(errors, "accumulated error never decreases");
+	// SelectLOD: full resolution if the camera is inside the bounding sphere, else a coarse LOD when far
+	CameraAB camera(0, 0, 512, 512, vec3(0, 0, 0), vec3(0, 0, 0), 60, .1f, 200);
+	camera.SetModelview(mat4());
+	sphere.lodPixelError = 1e6f;
+	sphere.transform = Translate(-sphere.lodCenter);
+	int inside = sphere.SelectLOD(camera, 512);
+	sphere.transform = Translate(0, 0, -.5f*sphere.lodRadius)*Translate(-sphere.lodCenter);
+	int justInside = sphere.SelectLOD(camera, 512);
+	sphere.transform = Translate(0, 0, -100)*Translate(-sphere.lodCenter);
+	int far = sphere.SelectLOD(camera, 512);
+	Check(inside == -1 && justInside == -1 && far == (int) sphere.lods.size()-1, "SelectLOD -1 inside bounding sphere");
+	// Head.obj: error accumulates along the chain; its uv seams and borders limit the coarser levels
+	Mesh head;
+	if (Check(ReadAsciiObj("Assets/Head.obj", head.points, head.triangles, NULL, NULL, &head.triangleGroups, &head.triangleMtls), "read Head.obj")) {
+		vector<int> headBorder = BorderVertices(head.triangles);
+		head.BuildLODs(ratios);
+		bool headOk = true;
+		for (size_t i = 0; i < head.lods.size(); i++) {
+			MeshLOD &lod = head.lods[i];
+			int n = (int) lod.triangles.size();
+			headOk = headOk && Contiguous(lod.triangleGroups, n) && Contiguous(lod.triangleMtls, n) &&
+					 AllUsed(headBorder, lod.triangles, (int) head.points.size()) && (!i || lod.error >= head.lods[i-1].error);
+		}
+		Check(headOk, "Head.obj ranges, locked vertices, error");
+		Report("Head.obj", head, ratios, false);
+	}
+	Report("sphere", sphere, ratios, true);
+	return TestResult("SimplifyTest");
+}
@@ -0,0 +1,81 @@
+// Test.h - checks, timing and GL context for the test programs (c) 2019-2022 Jules Bloomenthal
+
+#ifndef TEST_HDR
+#define TEST_HDR
+
+#include <glad.h>
+#include <GLFW/glfw3.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+
+// Checks
+
+inline int testFailures = 0;
+
+inline bool Check(bool ok, const char *what) {
+	// print and count a failed check
+	if (!ok) {
+		printf("FAILED: %s\n", what);
+		testFailures++;
+	}
+	return ok;
+}
+
+inline int TestResult(const char *name) {
+	// return value for main: 0 if all checks passed
+	printf("%s: %s\n", name, testFailures? "FAILED" : "passed");
+	return testFailures? 1 : 0;
+}
+
+const int testSkipped = 77;		// return value for main if the test can't run (eg, no GL context)
+
+// Timing
+
+inline double Seconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <class F> double BestTime(F f, int reps = 5) {
+	// fastest of reps calls to f, in seconds
+	double best = 1e30;
+	for (int r = 0; r < reps; r++) {
+		double start = Seconds();
+		f();
+		double t = Seconds()-start;
+		if (t < best)
+			best = t;
+	}
+	return best;
+}
+
+// Files
+
+inline std::string TempFile(const char *name) {
+	// path of name in the temporary directory
+	const char *dir = getenv("TEMP");
+	if (!dir) dir = getenv("TMPDIR");
+	return std::string(dir? dir : "/tmp")+"/"+name;
+}
+
+// GL
+
+inline GLFWwindow *TestContext(int width = 256, int height = 256) {
+	// hidden window with a current GL 4.1 context and glad loaded; NULL if there is no display
+	if (!glfwInit())
+		return NULL;
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow *w = glfwCreateWindow(width, height, "Test", NULL, NULL);
+	if (!w)
+		return NULL;
+	glfwMakeContextCurrent(w);
+	gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
+	return w;
+}
+
+#endif
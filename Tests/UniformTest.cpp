@@ -0,0 +1,134 @@
+// UniformTest.cpp - uniform cache: GL calls counted by a shim, current program (tracked, not queried), deletion, array elements (c) 2019-2022 Jules Bloomenthal
+// usage: UniformTest [# sets]  (default 1000000)
+
+#include "GLXtras.h"
+#include "Test.h"
+
+// GL shim: glad's function pointers are replaced by counting thunks
+
+int nUploads = 0, nLocations = 0, nQueries = 0;
+PFNGLUNIFORM1FPROC uniform1f;
+PFNGLUNIFORM3FPROC uniform3f;
+PFNGLUNIFORM3FVPROC uniform3fv;
+PFNGLUNIFORMMATRIX4FVPROC uniformMatrix4fv;
+PFNGLGETUNIFORMLOCATIONPROC getUniformLocation;
+PFNGLGETINTEGERVPROC getIntegerv;
+PFNGLISPROGRAMPROC isProgram;
+
+void Shim() {
+	uniform1f = glad_glUniform1f;
+	uniform3f = glad_glUniform3f;
+	uniform3fv = glad_glUniform3fv;
+	uniformMatrix4fv = glad_glUniformMatrix4fv;
+	getUniformLocation = glad_glGetUniformLocation;
+	getIntegerv = glad_glGetIntegerv;
+	isProgram = glad_glIsProgram;
+	glad_glUniform1f = [](GLint l, GLfloat v) { nUploads++; uniform1f(l, v); };
+	glad_glUniform3f = [](GLint l, GLfloat x, GLfloat y, GLfloat z) { nUploads++; uniform3f(l, x, y, z); };
+	glad_glUniform3fv = [](GLint l, GLsizei n, const GLfloat *v) { nUploads++; uniform3fv(l, n, v); };
+	glad_glUniformMatrix4fv = [](GLint l, GLsizei n, GLboolean t, const GLfloat *v) { nUploads++; uniformMatrix4fv(l, n, t, v); };
+	glad_glGetUniformLocation = [](GLuint p, const GLchar *n) { nLocations++; return getUniformLocation(p, n); };
+	glad_glGetIntegerv = [](GLenum e, GLint *v) { nQueries++; getIntegerv(e, v); };
+	glad_glIsProgram = [](GLuint p) { nQueries++; return isProgram(p); };
+}
+
+const char *vShader = R"(
+	#version 330
+	in vec3 point;
+	uniform mat4 m;
+	void main() { gl_Position = m*vec4(point, 1); }
+)";
+
+const char *pShader = R"(
+	#version 330
+	uniform float f;
+	uniform vec3 lights[4];
+	out vec4 pColor;
+	void main() { pColor = vec4(f*(lights[0]+lights[1]+lights[2]+lights[3]), 1); }
+)";
+
+int Uploads(void (*f)()) {
+	// GL uploads made by f
+	int n = nUploads;
+	f();
+	return nUploads-n;
+}
+
+GLuint a, b;
+vec3 lights[4] = {vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1), vec3(1, 1, 1)};
+
+vec3 Light(GLuint program, int i) {
+	vec3 v;
+	glGetUniformfv(program, glGetUniformLocation(program, ("lights["+std::to_string(i)+"]").c_str()), (float *) &v);
+	return v;
+}
+
+bool Same(vec3 a, vec3 b) { return !memcmp(&a, &b, sizeof(vec3)); }
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 1000000;
+	if (!TestContext()) {
+		printf("UniformTest: no GL context, skipped\n");
+		return testSkipped;
+	}
+	Shim();
+	a = LinkProgramViaCode(&vShader, &pShader);
+	b = LinkProgramViaCode(&vShader, &pShader);
+	if (!Check(a && b, "programs link"))
+		return TestResult("UniformTest");
+	// a repeated value is uploaded once; locations come from the table built at link
+	nLocations = 0;
+	glUseProgram(a);
+	Check(Uploads([]() { SetUniform(a, "f", 2.f); SetUniform(a, "f", 2.f); SetUniform(a, "m", mat4()); SetUniform(a, "m", mat4()); }) == 2, "repeated values skipped");
+	Check(nLocations == 0, "no glGetUniformLocation for active uniforms");
+	// a program that isn't current has no value recorded, and the current program's values are forgotten
+	SetUniform(b, "f", 3.f);
+	glUseProgram(b);
+	Check(Uploads([]() { SetUniform(b, "f", 3.f); }) == 1, "value for non-current program not recorded");
+	glUseProgram(a);
+	Check(Uploads([]() { SetUniform(a, "f", 2.f); }) == 1, "current program's values forgotten");
+	float f = 0;
+	glGetUniformfv(a, glGetUniformLocation(a, "f"), &f);
+	Check(f == 2, "current program's value restored");
+	// an array and its elements
+	Check(Uploads([]() { SetUniform3v(a, "lights", 4, (float *) lights); SetUniform3v(a, "lights", 4, (float *) lights); }) == 1, "array upload skipped");
+	Check(Uploads([]() { SetUniform(a, "lights[2]", vec3(5, 5, 5)); SetUniform3v(a, "lights", 4, (float *) lights); }) == 2, "element invalidates array");
+	Check(Same(Light(a, 2), lights[2]), "array restored");
+	Check(Uploads([]() { SetUniform(a, "lights[2]", lights[2]); SetUniform3v(a, "lights", 4, (float *) lights); SetUniform(a, "lights[2]", lights[2]); }) == 3, "array invalidates element");
+	// direct glUniform, then InvalidateUniforms
+	glUniform1f(glGetUniformLocation(a, "f"), 7);
+	InvalidateUniforms(a);
+	Check(Uploads([]() { SetUniform(a, "f", 2.f); }) == 1, "InvalidateUniforms");
+	// a program deleted with glDeleteProgram is forgotten
+	glUseProgram(b);
+	SetUniform(b, "f", 1.f);
+	glUseProgram(0);
+	glDeleteProgram(a);
+	Check(!SetUniform(a, "f", 1.f), "no uniforms for deleted program");
+	// the current program is tracked, not queried (debug builds also query GL, to check)
+	GLuint c = LinkProgramViaCode(&vShader, &pShader);
+	nQueries = 0;
+	for (int i = 0; i < 200; i++) {
+		GLuint p = i%2? b : c;
+		glUseProgram(p);
+		SetUniform(p, "f", (float) (i/4));
+		SetUniform(p, "m", mat4());
+	}
+#ifdef NDEBUG
+	Check(nQueries == 0, "no glGet or glIsProgram for SetUniform or program switches");
+#endif
+	float fb = 0, fc = 0;
+	glGetUniformfv(b, glGetUniformLocation(b, "f"), &fb);
+	glGetUniformfv(c, glGetUniformLocation(c, "f"), &fc);
+	Check(fb == 49 && fc == 49, "values set with tracked current program");
+	printf("%d glGet/glIsProgram calls for 200 program switches and 400 SetUniforms\n", nQueries);
+	// times: a repeated value, and a changing one
+	glUseProgram(b);
+	nUploads = 0;
+	double tSame = BestTime([&]() { for (int i = 0; i < n; i++) SetUniform(b, "f", 1.f); }, 3)/n;
+	int nSame = nUploads;
+	double tChanged = BestTime([&]() { for (int i = 0; i < n; i++) SetUniform(b, "f", (float) i); }, 3)/n;
+	Check(nSame <= 1, "one upload for a repeated value");
+	printf("SetUniform: repeated value %.0f ns (%d uploads for %d calls), changing value %.0f ns\n", 1e9*tSame, nSame, 3*n, 1e9*tChanged);
+	return TestResult("UniformTest");
+}
@@ -0,0 +1,209 @@
+// VecMatCompatTest.cpp - Vec/Mat templates are bit-identical to the hand-written classes they replaced; times (c) 2019-2022 Jules Bloomenthal
+// usage: VecMatCompatTest [# evaluations]  (default 250000)
+
+#include <vector>
+#include "VecMat.h"
+#include "VecMatOld.h"
+#include "Test.h"
+
+using std::vector;
+
+// sizes, copies and compile-time evaluation
+
+static_assert(sizeof(vec2) == 8 && sizeof(vec3) == 12 && sizeof(vec4) == 16 && sizeof(mat3) == 36 && sizeof(mat4) == 64, "sizes");
+static_assert(sizeof(int2) == 8 && sizeof(int3) == 12 && sizeof(int4) == 16, "sizes");
+static_assert(std::is_trivially_copyable<vec3>::value && std::is_trivially_copyable<mat4>::value, "trivial copy");
+constexpr vec3 ca(1, 2, 3), cb = 2.f*ca+vec3(1, 1, 1);
+static_assert(cb.x == 3 && cb.y == 5 && cb.z == 7 && dot(ca, cb) == 3+10+21, "constexpr vec3");
+static_assert(cross(vec3(1, 0, 0), vec3(0, 1, 0)).z == 1 && (-ca/2.f).z == -1.5f, "constexpr vec3");
+constexpr mat4 cs = Scale(2, 3, 4), ct = Translate(5, 6, 7), ctt = Transpose(ct), c2 = 2.f*cs;
+static_assert(cs[1].y == 3 && ct[2].w == 7 && ctt[3].z == 7 && c2[2].z == 8, "constexpr mat4");
+static_assert(int3(1, 2, 3)+int3(1, 1, 1) == int3(2, 3, 4), "int3");
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+vec3 New(const Old::vec3 &v) { return vec3(v.x, v.y, v.z); }
+
+int nChecks = 0, nBad = 0;
+
+template <class A, class B> bool Same(const A &a, const B &b) {
+	static_assert(sizeof(A) == sizeof(B), "same size");
+	return !memcmp(&a, &b, sizeof(A));
+}
+
+template <class A, class B> void Compare(const A &a, const B &b) {
+	nChecks++;
+	nBad += !Same(a, b);
+}
+
+template <class O, class N> void Vectors(const O &a, const O &b, const N &A, const N &B, float s, float f) {
+	// each operator and non-class operation, old a, b vs new A, B
+	Compare(-a, -A);
+	Compare(a+b, A+B);
+	Compare(a-b, A-B);
+	Compare(a*s, A*s);
+	Compare(s*a, s*A);
+	Compare(a/s, A/s);
+	Compare(dot(a, b), dot(A, B));
+	Compare(length(a), length(A));
+	Compare(normalize(a), normalize(A));
+	Compare(a+1.5f, A+1.5f);
+	O o = a;
+	N n = A;
+	o += b; o -= b*f; o *= s; o /= f;
+	n += B; n -= B*f; n *= s; n /= f;
+	Compare(o, n);
+	for (int i = 0; i < (int) (sizeof(O)/sizeof(float)); i++)
+		Compare(a[i], A[i]);
+}
+
+template <class V> V RandomVec() {
+	V v;
+	for (int i = 0; i < (int) (sizeof(V)/sizeof(float)); i++)
+		v[i] = Random(-10, 10);
+	return v;
+}
+
+template <class O, class N> void RandomMat(O &o, N &n, int size) {
+	for (int i = 0; i < size; i++)
+		for (int j = 0; j < size; j++)
+			o[i][j] = n[i][j] = Random(-10, 10);
+}
+
+void Compatible(int nTrials) {
+	for (int t = 0; t < nTrials; t++) {
+		float s = Random(-10, 10), f = Random(-10, 10);
+		Old::vec2 a2 = RandomVec<Old::vec2>(), b2 = RandomVec<Old::vec2>();
+		Old::vec3 a3 = RandomVec<Old::vec3>(), b3 = RandomVec<Old::vec3>();
+		Old::vec4 a4 = RandomVec<Old::vec4>(), b4 = RandomVec<Old::vec4>();
+		vec2 A2(a2.x, a2.y), B2(b2.x, b2.y);
+		vec3 A3(a3.x, a3.y, a3.z), B3(b3.x, b3.y, b3.z);
+		vec4 A4(a4.x, a4.y, a4.z, a4.w), B4(b4.x, b4.y, b4.z, b4.w);
+		Vectors(a2, b2, A2, B2, s, f);
+		Vectors(a3, b3, A3, B3, s, f);
+		Vectors(a4, b4, A4, B4, s, f);
+		// componentwise products (old vec4*vec4 had w*v.z, fixed; vec4 *= was componentwise)
+		Compare(a2*b2, A2*B2); Compare(a2/b2, A2/B2);
+		Compare(a3*b3, A3*B3); Compare(a3/b3, A3/B3);
+		Old::vec4 o4 = a4; o4 *= b4;
+		vec4 n4 = A4; n4 *= B4;
+		Compare(o4, n4);
+		Compare(cross(a2, b2), cross(A2, B2));
+		Compare(cross(a3, b3), cross(A3, B3));
+		// constructors
+		Compare(Old::vec3(a2, f), vec3(A2, f));
+		Compare(Old::vec4(a3, f), vec4(A3, f));
+		Compare(Old::vec4(a2, f, s), vec4(A2, f, s));
+		Compare(Old::vec2(3, 4), vec2(3, 4));
+		Compare(Old::int3(1, 2, 3)+Old::int3(4, 5, 6)-Old::int3(1, 1, 1), int3(1, 2, 3)+int3(4, 5, 6)-int3(1, 1, 1));
+		// matrices
+		Old::mat4 m1, m2;
+		mat4 M1, M2;
+		RandomMat(m1, M1, 4);
+		RandomMat(m2, M2, 4);
+		Old::mat3 q1, q2;
+		mat3 Q1, Q2;
+		RandomMat(q1, Q1, 3);
+		RandomMat(q2, Q2, 3);
+		Compare(m1*m2, M1*M2); Compare(m1*a4, M1*A4); Compare(s*m1, s*M1); Compare(m1*s, M1*s);
+		Compare(q1*q2, Q1*Q2); Compare(q1*a3, Q1*A3); Compare(s*q1, s*Q1);
+		Compare(Old::mat4(q1), mat4(Q1));
+		Compare(Old::mat4(f), mat4(f));
+		Compare(Old::mat3(), mat3());
+		Compare(Old::Scale(a3)*Old::Translate(b3)*Old::RotateX(9*s)*Old::RotateY(9*f)*Old::RotateZ(s*f),
+			 Scale(A3)*Translate(B3)*RotateX(9*s)*RotateY(9*f)*RotateZ(s*f));
+		Compare(Old::Orthographic(a4.x, a4.y, a4.z, a4.w, s, f), Orthographic(A4.x, A4.y, A4.z, A4.w, s, f));
+		Compare(Old::Perspective(30+s, 1.5f, 1, 100), Perspective(30+s, 1.5f, 1, 100));
+		Compare(Old::LookAt(a3, b3, Old::vec3(0, 1, 0)), LookAt(A3, B3, vec3(0, 1, 0)));
+		Compare(Old::Transpose(m1), Transpose(M1));
+		const float *o = m1, *n = M1;
+		Compare(o[7], n[7]);
+	}
+}
+
+// benchmark: C++ versions of the BezierLOD evaluation shader, shading and a ScreenMode matrix chain,
+// for either set of classes
+
+template <class V> V CurvePoint(float t, V b1, V b2, V b3, V b4) {
+	float t2 = t*t, t3 = t*t2;
+	return (-t3+3*t2-3*t+1)*b1+(3*t3-6*t2+3*t)*b2+(3*t2-3*t3)*b3+t3*b4;
+}
+
+template <class V> V PatchPoint(const V *ctrlPts, float s, float t) {
+	V spts[4];
+	for (int i = 0; i < 4; i++)
+		spts[i] = CurvePoint(s, ctrlPts[4*i], ctrlPts[4*i+1], ctrlPts[4*i+2], ctrlPts[4*i+3]);
+	return CurvePoint(t, spts[0], spts[1], spts[2], spts[3]);
+}
+
+template <class V> V PatchPolynomial(const V *coeffs, float s, float t) {
+	float s2 = s*s, s3 = s*s2, t2 = t*t, t3 = t*t2;
+	V spts[4];
+	for (int i = 0; i < 4; i++)
+		spts[i] = s3*coeffs[4*i]+s2*coeffs[4*i+1]+s*coeffs[4*i+2]+coeffs[4*i+3];
+	return t3*spts[0]+t2*spts[1]+t*spts[2]+spts[3];
+}
+
+template <class V> V Patch(bool polynomial, const V *c, int res) {
+	V sum;
+	for (int i = 0; i < res; i++)
+		for (int j = 0; j < res; j++) {
+			float s = (float) i/res, t = (float) j/res;
+			sum += polynomial? PatchPolynomial(c, s, t) : PatchPoint(c, s, t);
+		}
+	return sum;
+}
+
+template <class V> V Shade(const V *points, const V *normals, int n) {
+	V light(1, 2, 3), sum;
+	for (int i = 0; i < n; i++) {
+		V l = normalize(light-points[i]), nn = normalize(normals[i]), h = normalize(l+V(0, 0, 1));
+		float d = dot(nn, l), s = dot(nn, h);
+		sum += (d > 0? d : 0)*V(.8f, .6f, .4f)+s*s*s*V(1, 1, 1);
+	}
+	return sum;
+}
+
+template <class M, class V> V Chain(int n, float w, float h, M (*translate)(float, float, float), M (*scale)(float, float, float)) {
+	V sum;
+	for (int i = 0; i < n; i++)
+		sum += translate(-1, -1, 0)*scale(2/(w+i), 2/h, 1)*translate(-(float) i, -h, 0)*V(1, 1, 1, 1);
+	return sum;
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 250000;
+	srand(1);
+	Compatible(20000);
+	printf("%d comparisons\n", nChecks);
+	Check(nBad == 0, "templates bit-identical to hand-written classes");
+	Old::vec4 o = Old::vec4(1, 2, 3, 4)*Old::vec4(5, 6, 7, 8);
+	vec4 p = vec4(1, 2, 3, 4)*vec4(5, 6, 7, 8);
+	Check(o.w == 28 && p.w == 32, "vec4*vec4 w is w*v.w (was w*v.z)");
+	// times, hand-written vs templates
+	int res = (int) sqrt((float) n);
+	vector<Old::vec3> oCtrl(16), oPoints(n), oNormals(n);
+	vector<vec3> ctrl(16), points(n), normals(n);
+	for (int i = 0; i < 16; i++)
+		ctrl[i] = New(oCtrl[i] = RandomVec<Old::vec3>());
+	for (int i = 0; i < n; i++) {
+		points[i] = New(oPoints[i] = RandomVec<Old::vec3>());
+		normals[i] = New(oNormals[i] = RandomVec<Old::vec3>());
+	}
+	Check(Same(Patch(false, oCtrl.data(), 20), Patch(false, ctrl.data(), 20)), "patch points bit-identical");
+	volatile float sink = 0;
+	double tOldPatch = BestTime([&]() { sink = Patch(false, oCtrl.data(), res).x; });
+	double tPatch = BestTime([&]() { sink = Patch(false, ctrl.data(), res).x; });
+	double tOldPoly = BestTime([&]() { sink = Patch(true, oCtrl.data(), res).x; });
+	double tPoly = BestTime([&]() { sink = Patch(true, ctrl.data(), res).x; });
+	double tOldShade = BestTime([&]() { sink = Shade(oPoints.data(), oNormals.data(), n).x; });
+	double tShade = BestTime([&]() { sink = Shade(points.data(), normals.data(), n).x; });
+	double tOldChain = BestTime([&]() { sink = Chain<Old::mat4, Old::vec4>(n, 640, 480, Old::Translate, Old::Scale).x; });
+	double tChain = BestTime([&]() { sink = Chain<mat4, vec4>(n, 640, 480, Translate, Scale).x; });
+	printf("%d evaluations, ms hand-written vs templates:\n", res*res);
+	printf("  patch points (curve points) %.2f, %.2f; patch points (polynomial) %.2f, %.2f\n",
+		1e3*tOldPatch, 1e3*tPatch, 1e3*tOldPoly, 1e3*tPoly);
+	printf("  %d shades (normalize, dot) %.2f, %.2f; matrix chains %.2f, %.2f\n",
+		n, 1e3*tOldShade, 1e3*tShade, 1e3*tOldChain, 1e3*tChain);
+	return TestResult("VecMatCompatTest");
+}
@@ -0,0 +1,132 @@
+// VecMatTest.cpp - SIMD mat4*vec4 and batch transforms are bit-identical to scalar code; times (c) 2019-2022 Jules Bloomenthal
+// usage: VecMatTest [# points]  (default 4096)
+
+#include <vector>
+#include "VecMat.h"
+#include "Test.h"
+
+using std::vector;
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+mat4 RandomMatrix() {
+	mat4 m;
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			m[i][j] = Random(-10, 10);
+	return m;
+}
+
+// scalar reference: the loops VecMat used before SIMD (same products, same summation order)
+
+mat4 Product(const mat4 &a, const mat4 &b) {
+	mat4 r(0);
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 4; j++)
+			for (int k = 0; k < 4; k++)
+				r[i][j] += a[i][k]*b[k][j];
+	return r;
+}
+
+float Dot(const mat4 &m, int row, const vec4 &v) { return m[row][0]*v[0]+m[row][1]*v[1]+m[row][2]*v[2]+m[row][3]*v[3]; }
+
+vec4 Product(const mat4 &m, const vec4 &v) { return vec4(Dot(m, 0, v), Dot(m, 1, v), Dot(m, 2, v), Dot(m, 3, v)); }
+
+vec2 Screen(const mat4 &m, const vec3 &p, const vec4 &vp) {
+	vec4 x = Product(m, vec4(p, 1));
+	return vec2(vp.x+((x.x/x.w)+1)*.5f*vp.z, vp.y+((x.y/x.w)+1)*.5f*vp.w);
+}
+
+template <class T> bool Same(const T &a, const T &b) { return !memcmp(&a, &b, sizeof(T)); }
+
+int main(int argc, char **argv) {
+	int n = argc > 1? atoi(argv[1]) : 4096;
+	srand(1);
+	// products: random, and signed zeros
+	int nBad = 0;
+	for (int t = 0; t < 100000; t++) {
+		mat4 a = RandomMatrix(), b = RandomMatrix();
+		nBad += !Same(a*b, Product(a, b));
+	}
+	mat4 z(0);
+	z[0][0] = -0.f;
+	nBad += !Same(z*z, Product(z, z));
+	Check(nBad == 0, "mat4*mat4 bit-identical");
+	nBad = 0;
+	for (int t = 0; t < 100000; t++) {
+		mat4 m = RandomMatrix();
+		vec4 v(Random(-10, 10), Random(-10, 10), Random(-10, 10), Random(-10, 10));
+		nBad += !Same(m*v, Product(m, v));
+	}
+	Check(nBad == 0, "mat4*vec4 bit-identical");
+	// batches: counts around the SIMD widths and the 64 point blocks
+	mat4 m = RandomMatrix(), persp = Perspective(30, 1.5f, .1f, 100)*Translate(0, 0, -20)*RotateY(30);
+	vec4 vp(10, 20, 640, 480);
+	int nBad3 = 0, nBad4 = 0, nBadSoA = 0, nBadScreen = 0, nBadInPlace = 0;
+	for (int count : {0, 1, 3, 7, 8, 9, 63, 64, 65, 1000, 1001}) {
+		vector<vec3> in(count), out3(count), inPlace;
+		vector<vec4> out4(count);
+		vector<vec2> screen(count);
+		vector<float> x(count), y(count), zs(count), ox(count), oy(count), oz(count), ow(count);
+		for (int i = 0; i < count; i++) {
+			in[i] = vec3(Random(-10, 10), Random(-10, 10), Random(-10, 10));
+			x[i] = in[i].x;
+			y[i] = in[i].y;
+			zs[i] = in[i].z;
+		}
+		inPlace = in;
+		TransformPoints(m, in.data(), out3.data(), count);
+		TransformPoints(m, inPlace.data(), inPlace.data(), count);
+		TransformPoints(m, in.data(), out4.data(), count);
+		TransformPoints(m, x.data(), y.data(), zs.data(), ox.data(), oy.data(), oz.data(), ow.data(), count);
+		TransformToViewport(persp, in.data(), screen.data(), count, vp);
+		for (int i = 0; i < count; i++) {
+			vec4 r = Product(m, vec4(in[i], 1));
+			nBad3 += !Same(out3[i], vec3(r.x, r.y, r.z));
+			nBadInPlace += !Same(inPlace[i], out3[i]);
+			nBad4 += !Same(out4[i], r);
+			nBadSoA += !Same(vec4(ox[i], oy[i], oz[i], ow[i]), r);
+			nBadScreen += !Same(screen[i], Screen(persp, in[i], vp));
+		}
+	}
+	Check(nBad3 == 0 && nBadInPlace == 0, "TransformPoints vec3 to vec3, and in place");
+	Check(nBad4 == 0, "TransformPoints vec3 to vec4");
+	Check(nBadSoA == 0, "TransformPoints structure of arrays");
+	Check(nBadScreen == 0, "TransformToViewport");
+	// times, per product or point, against the scalar reference
+	vector<mat4> ms(1024), mo(1024);
+	vector<vec4> vs(1024), vo(1024);
+	for (int i = 0; i < 1024; i++) {
+		ms[i] = RandomMatrix();
+		vs[i] = vec4(Random(-10, 10), Random(-10, 10), Random(-10, 10), 1);
+	}
+	vector<vec3> in(n), out3(n);
+	vector<vec4> out4(n);
+	vector<vec2> screen(n);
+	for (vec3 &p : in)
+		p = vec3(Random(-10, 10), Random(-10, 10), Random(-10, 10));
+	double tRefMat = BestTime([&]() { for (int i = 0; i < 1023; i++) mo[i] = Product(ms[i], ms[i+1]); })/1023;
+	double tMat = BestTime([&]() { for (int i = 0; i < 1023; i++) mo[i] = ms[i]*ms[i+1]; })/1023;
+	double tRefVec = BestTime([&]() { for (int i = 0; i < 1024; i++) vo[i] = Product(ms[i], vs[i]); })/1024;
+	double tVec = BestTime([&]() { for (int i = 0; i < 1024; i++) vo[i] = ms[i]*vs[i]; })/1024;
+	double tRef3 = BestTime([&]() { for (int i = 0; i < n; i++) { vec4 r = Product(m, vec4(in[i], 1)); out3[i] = vec3(r.x, r.y, r.z); } })/n;
+	double t3 = BestTime([&]() { TransformPoints(m, in.data(), out3.data(), n); })/n;
+	double tRef4 = BestTime([&]() { for (int i = 0; i < n; i++) out4[i] = Product(m, vec4(in[i], 1)); })/n;
+	double t4 = BestTime([&]() { TransformPoints(m, in.data(), out4.data(), n); })/n;
+	double tRefScreen = BestTime([&]() { for (int i = 0; i < n; i++) screen[i] = Screen(persp, in[i], vp); })/n;
+	double tScreen = BestTime([&]() { TransformToViewport(persp, in.data(), screen.data(), n, vp); })/n;
+#if defined(VECMAT_SSE) && defined(__AVX__)
+	const char *simd = "SSE, AVX batches";
+#elif defined(VECMAT_SSE)
+	const char *simd = "SSE";
+#elif defined(VECMAT_NEON)
+	const char *simd = "NEON";
+#else
+	const char *simd = "none";
+#endif
+	printf("SIMD: %s; ns, scalar reference vs VecMat:\n", simd);
+	printf("  mat4*mat4 %.2f, %.2f; mat4*vec4 %.2f, %.2f\n", 1e9*tRefMat, 1e9*tMat, 1e9*tRefVec, 1e9*tVec);
+	printf("  per point (%d): vec3 to vec3 %.2f, %.2f; vec3 to vec4 %.2f, %.2f; to viewport %.2f, %.2f\n",
+		n, 1e9*tRef3, 1e9*t3, 1e9*tRef4, 1e9*t4, 1e9*tRefScreen, 1e9*tScreen);
+	return TestResult("VecMatTest");
+}
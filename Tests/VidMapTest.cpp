@@ -0,0 +1,71 @@
+// VidMapTest.cpp - VidMap agrees with std::map; weld times (c) 2019-2022 Jules Bloomenthal
+// usage: VidMapTest [grid resolution]  (default 1000: 1M vid/tid/nid keys, 6M lookups as in an OBJ grid)
+
+#include <map>
+#include "Mesh.h"
+#include "Test.h"
+
+struct CompareVid {
+	bool operator() (const int3 &a, const int3 &b) const {
+		return (a.i1==b.i1? (a.i2==b.i2? a.i3 < b.i3 : a.i2 < b.i2) : a.i1 < b.i1);
+	}
+};
+
+vector<int3> GridCorners(int res) {
+	// corners of a res*res grid of triangles in OBJ file order, each a vid/tid/nid triplet
+	vector<int3> corners;
+	corners.reserve(6*(size_t)(res-1)*(res-1));
+	for (int j = 0; j < res-1; j++)
+		for (int i = 0; i < res-1; i++) {
+			int a = j*res+i+1, b = a+1, c = a+res, d = c+1;
+			for (int v : {a, b, d, a, d, c})
+				corners.push_back(int3(v, v, v));
+		}
+	return corners;
+}
+
+int WeldStdMap(vector<int3> &corners, vector<int> &ids) {
+	// the readers' former weld: one tree node per unique key
+	std::map<int3, int, CompareVid> map;
+	for (size_t i = 0; i < corners.size(); i++) {
+		auto it = map.find(corners[i]);
+		if (it == map.end())
+			it = map.insert({corners[i], (int) map.size()}).first;
+		ids[i] = it->second;
+	}
+	return (int) map.size();
+}
+
+int WeldVidMap(vector<int3> &corners, vector<int> &ids, int expectedKeys) {
+	VidMap map(expectedKeys);
+	for (size_t i = 0; i < corners.size(); i++) {
+		int id = map.FindOrAdd(corners[i], map.Size());
+		ids[i] = id < 0? map.Size()-1 : id;
+	}
+	return map.Size();
+}
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 1000;
+	// small table: growth, Find, and keys with negative and zero fields
+	VidMap small;
+	for (int k = 0; k < 5000; k++)
+		Check(small.FindOrAdd(int3(k-2500, -k, k%7), k) == -1, "FindOrAdd new key");
+	for (int k = 0; k < 5000; k++) {
+		Check(small.Find(int3(k-2500, -k, k%7)) == k, "Find after growth");
+		Check(small.FindOrAdd(int3(k-2500, -k, k%7), -1) == k, "FindOrAdd existing key");
+	}
+	Check(small.Find(int3(0, 1, 0)) == -1 && small.Size() == 5000, "missing key, size");
+	// grid corners: same vertex ids as std::map, unsized and presized
+	vector<int3> corners = GridCorners(res);
+	vector<int> idsMap(corners.size()), idsHash(corners.size()), idsSized(corners.size());
+	int nMap = 0, nHash = 0, nSized = 0;
+	double tMap = BestTime([&]() { nMap = WeldStdMap(corners, idsMap); }, 3);
+	double tHash = BestTime([&]() { nHash = WeldVidMap(corners, idsHash, 0); }, 3);
+	double tSized = BestTime([&]() { nSized = WeldVidMap(corners, idsSized, (int) corners.size()/4); }, 3);
+	Check(nMap == res*res && nHash == nMap && nSized == nMap, "unique keys");
+	Check(idsHash == idsMap && idsSized == idsMap, "vertex ids");
+	printf("%d keys, %d lookups: std::map %.0f ms, VidMap %.0f ms (%.1fx), presized %.0f ms (%.1fx)\n",
+		nMap, (int) corners.size(), 1000*tMap, 1000*tHash, tMap/tHash, 1000*tSized, tMap/tSized);
+	return TestResult("VidMapTest");
+}
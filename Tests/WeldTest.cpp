@@ -0,0 +1,100 @@
+// WeldTest.cpp - WeldSTL agrees with a brute-force weld, including far from the origin; weld times (c) 2019-2022 Jules Bloomenthal
+// usage: WeldTest [grid resolution]  (default 1000: a 2M triangle soup)
+
+#include "Mesh.h"
+#include "Misc.h"
+#include "Test.h"
+
+float Random(float lo, float hi) { return lo+(hi-lo)*rand()/(float) RAND_MAX; }
+
+void BruteWeld(vector<VertexSTL> &v, float epsilon, vector<vec3> &points, vector<int3> &triangles) {
+	// as WeldSTL: each corner merges with the least-index corner within epsilon, chains resolved
+	int n = (int) v.size();
+	vector<int> rep(n);
+	for (int c = 0; c < n; c++) {
+		rep[c] = c;
+		for (int j = 0; j < c; j++) {
+			vec3 d = v[j].point-v[c].point;
+			if (epsilon > 0? dot(d, d) <= epsilon*epsilon : !memcmp(&v[j].point, &v[c].point, sizeof(vec3))) {
+				rep[c] = j;
+				break;
+			}
+		}
+	}
+	points.resize(0);
+	for (int c = 0; c < n; c++)
+		if (rep[c] == c) {
+			rep[c] = (int) points.size();
+			points.push_back(v[c].point);
+		}
+		else
+			rep[c] = rep[rep[c]];
+	triangles.resize(0);
+	for (int c = 0; c < n; c += 3)
+		if (rep[c] != rep[c+1] && rep[c+1] != rep[c+2] && rep[c+2] != rep[c])
+			triangles.push_back(int3(rep[c], rep[c+1], rep[c+2]));
+}
+
+bool SameWeld(vector<VertexSTL> &v, float epsilon) {
+	vector<vec3> points, brutePoints;
+	vector<int3> triangles, bruteTriangles;
+	WeldSTL(v, points, triangles, epsilon);
+	BruteWeld(v, epsilon, brutePoints, bruteTriangles);
+	return points.size() == brutePoints.size() && triangles.size() == bruteTriangles.size() &&
+		   !memcmp(points.data(), brutePoints.data(), points.size()*sizeof(vec3)) &&
+		   !memcmp(triangles.data(), bruteTriangles.data(), triangles.size()*sizeof(int3));
+}
+
+vector<VertexSTL> Soup(int nTriangles, vec3 center, float size, float jitter) {
+	// triangles whose corners are drawn from a small set of points, each corner jittered
+	vector<vec3> pool(nTriangles/2+3);
+	for (vec3 &p : pool)
+		p = center+size*vec3(Random(-1, 1), Random(-1, 1), Random(-1, 1));
+	vector<VertexSTL> v(3*nTriangles);
+	for (VertexSTL &c : v) {
+		c.point = pool[rand()%pool.size()];
+		c.point += jitter*vec3(Random(-1, 1), Random(-1, 1), Random(-1, 1));
+	}
+	return v;
+}
+
+vector<VertexSTL> GridSoup(int res) {
+	// two triangles per grid square, corners repeated as in an STL file
+	vector<VertexSTL> v;
+	v.reserve(6*(size_t) res*res);
+	for (int j = 0; j < res; j++)
+		for (int i = 0; i < res; i++) {
+			vec3 a((float) i, (float) j, 0), b(i+1.f, (float) j, 0), c((float) i, j+1.f, 0), d(i+1.f, j+1.f, 0);
+			for (vec3 p : {a, b, d, a, d, c}) {
+				VertexSTL vs;
+				vs.point = .01f*p;
+				v.push_back(vs);
+			}
+		}
+	return v;
+}
+
+int main(int argc, char **argv) {
+	int res = argc > 1? atoi(argv[1]) : 1000;
+	srand(1);
+	vector<VertexSTL> exact = Soup(1000, vec3(0, 0, 0), 1, 0);
+	Check(SameWeld(exact, 0), "exact weld");
+	vector<VertexSTL> near = Soup(1000, vec3(0, 0, 0), 1, .001f);
+	Check(SameWeld(near, .004f) && SameWeld(near, .0005f), "epsilon weld");
+	// cells far from the origin were once cast from float to int without a clamp
+	vector<VertexSTL> far = Soup(500, vec3(1e20f, -1e20f, 3e9f), 1e13f, 1e9f);
+	vector<VertexSTL> nearOrigin = Soup(500, vec3(0, 0, 0), 1, .001f);
+	far.insert(far.end(), nearOrigin.begin(), nearOrigin.end());
+	Check(SameWeld(far, .004f) && SameWeld(far, 4e9f), "epsilon weld far from origin");
+	// weld times
+	vector<VertexSTL> grid = GridSoup(res);
+	vector<vec3> points;
+	vector<int3> triangles;
+	double tExact = BestTime([&]() { WeldSTL(grid, points, triangles, 0); }, 3);
+	Check((int) points.size() == (res+1)*(res+1) && (int) triangles.size() == 2*res*res, "exact grid weld");
+	double tEpsilon = BestTime([&]() { WeldSTL(grid, points, triangles, .001f); }, 3);
+	Check((int) points.size() == (res+1)*(res+1) && (int) triangles.size() == 2*res*res, "epsilon grid weld");
+	printf("%d triangles, %d threads: WeldSTL exact %.0f ms, epsilon %.0f ms\n",
+		(int) grid.size()/3, NumThreads(), 1000*tExact, 1000*tEpsilon);
+	return TestResult("WeldTest");
+}